@@ -0,0 +1,90 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "Resources.h"
+#include "SkBitmap.h"
+#include "SkCodec.h"
+#include "SkData.h"
+#include "SkRandom.h"
+
+#include <vector>
+
+/**
+ *  Measures the latency of decoding frames of an animated image in random order, as when
+ *  scrubbing, with each frame decoded without its prior frame.  With a frame cache, each
+ *  decode replays at most fKeyframeInterval frames once the cache is warm.
+ */
+class AnimatedImageBench : public Benchmark {
+public:
+    AnimatedImageBench(const char* filename, const SkCodec::FrameCacheOptions& cacheOptions)
+        : fFilename(filename)
+        , fCacheOptions(cacheOptions)
+    {
+        fName.printf("AnimatedImage_%s_random_access", filename);
+        if (cacheOptions.fBudget) {
+            fName.appendf("_cache%d", cacheOptions.fKeyframeInterval);
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        sk_sp<SkData> data(GetResourceAsData(fFilename));
+        fCodec.reset(SkCodec::NewFromData(data));
+        if (!fCodec) {
+            return;
+        }
+
+        fInfo = fCodec->getInfo().makeColorType(kN32_SkColorType);
+        fBitmap.allocPixels(fInfo);
+        fCodec->setFrameCacheOptions(fCacheOptions);
+
+        const int frameCount = (int) fCodec->getFrameInfo().size();
+        SkRandom random;
+        for (int i = 0; i < 64; i++) {
+            fFrameOrder.push_back(random.nextULessThan(frameCount));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fCodec) {
+            return;
+        }
+
+        for (int i = 0; i < loops; i++) {
+            SkCodec::Options options;
+            options.fFrameIndex = fFrameOrder[i % fFrameOrder.size()];
+            SkAssertResult(SkCodec::kSuccess == fCodec->getPixels(fInfo, fBitmap.getPixels(),
+                    fBitmap.rowBytes(), &options, nullptr, nullptr));
+        }
+    }
+
+private:
+    const char*                         fFilename;
+    const SkCodec::FrameCacheOptions    fCacheOptions;
+    SkString                            fName;
+    std::unique_ptr<SkCodec>            fCodec;
+    SkImageInfo                         fInfo;
+    SkBitmap                            fBitmap;
+    std::vector<size_t>                 fFrameOrder;
+};
+
+static SkCodec::FrameCacheOptions frame_cache_options(int keyframeInterval) {
+    SkCodec::FrameCacheOptions options;
+    options.fBudget = keyframeInterval ? 16 * 1024 * 1024 : 0;
+    options.fKeyframeInterval = keyframeInterval;
+    return options;
+}
+
+DEF_BENCH(return new AnimatedImageBench("randPixelsAnim.gif", frame_cache_options(0)));
+DEF_BENCH(return new AnimatedImageBench("randPixelsAnim.gif", frame_cache_options(1)));
+DEF_BENCH(return new AnimatedImageBench("randPixelsAnim.gif", frame_cache_options(4)));
+DEF_BENCH(return new AnimatedImageBench("test640x479.gif", frame_cache_options(0)));
+DEF_BENCH(return new AnimatedImageBench("test640x479.gif", frame_cache_options(2)));
@@ -126,6 +126,12 @@ public:
 
     virtual void getGpuStats(SkCanvas*, SkTArray<SkString>* keys, SkTArray<double>* values) {}
 
+    /*
+     * Benches may report metrics derived from their fastest time, |ms| per loop, such as
+     * throughput.
+     */
+    virtual void getMetrics(double ms, SkTArray<SkString>* keys, SkTArray<double>* values) {}
+
 protected:
     virtual void setupPaint(SkPaint* paint);
 
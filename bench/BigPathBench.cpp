@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "SkCanvas.h"
 #include "SkPath.h"
+#include "SkScan.h"
 #include "sk_tool_utils.h"
 
 enum Align {
@@ -18,19 +19,40 @@ enum Align {
 
 const char* gAlignName[] = { "left", "middle", "right" };
 
+// Which scan converter fills the stroked path.  By default, analytic AA or supersampling,
+// depending on the path's complexity.
+enum AAMode {
+    kDefault_AAMode,
+    kSupersample_AAMode,
+    kDelta_AAMode
+};
+
+const char* gAAModeName[] = { "", "_ssaa", "_daa" };
+
+// With banded, the path's edges are split into bands scan-converted on the default executor,
+// which nanobench makes a thread pool (see --threads).
+
 // Inspired by crbug.com/455429
 class BigPathBench : public Benchmark {
     SkPath      fPath;
     SkString    fName;
     Align       fAlign;
     bool        fRound;
+    AAMode      fAAMode;
+    bool        fBanded;
+    bool        fUseAnalyticAA, fUseDeltaAA, fForceDeltaAA, fUseBandedFill;
 
 public:
-    BigPathBench(Align align, bool round) : fAlign(align), fRound(round) {
+    BigPathBench(Align align, bool round, AAMode aaMode = kDefault_AAMode, bool banded = false)
+        : fAlign(align), fRound(round), fAAMode(aaMode), fBanded(banded) {
         fName.printf("bigpath_%s", gAlignName[fAlign]);
         if (round) {
             fName.append("_round");
         }
+        fName.append(gAAModeName[fAAMode]);
+        if (banded) {
+            fName.append("_bands");
+        }
     }
 
 protected:
@@ -46,6 +68,31 @@ protected:
         sk_tool_utils::make_big_path(fPath);
     }
 
+    void onPreDraw(SkCanvas*) override {
+        fUseAnalyticAA = gSkUseAnalyticAA;
+        fUseDeltaAA = gSkUseDeltaAA;
+        fForceDeltaAA = gSkForceDeltaAA;
+        fUseBandedFill = gSkUseBandedFill;
+        gSkUseBandedFill = fBanded;
+        switch (fAAMode) {
+            case kDefault_AAMode:
+                break;
+            case kSupersample_AAMode:
+                gSkUseAnalyticAA = gSkUseDeltaAA = false;
+                break;
+            case kDelta_AAMode:
+                gSkUseDeltaAA = gSkForceDeltaAA = true;
+                break;
+        }
+    }
+
+    void onPostDraw(SkCanvas*) override {
+        gSkUseAnalyticAA = fUseAnalyticAA;
+        gSkUseDeltaAA = fUseDeltaAA;
+        gSkForceDeltaAA = fForceDeltaAA;
+        gSkUseBandedFill = fUseBandedFill;
+    }
+
     void onDraw(int loops, SkCanvas* canvas) override {
         SkPaint paint;
         paint.setAntiAlias(true);
@@ -84,3 +131,11 @@ DEF_BENCH( return new BigPathBench(kRight_Align,    false); )
 DEF_BENCH( return new BigPathBench(kLeft_Align,     true); )
 DEF_BENCH( return new BigPathBench(kMiddle_Align,   true); )
 DEF_BENCH( return new BigPathBench(kRight_Align,    true); )
+
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   false, kSupersample_AAMode); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   false, kDelta_AAMode); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   true,  kSupersample_AAMode); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   true,  kDelta_AAMode); )
+
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   false, kSupersample_AAMode, true); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   true,  kSupersample_AAMode, true); )
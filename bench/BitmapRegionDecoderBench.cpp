@@ -11,12 +11,13 @@
 #include "SkOSFile.h"
 
 BitmapRegionDecoderBench::BitmapRegionDecoderBench(const char* baseName, SkData* encoded,
-        SkColorType colorType, uint32_t sampleSize, const SkIRect& subset)
+        SkColorType colorType, uint32_t sampleSize, const SkIRect& subset, int indexRowInterval)
     : fBRD(nullptr)
     , fData(SkRef(encoded))
     , fColorType(colorType)
     , fSampleSize(sampleSize)
     , fSubset(subset)
+    , fIndexRowInterval(indexRowInterval)
 {
     // Choose a useful name for the color type
     const char* colorName = color_type_to_str(colorType);
@@ -25,6 +26,9 @@ BitmapRegionDecoderBench::BitmapRegionDecoderBench(const char* baseName, SkData*
     if (1 != sampleSize) {
         fName.appendf("_%.3f", 1.0f / (float) sampleSize);
     }
+    if (indexRowInterval > 0) {
+        fName.appendf("_index%d", indexRowInterval);
+    }
 }
 
 const char* BitmapRegionDecoderBench::onGetName() {
@@ -37,6 +41,10 @@ bool BitmapRegionDecoderBench::isSuitableFor(Backend backend) {
 
 void BitmapRegionDecoderBench::onDelayedSetup() {
     fBRD.reset(SkBitmapRegionDecoder::Create(fData, SkBitmapRegionDecoder::kAndroidCodec_Strategy));
+    if (fIndexRowInterval > 0) {
+        // Images that cannot be indexed are simply decoded as before.
+        fBRD->buildRegionIndex(fIndexRowInterval);
+    }
 }
 
 void BitmapRegionDecoderBench::onDraw(int n, SkCanvas* canvas) {
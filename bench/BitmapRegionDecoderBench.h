@@ -24,8 +24,9 @@
 class BitmapRegionDecoderBench : public Benchmark {
 public:
     // Calls encoded->ref()
+    // If indexRowInterval is positive, a region index is built before decoding.
     BitmapRegionDecoderBench(const char* basename, SkData* encoded, SkColorType colorType,
-            uint32_t sampleSize, const SkIRect& subset);
+            uint32_t sampleSize, const SkIRect& subset, int indexRowInterval = 0);
 
 protected:
     const char* onGetName() override;
@@ -40,6 +41,7 @@ private:
     const SkColorType                              fColorType;
     const uint32_t                                 fSampleSize;
     const SkIRect                                  fSubset;
+    const int                                      fIndexRowInterval;
     typedef Benchmark INHERITED;
 };
 #endif // BitmapRegionDecoderBench_DEFINED
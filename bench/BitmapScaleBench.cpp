@@ -159,3 +159,90 @@ DEF_BENCH( return new PixmapScalerBench(SkBitmapScaler::RESIZE_MITCHELL, "mitche
 DEF_BENCH( return new PixmapScalerBench(SkBitmapScaler::RESIZE_HAMMING,  "hamming");  )
 DEF_BENCH( return new PixmapScalerBench(SkBitmapScaler::RESIZE_TRIANGLE, "triangle"); )
 DEF_BENCH( return new PixmapScalerBench(SkBitmapScaler::RESIZE_BOX,      "box");      )
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SkExecutor.h"
+#include "SkResampler.h"
+
+// Compares SkResampler with SkBitmapScaler, and with itself split across threads.
+class ResamplerBench : public Benchmark {
+public:
+    enum class Scaler { kBitmapScaler, kResampler, kThreadedResampler };
+
+    ResamplerBench(Scaler scaler, SkColorType colorType, SkISize srcSize, SkISize dstSize)
+        : fScaler(scaler)
+        , fColorType(colorType)
+        , fSrcSize(srcSize)
+        , fDstSize(dstSize)
+    {
+        const char* scalerName = Scaler::kBitmapScaler == scaler ? "bitmapscaler" :
+                                 Scaler::kResampler    == scaler ? "resampler"
+                                                                 : "resampler_threaded";
+        const char* colorTypeName = kN32_SkColorType   == colorType ? "8888" :
+                                    kAlpha_8_SkColorType == colorType ? "A8" : "F16";
+        fName.printf("resize_%s_%s_%dx%d_%dx%d", scalerName, colorTypeName, srcSize.width(),
+                     srcSize.height(), dstSize.width(), dstSize.height());
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        const SkAlphaType alphaType = kAlpha_8_SkColorType == fColorType ? kPremul_SkAlphaType
+                                                                         : kOpaque_SkAlphaType;
+        fSrc.allocPixels(SkImageInfo::Make(fSrcSize.width(), fSrcSize.height(), fColorType,
+                                           alphaType));
+        fSrc.eraseColor(SK_ColorWHITE);
+        fDst.allocPixels(fSrc.info().makeWH(fDstSize.width(), fDstSize.height()));
+        if (Scaler::kThreadedResampler == fScaler) {
+            fExecutor = SkExecutor::MakeThreadPool();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPixmap src, dst;
+        fSrc.peekPixels(&src);
+        fDst.peekPixels(&dst);
+        for (int i = 0; i < loops; i++) {
+            if (Scaler::kBitmapScaler == fScaler) {
+                SkBitmapScaler::Resize(dst, src, SkBitmapScaler::RESIZE_MITCHELL);
+            } else {
+                SkResampler::Resize(dst, src, SkBitmapScaler::RESIZE_MITCHELL, fExecutor.get());
+            }
+        }
+    }
+
+private:
+    const Scaler                fScaler;
+    const SkColorType           fColorType;
+    const SkISize               fSrcSize, fDstSize;
+    SkString                    fName;
+    SkBitmap                    fSrc, fDst;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    typedef Benchmark INHERITED;
+};
+
+#define RESAMPLER_BENCHES(colorType, srcW, srcH, dstW, dstH)                                 \
+    DEF_BENCH(return new ResamplerBench(ResamplerBench::Scaler::kResampler, colorType,        \
+                                        { srcW, srcH }, { dstW, dstH });)                    \
+    DEF_BENCH(return new ResamplerBench(ResamplerBench::Scaler::kThreadedResampler, colorType,\
+                                        { srcW, srcH }, { dstW, dstH });)
+
+DEF_BENCH(return new ResamplerBench(ResamplerBench::Scaler::kBitmapScaler, kN32_SkColorType,
+                                    { 640, 480 }, { 300, 250 });)
+DEF_BENCH(return new ResamplerBench(ResamplerBench::Scaler::kBitmapScaler, kN32_SkColorType,
+                                    { 4000, 3000 }, { 1000, 750 });)
+RESAMPLER_BENCHES(kN32_SkColorType,      640,  480,  300, 250)
+RESAMPLER_BENCHES(kN32_SkColorType,     4000, 3000, 1000, 750)
+RESAMPLER_BENCHES(kAlpha_8_SkColorType, 4000, 3000, 1000, 750)
+RESAMPLER_BENCHES(kRGBA_F16_SkColorType, 4000, 3000, 1000, 750)
+
+#undef RESAMPLER_BENCHES
@@ -18,6 +18,7 @@
 #define REAL    1.5f
 #define BIG     SkIntToScalar(10)
 #define REALBIG 100.5f
+static const SkScalar kHuge = SkIntToScalar(250);
 
 static const char* gStyleName[] = {
     "normal",
@@ -45,6 +46,9 @@ public:
         } else {
             fName.printf("blur_%d_%s_%s", SkScalarRoundToInt(rad), name, quality);
         }
+        if (flags & SkBlurMaskFilter::kAllowDownsample_BlurFlag) {
+            fName.append("_downsample");
+        }
     }
 
 protected:
@@ -112,4 +116,15 @@ DEF_BENCH(return new BlurBench(REALBIG, kNormal_SkBlurStyle, SkBlurMaskFilter::k
 
 DEF_BENCH(return new BlurBench(REAL, kNormal_SkBlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag);)
 
+DEF_BENCH(return new BlurBench(kHuge, kNormal_SkBlurStyle);)
+DEF_BENCH(return new BlurBench(kHuge, kNormal_SkBlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag);)
+
+DEF_BENCH(return new BlurBench(REALBIG, kNormal_SkBlurStyle,
+                               SkBlurMaskFilter::kAllowDownsample_BlurFlag);)
+DEF_BENCH(return new BlurBench(kHuge, kNormal_SkBlurStyle,
+                               SkBlurMaskFilter::kAllowDownsample_BlurFlag);)
+DEF_BENCH(return new BlurBench(kHuge, kNormal_SkBlurStyle,
+                               SkBlurMaskFilter::kHighQuality_BlurFlag |
+                               SkBlurMaskFilter::kAllowDownsample_BlurFlag);)
+
 DEF_BENCH(return new BlurBench(0, kNormal_SkBlurStyle);)
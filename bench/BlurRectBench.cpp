@@ -19,6 +19,8 @@ static const SkScalar kMedium = SkIntToScalar(5);
 #define BIG     SkIntToScalar(10)
 static const SkScalar kMedBig = SkIntToScalar(20);
 #define REALBIG 30.5f
+static const SkScalar kLarge = SkIntToScalar(100);
+static const SkScalar kHuge = SkIntToScalar(300);
 
 class BlurRectBench: public Benchmark {
     int         fLoopCount;
@@ -128,7 +130,9 @@ private:
 
 class BlurRectBoxFilterBench: public BlurRectSeparableBench {
 public:
-    BlurRectBoxFilterBench(SkScalar rad) : INHERITED(rad) {
+    BlurRectBoxFilterBench(SkScalar rad, bool allowDownsample = false)
+        : INHERITED(rad)
+        , fAllowDownsample(allowDownsample) {
         SkString name;
 
         if (SkScalarFraction(rad) != 0) {
@@ -136,6 +140,9 @@ public:
         } else {
             name.printf("blurrect_boxfilter_%d", SkScalarRoundToInt(rad));
         }
+        if (allowDownsample) {
+            name.append("_downsample");
+        }
 
         this->setName(name);
     }
@@ -145,12 +152,15 @@ protected:
     void makeBlurryRect(const SkRect&) override {
         SkMask mask;
         if (!SkBlurMask::BoxBlur(&mask, fSrcMask, SkBlurMask::ConvertRadiusToSigma(this->radius()),
-                                 kNormal_SkBlurStyle, kHigh_SkBlurQuality)) {
+                                 kNormal_SkBlurStyle, kHigh_SkBlurQuality, nullptr, false,
+                                 fAllowDownsample)) {
             return;
         }
         SkMask::FreeImage(mask.fImage);
     }
 private:
+    bool fAllowDownsample;
+
     typedef BlurRectSeparableBench INHERITED;
 };
 
@@ -186,6 +196,10 @@ DEF_BENCH(return new BlurRectBoxFilterBench(SMALL);)
 DEF_BENCH(return new BlurRectBoxFilterBench(BIG);)
 DEF_BENCH(return new BlurRectBoxFilterBench(REALBIG);)
 DEF_BENCH(return new BlurRectBoxFilterBench(REAL);)
+DEF_BENCH(return new BlurRectBoxFilterBench(kLarge);)
+DEF_BENCH(return new BlurRectBoxFilterBench(kHuge);)
+DEF_BENCH(return new BlurRectBoxFilterBench(kLarge, true);)
+DEF_BENCH(return new BlurRectBoxFilterBench(kHuge, true);)
 DEF_BENCH(return new BlurRectGaussianBench(SMALL);)
 DEF_BENCH(return new BlurRectGaussianBench(BIG);)
 DEF_BENCH(return new BlurRectGaussianBench(REALBIG);)
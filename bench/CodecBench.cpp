@@ -16,14 +16,15 @@
 DEFINE_bool(zero_init, false, "Pretend our destination is zero-intialized, simulating Android?");
 
 CodecBench::CodecBench(SkString baseName, SkData* encoded, SkColorType colorType,
-        SkAlphaType alphaType)
+        SkAlphaType alphaType, SkExecutor* executor)
     : fColorType(colorType)
     , fAlphaType(alphaType)
+    , fExecutor(executor)
     , fData(SkRef(encoded))
 {
     // Parse filename and the color type to give the benchmark a useful name
-    fName.printf("Codec_%s_%s%s", baseName.c_str(), color_type_to_str(colorType),
-            alpha_type_to_str(alphaType));
+    fName.printf("Codec_%s_%s%s%s", baseName.c_str(), color_type_to_str(colorType),
+            alpha_type_to_str(alphaType), executor ? "_threaded" : "");
 #ifdef SK_DEBUG
     // Ensure that we can create an SkCodec from this data.
     std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(fData));
@@ -57,6 +58,7 @@ void CodecBench::onDraw(int n, SkCanvas* canvas) {
     if (FLAGS_zero_init) {
         options.fZeroInitialized = SkCodec::kYes_ZeroInitialized;
     }
+    options.fExecutor = fExecutor;
     for (int i = 0; i < n; i++) {
         colorCount = 256;
         codec.reset(SkCodec::NewFromData(fData));
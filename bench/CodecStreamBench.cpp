@@ -0,0 +1,75 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "Resources.h"
+#include "SkBitmap.h"
+#include "SkCodec.h"
+#include "SkData.h"
+#include "SkStream.h"
+
+/**
+ *  Measures decoding an image read from a file through an SkFILEStream, which the codec has
+ *  to copy out of, against decoding the same file mapped into memory, which the codec reads
+ *  in place.  The difference is the cost of copying the encoded bytes.
+ */
+class CodecStreamBench : public Benchmark {
+public:
+    CodecStreamBench(const char* filename, bool mapped)
+        : fFilename(filename)
+        , fMapped(mapped)
+    {
+        fName.printf("CodecStream_%s_%s", filename, mapped ? "mmap" : "file");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fPath = GetResourcePath(fFilename);
+        fData = SkData::MakeFromFileName(fPath.c_str());
+        std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(fData));
+        if (!codec) {
+            fData = nullptr;
+            return;
+        }
+
+        fInfo = codec->getInfo().makeColorType(kN32_SkColorType).makeColorSpace(nullptr);
+        fBitmap.allocPixels(fInfo);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fData) {
+            return;
+        }
+
+        for (int i = 0; i < loops; i++) {
+            SkStream* stream = fMapped ? static_cast<SkStream*>(new SkMemoryStream(fData))
+                                       : new SkFILEStream(fPath.c_str());
+            std::unique_ptr<SkCodec> codec(SkCodec::NewFromStream(stream));
+            SkAssertResult(SkCodec::kSuccess == codec->getPixels(fInfo, fBitmap.getPixels(),
+                                                                 fBitmap.rowBytes()));
+        }
+    }
+
+private:
+    const char*     fFilename;
+    const bool      fMapped;
+    SkString        fName;
+    SkString        fPath;
+    sk_sp<SkData>   fData;
+    SkImageInfo     fInfo;
+    SkBitmap        fBitmap;
+};
+
+DEF_BENCH(return new CodecStreamBench("mandrill_512_q075.jpg", false));
+DEF_BENCH(return new CodecStreamBench("mandrill_512_q075.jpg", true));
+DEF_BENCH(return new CodecStreamBench("mandrill_512.png", false));
+DEF_BENCH(return new CodecStreamBench("mandrill_512.png", true));
+DEF_BENCH(return new CodecStreamBench("test640x479.gif", false));
+DEF_BENCH(return new CodecStreamBench("test640x479.gif", true));
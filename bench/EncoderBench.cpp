@@ -9,7 +9,11 @@
 #include "Resources.h"
 #include "SkBitmap.h"
 #include "SkData.h"
+#include "SkExecutor.h"
 #include "SkImageEncoder.h"
+#include "SkPngEncoder.h"
+#include "SkStream.h"
+#include "SkWebpEncoder.h"
 
 #include "sk_tool_utils.h"
 
@@ -69,6 +73,99 @@ private:
     SkBitmap                   fBitmap;
 };
 
+static SkExecutor* png_encode_executor() {
+    static std::unique_ptr<SkExecutor> executor = SkExecutor::MakeThreadPool();
+    return executor.get();
+}
+
+// Encodes with an SkPngEncoder or SkWebpEncoder Options, and reports the throughput and
+// compression ratio of each setting alongside its time.
+template <typename Encoder>
+class OptionsEncodeBench : public Benchmark {
+public:
+    OptionsEncodeBench(const char* filename, const char* formatName, const char* settingName,
+                       const typename Encoder::Options& options)
+        : fFilename(filename)
+        , fOptions(options)
+        , fEncodedSize(0)
+    {
+        fName.printf("Encode_%s_%s_%s", filename, formatName, settingName);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onPreDraw(SkCanvas*) override {
+#ifdef SK_DEBUG
+        bool result =
+#endif
+        GetResourceAsBitmap(fFilename, &fBitmap);
+        SkASSERT(result);
+        SkAssertResult(fBitmap.peekPixels(&fPixmap));
+
+        SkDynamicMemoryWStream stream;
+        SkAssertResult(Encoder::Encode(&stream, fPixmap, fOptions));
+        fEncodedSize = stream.bytesWritten();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            SkNullWStream stream;
+            SkAssertResult(Encoder::Encode(&stream, fPixmap, fOptions));
+        }
+    }
+
+    void getMetrics(double ms, SkTArray<SkString>* keys, SkTArray<double>* values) override {
+        const double srcBytes = (double) fPixmap.getSafeSize();
+        keys->push_back(SkString("MB_per_s"));
+        values->push_back(srcBytes / (ms * 1000));
+        keys->push_back(SkString("compression_ratio"));
+        values->push_back(fEncodedSize ? srcBytes / fEncodedSize : 0);
+    }
+
+private:
+    const char*                            fFilename;
+    const typename Encoder::Options        fOptions;
+    size_t                                 fEncodedSize;
+    SkString                               fName;
+    SkBitmap                               fBitmap;
+    SkPixmap                               fPixmap;
+};
+
+class PngEncodeBench : public OptionsEncodeBench<SkPngEncoder> {
+public:
+    PngEncodeBench(const char* filename, const char* settingName,
+                   const SkPngEncoder::Options& options)
+        : OptionsEncodeBench(filename, "PNG", settingName, options) {}
+};
+
+class WebpEncodeBench : public OptionsEncodeBench<SkWebpEncoder> {
+public:
+    WebpEncodeBench(const char* filename, const char* settingName,
+                    const SkWebpEncoder::Options& options)
+        : OptionsEncodeBench(filename, "WEBP", settingName, options) {}
+};
+
+static SkPngEncoder::Options png_options(int filterFlags, int zlibLevel,
+                                         SkExecutor* executor = nullptr) {
+    SkPngEncoder::Options options;
+    options.fFilterFlags = filterFlags;
+    options.fZLibLevel = zlibLevel;
+    options.fExecutor = executor;
+    return options;
+}
+
+static SkWebpEncoder::Options webp_options(SkWebpEncoder::Compression compression, float quality,
+                                           int method, bool useThreads = false) {
+    SkWebpEncoder::Options options;
+    options.fCompression = compression;
+    options.fQuality = quality;
+    options.fMethod = method;
+    options.fUseThreads = useThreads;
+    return options;
+}
+
 
 // The Android Photos app uses a quality of 90 on JPEG encodes
 DEF_BENCH(return new EncodeBench("mandrill_512.png", SkEncodedImageFormat::kJPEG, 90));
@@ -78,6 +175,52 @@ DEF_BENCH(return new EncodeBench("color_wheel.jpg", SkEncodedImageFormat::kJPEG,
 DEF_BENCH(return new EncodeBench("mandrill_512.png", SkEncodedImageFormat::kPNG, 90));
 DEF_BENCH(return new EncodeBench("color_wheel.jpg", SkEncodedImageFormat::kPNG, 90));
 
+#define PNG_ENCODE_BENCHES(filename)                                                              \
+    DEF_BENCH(return new PngEncodeBench(filename, "default", SkPngEncoder::Options()));         \
+    DEF_BENCH(return new PngEncodeBench(filename, "none_zlib1",                                 \
+                                        png_options(SkPngEncoder::kNone_FilterFlag, 1)));        \
+    DEF_BENCH(return new PngEncodeBench(filename, "sub_zlib1",                                  \
+                                        png_options(SkPngEncoder::kSub_FilterFlag, 1)));         \
+    DEF_BENCH(return new PngEncodeBench(filename, "up_zlib6",                                   \
+                                        png_options(SkPngEncoder::kUp_FilterFlag, 6)));          \
+    DEF_BENCH(return new PngEncodeBench(filename, "all_zlib9",                                  \
+                                        png_options(SkPngEncoder::kAll_FilterFlag, 9)));         \
+    DEF_BENCH(return new PngEncodeBench(filename, "all_zlib6_threaded",                         \
+                                        png_options(SkPngEncoder::kAll_FilterFlag, 6,            \
+                                                    png_encode_executor())));                    \
+    DEF_BENCH(return new PngEncodeBench(filename, "sub_zlib1_threaded",                         \
+                                        png_options(SkPngEncoder::kSub_FilterFlag, 1,            \
+                                                    png_encode_executor())))
+
+PNG_ENCODE_BENCHES("mandrill_512.png");
+PNG_ENCODE_BENCHES("color_wheel.jpg");
+
 // TODO: What is the appropriate quality to use to benchmark WEBP encodes?
 DEF_BENCH(return new EncodeBench("mandrill_512.png", SkEncodedImageFormat::kWEBP, 90));
 DEF_BENCH(return new EncodeBench("color_wheel.jpg", SkEncodedImageFormat::kWEBP, 90));
+
+#define WEBP_ENCODE_BENCHES(filename)                                                             \
+    DEF_BENCH(return new WebpEncodeBench(filename, "lossy_q90_m4",                              \
+                                         webp_options(SkWebpEncoder::Compression::kLossy,        \
+                                                      90, 4)));                                  \
+    DEF_BENCH(return new WebpEncodeBench(filename, "lossy_q90_m0",                              \
+                                         webp_options(SkWebpEncoder::Compression::kLossy,        \
+                                                      90, 0)));                                  \
+    DEF_BENCH(return new WebpEncodeBench(filename, "lossy_q90_m6",                              \
+                                         webp_options(SkWebpEncoder::Compression::kLossy,        \
+                                                      90, 6)));                                  \
+    DEF_BENCH(return new WebpEncodeBench(filename, "lossy_q90_m4_threaded",                     \
+                                         webp_options(SkWebpEncoder::Compression::kLossy,        \
+                                                      90, 4, true)));                            \
+    DEF_BENCH(return new WebpEncodeBench(filename, "lossless_q0_m0",                            \
+                                         webp_options(SkWebpEncoder::Compression::kLossless,     \
+                                                      0, 0)));                                   \
+    DEF_BENCH(return new WebpEncodeBench(filename, "lossless_q75_m4",                           \
+                                         webp_options(SkWebpEncoder::Compression::kLossless,     \
+                                                      75, 4)));                                  \
+    DEF_BENCH(return new WebpEncodeBench(filename, "lossless_q75_m4_threaded",                  \
+                                         webp_options(SkWebpEncoder::Compression::kLossless,     \
+                                                      75, 4, true)))
+
+WEBP_ENCODE_BENCHES("mandrill_512.png");
+WEBP_ENCODE_BENCHES("color_wheel.jpg");
@@ -6,7 +6,9 @@
  */
 
 #include "Benchmark.h"
+#include "SkGraphics.h"
 #include "SkResourceCache.h"
+#include "SkTaskGroup.h"
 
 namespace {
 static void* gGlobalAddress;
@@ -72,6 +74,63 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Many threads hitting the global cache at once, each mostly finding recs it added earlier.
+class ImageCacheConcurrentBench : public Benchmark {
+    enum {
+        kThreads          = 16,
+        kKeysPerThread    = 256,
+        kLookupsPerThread = 2048,
+    };
+public:
+    explicit ImageCacheConcurrentBench(int shards) : fShards(shards) {
+        fName.printf("imagecache_concurrent_%dshards", shards);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onPreDraw(SkCanvas*) override {
+        fPrevShards = SkGraphics::SetResourceCacheShardCount(fShards);
+    }
+
+    void onPostDraw(SkCanvas*) override {
+        SkGraphics::SetResourceCacheShardCount(fPrevShards);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkTaskGroup().batch(kThreads, [](int thread) {
+                for (int j = 0; j < kLookupsPerThread; ++j) {
+                    // Every eighth lookup is for a key no thread has asked for before.
+                    intptr_t k = thread * kKeysPerThread + j % kKeysPerThread;
+                    if (0 == j % 8) {
+                        k = kThreads * kKeysPerThread + thread * kLookupsPerThread + j;
+                    }
+                    TestKey key(k);
+                    if (!SkResourceCache::Find(key, TestRec::Visitor, nullptr)) {
+                        SkResourceCache::Add(new TestRec(key, k));
+                    }
+                }
+            });
+        }
+    }
+
+private:
+    const int fShards;
+    int       fPrevShards = 1;
+    SkString  fName;
+
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ImageCacheBench(); )
+DEF_BENCH( return new ImageCacheConcurrentBench(1); )
+DEF_BENCH( return new ImageCacheConcurrentBench(8); )
@@ -7,23 +7,40 @@
 
 #include "Benchmark.h"
 #include "SkBitmap.h"
+#include "SkExecutor.h"
 #include "SkMipMap.h"
 
 class MipMapBench: public Benchmark {
+public:
+    enum Mode {
+        kSerial_Mode,       // Build every level on this thread.
+        kThreaded_Mode,     // Build every level, split into bands across a thread pool.
+        kLazyLevel0_Mode,   // BuildLazy(), then ask for just the first level.
+    };
+
+private:
     SkBitmap fBitmap;
     SkString fName;
     const int fW, fH;
     SkDestinationSurfaceColorMode fColorMode;
     bool fHalfFoat;
+    Mode fMode;
+    std::unique_ptr<SkExecutor> fExecutor;
 
 public:
-    MipMapBench(int w, int h, SkDestinationSurfaceColorMode colorMode, bool halfFloat = false)
-        : fW(w), fH(h), fColorMode(colorMode), fHalfFoat(halfFloat)
+    MipMapBench(int w, int h, SkDestinationSurfaceColorMode colorMode, bool halfFloat = false,
+                Mode mode = kSerial_Mode)
+        : fW(w), fH(h), fColorMode(colorMode), fHalfFoat(halfFloat), fMode(mode)
     {
         fName.printf("mipmap_build_%dx%d_%d_gamma", w, h, static_cast<int>(colorMode));
         if (halfFloat) {
             fName.append("_f16");
         }
+        switch (mode) {
+            case kSerial_Mode:                                     break;
+            case kThreaded_Mode:   fName.append("_threaded");     break;
+            case kLazyLevel0_Mode: fName.append("_lazy_level0");  break;
+        }
     }
 
 protected:
@@ -40,11 +57,27 @@ protected:
                                      : SkImageInfo::MakeS32(fW, fH, kPremul_SkAlphaType);
         fBitmap.allocPixels(info);
         fBitmap.eraseColor(SK_ColorWHITE);  // so we don't read uninitialized memory
+
+        if (kThreaded_Mode == fMode) {
+            fExecutor = SkExecutor::MakeWorkStealingPool();
+        }
     }
 
     void onDraw(int loops, SkCanvas*) override {
         for (int i = 0; i < loops * 4; i++) {
-            SkMipMap::Build(fBitmap, fColorMode, nullptr)->unref();
+            switch (fMode) {
+                case kSerial_Mode:
+                    SkMipMap::Build(fBitmap, fColorMode, nullptr)->unref();
+                    break;
+                case kThreaded_Mode:
+                    SkMipMap::Build(fBitmap, fColorMode, nullptr, fExecutor.get())->unref();
+                    break;
+                case kLazyLevel0_Mode: {
+                    sk_sp<SkMipMap> mipmap(SkMipMap::BuildLazy(fBitmap, fColorMode, nullptr));
+                    SkMipMap::Level level;
+                    mipmap->extractLevel(SkSize::Make(0.5f, 0.5f), &level);
+                } break;
+            }
         }
     }
 
@@ -71,3 +104,16 @@ DEF_BENCH( return new MipMapBench(2048, 2048,
 DEF_BENCH( return new MipMapBench(2047, 2047, SkDestinationSurfaceColorMode::kLegacy); )
 DEF_BENCH( return new MipMapBench(2047, 2047,
                                   SkDestinationSurfaceColorMode::kGammaAndColorSpaceAware); )
+
+// The same large builds spread across all cores, and built lazily up to just the first level.
+DEF_BENCH( return new MipMapBench(2048, 2048, SkDestinationSurfaceColorMode::kLegacy, false,
+                                  MipMapBench::kThreaded_Mode); )
+DEF_BENCH( return new MipMapBench(2048, 2048,
+                                  SkDestinationSurfaceColorMode::kGammaAndColorSpaceAware, false,
+                                  MipMapBench::kThreaded_Mode); )
+DEF_BENCH( return new MipMapBench(2047, 2047, SkDestinationSurfaceColorMode::kLegacy, false,
+                                  MipMapBench::kThreaded_Mode); )
+DEF_BENCH( return new MipMapBench(2048, 2048, SkDestinationSurfaceColorMode::kLegacy, true,
+                                  MipMapBench::kThreaded_Mode); )
+DEF_BENCH( return new MipMapBench(2048, 2048, SkDestinationSurfaceColorMode::kLegacy, false,
+                                  MipMapBench::kLazyLevel0_Mode); )
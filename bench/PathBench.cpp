@@ -6,30 +6,47 @@
  */
 
 #include "Benchmark.h"
+#include "SkArenaAlloc.h"
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
 #include "SkPaint.h"
 #include "SkPath.h"
+#include "SkPathPriv.h"
 #include "SkRandom.h"
+#include "SkScan.h"
 #include "SkShader.h"
 #include "SkString.h"
 #include "SkTArray.h"
 
 enum Flags {
     kStroke_Flag = 1 << 0,
-    kBig_Flag    = 1 << 1
+    kBig_Flag    = 1 << 1,
+    // Draw a non-volatile path, which raster backends may draw from its recorded coverage.
+    // Otherwise the path is volatile, so every draw scan converts it.
+    kRepeat_Flag = 1 << 2,
+    // Scan convert anti-aliased paths with delta AA, or with supersampling, rather than picking
+    // between analytic AA and supersampling by the path's complexity.
+    kDeltaAA_Flag       = 1 << 3,
+    kSupersampleAA_Flag = 1 << 4,
 };
 
 #define FLAGS00  Flags(0)
 #define FLAGS01  Flags(kStroke_Flag)
 #define FLAGS10  Flags(kBig_Flag)
 #define FLAGS11  Flags(kStroke_Flag | kBig_Flag)
+#define FLAGS_REPEAT00  Flags(kRepeat_Flag)
+#define FLAGS_REPEAT10  Flags(kRepeat_Flag | kBig_Flag)
+#define FLAGS_DAA00     Flags(kDeltaAA_Flag)
+#define FLAGS_DAA10     Flags(kDeltaAA_Flag | kBig_Flag)
+#define FLAGS_SSAA00    Flags(kSupersampleAA_Flag)
+#define FLAGS_SSAA10    Flags(kSupersampleAA_Flag | kBig_Flag)
 
 class PathBench : public Benchmark {
     SkPaint     fPaint;
     SkString    fName;
     Flags       fFlags;
+    bool        fUseAnalyticAA, fUseDeltaAA, fForceDeltaAA;
 public:
     PathBench(Flags flags) : fFlags(flags) {
         fPaint.setStyle(flags & kStroke_Flag ? SkPaint::kStroke_Style :
@@ -44,13 +61,36 @@ public:
 
 protected:
     const char* onGetName() override {
-        fName.printf("path_%s_%s_",
+        fName.printf("path_%s_%s_%s",
                      fFlags & kStroke_Flag ? "stroke" : "fill",
-                     fFlags & kBig_Flag ? "big" : "small");
+                     fFlags & kBig_Flag ? "big" : "small",
+                     fFlags & kRepeat_Flag ? "repeat_" : "");
         this->appendName(&fName);
+        if (fFlags & kDeltaAA_Flag) {
+            fName.append("_daa");
+        } else if (fFlags & kSupersampleAA_Flag) {
+            fName.append("_ssaa");
+        }
         return fName.c_str();
     }
 
+    void onPreDraw(SkCanvas*) override {
+        fUseAnalyticAA = gSkUseAnalyticAA;
+        fUseDeltaAA = gSkUseDeltaAA;
+        fForceDeltaAA = gSkForceDeltaAA;
+        if (fFlags & kDeltaAA_Flag) {
+            gSkUseDeltaAA = gSkForceDeltaAA = true;
+        } else if (fFlags & kSupersampleAA_Flag) {
+            gSkUseAnalyticAA = gSkUseDeltaAA = false;
+        }
+    }
+
+    void onPostDraw(SkCanvas*) override {
+        gSkUseAnalyticAA = fUseAnalyticAA;
+        gSkUseDeltaAA = fUseDeltaAA;
+        gSkForceDeltaAA = fForceDeltaAA;
+    }
+
     void onDraw(int loops, SkCanvas* canvas) override {
         SkPaint paint(fPaint);
         this->setupPaint(&paint);
@@ -61,6 +101,7 @@ protected:
             const SkMatrix m = SkMatrix::MakeScale(SkIntToScalar(10), SkIntToScalar(10));
             path.transform(m);
         }
+        path.setIsVolatile(!(fFlags & kRepeat_Flag));
 
         int count = loops;
         if (fFlags & kBig_Flag) {
@@ -555,6 +596,56 @@ private:
     typedef RandomPathBench INHERITED;
 };
 
+// Builds short, temporary paths, as recording does, and transforms each into another path.
+// Reports how many heap allocations each path needed: in an arena, only conic weights allocate.
+class ShortPathBench : public RandomPathBench {
+public:
+    ShortPathBench(bool inArena) : fInArena(inArena) {}
+
+protected:
+    const char* onGetName() override {
+        return fInArena ? "path_short_arena" : "path_short_heap";
+    }
+
+    void onDelayedSetup() override {
+        fMatrix.setScale(5 * SK_Scalar1, 6 * SK_Scalar1);
+        this->createData(2, 10);
+        fLoops = 0;
+        fAllocations = 0;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const int64_t allocations = SkPathPriv::ThreadHeapAllocationCount();
+        for (int i = 0; i < loops; ++i) {
+            char storage[2048];
+            SkArenaAlloc alloc(storage);
+            SkPath path, transformed;
+            if (fInArena) {
+                SkPathPriv::ResetInArena(&path, &alloc);
+                SkPathPriv::ResetInArena(&transformed, &alloc);
+            }
+            this->makePath(&path);
+            path.transform(fMatrix, &transformed);
+            transformed.close();
+        }
+        this->restartMakingPaths();
+        fLoops += loops;
+        fAllocations += SkPathPriv::ThreadHeapAllocationCount() - allocations;
+    }
+
+    void getMetrics(double ms, SkTArray<SkString>* keys, SkTArray<double>* values) override {
+        keys->push_back(SkString("allocations_per_path"));
+        values->push_back(fLoops ? (double)fAllocations / fLoops : 0);
+    }
+
+private:
+    SkMatrix fMatrix;
+    bool     fInArena;
+    int64_t  fLoops;
+    int64_t  fAllocations;
+    typedef RandomPathBench INHERITED;
+};
+
 class SkBench_AddPathTest : public RandomPathBench {
 public:
     enum AddType {
@@ -1153,6 +1244,16 @@ DEF_BENCH( return new AAAConcavePathBench(FLAGS10); )
 DEF_BENCH( return new AAAConvexPathBench(FLAGS00); )
 DEF_BENCH( return new AAAConvexPathBench(FLAGS10); )
 
+DEF_BENCH( return new TrianglePathBench(FLAGS_REPEAT00); )
+DEF_BENCH( return new TrianglePathBench(FLAGS_REPEAT10); )
+DEF_BENCH( return new OvalPathBench(FLAGS_REPEAT00); )
+DEF_BENCH( return new OvalPathBench(FLAGS_REPEAT10); )
+DEF_BENCH( return new CirclePathBench(FLAGS_REPEAT00); )
+DEF_BENCH( return new CirclePathBench(FLAGS_REPEAT10); )
+DEF_BENCH( return new NonAACirclePathBench(FLAGS_REPEAT10); )
+DEF_BENCH( return new AAAConcavePathBench(FLAGS_REPEAT10); )
+DEF_BENCH( return new SawToothPathBench(FLAGS_REPEAT00); )
+
 DEF_BENCH( return new SawToothPathBench(FLAGS00); )
 DEF_BENCH( return new SawToothPathBench(FLAGS01); )
 
@@ -1161,11 +1262,29 @@ DEF_BENCH( return new LongCurvedPathBench(FLAGS01); )
 DEF_BENCH( return new LongLinePathBench(FLAGS00); )
 DEF_BENCH( return new LongLinePathBench(FLAGS01); )
 
+// The same fills, with each scan converter.
+DEF_BENCH( return new CirclePathBench(FLAGS_DAA00); )
+DEF_BENCH( return new CirclePathBench(FLAGS_DAA10); )
+DEF_BENCH( return new CirclePathBench(FLAGS_SSAA00); )
+DEF_BENCH( return new CirclePathBench(FLAGS_SSAA10); )
+DEF_BENCH( return new AAAConcavePathBench(FLAGS_DAA00); )
+DEF_BENCH( return new AAAConcavePathBench(FLAGS_DAA10); )
+DEF_BENCH( return new AAAConcavePathBench(FLAGS_SSAA00); )
+DEF_BENCH( return new AAAConcavePathBench(FLAGS_SSAA10); )
+DEF_BENCH( return new SawToothPathBench(FLAGS_DAA00); )
+DEF_BENCH( return new SawToothPathBench(FLAGS_SSAA00); )
+DEF_BENCH( return new LongCurvedPathBench(FLAGS_DAA00); )
+DEF_BENCH( return new LongCurvedPathBench(FLAGS_SSAA00); )
+DEF_BENCH( return new LongLinePathBench(FLAGS_DAA00); )
+DEF_BENCH( return new LongLinePathBench(FLAGS_SSAA00); )
+
 DEF_BENCH( return new PathCreateBench(); )
 DEF_BENCH( return new PathCopyBench(); )
 DEF_BENCH( return new PathTransformBench(true); )
 DEF_BENCH( return new PathTransformBench(false); )
 DEF_BENCH( return new PathEqualityBench(); )
+DEF_BENCH( return new ShortPathBench(false); )
+DEF_BENCH( return new ShortPathBench(true); )
 
 DEF_BENCH( return new SkBench_AddPathTest(SkBench_AddPathTest::kAdd_AddType); )
 DEF_BENCH( return new SkBench_AddPathTest(SkBench_AddPathTest::kAddTrans_AddType); )
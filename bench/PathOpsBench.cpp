@@ -0,0 +1,120 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkTArray.h"
+
+// Unions many overlapping circles, with SkOpBuilder or one Op() at a time.  One at a time takes
+// seconds for a thousand circles, so only the builder unions that many.
+class PathOpsUnionBench : public Benchmark {
+public:
+    PathOpsUnionBench(int count, bool builder) : fCount(count), fBuilder(builder) {
+        fName.printf("pathops_union_%d_%s", count, builder ? "builder" : "serial");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        // Spread out, so that the circles form many clusters of a few circles each.
+        SkRandom rand;
+        const SkScalar size = 40 * SkScalarSqrt(SkIntToScalar(fCount));
+        for (int i = 0; i < fCount; ++i) {
+            SkPath& path = fPaths.push_back();
+            path.addCircle(rand.nextRangeScalar(0, size), rand.nextRangeScalar(0, size),
+                           rand.nextRangeScalar(5, 25),
+                           rand.nextBool() ? SkPath::kCW_Direction : SkPath::kCCW_Direction);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkPath result;
+            if (fBuilder) {
+                SkOpBuilder builder;
+                for (const SkPath& path : fPaths) {
+                    builder.add(path, kUnion_SkPathOp);
+                }
+                builder.resolve(&result);
+            } else {
+                result = fPaths[0];
+                for (int j = 1; j < fPaths.count(); ++j) {
+                    Op(result, fPaths[j], kUnion_SkPathOp, &result);
+                }
+            }
+        }
+    }
+
+private:
+    SkString         fName;
+    SkTArray<SkPath> fPaths;
+    int              fCount;
+    bool             fBuilder;
+    typedef Benchmark INHERITED;
+};
+
+// Adds a small rect to a large resolved path, with SkOpBuilder::resolveInto() or Op().
+class PathOpsAddBench : public Benchmark {
+public:
+    PathOpsAddBench(bool incremental) : fIncremental(incremental) {}
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fIncremental ? "pathops_add_incremental" : "pathops_add_full";
+    }
+
+    void onDelayedSetup() override {
+        SkOpBuilder builder;
+        for (int i = 0; i < 400; ++i) {
+            SkPath circle;
+            circle.addCircle(SkIntToScalar(20 + 40 * (i % 20)), SkIntToScalar(20 + 40 * (i / 20)),
+                             12);
+            builder.add(circle, kUnion_SkPathOp);
+        }
+        builder.resolve(&fBase);
+        fAdded.addRect(300, 300, 350, 320);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkPath result = fBase;
+            if (fIncremental) {
+                SkOpBuilder builder;
+                builder.add(fAdded, kUnion_SkPathOp);
+                builder.resolveInto(&result);
+            } else {
+                Op(result, fAdded, kUnion_SkPathOp, &result);
+            }
+        }
+    }
+
+private:
+    SkPath fBase;
+    SkPath fAdded;
+    bool   fIncremental;
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new PathOpsUnionBench(100, false); )
+DEF_BENCH( return new PathOpsUnionBench(100, true); )
+DEF_BENCH( return new PathOpsUnionBench(1000, true); )
+DEF_BENCH( return new PathOpsAddBench(false); )
+DEF_BENCH( return new PathOpsAddBench(true); )
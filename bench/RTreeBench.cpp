@@ -56,8 +56,11 @@ private:
 // Time how long it takes to perform queries on an R-Tree.
 class RTreeQueryBench : public Benchmark {
 public:
-    RTreeQueryBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_query", name);
+    // If incremental, the tree is built one insert() at a time rather than bulk-loaded.
+    RTreeQueryBench(const char* name, MakeRectProc proc, bool incremental = false)
+        : fProc(proc)
+        , fIncremental(incremental) {
+        fName.printf("rtree_%s_query%s", name, incremental ? "_incremental" : "");
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -73,7 +76,13 @@ protected:
         for (int i = 0; i < NUM_QUERY_RECTS; ++i) {
             rects[i] = fProc(rand, i, NUM_QUERY_RECTS);
         }
-        fTree.insert(rects.get(), NUM_QUERY_RECTS);
+        if (fIncremental) {
+            for (int i = 0; i < NUM_QUERY_RECTS; ++i) {
+                fTree.insert(i, rects[i]);
+            }
+        } else {
+            fTree.insert(rects.get(), NUM_QUERY_RECTS);
+        }
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
@@ -91,6 +100,75 @@ protected:
 private:
     SkRTree fTree;
     MakeRectProc fProc;
+    bool fIncremental;
+    SkString fName;
+    typedef Benchmark INHERITED;
+};
+
+// Time how long it takes to edit one entry of a bulk-loaded R-Tree, as a picture that changes a
+// little every frame would.  Compare with rtree_*_build, which rebuilds the whole thing.
+class RTreeUpdateBench : public Benchmark {
+public:
+    enum Edit {
+        kNudge_Edit,         // Move an entry by a pixel or two.
+        kMove_Edit,          // Move an entry anywhere.
+        kRemoveInsert_Edit,  // Remove an entry, then insert it again.
+    };
+
+    RTreeUpdateBench(const char* name, MakeRectProc proc, Edit edit)
+        : fProc(proc)
+        , fEdit(edit) {
+        static const char* kEditNames[] = { "nudge", "move", "remove_insert" };
+        fName.printf("rtree_%s_update_%s", name, kEditNames[edit]);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+    void onDelayedSetup() override {
+        SkRandom rand;
+        fRects.reset(NUM_BUILD_RECTS);
+        for (int i = 0; i < NUM_BUILD_RECTS; ++i) {
+            fRects[i] = fProc(rand, i, NUM_BUILD_RECTS);
+        }
+        fTree.insert(fRects.get(), NUM_BUILD_RECTS);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkRandom rand;
+        for (int i = 0; i < loops; ++i) {
+            int op = rand.nextULessThan(NUM_BUILD_RECTS);
+            switch (fEdit) {
+                case kNudge_Edit: {
+                    SkScalar dx = rand.nextSScalar1(),
+                             dy = rand.nextSScalar1();
+                    fRects[op].offset(dx, dy);
+                    fTree.update(op, fRects[op]);
+                    fRects[op].offset(-dx, -dy);  // Don't wander off over many loops.
+                    fTree.update(op, fRects[op]);
+                    break;
+                }
+                case kMove_Edit:
+                    fRects[op] = fProc(rand, op, NUM_BUILD_RECTS);
+                    fTree.update(op, fRects[op]);
+                    break;
+                case kRemoveInsert_Edit:
+                    fTree.remove(op);
+                    fTree.insert(op, fRects[op]);
+                    break;
+            }
+        }
+    }
+private:
+    SkRTree fTree;
+    SkAutoTMalloc<SkRect> fRects;
+    MakeRectProc fProc;
+    Edit fEdit;
     SkString fName;
     typedef Benchmark INHERITED;
 };
@@ -136,3 +214,15 @@ DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects));
 DEF_BENCH(return new RTreeQueryBench("YX", &make_YXordered_rects));
 DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects));
 DEF_BENCH(return new RTreeQueryBench("concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects, true));
+DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects, true));
+
+DEF_BENCH(return new RTreeUpdateBench("XY", &make_XYordered_rects,
+                                      RTreeUpdateBench::kNudge_Edit));
+DEF_BENCH(return new RTreeUpdateBench("random", &make_random_rects,
+                                      RTreeUpdateBench::kNudge_Edit));
+DEF_BENCH(return new RTreeUpdateBench("random", &make_random_rects,
+                                      RTreeUpdateBench::kMove_Edit));
+DEF_BENCH(return new RTreeUpdateBench("random", &make_random_rects,
+                                      RTreeUpdateBench::kRemoveInsert_Edit));
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SKPPipelineCacheBench.h"
+#include "SkRasterPipeline.h"
+
+SKPPipelineCacheBench::SKPPipelineCacheBench(const char* name, const SkPicture* pic,
+                                             const SkIRect& clip, bool useCache, bool doLooping)
+    : INHERITED(name, pic, clip, 1.0, false, doLooping)
+    , fUseCache(useCache) {
+    fUniqueName.printf("%s_%s", name, useCache ? "pipelinecache" : "nopipelinecache");
+}
+
+const char* SKPPipelineCacheBench::onGetUniqueName() {
+    return fUniqueName.c_str();
+}
+
+bool SKPPipelineCacheBench::isSuitableFor(Backend backend) {
+    return backend == kRaster_Backend;
+}
+
+void SKPPipelineCacheBench::onPerCanvasPreDraw(SkCanvas* canvas) {
+    INHERITED::onPerCanvasPreDraw(canvas);
+    // Start each run cold, so both variants pay for the first lookup of each pipeline.
+    SkRasterPipeline::PurgeProgramCache();
+    SkRasterPipeline::SetProgramCacheEnabled(fUseCache);
+}
+
+void SKPPipelineCacheBench::onPerCanvasPostDraw(SkCanvas* canvas) {
+    SkRasterPipeline::SetProgramCacheEnabled(true);
+    INHERITED::onPerCanvasPostDraw(canvas);
+}
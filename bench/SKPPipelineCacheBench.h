@@ -0,0 +1,39 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SKPPipelineCacheBench_DEFINED
+#define SKPPipelineCacheBench_DEFINED
+
+#include "SKPBench.h"
+
+/**
+ * Plays back an SkPicture like SKPBench, but with SkRasterPipeline's program cache forced on or
+ * off, so the two runs of each picture measure what the cache saves.  Only CPU configs use it.
+ */
+class SKPPipelineCacheBench : public SKPBench {
+public:
+    SKPPipelineCacheBench(const char* name, const SkPicture*, const SkIRect& devClip,
+                          bool useCache, bool doLooping);
+
+protected:
+    const char* onGetUniqueName() override;
+    bool isSuitableFor(Backend backend) override;
+    void onPerCanvasPreDraw(SkCanvas*) override;
+    void onPerCanvasPostDraw(SkCanvas*) override;
+
+    void drawMPDPicture() override {
+        SkFAIL("MPD not supported\n");
+    }
+
+private:
+    const bool fUseCache;
+    SkString   fUniqueName;
+
+    typedef SKPBench INHERITED;
+};
+
+#endif
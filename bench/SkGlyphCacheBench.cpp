@@ -112,7 +112,48 @@ private:
     SkString fName;
 };
 
+// Every thread draws with the same typeface and sizes, so they all want the same strikes.
+class SkGlyphCacheContention : public Benchmark {
+public:
+    explicit SkGlyphCacheContention(bool shared) : fShared(shared) { }
+
+protected:
+    const char* onGetName() override {
+        return fShared ? "SkGlyphCacheContention_shared" : "SkGlyphCacheContention_exclusive";
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        size_t oldCacheLimitSize = SkGraphics::GetFontCacheLimit();
+        SkGraphics::SetFontCacheLimit(32 * 1024 * 1024);
+        bool oldShared = SkGraphics::SetFontCacheShared(fShared);
+        sk_sp<SkTypeface> typeface = sk_tool_utils::create_portable_typeface(
+                "serif", SkFontStyle::FromOldStyle(SkTypeface::kItalic));
+
+        for (int work = 0; work < loops; work++) {
+            SkTaskGroup().batch(16, [&](int) {
+                SkPaint paint;
+                paint.setAntiAlias(true);
+                paint.setSubpixelText(true);
+                paint.setTypeface(typeface);
+                do_font_stuff(&paint);
+            });
+        }
+        SkGraphics::SetFontCacheShared(oldShared);
+        SkGraphics::SetFontCacheLimit(oldCacheLimitSize);
+    }
+
+private:
+    typedef Benchmark INHERITED;
+    const bool fShared;
+};
+
 DEF_BENCH( return new SkGlyphCacheBasic(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheBasic(32 * 1024 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(32 * 1024 * 1024); )
+DEF_BENCH( return new SkGlyphCacheContention(false); )
+DEF_BENCH( return new SkGlyphCacheContention(true); )
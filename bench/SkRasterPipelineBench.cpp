@@ -6,8 +6,13 @@
  */
 
 #include "Benchmark.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkColorSpace.h"
 #include "SkOpts.h"
 #include "SkRasterPipeline.h"
+#include "SkTemplates.h"
+#include "SkUtils.h"
 
 static const int N = 15;
 
@@ -90,3 +95,109 @@ public:
     }
 };
 DEF_BENCH( return (new SkRasterPipelineLegacyBench); )
+
+// Runs a srcover pipeline over a 512x512 rectangle, either one run() per row (which builds the
+// program from the stages again for every row), or once through run_2d().
+template <bool k2D>
+class SkRasterPipelineRectBench : public Benchmark {
+public:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override {
+        return k2D ? "SkRasterPipeline_rect_2d" : "SkRasterPipeline_rect_1d";
+    }
+
+    void onDelayedSetup() override {
+        fSrc.reset(kDim*kDim);
+        fDst.reset(kDim*kDim);
+        sk_memset32(fSrc.get(), 0x80402010, kDim*kDim);
+        sk_memset32(fDst.get(), 0xff204080, kDim*kDim);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        void* src_ctx = nullptr;
+        void* dst_ctx = nullptr;
+
+        SkRasterPipeline p;
+        p.append(SkRasterPipeline::load_8888, &dst_ctx);
+        p.append(SkRasterPipeline::move_src_dst);
+        p.append(SkRasterPipeline::load_8888, &src_ctx);
+        p.append(SkRasterPipeline::srcover);
+        p.append(SkRasterPipeline::store_8888, &dst_ctx);
+
+        auto setRow = [&](size_t y) {
+            src_ctx = fSrc.get() + y*kDim;
+            dst_ctx = fDst.get() + y*kDim;
+        };
+
+        while (loops --> 0) {
+            if (k2D) {
+                p.run_2d(0,0, kDim,kDim, setRow);
+            } else {
+                for (int y = 0; y < kDim; y++) {
+                    setRow(y);
+                    p.run(0,kDim);
+                }
+            }
+        }
+    }
+
+private:
+    static const int kDim = 512;
+    SkAutoTMalloc<uint32_t> fSrc, fDst;
+};
+DEF_BENCH( return (new SkRasterPipelineRectBench< true>); )
+DEF_BENCH( return (new SkRasterPipelineRectBench<false>); )
+
+// Large rect fills into an F16 destination, which always go through SkRasterPipelineBlitter.
+class SkRasterPipelineBlitRectBench : public Benchmark {
+public:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return "SkRasterPipeline_blitRect_f16"; }
+
+    void onDelayedSetup() override {
+        fBitmap.allocPixels(SkImageInfo::Make(kDim, kDim, kRGBA_F16_SkColorType,
+                                              kPremul_SkAlphaType,
+                                              SkColorSpace::MakeSRGBLinear()));
+        fBitmap.eraseColor(SK_ColorWHITE);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas canvas(fBitmap);
+        SkPaint paint;
+        paint.setColor(0x80FF8040);
+        const SkRect rect = SkRect::MakeWH(kDim, kDim);
+        while (loops --> 0) {
+            canvas.drawRect(rect, paint);
+        }
+    }
+
+private:
+    static const int kDim = 1024;
+    SkBitmap fBitmap;
+};
+DEF_BENCH( return (new SkRasterPipelineBlitRectBench); )
+
+// Converting sRGB 8888 to linear F16 pixels uses a pipeline over the whole image.
+class SkRasterPipelineConvertPixelsBench : public Benchmark {
+public:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return "SkRasterPipeline_convert_8888_to_f16"; }
+
+    void onDelayedSetup() override {
+        fSrc.allocPixels(SkImageInfo::MakeS32(kDim, kDim, kPremul_SkAlphaType));
+        fSrc.eraseColor(0x80402010);
+        fDst.allocPixels(SkImageInfo::Make(kDim, kDim, kRGBA_F16_SkColorType,
+                                           kPremul_SkAlphaType, SkColorSpace::MakeSRGBLinear()));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops --> 0) {
+            fSrc.readPixels(fDst.info(), fDst.getPixels(), fDst.rowBytes(), 0, 0);
+        }
+    }
+
+private:
+    static const int kDim = 1024;
+    SkBitmap fSrc, fDst;
+};
+DEF_BENCH( return (new SkRasterPipelineConvertPixelsBench); )
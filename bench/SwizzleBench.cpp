@@ -8,32 +8,40 @@
 #include "Benchmark.h"
 #include "SkOpts.h"
 
+template <typename Dst>
 class SwizzleBench : public Benchmark {
 public:
-    SwizzleBench(const char* name, SkOpts::Swizzle_8888 fn) : fName(name), fFn(fn) {}
+    SwizzleBench(const char* name, void (*fn)(Dst*, const void*, int)) : fName(name), fFn(fn) {}
 
     bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
     const char* onGetName() override { return fName; }
     void onDraw(int loops, SkCanvas*) override {
         static const int K = 1023; // Arbitrary, but nice to be a non-power-of-two to trip up SIMD.
-        uint32_t dst[K], src[K];
+        // Big enough for the widest source and destination pixels, 16-bit RGBA and F16.
+        uint64_t src[K];
+        Dst dst[K];
         while (loops --> 0) {
             fFn(dst, src, K);
         }
     }
 private:
     const char* fName;
-    SkOpts::Swizzle_8888 fFn;
+    void (*fFn)(Dst*, const void*, int);
 };
 
-
-DEF_BENCH(return new SwizzleBench("SkOpts::RGBA_to_rgbA", SkOpts::RGBA_to_rgbA));
-DEF_BENCH(return new SwizzleBench("SkOpts::RGBA_to_bgrA", SkOpts::RGBA_to_bgrA));
-DEF_BENCH(return new SwizzleBench("SkOpts::RGBA_to_BGRA", SkOpts::RGBA_to_BGRA));
-DEF_BENCH(return new SwizzleBench("SkOpts::RGB_to_RGB1",  SkOpts::RGB_to_RGB1));
-DEF_BENCH(return new SwizzleBench("SkOpts::RGB_to_BGR1",  SkOpts::RGB_to_BGR1));
-DEF_BENCH(return new SwizzleBench("SkOpts::gray_to_RGB1", SkOpts::gray_to_RGB1));
-DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_RGBA", SkOpts::grayA_to_RGBA));
-DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_rgbA", SkOpts::grayA_to_rgbA));
-DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_RGB1", SkOpts::inverted_CMYK_to_RGB1));
-DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_BGR1", SkOpts::inverted_CMYK_to_BGR1));
+DEF_BENCH(return new SwizzleBench<uint32_t>("SkOpts::RGBA_to_rgbA", SkOpts::RGBA_to_rgbA));
+DEF_BENCH(return new SwizzleBench<uint32_t>("SkOpts::RGBA_to_bgrA", SkOpts::RGBA_to_bgrA));
+DEF_BENCH(return new SwizzleBench<uint32_t>("SkOpts::RGBA_to_BGRA", SkOpts::RGBA_to_BGRA));
+DEF_BENCH(return new SwizzleBench<uint32_t>("SkOpts::RGB_to_RGB1",  SkOpts::RGB_to_RGB1));
+DEF_BENCH(return new SwizzleBench<uint32_t>("SkOpts::RGB_to_BGR1",  SkOpts::RGB_to_BGR1));
+DEF_BENCH(return new SwizzleBench<uint32_t>("SkOpts::gray_to_RGB1", SkOpts::gray_to_RGB1));
+DEF_BENCH(return new SwizzleBench<uint32_t>("SkOpts::grayA_to_RGBA", SkOpts::grayA_to_RGBA));
+DEF_BENCH(return new SwizzleBench<uint32_t>("SkOpts::grayA_to_rgbA", SkOpts::grayA_to_rgbA));
+DEF_BENCH(return new SwizzleBench<uint32_t>("SkOpts::inverted_CMYK_to_RGB1", SkOpts::inverted_CMYK_to_RGB1));
+DEF_BENCH(return new SwizzleBench<uint32_t>("SkOpts::inverted_CMYK_to_BGR1", SkOpts::inverted_CMYK_to_BGR1));
+DEF_BENCH(return new SwizzleBench<uint32_t>("SkOpts::RGBA16_to_rgbA", SkOpts::RGBA16_to_rgbA));
+DEF_BENCH(return new SwizzleBench<uint32_t>("SkOpts::RGBA16_to_bgrA", SkOpts::RGBA16_to_bgrA));
+DEF_BENCH(return new SwizzleBench<uint64_t>("SkOpts::RGB16_to_F16", SkOpts::RGB16_to_F16));
+DEF_BENCH(return new SwizzleBench<uint64_t>("SkOpts::RGBA16_to_F16", SkOpts::RGBA16_to_F16));
+DEF_BENCH(return new SwizzleBench<uint64_t>("SkOpts::RGBA16_to_F16_premul",
+                                            SkOpts::RGBA16_to_F16_premul));
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkString.h"
+#include "SkTaskGroup.h"
+#include "SkTemplates.h"
+
+// Does a trivial amount of work per index over N indices, so that what we measure is mostly
+// the cost of handing the work out: one task per index with batch(), or one task per chunk
+// of grain indices with parallel_for() and parallel_reduce().
+// Runs on SkExecutor::GetDefault(), so use --threads to pick how many threads to spread over.
+class TaskGroupBench : public Benchmark {
+public:
+    enum Mode { kBatch_Mode, kParallelFor_Mode, kParallelReduce_Mode };
+
+    TaskGroupBench(Mode mode, int grain) : fMode(mode), fGrain(grain) {
+        switch (mode) {
+            case kBatch_Mode:          fName.set("taskgroup_batch");                         break;
+            case kParallelFor_Mode:    fName.printf("taskgroup_parallel_for_%d", grain);     break;
+            case kParallelReduce_Mode: fName.printf("taskgroup_parallel_reduce_%d", grain);  break;
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fData.reset(kN);
+        for (int i = 0; i < kN; i++) {
+            fData[i] = (float)i;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        float* data = fData.get();
+        for (int loop = 0; loop < loops; loop++) {
+            SkTaskGroup tg;
+            switch (fMode) {
+                case kBatch_Mode:
+                    tg.batch(kN, [data](int i) { data[i] = data[i] * 0.5f + 1.0f; });
+                    tg.wait();
+                    break;
+                case kParallelFor_Mode:
+                    tg.parallel_for(kN, fGrain, [data](int start, int end) {
+                        for (int i = start; i < end; i++) {
+                            data[i] = data[i] * 0.5f + 1.0f;
+                        }
+                    });
+                    tg.wait();
+                    break;
+                case kParallelReduce_Mode: {
+                    float sum = tg.parallel_reduce(kN, fGrain, 0.0f,
+                                                   [data](int start, int end) {
+                                                       float partial = 0;
+                                                       for (int i = start; i < end; i++) {
+                                                           partial += data[i];
+                                                       }
+                                                       return partial;
+                                                   },
+                                                   [](float a, float b) { return a + b; });
+                    volatile float blackhole = sum;
+                    sk_ignore_unused_variable(blackhole);
+                } break;
+            }
+        }
+    }
+
+private:
+    static constexpr int kN = 1 << 16;
+
+    Mode                   fMode;
+    int                    fGrain;
+    SkString               fName;
+    SkAutoTMalloc<float>   fData;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::kBatch_Mode,             1); )
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::kParallelFor_Mode,      64); )
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::kParallelFor_Mode,    1024); )
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::kParallelFor_Mode,   16384); )
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::kParallelReduce_Mode, 1024); )
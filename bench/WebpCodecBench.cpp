@@ -0,0 +1,86 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "Resources.h"
+#include "SkBitmap.h"
+#include "SkCodec.h"
+#include "SkData.h"
+
+/**
+ *  Measures WebP decodes with and without libwebp's decoding thread (SkCodec::Options::
+ *  fUseThreads), and through the incremental decoder, which should cost the same as getPixels.
+ */
+class WebpCodecBench : public Benchmark {
+public:
+    enum Mode {
+        kGetPixels_Mode,
+        kThreaded_Mode,
+        kIncremental_Mode,
+    };
+
+    WebpCodecBench(const char* filename, Mode mode)
+        : fFilename(filename)
+        , fMode(mode)
+    {
+        static const char* kModeNames[] = { "getPixels", "threaded", "incremental" };
+        fName.printf("WebpCodec_%s_%s", filename, kModeNames[mode]);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fData = GetResourceAsData(fFilename);
+        std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(fData));
+        if (!codec) {
+            fData = nullptr;
+            return;
+        }
+
+        fInfo = codec->getInfo().makeColorType(kN32_SkColorType).makeColorSpace(nullptr);
+        fBitmap.allocPixels(fInfo);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fData) {
+            return;
+        }
+
+        SkCodec::Options options;
+        options.fUseThreads = kThreaded_Mode == fMode;
+        for (int i = 0; i < loops; i++) {
+            std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(fData));
+            if (kIncremental_Mode == fMode) {
+                SkAssertResult(SkCodec::kSuccess == codec->startIncrementalDecode(fInfo,
+                        fBitmap.getPixels(), fBitmap.rowBytes(), &options));
+                SkAssertResult(SkCodec::kSuccess == codec->incrementalDecode());
+            } else {
+                SkAssertResult(SkCodec::kSuccess == codec->getPixels(fInfo, fBitmap.getPixels(),
+                        fBitmap.rowBytes(), &options, nullptr, nullptr));
+            }
+        }
+    }
+
+private:
+    const char*     fFilename;
+    const Mode      fMode;
+    SkString        fName;
+    sk_sp<SkData>   fData;
+    SkImageInfo     fInfo;
+    SkBitmap        fBitmap;
+};
+
+#define WEBP_CODEC_BENCHES(filename)                                                   \
+    DEF_BENCH(return new WebpCodecBench(filename, WebpCodecBench::kGetPixels_Mode));   \
+    DEF_BENCH(return new WebpCodecBench(filename, WebpCodecBench::kThreaded_Mode));    \
+    DEF_BENCH(return new WebpCodecBench(filename, WebpCodecBench::kIncremental_Mode))
+
+WEBP_CODEC_BENCHES("yellow_rose.webp");
+WEBP_CODEC_BENCHES("baby_tux.webp");
+WEBP_CODEC_BENCHES("randPixels.webp");
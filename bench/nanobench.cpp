@@ -22,6 +22,7 @@
 #include "RecordingBench.h"
 #include "SKPAnimationBench.h"
 #include "SKPBench.h"
+#include "SKPPipelineCacheBench.h"
 #include "Stats.h"
 #include "ios_utils.h"
 
@@ -40,6 +41,7 @@
 #include "SkOSFile.h"
 #include "SkOSPath.h"
 #include "SkPictureRecorder.h"
+#include "SkRasterPipeline.h"
 #include "SkSVGDOM.h"
 #include "SkScan.h"
 #include "SkString.h"
@@ -115,6 +117,8 @@ DEFINE_bool(bbh, true, "Build a BBH for SKPs?");
 DEFINE_bool(lite, false, "Use SkLiteRecorder in recording benchmarks?");
 DEFINE_bool(mpd, true, "Use MultiPictureDraw for the SKPs?");
 DEFINE_bool(loopSKP, true, "Loop SKPs like we do for micro benches?");
+DEFINE_bool(pipelineCache, false, "Also play back SKPs with SkRasterPipeline's program cache "
+                                  "on and off?");
 DEFINE_int32(flushEvery, 10, "Flush --outResultsFile every Nth run.");
 DEFINE_bool(resetGpuContext, true, "Reset the GrContext before running each test.");
 DEFINE_bool(gpuStats, false, "Print GPU stats after each gpu benchmark?");
@@ -140,9 +144,33 @@ static SkString humanize(double ms) {
 }
 #define HUMANIZE(ms) humanize(ms).c_str()
 
+DEFINE_int32(rasterTiles, 16, "How many tiles the threaded config splits each surface into.");
+DEFINE_int32(rasterThreads, 0, "Threads rasterizing tiles for the threaded config, 0 -> num cores.");
+
+static SkExecutor* threaded_raster_executor() {
+    static std::unique_ptr<SkExecutor> executor = SkExecutor::MakeThreadPool(FLAGS_rasterThreads);
+    return executor.get();
+}
+
+DEFINE_int32(brdIndexRows, 0, "If >0, BRD benches first build a region index with restart points "
+                              "this many rows apart.");
+
+DEFINE_int32(codecThreads, 0, "Threads decoding bands of rows for the threaded JPEG codec benches, "
+                              "0 -> num cores.");
+
+static SkExecutor* threaded_codec_executor() {
+    static std::unique_ptr<SkExecutor> executor = SkExecutor::MakeThreadPool(FLAGS_codecThreads);
+    return executor.get();
+}
+
 bool Target::init(SkImageInfo info, Benchmark* bench) {
     if (Benchmark::kRaster_Backend == config.backend) {
-        this->surface = SkSurface::MakeRaster(info);
+        if (config.name.equals("threaded")) {
+            this->surface = SkSurface::MakeRasterThreaded(info, FLAGS_rasterTiles,
+                                                          threaded_raster_executor());
+        } else {
+            this->surface = SkSurface::MakeRaster(info);
+        }
         if (!this->surface) {
             return false;
         }
@@ -466,6 +494,8 @@ static void create_config(const SkCommandLineConfig* config, SkTArray<Config>* c
         auto srgbLinearColorSpace = SkColorSpace::MakeSRGBLinear();
         CPU_CONFIG(f16,  kRaster_Backend,
                    kRGBA_F16_SkColorType, kPremul_SkAlphaType, srgbLinearColorSpace)
+        CPU_CONFIG(threaded, kRaster_Backend,
+                   kN32_SkColorType, kPremul_SkAlphaType, nullptr)
     }
 
     #undef CPU_CONFIG
@@ -579,6 +609,7 @@ public:
                       , fCurrentSVG(0)
                       , fCurrentUseMPD(0)
                       , fCurrentCodec(0)
+                      , fCurrentThreadedCodec(0)
                       , fCurrentAndroidCodec(0)
                       , fCurrentBRDImage(0)
                       , fCurrentColorImage(0)
@@ -586,7 +617,9 @@ public:
                       , fCurrentAlphaType(0)
                       , fCurrentSubsetType(0)
                       , fCurrentSampleSize(0)
-                      , fCurrentAnimSKP(0) {
+                      , fCurrentAnimSKP(0)
+                      , fCurrentPipelineCacheSKP(0)
+                      , fCurrentUsePipelineCache(0) {
         collect_files(FLAGS_skps, ".skp", &fSKPs);
         collect_files(FLAGS_svgs, ".svg", &fSVGs);
 
@@ -798,6 +831,30 @@ public:
             }
         }
 
+        // And once more with and without SkRasterPipeline's program cache.
+        if (FLAGS_pipelineCache) {
+            while (fCurrentPipelineCacheSKP < fSKPs.count()) {
+                const SkString& path = fSKPs[fCurrentPipelineCacheSKP];
+                sk_sp<SkPicture> pic = ReadPicture(path.c_str());
+                if (!pic) {
+                    fCurrentPipelineCacheSKP++;
+                    continue;
+                }
+
+                const bool useCache = 0 == fCurrentUsePipelineCache++;
+                if (2 == fCurrentUsePipelineCache) {
+                    fCurrentUsePipelineCache = 0;
+                    fCurrentPipelineCacheSKP++;
+                }
+                SkString name = SkOSPath::Basename(path.c_str());
+                fSourceType = "skp";
+                fBenchType  = "pipeline_cache";
+                fPipelineCacheStats = SkRasterPipeline::GetProgramCacheStats();
+                return new SKPPipelineCacheBench(name.c_str(), pic.get(), fClip, useCache,
+                                                 FLAGS_loopSKP);
+            }
+        }
+
         for (; fCurrentCodec < fImages.count(); fCurrentCodec++) {
             fSourceType = "image";
             fBenchType = "skcodec";
@@ -879,6 +936,25 @@ public:
             fCurrentColorType = 0;
         }
 
+        // Run CodecBenches that decode JPEGs in bands of rows on several threads.
+        for (; fCurrentThreadedCodec < fImages.count(); fCurrentThreadedCodec++) {
+            fSourceType = "image";
+            fBenchType = "skcodec_threaded";
+            const SkString& path = fImages[fCurrentThreadedCodec];
+            if (SkCommandLineFlags::ShouldSkip(FLAGS_match, path.c_str())) {
+                continue;
+            }
+            sk_sp<SkData> encoded(SkData::MakeFromFileName(path.c_str()));
+            std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(encoded));
+            if (!codec || SkEncodedImageFormat::kJPEG != codec->getEncodedFormat()) {
+                continue;
+            }
+            fCurrentThreadedCodec++;
+            return new CodecBench(SkOSPath::Basename(path.c_str()), encoded.get(),
+                                  kN32_SkColorType, codec->getInfo().alphaType(),
+                                  threaded_codec_executor());
+        }
+
         // Run AndroidCodecBenches
         const int sampleSizes[] = { 2, 4, 8 };
         for (; fCurrentAndroidCodec < fImages.count(); fCurrentAndroidCodec++) {
@@ -984,7 +1060,7 @@ public:
                         }
 
                         return new BitmapRegionDecoderBench(basename.c_str(), encoded.get(),
-                                colorType, sampleSize, subset);
+                                colorType, sampleSize, subset, FLAGS_brdIndexRows);
                     }
                     fCurrentSubsetType = 0;
                     fCurrentSampleSize++;
@@ -1015,7 +1091,12 @@ public:
     void fillCurrentOptions(ResultsWriter* log) const {
         log->configOption("source_type", fSourceType);
         log->configOption("bench_type",  fBenchType);
-        if (0 == strcmp(fSourceType, "skp")) {
+        if (0 == strcmp(fBenchType, "pipeline_cache")) {
+            // Hits and misses over the whole run, warmup included.
+            SkRasterPipeline::ProgramCacheStats stats = SkRasterPipeline::GetProgramCacheStats();
+            log->metric("pipeline_cache_hits",   stats.hits   - fPipelineCacheStats.hits);
+            log->metric("pipeline_cache_misses", stats.misses - fPipelineCacheStats.misses);
+        } else if (0 == strcmp(fSourceType, "skp")) {
             log->configOption("clip",
                     SkStringPrintf("%d %d %d %d", fClip.fLeft, fClip.fTop,
                                                   fClip.fRight, fClip.fBottom).c_str());
@@ -1059,6 +1140,7 @@ private:
     double             fZoomPeriodMs;
 
     double fSKPBytes, fSKPOps;
+    SkRasterPipeline::ProgramCacheStats fPipelineCacheStats;
 
     const char* fSourceType;  // What we're benching: bench, GM, SKP, ...
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
@@ -1069,6 +1151,7 @@ private:
     int fCurrentSVG;
     int fCurrentUseMPD;
     int fCurrentCodec;
+    int fCurrentThreadedCodec;
     int fCurrentAndroidCodec;
     int fCurrentBRDImage;
     int fCurrentColorImage;
@@ -1077,6 +1160,8 @@ private:
     int fCurrentSubsetType;
     int fCurrentSampleSize;
     int fCurrentAnimSKP;
+    int fCurrentPipelineCacheSKP;
+    int fCurrentUsePipelineCache;
 };
 
 // Some runs (mostly, Valgrind) are so slow that the bot framework thinks we've hung.
@@ -1197,6 +1282,14 @@ int main(int argc, char** argv) {
         gSkForceAnalyticAA = true;
     }
 
+    gSkUseDeltaAA = FLAGS_deltaAA;
+
+    if (FLAGS_forceDeltaAA) {
+        gSkForceDeltaAA = true;
+    }
+
+    gSkUseBandedFill = FLAGS_bandedFill;
+
     int runs = 0;
     BenchmarkStream benchStream;
     while (Benchmark* b = benchStream.next()) {
@@ -1287,6 +1380,15 @@ int main(int argc, char** argv) {
             target->fillOptions(log.get());
             log->metric("min_ms",    stats.min);
             log->metrics("samples",    samples);
+            SkTArray<SkString> metricKeys;
+            SkTArray<double> metricValues;
+            bench->getMetrics(stats.min, &metricKeys, &metricValues);
+            SkASSERT(metricKeys.count() == metricValues.count());
+            SkString metricSummary;
+            for (int m = 0; m < metricKeys.count(); m++) {
+                log->metric(metricKeys[m].c_str(), metricValues[m]);
+                metricSummary.appendf("\t%s %.2f", metricKeys[m].c_str(), metricValues[m]);
+            }
 #if SK_SUPPORT_GPU
             if (gpuStatsDump) {
                 // dump to json, only SKPBench currently returns valid keys / values
@@ -1316,11 +1418,12 @@ int main(int argc, char** argv) {
                 if (stddev_percent >  5) mark = "?";
                 if (stddev_percent > 10) mark = "!";
 
-                SkDebugf("%10.2f %s\t%s\t%s\n",
-                         stats.median*1e3, mark, bench->getUniqueName(), config);
+                SkDebugf("%10.2f %s\t%s\t%s%s\n",
+                         stats.median*1e3, mark, bench->getUniqueName(), config,
+                         metricSummary.c_str());
             } else {
                 const double stddev_percent = 100 * sqrt(stats.var) / stats.mean;
-                SkDebugf("%4d/%-4dMB\t%d\t%s\t%s\t%s\t%s\t%.0f%%\t%s\t%s\t%s\n"
+                SkDebugf("%4d/%-4dMB\t%d\t%s\t%s\t%s\t%s\t%.0f%%\t%s\t%s\t%s%s\n"
                         , sk_tools::getCurrResidentSetSizeMB()
                         , sk_tools::getMaxResidentSetSizeMB()
                         , loops
@@ -1332,6 +1435,7 @@ int main(int argc, char** argv) {
                         , FLAGS_ms ? to_string(samples.count()).c_str() : stats.plot.c_str()
                         , config
                         , bench->getUniqueName()
+                        , metricSummary.c_str()
                         );
             }
 
@@ -873,6 +873,7 @@ static Sink* create_sink(const GrContextOptions& grCtxOptions, const SkCommandLi
         SINK("8888",    RasterSink, kN32_SkColorType);
         SINK("srgb",    RasterSink, kN32_SkColorType, srgbColorSpace);
         SINK("f16",     RasterSink, kRGBA_F16_SkColorType, srgbLinearColorSpace);
+        SINK("threaded", ThreadedSink, kN32_SkColorType);
         SINK("pdf",     PDFSink);
         SINK("skp",     SKPSink);
         SINK("pipe",    PipeSink);
@@ -1329,6 +1330,14 @@ int main(int argc, char** argv) {
         gSkForceAnalyticAA = true;
     }
 
+    gSkUseDeltaAA = FLAGS_deltaAA;
+
+    if (FLAGS_forceDeltaAA) {
+        gSkForceDeltaAA = true;
+    }
+
+    gSkUseBandedFill = FLAGS_bandedFill;
+
     if (FLAGS_verbose) {
         gVLog = stderr;
     } else if (!FLAGS_writePath.isEmpty()) {
@@ -39,6 +39,7 @@
 #include "SkRecorder.h"
 #include "SkSVGCanvas.h"
 #include "SkStream.h"
+#include "SkSurface.h"
 #include "SkSwizzler.h"
 #include "SkTLogic.h"
 #include <cmath>
@@ -1455,6 +1456,38 @@ Error RasterSink::draw(const Src& src, SkBitmap* dst, SkWStream*, SkString*) con
     return src.draw(&canvas);
 }
 
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+DEFINE_int32(rasterTiles, 16, "How many tiles the threaded config splits each surface into.");
+
+ThreadedSink::ThreadedSink(SkColorType colorType, sk_sp<SkColorSpace> colorSpace)
+    : RasterSink(colorType, std::move(colorSpace)) {}
+
+Error ThreadedSink::draw(const Src& src, SkBitmap* dst, SkWStream*, SkString*) const {
+    const SkISize size = src.size();
+    SkAlphaType alphaType = kPremul_SkAlphaType;
+    (void)SkColorTypeValidateAlphaType(fColorType, alphaType, &alphaType);
+
+    // Tiles are rasterized on the default executor, i.e. DM's own thread pool.
+    const SkImageInfo info = SkImageInfo::Make(size.width(), size.height(),
+                                               fColorType, alphaType, fColorSpace);
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterThreaded(info, FLAGS_rasterTiles);
+    if (!surface) {
+        return "Could not create a threaded surface.";
+    }
+
+    Error err = src.draw(surface->getCanvas());
+    if (!err.isEmpty()) {
+        return err;
+    }
+
+    dst->allocPixels(info);
+    if (!surface->readPixels(info, dst->getPixels(), dst->rowBytes(), 0, 0)) {
+        return "Could not read back threaded surface pixels.";
+    }
+    return "";
+}
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
 // Handy for front-patching a Src.  Do whatever up-front work you need, then call draw_to_canvas(),
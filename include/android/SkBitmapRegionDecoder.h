@@ -71,6 +71,18 @@ public:
 
     virtual SkEncodedImageFormat getEncodedFormat() = 0;
 
+    /*
+     * Scan the image once so that later calls to decodeRegion() start decoding near the top
+     * of the region, rather than at the top of the image.  Worthwhile for huge images that
+     * are decoded one tile at a time.
+     *
+     * @param rowInterval Approximate number of rows between restart points.  Each costs
+     *                    roughly 32K plus two rows of memory.
+     * @return            true if the index was built.  Only supported for non-interlaced
+     *                    PNGs in seekable streams; other images decode as before.
+     */
+    virtual bool buildRegionIndex(int rowInterval) { return false; }
+
     virtual SkColorType computeOutputColorType(SkColorType requestedColorType) = 0;
 
     virtual sk_sp<SkColorSpace> computeOutputColorSpace(SkColorType outputColorType,
@@ -10,9 +10,12 @@
 
 #include "SkCodec.h"
 #include "SkEncodedImageFormat.h"
+#include "SkPixmap.h"
 #include "SkStream.h"
 #include "SkTypes.h"
 
+class SkExecutor;
+
 /**
  *  Abstract interface defining image codec functionality that is necessary for
  *  Android.
@@ -258,6 +261,66 @@ public:
         return this->getAndroidPixels(info, pixels, rowBytes);
     }
 
+    /**
+     *  Decode the whole image, resized to the dimensions of |dst|, e.g. to make a thumbnail.
+     *
+     *  This first uses the cheapest reduction the codec supports natively: the largest sample
+     *  size whose sampled dimensions are still at least as large as |dst| (JPEG scales in the
+     *  DCT, other formats skip rows and columns, WebP scales to any size).  The remaining
+     *  resize uses a high quality (Mitchell) filter, applied to the rows as they are decoded
+     *  where the codec supports top-down scanline decoding, so that only |dst| and a few
+     *  decoded rows are held in memory.  Otherwise the sampled image is decoded into a
+     *  temporary buffer first.
+     *
+     *  |dst| must be kN32_SkColorType, and kPremul_SkAlphaType (or kOpaque_SkAlphaType if the
+     *  image is opaque).  Its color space is the color space to decode to.
+     *
+     *  @return kSuccess, kIncompleteInput if the encoded data was truncated (the missing rows
+     *          are filled before resizing), or another value explaining the failure.
+     */
+    SkCodec::Result getResizedPixels(const SkPixmap& dst);
+
+    /**
+     *  One image to decode with DecodeResized().
+     */
+    struct ResizeRequest {
+        ResizeRequest()
+            : fResult(SkCodec::kInvalidInput)
+        {}
+
+        /**
+         *  The encoded image.  For files, SkData::MakeFromFileName() maps the file, which
+         *  the codecs read in place.
+         */
+        sk_sp<SkData>   fEncoded;
+
+        /**
+         *  Allocated by the caller.  Must meet the requirements of getResizedPixels().
+         */
+        SkPixmap        fDst;
+
+        /**
+         *  Set by DecodeResized() to the result of getResizedPixels(), or kInvalidInput if
+         *  fEncoded could not be decoded at all.
+         */
+        SkCodec::Result fResult;
+    };
+
+    /**
+     *  Decode each of |requests| with getResizedPixels().  If |executor| is not null, the
+     *  requests are decoded concurrently on it, and this returns once all of them are done.
+     *  Each request only needs the memory getResizedPixels() needs, so large batches of
+     *  thumbnails stay cheap.
+     */
+    static void DecodeResized(ResizeRequest requests[], int count, SkExecutor* executor = nullptr);
+
+    /**
+     *  Speeds up later subset decodes of large images.  See SkCodec::buildSubsetIndex().
+     */
+    bool buildSubsetIndex(int rowInterval) {
+        return fCodec->buildSubsetIndex(rowInterval);
+    }
+
 protected:
 
     SkAndroidCodec(SkCodec*);
@@ -271,6 +334,12 @@ protected:
     virtual SkCodec::Result onGetAndroidPixels(const SkImageInfo& info, void* pixels,
             size_t rowBytes, const AndroidOptions& options) = 0;
 
+    /**
+     *  Called by getResizedPixels() when |sampleSize| does not scale to |dst|'s dimensions
+     *  exactly.  The default decodes the sampled image into a temporary buffer, then resizes it.
+     */
+    virtual SkCodec::Result onGetResizedPixels(const SkPixmap& dst, int sampleSize);
+
 private:
 
     // This will always be a reference to the info that is contained by the
@@ -23,6 +23,8 @@
 class SkColorSpace;
 class SkColorSpaceXform;
 class SkData;
+class SkExecutor;
+class SkFrameCache;
 class SkPngChunkReader;
 class SkSampler;
 
@@ -250,6 +252,8 @@ public:
             , fFrameIndex(0)
             , fHasPriorFrame(false)
             , fPremulBehavior(SkTransferFunctionBehavior::kRespect)
+            , fExecutor(nullptr)
+            , fUseThreads(false)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -305,6 +309,26 @@ public:
          *  we will always do a legacy premultiply.
          */
         SkTransferFunctionBehavior fPremulBehavior;
+
+        /**
+         *  If not NULL, getPixels() may split the decode into bands of rows and
+         *  decode them concurrently on this executor.  Not owned.
+         *
+         *  Currently only used by JPEG, for baseline images whose encoded data is
+         *  in memory and that have restart markers at row boundaries.  Other
+         *  images decode on the calling thread as usual.
+         */
+        SkExecutor*                fExecutor;
+
+        /**
+         *  If true, the decoder may run parts of the decode on worker threads of
+         *  its own (unlike fExecutor, which lends it the caller's threads).  This
+         *  does not change the output.
+         *
+         *  Currently only used by WebP, where libwebp filters lossy images on a
+         *  second thread while it decodes the next rows.
+         */
+        bool                       fUseThreads;
     };
 
     /**
@@ -443,8 +467,10 @@ public:
      *      lines initialized. Only meaningful if this method returns kIncompleteInput.
      *      Otherwise the implementation may not set it.
      *      Note that some implementations may have initialized this many rows, but
-     *      not necessarily finished those rows (e.g. interlaced PNG). This may be
-     *      useful for determining what rows the client needs to initialize.
+     *      not necessarily finished those rows (e.g. interlaced PNG, or progressive
+     *      JPEG, which writes a lower fidelity version of the whole image for each
+     *      scan that arrives). This may be useful for determining what rows the
+     *      client needs to initialize.
      *  @return kSuccess if all lines requested in startIncrementalDecode have
      *      been completely decoded. kIncompleteInput otherwise.
      */
@@ -650,6 +676,56 @@ public:
         return this->onGetRepetitionCount();
     }
 
+    /**
+     *  Options for a cache of decoded frames of an animated image.
+     *
+     *  Without the cache, decoding frame N with Options::fHasPriorFrame false decodes every
+     *  frame it depends on, back to an independent frame.  With it, the codec keeps a snapshot
+     *  after every fKeyframeInterval frames it decodes on top of one another, and starts from
+     *  the nearest snapshot instead.  A cached frame requested again is simply copied.
+     */
+    struct FrameCacheOptions {
+        /**
+         *  Most bytes of snapshots to keep.  Zero disables the cache.
+         */
+        size_t fBudget = 0;
+
+        /**
+         *  Once the cache is warm, no decode replays more than this many frames, budget
+         *  permitting.  Smaller intervals decode faster but need more snapshots.
+         */
+        int    fKeyframeInterval = 8;
+
+        /**
+         *  If true, snapshots are kept in SkDiscardableMemory, so the system may purge them.
+         */
+        bool   fUseDiscardableMemory = false;
+    };
+
+    /**
+     *  Enable, reconfigure or (with a zero fBudget) disable the frame cache.  Drops any frames
+     *  already cached.
+     *
+     *  Only used by animated GIFs.  Frames are only cached for unscaled decodes, so
+     *  SkAndroidCodec sampling bypasses the cache.
+     */
+    void setFrameCacheOptions(const FrameCacheOptions&);
+
+    /**
+     *  Scan the encoded data once and record where decoding can resume, about every
+     *  |rowInterval| rows.  Afterwards, incremental decodes of a subset (as performed by
+     *  SkAndroidCodec and SkBitmapRegionDecoder) start inflating near the top of the subset
+     *  rather than at the top of the image.
+     *
+     *  Each restart point costs roughly 32K plus two rows of memory.
+     *
+     *  Only supported for non-interlaced PNGs in seekable streams.  Returns false if no index
+     *  was built, in which case subset decodes behave as before.
+     */
+    bool buildSubsetIndex(int rowInterval) {
+        return rowInterval > 0 && this->onBuildSubsetIndex(rowInterval);
+    }
+
 protected:
     /**
      *  Takes ownership of SkStream*
@@ -803,8 +879,17 @@ protected:
         return 0;
     }
 
+    virtual bool onBuildSubsetIndex(int /*rowInterval*/) {
+        return false;
+    }
+
     void setUnsupportedICC(bool SkDEBUGCODE(value)) { SkDEBUGCODE(fUnsupportedICC = value); }
 
+    /**
+     *  The frame cache, if the client enabled one.
+     */
+    SkFrameCache* frameCache() const { return fFrameCache.get(); }
+
 private:
     const SkEncodedInfo                fEncodedInfo;
     const SkImageInfo                  fSrcInfo;
@@ -820,6 +905,7 @@ private:
     int                                fCurrScanline;
 
     bool                               fStartedIncrementalDecode;
+    std::unique_ptr<SkFrameCache>      fFrameCache;
 #ifdef SK_DEBUG
     bool                               fUnsupportedICC = false;
 #endif
@@ -18,6 +18,11 @@ public:
     // Create a thread pool SkExecutor with a fixed thread count, by default the number of cores.
     static std::unique_ptr<SkExecutor> MakeThreadPool(int threads = 0);
 
+    // Create a work-stealing SkExecutor with a fixed thread count, by default the number of cores.
+    // Each thread keeps its own deque of work, so work added from inside a task (e.g. by a nested
+    // SkTaskGroup) stays on that thread unless another, idle thread steals it.
+    static std::unique_ptr<SkExecutor> MakeWorkStealingPool(int threads = 0);
+
     // There is always a default SkExecutor available by calling SkExecutor::GetDefault().
     static SkExecutor& GetDefault();
     static void SetDefault(SkExecutor*);  // Does not take ownership.  Not thread safe.
@@ -25,6 +30,10 @@ public:
     // Add work to execute.
     virtual void add(std::function<void(void)>) = 0;
 
+    // Add N pieces of work, calling fn(0), fn(1), ... fn(N-1), in any order and on any threads.
+    // By default this calls add() N times.
+    virtual void batch(int N, std::function<void(int)> fn);
+
     // If it makes sense for this executor, use this thread to execute work for a little while.
     virtual void borrow() {}
 };
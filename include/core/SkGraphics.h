@@ -79,6 +79,15 @@ public:
      */
     static void PurgeFontCache();
 
+    /**
+     *  By default each font cache strike is used by one thread at a time, so a second thread
+     *  drawing text with the same typeface and settings builds a duplicate strike. When shared,
+     *  those threads use one strike together, each strike guarding its glyphs with its own lock.
+     *  Returns the previous setting.
+     */
+    static bool SetFontCacheShared(bool shared);
+    static bool GetFontCacheShared();
+
     /**
      *  Scaling bitmaps with the kHigh_SkFilterQuality setting is
      *  expensive, so the result is saved in the global Scaled Image
@@ -113,6 +122,31 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  By default the resource cache is one cache behind one lock. With more than one shard,
+     *  entries are spread across that many caches by key, each with its own lock and LRU, so
+     *  threads drawing in parallel rarely wait on each other. The total byte limit still applies
+     *  to all the shards together. Changing the count purges the cache.
+     *
+     *  Returns the previous count.
+     */
+    static int GetResourceCacheShardCount();
+    static int SetResourceCacheShardCount(int count);
+
+    /**
+     *  Raster draws of filled, non-volatile paths without mask filters, drawn more than once,
+     *  keep each path's coverage mask, keyed by the path's generation ID, the matrix's scale,
+     *  skew and subpixel translation, and anti-aliasing, so drawing the same path again, even
+     *  elsewhere by whole pixels, is just a mask blit. Paths may opt out with
+     *  SkPath::setIsVolatile().
+     *
+     *  These functions get/set the memory those masks may use. Masks bigger than 1/64th of the
+     *  limit are not kept. A limit of zero purges and disables the cache.
+     */
+    static size_t GetPathMaskCacheBytesUsed();
+    static size_t GetPathMaskCacheByteLimit();
+    static size_t SetPathMaskCacheByteLimit(size_t newLimit);
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
@@ -18,6 +18,7 @@
 #include "SkRefCnt.h"
 #include <stddef.h> // ptrdiff_t
 
+class SkArenaAlloc;
 class SkRBuffer;
 class SkWBuffer;
 
@@ -34,6 +35,11 @@ class SkWBuffer;
  * and verbs both grow into the middle of the allocation until the meet. To access verb i in the
  * verb array use ref.verbs()[~i] (because verbs() returns a pointer just beyond the first
  * logical verb or the last verb in memory).
+ *
+ * A path ref made as a copy of a short path, or with room reserved for one, keeps its points and
+ * verbs in the same allocation as itself, sized to fit, and only moves them to the heap once they
+ * outgrow it. A path ref may also be created in an SkArenaAlloc, for temporary paths that should
+ * not touch the heap at all; see SkPathPriv::ResetInArena().
  */
 
 class SK_API SkPathRef final : public SkNVRefCnt<SkPathRef> {
@@ -146,6 +152,27 @@ public:
      */
     static SkPathRef* CreateEmpty();
 
+    /**
+     * Creates an empty path ref in the arena, with room for reserveVerbs verbs and reservePoints
+     * points. Its points and verbs move to the heap only if it grows past that. The path ref must
+     * not outlive the arena: SkPath copies it to the heap rather than share it.
+     */
+    static SkPathRef* CreateInArena(SkArenaAlloc* alloc, int reserveVerbs, int reservePoints);
+
+    /**
+     * Returns true if this path ref was created by CreateInArena().
+     */
+    bool isInArena() const;
+
+    /**
+     * Returns a new reference to this path ref, or, if it is in an arena, to a copy of it on the
+     * heap.
+     */
+    SkPathRef* refOrCopy() const;
+
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr);
+
     /**
      *  Returns true if all of the points in this path are finite, meaning there
      *  are no infinities and no NaNs.
@@ -314,6 +341,25 @@ public:
     SkDEBUGCODE(void validate() const;)
 
 private:
+    // Allocates a path ref followed by inlineStorageSize bytes for its points and verbs, in alloc
+    // or, if it is null, on the heap. The matching delete is called only if the constructor
+    // throws.
+    static void* operator new(size_t size, SkArenaAlloc* alloc, size_t inlineStorageSize);
+    static void operator delete(void* ptr, SkArenaAlloc* alloc, size_t inlineStorageSize);
+
+    /**
+     * Creates an empty path ref, in alloc or on the heap, with room for reserveVerbs verbs and
+     * reservePoints points. In an arena, that room, and at least enough for a short path, is
+     * allocated along with the path ref; on the heap, only if it is short enough.
+     */
+    static SkPathRef* CreateWithStorage(SkArenaAlloc* alloc, int reserveVerbs, int reservePoints);
+
+    /**
+     * The storage allocated along with this path ref, if any, and its size.
+     */
+    uint8_t* inlineStorage();
+    size_t inlineStorageSize() const;
+
     enum SerializationOffsets {
         kRRectOrOvalStartIdx_SerializationShift = 28,  // requires 3 bits
         kRRectOrOvalIsCCW_SerializationShift = 27,     // requires 1 bit
@@ -330,6 +376,7 @@ private:
         fVerbs = NULL;
         fPoints = NULL;
         fFreeSpace = 0;
+        fOwnsStorage = false;
         fGenerationID = kEmptyGenID;
         fSegmentMask = 0;
         fIsOval = false;
@@ -393,7 +440,7 @@ private:
         ptrdiff_t sizeDelta = this->currSize() - minSize;
 
         if (sizeDelta < 0 || static_cast<size_t>(sizeDelta) >= 3 * minSize) {
-            sk_free(fPoints);
+            this->freeStorage();
             fPoints = NULL;
             fVerbs = NULL;
             fFreeSpace = 0;
@@ -437,31 +484,21 @@ private:
         if (growSize <= 0) {
             return;
         }
-        size_t oldSize = this->currSize();
-        // round to next multiple of 8 bytes
-        growSize = (growSize + 7) & ~static_cast<size_t>(7);
-        // we always at least double the allocation
-        if (static_cast<size_t>(growSize) < oldSize) {
-            growSize = oldSize;
-        }
-        if (growSize < kMinSize) {
-            growSize = kMinSize;
-        }
-        size_t newSize = oldSize + growSize;
-        // Note that realloc could memcpy more than we need. It seems to be a win anyway. TODO:
-        // encapsulate this.
-        fPoints = reinterpret_cast<SkPoint*>(sk_realloc_throw(fPoints, newSize));
-        size_t oldVerbSize = fVerbCnt * sizeof(uint8_t);
-        void* newVerbsDst = reinterpret_cast<void*>(
-                                reinterpret_cast<intptr_t>(fPoints) + newSize - oldVerbSize);
-        void* oldVerbsSrc = reinterpret_cast<void*>(
-                                reinterpret_cast<intptr_t>(fPoints) + oldSize - oldVerbSize);
-        memmove(newVerbsDst, oldVerbsSrc, oldVerbSize);
-        fVerbs = reinterpret_cast<uint8_t*>(reinterpret_cast<intptr_t>(fPoints) + newSize);
-        fFreeSpace += growSize;
+        this->growSpace(growSize);
         SkDEBUGCODE(this->validate();)
     }
 
+    /**
+     * Grows the space for points and verbs by at least growSize bytes: into the inline storage if
+     * there is none yet and it is big enough, otherwise into a larger heap allocation.
+     */
+    void growSpace(ptrdiff_t growSize);
+
+    /**
+     * Frees the points and verbs, if they are on the heap.
+     */
+    void freeStorage();
+
     /**
      * Private, non-const-ptr version of the public function verbsMemBegin().
      */
@@ -511,6 +548,8 @@ private:
 
     enum {
         kMinSize = 256,
+        // The most inline storage a heap path ref gets: enough for 20 points and 32 verbs.
+        kMaxInlineStorageSize = 192,
     };
 
     mutable SkRect   fBounds;
@@ -520,6 +559,7 @@ private:
     int                 fVerbCnt;
     int                 fPointCnt;
     size_t              fFreeSpace; // redundant but saves computation
+    SkBool8             fOwnsStorage; // whether fPoints is our own heap allocation
     SkTDArray<SkScalar> fConicWeights;
 
     enum {
@@ -13,6 +13,7 @@
 #include "SkSurfaceProps.h"
 
 class SkCanvas;
+class SkExecutor;
 class SkPaint;
 class GrContext;
 class GrRenderTarget;
@@ -78,6 +79,18 @@ public:
         return MakeRaster(SkImageInfo::MakeN32Premul(width, height), props);
     }
 
+    /**
+     *  Like MakeRaster(), but the surface's canvas splits the pixels into the given number of
+     *  tiles, records draws per tile, and rasterizes the tiles in parallel on the executor
+     *  (SkExecutor::GetDefault() if null) when the canvas is flushed or its pixels are read.
+     *  The result is the same as drawing with a canvas from MakeRaster().
+     *
+     *  The executor must outlive the surface and any canvas it returns.
+     */
+    static sk_sp<SkSurface> MakeRasterThreaded(const SkImageInfo&, int tiles,
+                                               SkExecutor* = nullptr,
+                                               const SkSurfaceProps* = nullptr);
+
     /**
      *  Used to wrap a pre-existing backend 3D API texture as a SkSurface. The kRenderTarget flag
      *  must be set on GrBackendTextureDesc for this to succeed. Skia will not assume ownership
@@ -27,8 +27,11 @@ public:
         kIgnoreTransform_BlurFlag   = 0x01,
         /** Use a smother, higher qulity blur algorithm */
         kHighQuality_BlurFlag       = 0x02,
+        /** Allow very large blurs to be computed at a reduced resolution and scaled back up.
+            Much faster, and each pixel stays within a few units (of 255) of the full blur. */
+        kAllowDownsample_BlurFlag   = 0x04,
         /** mask for all blur flags */
-        kAll_BlurFlag               = 0x03
+        kAll_BlurFlag               = 0x07
     };
 
     /** Create a blur maskfilter.
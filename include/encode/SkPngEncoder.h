@@ -0,0 +1,73 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPngEncoder_DEFINED
+#define SkPngEncoder_DEFINED
+
+#include "SkImageInfo.h"
+
+class SkExecutor;
+class SkPixmap;
+class SkWStream;
+
+class SK_API SkPngEncoder {
+public:
+    /**
+     *  The filters a row may be run through before it is compressed.  These match libpng's
+     *  PNG_FILTER_* values.
+     */
+    enum FilterFlag {
+        kNone_FilterFlag  = 0x08,
+        kSub_FilterFlag   = 0x10,
+        kUp_FilterFlag    = 0x20,
+        kAvg_FilterFlag   = 0x40,
+        kPaeth_FilterFlag = 0x80,
+        kAll_FilterFlag   = kNone_FilterFlag | kSub_FilterFlag | kUp_FilterFlag |
+                            kAvg_FilterFlag | kPaeth_FilterFlag,
+    };
+
+    struct Options {
+        /**
+         *  Which filters each row may use, as a combination of FilterFlags.  With more than one,
+         *  the encoder tries each on every row and keeps the one that looks most compressible
+         *  (adaptive filtering).  Fewer filters encode faster, usually at some cost in size.
+         *
+         *  Ignored for kIndex_8 images, which are never filtered.
+         */
+        int fFilterFlags = kAll_FilterFlag;
+
+        /**
+         *  The zlib compression level, from 0 (no compression, fastest) to 9 (smallest).
+         */
+        int fZLibLevel = 6;
+
+        /**
+         *  If the input is premultiplied, this controls the unpremultiplication behavior.
+         *  The encoder can convert to linear before unpremultiplying or ignore the transfer
+         *  function and unpremultiply the input as is.
+         */
+        SkTransferFunctionBehavior fUnpremulBehavior = SkTransferFunctionBehavior::kIgnore;
+
+        /**
+         *  If not null, large images are split into bands of rows that are converted, filtered
+         *  and deflated concurrently on this executor.  The output is still one standard zlib
+         *  stream, though usually a little larger than a serial encode.  Not owned.
+         */
+        SkExecutor* fExecutor = nullptr;
+    };
+
+    /**
+     *  Encode the |src| pixels to the |dst| stream.
+     *  |options| may be used to control the encoding behavior.
+     *
+     *  Returns true on success.  Returns false on an invalid or unsupported |src|, invalid
+     *  |options|, or if Skia was built without PNG support.
+     */
+    static bool Encode(SkWStream* dst, const SkPixmap& src, const Options& options);
+};
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkWebpEncoder_DEFINED
+#define SkWebpEncoder_DEFINED
+
+#include "SkImageInfo.h"
+
+class SkPixmap;
+class SkWStream;
+
+class SK_API SkWebpEncoder {
+public:
+    enum class Compression {
+        kLossy,
+        kLossless,
+    };
+
+    struct Options {
+        /**
+         *  Whether to use webp lossy or lossless compression.
+         */
+        Compression fCompression = Compression::kLossy;
+
+        /**
+         *  Must be in [0.0f, 100.0f].
+         *
+         *  If |fCompression| is kLossy, this is the visual quality of the encoding.  Lower
+         *  values produce smaller files.
+         *
+         *  If |fCompression| is kLossless, this is the effort spent compressing.  Lower values
+         *  encode faster into larger files.
+         */
+        float fQuality = 100.0f;
+
+        /**
+         *  libwebp's compression method, from 0 (fastest) to 6 (slowest, smallest).  Higher
+         *  methods search harder for a good encoding, at the same |fQuality|.
+         */
+        int fMethod = 4;
+
+        /**
+         *  If true, libwebp may run parts of the encode (e.g. lossy analysis, or trying
+         *  several lossless transforms) on a worker thread of its own.  This does not change
+         *  the output.
+         */
+        bool fUseThreads = false;
+
+        /**
+         *  If the input is premultiplied, this controls the unpremultiplication behavior.
+         *  The encoder can convert to linear before unpremultiplying or ignore the transfer
+         *  function and unpremultiply the input as is.
+         */
+        SkTransferFunctionBehavior fUnpremulBehavior = SkTransferFunctionBehavior::kIgnore;
+    };
+
+    /**
+     *  Encode the |src| pixels to the |dst| stream.
+     *  |options| may be used to control the encoding behavior.
+     *
+     *  Returns true on success.  Returns false on an invalid or unsupported |src|, invalid
+     *  |options|, or if Skia was built without WEBP support.
+     */
+    static bool Encode(SkWStream* dst, const SkPixmap& src, const Options& options);
+};
+
+#endif
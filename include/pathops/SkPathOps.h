@@ -80,19 +80,33 @@ public:
     void add(const SkPath& path, SkPathOp _operator);
 
     /** Computes the sum of all paths and operands, and resets the builder to its
-        initial state.
+        initial state. If all operands are unions, paths whose bounds do not touch are
+        unioned separately, and many paths are unioned in halves, concurrently on the
+        default SkExecutor.
  
         @param result The product of the operands.
         @return True if the operation succeeded.
       */
     bool resolve(SkPath* result);
 
+    /** Applies the added paths and operands to result, which must already be the product of
+        a path operation (Op, Simplify, resolve or resolveInto), and resets the builder to its
+        initial state. Only the contours of result whose bounds touch an added path are
+        recomputed; the rest are kept as they are.
+
+        @param result The first operand, and the product of the operands.
+        @return True if the operation succeeded.
+      */
+    bool resolveInto(SkPath* result);
+
 private:
     SkTArray<SkPath> fPathRefs;
     SkTDArray<SkPathOp> fOps;
 
     static bool FixWinding(SkPath* path);
     static void ReversePath(SkPath* path);
+    static bool UnionTree(SkPath* paths[], int count, SkPath* result);
+    static bool Union(SkPath* paths[], int count, SkPath* result);
     void reset();
 };
 
@@ -32,6 +32,10 @@ public:
 
     SkEncodedImageFormat getEncodedFormat() override { return fCodec->getEncodedFormat(); }
 
+    bool buildRegionIndex(int rowInterval) override {
+        return fCodec->buildSubsetIndex(rowInterval);
+    }
+
     SkColorType computeOutputColorType(SkColorType requestedColorType) override {
         return fCodec->computeOutputColorType(requestedColorType);
     }
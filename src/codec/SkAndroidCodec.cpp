@@ -6,10 +6,13 @@
  */
 
 #include "SkAndroidCodec.h"
+#include "SkBitmap.h"
 #include "SkCodec.h"
 #include "SkCodecPriv.h"
 #include "SkRawAdapterCodec.h"
+#include "SkResampler.h"
 #include "SkSampledCodec.h"
+#include "SkTaskGroup.h"
 #include "SkWebpAdapterCodec.h"
 
 static bool is_valid_sample_size(int sampleSize) {
@@ -286,3 +289,77 @@ SkCodec::Result SkAndroidCodec::getAndroidPixels(const SkImageInfo& info, void*
         size_t rowBytes) {
     return this->getAndroidPixels(info, pixels, rowBytes, nullptr);
 }
+
+SkCodec::Result SkAndroidCodec::getResizedPixels(const SkPixmap& dst) {
+    if (!dst.addr() || dst.width() < 1 || dst.height() < 1) {
+        return SkCodec::kInvalidParameters;
+    }
+    // The resize filters work on N32 pixels, and need premultiplied input to blend correctly.
+    if (kN32_SkColorType != dst.colorType() ||
+            (kPremul_SkAlphaType != dst.alphaType() && kOpaque_SkAlphaType != dst.alphaType())) {
+        return SkCodec::kInvalidConversion;
+    }
+
+    // Find the largest sample size that does not shrink the image below |dst|.
+    int sampleSize = SkTMax(1, SkTMin(fInfo.width() / dst.width(),
+                                      fInfo.height() / dst.height()));
+    SkISize sampledSize = this->getSampledDimensions(sampleSize);
+    while (sampleSize > 1 &&
+            (sampledSize.width() < dst.width() || sampledSize.height() < dst.height())) {
+        sampledSize = this->getSampledDimensions(--sampleSize);
+    }
+
+    if (sampledSize == dst.info().dimensions()) {
+        AndroidOptions options;
+        options.fSampleSize = sampleSize;
+        return this->getAndroidPixels(dst.info(), dst.writable_addr(), dst.rowBytes(), &options);
+    }
+    return this->onGetResizedPixels(dst, sampleSize);
+}
+
+SkCodec::Result SkAndroidCodec::onGetResizedPixels(const SkPixmap& dst, int sampleSize) {
+    const SkISize sampledSize = this->getSampledDimensions(sampleSize);
+    SkBitmap sampled;
+    if (!sampled.tryAllocPixels(dst.info().makeWH(sampledSize.width(), sampledSize.height()))) {
+        return SkCodec::kInvalidParameters;
+    }
+
+    AndroidOptions options;
+    options.fSampleSize = sampleSize;
+    const SkCodec::Result result = this->getAndroidPixels(sampled.info(), sampled.getPixels(),
+                                                          sampled.rowBytes(), &options);
+    switch (result) {
+        case SkCodec::kSuccess:
+        case SkCodec::kIncompleteInput:
+            break;
+        default:
+            return result;
+    }
+
+    SkPixmap src;
+    if (!sampled.peekPixels(&src) ||
+            !SkResampler::Resize(dst, src, SkBitmapScaler::RESIZE_MITCHELL)) {
+        return SkCodec::kInvalidParameters;
+    }
+    return result;
+}
+
+void SkAndroidCodec::DecodeResized(ResizeRequest requests[], int count, SkExecutor* executor) {
+    auto decode = [requests](int i) {
+        ResizeRequest& request = requests[i];
+        std::unique_ptr<SkAndroidCodec> codec(NewFromData(request.fEncoded));
+        request.fResult = codec ? codec->getResizedPixels(request.fDst)
+                                : SkCodec::kInvalidInput;
+    };
+
+    if (!executor) {
+        for (int i = 0; i < count; i++) {
+            decode(i);
+        }
+        return;
+    }
+
+    SkTaskGroup tg(*executor);
+    tg.batch(count, decode);
+    tg.wait();
+}
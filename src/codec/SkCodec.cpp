@@ -11,6 +11,7 @@
 #include "SkColorSpace.h"
 #include "SkColorSpaceXform_Base.h"
 #include "SkData.h"
+#include "SkFrameCache.h"
 #include "SkGifCodec.h"
 #include "SkHalf.h"
 #include "SkIcoCodec.h"
@@ -140,6 +141,10 @@ SkCodec::SkCodec(const SkEncodedInfo& info, const SkImageInfo& imageInfo, SkStre
 
 SkCodec::~SkCodec() {}
 
+void SkCodec::setFrameCacheOptions(const FrameCacheOptions& options) {
+    fFrameCache.reset(options.fBudget ? new SkFrameCache(options) : nullptr);
+}
+
 bool SkCodec::rewindIfNeeded() {
     // Store the value of fNeedsRewind so we can update it. Next read will
     // require a rewind.
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkConvertPixels.h"
+#include "SkDiscardableMemory.h"
+#include "SkFrameCache.h"
+
+SkFrameCache::SkFrameCache(const SkCodec::FrameCacheOptions& options)
+    : fBudget(options.fBudget)
+    , fKeyframeInterval(SkTMax(options.fKeyframeInterval, 1))
+    , fUseDiscardableMemory(options.fUseDiscardableMemory)
+    , fInfo(SkImageInfo::MakeUnknown())
+    , fParams(0)
+    , fUseCount(0)
+{}
+
+SkFrameCache::~SkFrameCache() {}
+
+void SkFrameCache::setDecodeParams(const SkImageInfo& info, uint32_t params) {
+    if (info != fInfo || params != fParams) {
+        fSnapshots.reset();
+        fInfo = info;
+        fParams = params;
+    }
+}
+
+int SkFrameCache::find(size_t frameIndex) const {
+    for (int i = 0; i < fSnapshots.count(); i++) {
+        if (fSnapshots[i].fFrameIndex == frameIndex) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool SkFrameCache::copyFrame(size_t frameIndex, void* dst, size_t rowBytes) {
+    const int index = this->find(frameIndex);
+    if (index < 0) {
+        return false;
+    }
+
+    Snapshot& snapshot = fSnapshots[index];
+    const void* pixels = snapshot.fPixels.get();
+    if (snapshot.fDiscardable) {
+        if (!snapshot.fDiscardable->lock()) {
+            fSnapshots.removeShuffle(index);
+            return false;
+        }
+        pixels = snapshot.fDiscardable->data();
+    }
+
+    SkRectMemcpy(dst, rowBytes, pixels, fInfo.minRowBytes(), fInfo.minRowBytes(),
+                 fInfo.height());
+    if (snapshot.fDiscardable) {
+        snapshot.fDiscardable->unlock();
+    }
+    snapshot.fLastUse = ++fUseCount;
+    return true;
+}
+
+void SkFrameCache::addFrame(size_t frameIndex, const void* src, size_t rowBytes) {
+    const size_t size = fInfo.getSafeSize(fInfo.minRowBytes());
+    if (0 == size || size > fBudget || this->find(frameIndex) >= 0) {
+        return;
+    }
+
+    while (this->bytesUsed() + size > fBudget) {
+        int lru = 0;
+        for (int i = 1; i < fSnapshots.count(); i++) {
+            if (fSnapshots[i].fLastUse < fSnapshots[lru].fLastUse) {
+                lru = i;
+            }
+        }
+        fSnapshots.removeShuffle(lru);
+    }
+
+    Snapshot snapshot;
+    snapshot.fFrameIndex = frameIndex;
+    snapshot.fLastUse = ++fUseCount;
+    void* pixels;
+    if (fUseDiscardableMemory) {
+        // Created locked.
+        snapshot.fDiscardable.reset(SkDiscardableMemory::Create(size));
+        if (!snapshot.fDiscardable) {
+            return;
+        }
+        pixels = snapshot.fDiscardable->data();
+    } else {
+        snapshot.fPixels.reset(new uint8_t[size]);
+        pixels = snapshot.fPixels.get();
+    }
+
+    SkRectMemcpy(pixels, fInfo.minRowBytes(), src, rowBytes, fInfo.minRowBytes(),
+                 fInfo.height());
+    if (snapshot.fDiscardable) {
+        snapshot.fDiscardable->unlock();
+    }
+    fSnapshots.push_back(std::move(snapshot));
+}
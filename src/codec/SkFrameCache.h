@@ -0,0 +1,78 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkFrameCache_DEFINED
+#define SkFrameCache_DEFINED
+
+#include "SkCodec.h"
+#include "SkImageInfo.h"
+#include "SkTArray.h"
+#include "SkTypes.h"
+
+#include <memory>
+
+class SkDiscardableMemory;
+
+/**
+ *  A budgeted cache of fully decoded frames of an animated image, owned by its SkCodec.
+ *
+ *  A snapshot of frame N is exactly what getPixels() writes for frame N, so it can stand in
+ *  for decoding the chain of frames that frame N + 1 is blended on top of.
+ */
+class SkFrameCache : SkNoncopyable {
+public:
+    explicit SkFrameCache(const SkCodec::FrameCacheOptions&);
+    ~SkFrameCache();
+
+    /**
+     *  How many frames may be decoded on top of one another before the last of them should be
+     *  kept with addFrame().
+     */
+    int keyframeInterval() const { return fKeyframeInterval; }
+
+    /**
+     *  Snapshots are only valid for one dst SkImageInfo and one set of codec specific decode
+     *  parameters, packed into |params|.  If either differs from the previous call, all
+     *  snapshots are dropped.
+     */
+    void setDecodeParams(const SkImageInfo& info, uint32_t params);
+
+    /**
+     *  Copies the snapshot of |frameIndex| to |dst|.  Returns false if there is none, including
+     *  when its discardable memory has been purged.
+     */
+    bool copyFrame(size_t frameIndex, void* dst, size_t rowBytes);
+
+    /**
+     *  Keeps a snapshot of |frameIndex|, evicting the least recently used snapshots as needed
+     *  to stay within budget.  Does nothing if a snapshot alone is larger than the budget.
+     */
+    void addFrame(size_t frameIndex, const void* src, size_t rowBytes);
+
+    int count() const { return fSnapshots.count(); }
+    size_t bytesUsed() const { return fSnapshots.count() * fInfo.getSafeSize(fInfo.minRowBytes()); }
+
+private:
+    struct Snapshot {
+        size_t                               fFrameIndex;
+        uint64_t                             fLastUse;
+        std::unique_ptr<uint8_t[]>           fPixels;
+        std::unique_ptr<SkDiscardableMemory> fDiscardable;
+    };
+
+    int find(size_t frameIndex) const;
+
+    const size_t             fBudget;
+    const int                fKeyframeInterval;
+    const bool               fUseDiscardableMemory;
+    SkImageInfo              fInfo;
+    uint32_t                 fParams;
+    uint64_t                 fUseCount;
+    SkTArray<Snapshot>       fSnapshots;
+};
+
+#endif // SkFrameCache_DEFINED
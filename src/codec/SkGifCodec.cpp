@@ -34,6 +34,7 @@
 #include "SkCodecPriv.h"
 #include "SkColorPriv.h"
 #include "SkColorTable.h"
+#include "SkFrameCache.h"
 #include "SkGifCodec.h"
 #include "SkStream.h"
 #include "SkSwizzler.h"
@@ -128,6 +129,7 @@ SkGifCodec::SkGifCodec(const SkEncodedInfo& encodedInfo, const SkImageInfo& imag
     , fDst(nullptr)
     , fDstRowBytes(0)
     , fRowsDecoded(0)
+    , fFramesSinceSnapshot(0)
 {
     reader->setClient(this);
 }
@@ -367,6 +369,18 @@ SkCodec::Result SkGifCodec::decodeFrame(bool firstAttempt, const Options& opts,
     SkASSERT(frameIndex < fReader->imagesCount());
     const SkGIFFrameContext* frameContext = fReader->frameContext(frameIndex);
     if (firstAttempt) {
+        SkFrameCache* frameCache = this->usableFrameCache();
+        if (frameCache && frameCache->copyFrame(frameIndex, fDst, fDstRowBytes)) {
+            fFilledBackground = true;
+            fRowsDecoded = dstInfo.height();
+            fFramesSinceSnapshot = 0;
+            return kSuccess;
+        }
+
+        // Counts this frame and any prior frames decoded below, which may in turn have
+        // been copied from the frame cache.
+        fFramesSinceSnapshot = 0;
+
         // rowsDecoded reports how many rows have been initialized, so a layer above
         // can fill the rest. In some cases, we fill the background before decoding
         // (or it is already filled for us), so we report rowsDecoded to be the full
@@ -455,6 +469,7 @@ SkCodec::Result SkGifCodec::decodeFrame(bool firstAttempt, const Options& opts,
 
     if (!fCurrColorTableIsReal) {
         // Nothing to draw this frame.
+        this->didDecodeFrame(frameIndex);
         return kSuccess;
     }
 
@@ -475,9 +490,33 @@ SkCodec::Result SkGifCodec::decodeFrame(bool firstAttempt, const Options& opts,
         return kIncompleteInput;
     }
 
+    this->didDecodeFrame(frameIndex);
     return kSuccess;
 }
 
+SkFrameCache* SkGifCodec::usableFrameCache() {
+    SkFrameCache* frameCache = this->frameCache();
+    const SkImageInfo& dstInfo = this->dstInfo();
+    // Frames beyond the first cannot be decoded to index 8, and snapshots of sampled decodes
+    // would be of little use to anyone.
+    if (!frameCache || kIndex_8_SkColorType == dstInfo.colorType() ||
+            dstInfo.dimensions() != this->getInfo().dimensions() ||
+            1 != fSwizzler->sampleX() || 1 != fSwizzler->sampleY()) {
+        return nullptr;
+    }
+
+    frameCache->setDecodeParams(dstInfo, (uint32_t) this->options().fPremulBehavior);
+    return frameCache;
+}
+
+void SkGifCodec::didDecodeFrame(size_t frameIndex) {
+    SkFrameCache* frameCache = this->usableFrameCache();
+    if (frameCache && ++fFramesSinceSnapshot >= frameCache->keyframeInterval()) {
+        frameCache->addFrame(frameIndex, fDst, fDstRowBytes);
+        fFramesSinceSnapshot = 0;
+    }
+}
+
 uint64_t SkGifCodec::onGetFillValue(const SkImageInfo& dstInfo) const {
     // Note: Using fCurrColorTable relies on having called initializeColorTable already.
     // This is (currently) safe because this method is only called when filling, after
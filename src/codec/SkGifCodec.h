@@ -116,6 +116,19 @@ private:
      */
     Result decodeFrame(bool firstAttempt, const Options& opts, int* rowsDecoded);
 
+    /*
+     * Returns the frame cache if snapshots of this decode may be cached and
+     * reused, or nullptr.
+     */
+    SkFrameCache* usableFrameCache();
+
+    /*
+     * Called after frameIndex is completely decoded to fDst, whether for
+     * the client or as the prior frame of another frame. Keeps a snapshot
+     * in the frame cache every keyframeInterval() frames.
+     */
+    void didDecodeFrame(size_t frameIndex);
+
     /*
      *  Swizzles and color xforms (if necessary) into dst.
      */
@@ -152,6 +165,10 @@ private:
     std::unique_ptr<uint32_t[]>         fXformBuffer;
     bool                                fXformOnDecode;
 
+    // Frames decoded into fDst since it was last filled from or stored to the
+    // frame cache, or since the last independent frame.
+    int                                 fFramesSinceSnapshot;
+
     typedef SkCodec INHERITED;
 };
 #endif  // SkGifCodec_DEFINED
@@ -13,6 +13,8 @@
 #include "SkColorPriv.h"
 #include "SkColorSpace_Base.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
+#include "SkTDArray.h"
 #include "SkTemplates.h"
 #include "SkTypes.h"
 
@@ -288,6 +290,13 @@ SkJpegCodec::SkJpegCodec(int width, int height, const SkEncodedInfo& info, SkStr
     , fSwizzleSrcRow(nullptr)
     , fColorXformSrcRow(nullptr)
     , fSwizzlerSubset(SkIRect::MakeEmpty())
+    , fIncrementalDst(nullptr)
+    , fIncrementalRowBytes(0)
+    , fStartedDecompress(false)
+    , fInOutputPass(false)
+    , fFinishingOutput(false)
+    , fFinishedOutputPass(false)
+    , fLastCompletedScan(0)
 {}
 
 /*
@@ -485,8 +494,15 @@ bool SkJpegCodec::onDimensionsSupported(const SkISize& size) {
 
 int SkJpegCodec::readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count,
                           const Options& opts) {
+    return this->readRows(fDecoderMgr.get(), fSwizzleSrcRow, fColorXformSrcRow, dstInfo, dst,
+                          rowBytes, count, opts);
+}
+
+int SkJpegCodec::readRows(JpegDecoderMgr* decoderMgr, uint8_t* swizzleSrcRow,
+                          uint32_t* colorXformSrcRow, const SkImageInfo& dstInfo, void* dst,
+                          size_t rowBytes, int count, const Options& opts) {
     // Set the jump location for libjpeg-turbo errors
-    if (setjmp(fDecoderMgr->getJmpBuf())) {
+    if (setjmp(decoderMgr->getJmpBuf())) {
         return 0;
     }
 
@@ -502,26 +518,26 @@ int SkJpegCodec::readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes
     size_t decodeDstRowBytes = rowBytes;
     size_t swizzleDstRowBytes = rowBytes;
     int dstWidth = opts.fSubset ? opts.fSubset->width() : dstInfo.width();
-    if (fSwizzleSrcRow && fColorXformSrcRow) {
-        decodeDst = (JSAMPLE*) fSwizzleSrcRow;
-        swizzleDst = fColorXformSrcRow;
+    if (swizzleSrcRow && colorXformSrcRow) {
+        decodeDst = (JSAMPLE*) swizzleSrcRow;
+        swizzleDst = colorXformSrcRow;
         decodeDstRowBytes = 0;
         swizzleDstRowBytes = 0;
         dstWidth = fSwizzler->swizzleWidth();
-    } else if (fColorXformSrcRow) {
-        decodeDst = (JSAMPLE*) fColorXformSrcRow;
-        swizzleDst = fColorXformSrcRow;
+    } else if (colorXformSrcRow) {
+        decodeDst = (JSAMPLE*) colorXformSrcRow;
+        swizzleDst = colorXformSrcRow;
         decodeDstRowBytes = 0;
         swizzleDstRowBytes = 0;
-    } else if (fSwizzleSrcRow) {
-        decodeDst = (JSAMPLE*) fSwizzleSrcRow;
+    } else if (swizzleSrcRow) {
+        decodeDst = (JSAMPLE*) swizzleSrcRow;
         decodeDstRowBytes = 0;
         dstWidth = fSwizzler->swizzleWidth();
     }
 
     for (int y = 0; y < count; y++) {
-        uint32_t lines = jpeg_read_scanlines(fDecoderMgr->dinfo(), &decodeDst, 1);
-        size_t srcRowBytes = get_row_bytes(fDecoderMgr->dinfo());
+        uint32_t lines = jpeg_read_scanlines(decoderMgr->dinfo(), &decodeDst, 1);
+        size_t srcRowBytes = get_row_bytes(decoderMgr->dinfo());
         sk_msan_mark_initialized(decodeDst, decodeDst + srcRowBytes, "skbug.com/4550");
         if (0 == lines) {
             return y;
@@ -590,6 +606,13 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return fDecoderMgr->returnFailure("setOutputColorSpace", kInvalidConversion);
     }
 
+    if (options.fExecutor) {
+        Result result;
+        if (this->decodeBands(dstInfo, dst, dstRowBytes, options, rowsDecoded, &result)) {
+            return result;
+        }
+    }
+
     if (!jpeg_start_decompress(dinfo)) {
         return fDecoderMgr->returnFailure("startDecompress", kInvalidInput);
     }
@@ -614,21 +637,321 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
     return kSuccess;
 }
 
-void SkJpegCodec::allocateStorage(const SkImageInfo& dstInfo) {
+// Bands of at least this many iMCU rows are worth the context rows decoded twice at their edges.
+static const int kMinBandIMCURows = 4;
+static const int kMaxBands = 32;
+
+/*
+ * Where a band decode finds the pieces of a baseline JPEG in its encoded data.
+ */
+struct JpegRestartIndex {
+    size_t            fHeaderLength;    // Everything up to the end of the SOS marker.
+    size_t            fHeightOffset;    // Where the SOF marker stores the image height.
+    SkTDArray<size_t> fIntervalStarts;  // Where each restart interval's entropy coded data begins.
+    size_t            fScanEnd;         // Where the marker after the last interval begins.
+
+    // Where the entropy coded data of interval i ends, just before the next RST marker.
+    size_t intervalEnd(int i) const {
+        return i + 1 < fIntervalStarts.count() ? fIntervalStarts[i + 1] - 2 : fScanEnd;
+    }
+};
+
+/*
+ * Finds the header and every restart interval of a single scan, baseline or extended sequential
+ * Huffman coded JPEG.  Returns false for anything else, or if the data is truncated.
+ */
+static bool build_restart_index(const uint8_t* data, size_t length, JpegRestartIndex* index) {
+    static const uint8_t kSOF0 = 0xC0, kSOF1 = 0xC1, kSOF15 = 0xCF,
+                         kDHT = 0xC4, kJPG = 0xC8, kDAC = 0xCC, kSOS = 0xDA;
+
+    // Skip SOI, then walk the marker segments up to and including SOS.
+    size_t pos = 2;
+    index->fHeightOffset = 0;
+    for (;;) {
+        // A marker is 0xFF, optionally more 0xFF fill bytes, then the marker code.
+        if (pos >= length || 0xFF != data[pos]) {
+            return false;
+        }
+        while (pos < length && 0xFF == data[pos]) {
+            pos++;
+        }
+        if (pos + 2 >= length) {
+            return false;
+        }
+        const uint8_t marker = data[pos];
+        const size_t segmentLength = (data[pos + 1] << 8) | data[pos + 2];
+        const size_t segmentStart = pos + 1;
+        pos = segmentStart + segmentLength;
+        if (segmentLength < 2 || pos > length) {
+            return false;
+        }
+
+        if (kSOF0 == marker || kSOF1 == marker) {
+            // Precision, then height.
+            if (segmentLength < 5) {
+                return false;
+            }
+            index->fHeightOffset = segmentStart + 3;
+        } else if (kSOF0 <= marker && marker <= kSOF15 &&
+                   kDHT != marker && kJPG != marker && kDAC != marker) {
+            // Progressive, lossless, hierarchical, or arithmetic coded.
+            return false;
+        } else if (kSOS == marker) {
+            break;
+        }
+    }
+    if (0 == index->fHeightOffset) {
+        return false;
+    }
+
+    index->fHeaderLength = pos;
+    index->fIntervalStarts.reset();
+    index->fIntervalStarts.push(pos);
+    for (;;) {
+        const uint8_t* ff = (const uint8_t*) memchr(data + pos, 0xFF, length - pos);
+        if (!ff || ff + 1 >= data + length) {
+            return false;
+        }
+        pos = ff - data;
+        const uint8_t code = data[pos + 1];
+        if (0x00 == code) {
+            // A stuffed 0xFF in the entropy coded data.
+            pos += 2;
+        } else if (0xFF == code) {
+            // A fill byte before a marker.
+            pos += 1;
+        } else if (JPEG_RST0 <= code && code <= JPEG_RST0 + 7) {
+            // RST markers count from 0 to 7 and wrap around.
+            if (code - JPEG_RST0 != (index->fIntervalStarts.count() - 1) % 8) {
+                return false;
+            }
+            pos += 2;
+            index->fIntervalStarts.push(pos);
+        } else {
+            // Anything but EOI here means there's another scan.
+            index->fScanEnd = pos;
+            return JPEG_EOI == code;
+        }
+    }
+}
+
+/*
+ * Builds a standalone JPEG from the header and restart intervals [first, end), which claims to be
+ * height rows tall.  Returns its length.
+ */
+static size_t make_band(const uint8_t* data, const JpegRestartIndex& index, int first, int end,
+                        int height, SkAutoTMalloc<uint8_t>* band) {
+    const size_t intervalsStart = index.fIntervalStarts[first],
+                 intervalsLength = index.intervalEnd(end - 1) - intervalsStart,
+                 length = index.fHeaderLength + intervalsLength + 2;
+    band->reset(length);
+    uint8_t* dst = band->get();
+
+    memcpy(dst, data, index.fHeaderLength);
+    dst[index.fHeightOffset]     = height >> 8;
+    dst[index.fHeightOffset + 1] = height & 0xFF;
+
+    uint8_t* intervals = dst + index.fHeaderLength;
+    memcpy(intervals, data + intervalsStart, intervalsLength);
+    // The decoder expects the RST markers to count up from zero again.
+    for (int i = first + 1; i < end; i++) {
+        intervals[index.fIntervalStarts[i] - 1 - intervalsStart] = JPEG_RST0 + (i - first - 1) % 8;
+    }
+
+    dst[length - 2] = 0xFF;
+    dst[length - 1] = JPEG_EOI;
+    return length;
+}
+
+int SkJpegCodec::scaledRows(int imageRows) const {
+    // Set up a fake decompress struct in order to use libjpeg to calculate output dimensions
+    jpeg_decompress_struct dinfo;
+    sk_bzero(&dinfo, sizeof(dinfo));
+    dinfo.image_width = this->getInfo().width();
+    dinfo.image_height = imageRows;
+    dinfo.global_state = fReadyState;
+    calc_output_dimensions(&dinfo, fDecoderMgr->dinfo()->scale_num,
+                           fDecoderMgr->dinfo()->scale_denom);
+    return dinfo.output_height;
+}
+
+bool SkJpegCodec::decodeBands(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+                              const Options& options, int* rowsDecoded, Result* result) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    const uint8_t* data = (const uint8_t*) this->stream()->getMemoryBase();
+    if (!data || !this->stream()->hasLength() || !IsJpeg(data, this->stream()->getLength()) ||
+            0 == dinfo->restart_interval || dinfo->progressive_mode || dinfo->arith_code ||
+            dinfo->comps_in_scan != dinfo->num_components) {
+        return false;
+    }
+
+    // Restart intervals are counted in MCUs.  A band has to start at an iMCU row (a row of
+    // MCUs, when the scan is interleaved), and that iMCU row has to start an interval too.
+    // A scan with only one component isn't interleaved, and each of its MCUs is one block.
+    const int iMCURowHeight = dinfo->max_v_samp_factor * DCTSIZE;
+    const int iMCURows = dinfo->total_iMCU_rows;
+    int64_t mcusPerIMCURow, totalMCUs;
+    if (1 == dinfo->comps_in_scan) {
+        const jpeg_component_info* comp = dinfo->cur_comp_info[0];
+        mcusPerIMCURow = (int64_t) comp->width_in_blocks * comp->v_samp_factor;
+        totalMCUs = (int64_t) comp->width_in_blocks * comp->height_in_blocks;
+    } else {
+        const int mcuWidth = dinfo->max_h_samp_factor * DCTSIZE;
+        mcusPerIMCURow = (dinfo->image_width + mcuWidth - 1) / mcuWidth;
+        totalMCUs = mcusPerIMCURow * iMCURows;
+    }
+    const int64_t restartInterval = dinfo->restart_interval;
+    int64_t a = restartInterval, b = mcusPerIMCURow;
+    while (b) {
+        int64_t r = a % b;
+        a = b;
+        b = r;
+    }
+    // A band can start every granularity iMCU rows.
+    const int64_t granularity = restartInterval / a;
+    if (granularity >= iMCURows) {
+        return false;
+    }
+    const int granules = (int) ((iMCURows + granularity - 1) / granularity);
+    const int bandGranules = (int) SkTMax((kMinBandIMCURows + granularity - 1) / granularity,
+                                          (int64_t) (granules + kMaxBands - 1) / kMaxBands);
+    const int bands = (granules + bandGranules - 1) / bandGranules;
+    if (bands < 2) {
+        return false;
+    }
+
+    JpegRestartIndex index;
+    if (!build_restart_index(data, this->stream()->getLength(), &index) ||
+            index.fIntervalStarts.count() !=
+                    (totalMCUs + restartInterval - 1) / restartInterval) {
+        return false;
+    }
+
+    // Each band decodes with its own decompress struct, set up like this one would have been.
+    jpeg_calc_output_dimensions(dinfo);
+    SkASSERT(dinfo->output_height == (uint32_t) dstInfo.height());
+    if (needs_swizzler_to_convert_from_cmyk(dinfo->out_color_space, this->getInfo(),
+            this->colorXform())) {
+        this->initializeSwizzler(dstInfo, options, true);
+    }
+
+    const int height = this->getInfo().height();
+    auto imageRow = [=](int64_t iMCURow) {
+        return (int) SkTMin(iMCURow * iMCURowHeight, (int64_t) height);
+    };
+
+    struct BandRows {
+        int fDstRow;
+        int fCount;
+        int fDecoded;
+    };
+    SkAutoTMalloc<BandRows> bandRows(bands);
+    SkTaskGroup taskGroup(*options.fExecutor);
+    taskGroup.batch(bands, [&](int band) {
+        // The band's own iMCU rows, plus a granule above and below.  Those rows of context are
+        // decoded too, so that the upsampler treats the band's edges as it does serially.
+        const int64_t first = band * bandGranules * granularity,
+                      end   = SkTMin(first + bandGranules * granularity, (int64_t) iMCURows),
+                      contextFirst = SkTMax(first - granularity, (int64_t) 0),
+                      contextEnd   = SkTMin(end + granularity, (int64_t) iMCURows);
+        const int firstInterval = (int) (contextFirst * mcusPerIMCURow / restartInterval),
+                  endInterval = contextEnd == iMCURows ? index.fIntervalStarts.count()
+                                : (int) (contextEnd * mcusPerIMCURow / restartInterval);
+
+        SkAutoTMalloc<uint8_t> bandData;
+        size_t length = make_band(data, index, firstInterval, endInterval,
+                                  imageRow(contextEnd) - imageRow(contextFirst), &bandData);
+
+        BandRows& rows = bandRows[band];
+        rows.fDstRow = this->scaledRows(imageRow(first));
+        rows.fCount = this->scaledRows(imageRow(end)) - rows.fDstRow;
+        rows.fDecoded = this->decodeBand(bandData.get(), length, dstInfo,
+                                         SkTAddOffset<void>(dst, rows.fDstRow * dstRowBytes),
+                                         dstRowBytes,
+                                         rows.fDstRow - this->scaledRows(imageRow(contextFirst)),
+                                         rows.fCount, options);
+    });
+    taskGroup.wait();
+
+    *result = kSuccess;
+    for (int band = 0; band < bands; band++) {
+        if (bandRows[band].fDecoded < bandRows[band].fCount) {
+            SkCodecPrintf("Incomplete image data in band %d of %d\n", band, bands);
+            *rowsDecoded = bandRows[band].fDstRow + bandRows[band].fDecoded;
+            *result = kIncompleteInput;
+            break;
+        }
+    }
+    return true;
+}
+
+int SkJpegCodec::decodeBand(const uint8_t* data, size_t length, const SkImageInfo& dstInfo,
+                            void* dst, size_t rowBytes, int skipRows, int count,
+                            const Options& options) {
+    size_t swizzleBytes, xformBytes;
+    this->getStorageSizes(dstInfo, &swizzleBytes, &xformBytes);
+    SkAutoTMalloc<uint8_t> storage(SkTMax(swizzleBytes + xformBytes,
+                                          get_row_bytes(fDecoderMgr->dinfo())));
+
+    SkMemoryStream stream(data, length, false);
+    JpegDecoderMgr decoderMgr(&stream);
+    if (setjmp(decoderMgr.getJmpBuf())) {
+        decoderMgr.returnFalse("decodeBand");
+        return 0;
+    }
+
+    decoderMgr.init();
+    jpeg_decompress_struct* dinfo = decoderMgr.dinfo();
+    if (JPEG_HEADER_OK != jpeg_read_header(dinfo, true)) {
+        return 0;
+    }
+
+    const jpeg_decompress_struct* parent = fDecoderMgr->dinfo();
+    dinfo->out_color_space = parent->out_color_space;
+    dinfo->dither_mode = parent->dither_mode;
+    dinfo->scale_num = parent->scale_num;
+    dinfo->scale_denom = parent->scale_denom;
+    dinfo->dct_method = parent->dct_method;
+    dinfo->do_fancy_upsampling = parent->do_fancy_upsampling;
+    if (!jpeg_start_decompress(dinfo)) {
+        return 0;
+    }
+
+    JSAMPLE* contextRow = storage.get();
+    for (int y = 0; y < skipRows; y++) {
+        if (1 != jpeg_read_scanlines(dinfo, &contextRow, 1)) {
+            return 0;
+        }
+    }
+
+    uint8_t* swizzleSrcRow = swizzleBytes ? storage.get() : nullptr;
+    uint32_t* colorXformSrcRow = xformBytes ?
+            SkTAddOffset<uint32_t>(storage.get(), swizzleBytes) : nullptr;
+    return this->readRows(&decoderMgr, swizzleSrcRow, colorXformSrcRow, dstInfo, dst, rowBytes,
+                          count, options);
+}
+
+void SkJpegCodec::getStorageSizes(const SkImageInfo& dstInfo, size_t* swizzleBytes,
+                                  size_t* xformBytes) {
     int dstWidth = dstInfo.width();
 
-    size_t swizzleBytes = 0;
+    *swizzleBytes = 0;
     if (fSwizzler) {
-        swizzleBytes = get_row_bytes(fDecoderMgr->dinfo());
+        *swizzleBytes = get_row_bytes(fDecoderMgr->dinfo());
         dstWidth = fSwizzler->swizzleWidth();
-        SkASSERT(!this->colorXform() || SkIsAlign4(swizzleBytes));
+        SkASSERT(!this->colorXform() || SkIsAlign4(*swizzleBytes));
     }
 
-    size_t xformBytes = 0;
+    *xformBytes = 0;
     if (this->colorXform() && (kRGBA_F16_SkColorType == dstInfo.colorType() ||
                                kRGB_565_SkColorType == dstInfo.colorType())) {
-        xformBytes = dstWidth * sizeof(uint32_t);
+        *xformBytes = dstWidth * sizeof(uint32_t);
     }
+}
+
+void SkJpegCodec::allocateStorage(const SkImageInfo& dstInfo) {
+    size_t swizzleBytes, xformBytes;
+    this->getStorageSizes(dstInfo, &swizzleBytes, &xformBytes);
 
     size_t totalBytes = swizzleBytes + xformBytes;
     if (totalBytes > 0) {
@@ -772,6 +1095,210 @@ bool SkJpegCodec::onSkipScanlines(int count) {
     return (uint32_t) count == jpeg_skip_scanlines(fDecoderMgr->dinfo(), count);
 }
 
+SkCodec::Result SkJpegCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+        size_t rowBytes, const Options& options, SkPMColor*, int*) {
+    if (options.fSubset) {
+        // Subsets are not supported.
+        return kUnimplemented;
+    }
+
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+
+    // Set the jump location for libjpeg errors
+    if (setjmp(fDecoderMgr->getJmpBuf())) {
+        return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
+    }
+
+    if (!this->initializeColorXform(dstInfo, options.fPremulBehavior)) {
+        return kInvalidConversion;
+    }
+
+    // Check if we can decode to the requested destination and set the output color space
+    if (!this->setOutputColorSpace(dstInfo)) {
+        return fDecoderMgr->returnFailure("setOutputColorSpace", kInvalidConversion);
+    }
+
+    // From now on, running out of data suspends the decode instead of ending it.
+    fDecoderMgr->srcMgr()->startSuspending();
+    dinfo->buffered_image = jpeg_has_multiple_scans(dinfo);
+
+    // jpeg_start_decompress() may need more data than we have, so calculate the output
+    // dimensions here.  This lets getSampler() size the swizzler before decoding starts.
+    jpeg_calc_output_dimensions(dinfo);
+
+    if (needs_swizzler_to_convert_from_cmyk(dinfo->out_color_space, this->getInfo(),
+            this->colorXform())) {
+        this->initializeSwizzler(dstInfo, options, true);
+    }
+
+    this->allocateStorage(dstInfo);
+
+    fIncrementalDst = dst;
+    fIncrementalRowBytes = rowBytes;
+    fStartedDecompress = false;
+    fInOutputPass = false;
+    fFinishingOutput = false;
+    fFinishedOutputPass = false;
+    fLastCompletedScan = 0;
+    return kSuccess;
+}
+
+int SkJpegCodec::incrementalRowsDecoded() const {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    const int sampleY = fSwizzler ? fSwizzler->sampleY() : 1;
+    const int dstHeight = get_scaled_dimension(dinfo->output_height, sampleY);
+    if (fFinishedOutputPass) {
+        return dstHeight;
+    }
+
+    // Rows startY, startY + sampleY, ... are the ones written so far.
+    const int startY = get_start_coord(sampleY);
+    const int scanline = dinfo->output_scanline;
+    return scanline > startY ? SkTMin((scanline - startY - 1) / sampleY + 1, dstHeight) : 0;
+}
+
+/*
+ * Decodes a row that the sampler leaves out.  Returns the number of rows read.
+ */
+static int read_unsampled_row(JpegDecoderMgr* decoderMgr, JSAMPLE* scratch) {
+    // Set the jump location for libjpeg-turbo errors
+    if (setjmp(decoderMgr->getJmpBuf())) {
+        return 0;
+    }
+
+    return jpeg_read_scanlines(decoderMgr->dinfo(), &scratch, 1);
+}
+
+bool SkJpegCodec::readIncrementalRows() {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    const int height = dinfo->output_height;
+    const int sampleY = fSwizzler ? fSwizzler->sampleY() : 1;
+    const int dstHeight = get_scaled_dimension(height, sampleY);
+    while ((int) dinfo->output_scanline < height) {
+        const int y = dinfo->output_scanline;
+        int rows;
+        if (1 == sampleY) {
+            rows = this->readRows(this->dstInfo(),
+                                  SkTAddOffset<void>(fIncrementalDst, y * fIncrementalRowBytes),
+                                  fIncrementalRowBytes, height - y, this->options());
+        } else if (is_coord_necessary(y, sampleY, dstHeight)) {
+            void* dstRow = SkTAddOffset<void>(fIncrementalDst,
+                                              get_dst_coord(y, sampleY) * fIncrementalRowBytes);
+            rows = this->readRows(this->dstInfo(), dstRow, fIncrementalRowBytes, 1,
+                                  this->options());
+        } else {
+            // Sampling always uses the swizzler, so fSwizzleSrcRow is free to hold a row
+            // that we throw away.
+            rows = read_unsampled_row(fDecoderMgr.get(), fSwizzleSrcRow);
+        }
+
+        if (0 == rows && !fDecoderMgr->srcMgr()->fetchMoreData()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+SkCodec::Result SkJpegCodec::onIncrementalDecode(int* rowsDecoded) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    skjpeg_source_mgr* srcMgr = fDecoderMgr->srcMgr();
+
+    // Set the jump location for libjpeg errors
+    if (setjmp(fDecoderMgr->getJmpBuf())) {
+        return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
+    }
+
+    if (!fStartedDecompress) {
+        while (!jpeg_start_decompress(dinfo)) {
+            if (!srcMgr->fetchMoreData()) {
+                if (rowsDecoded) {
+                    *rowsDecoded = 0;
+                }
+                return kIncompleteInput;
+            }
+        }
+
+        // The recommended output buffer height should always be 1 in high quality modes.
+        SkASSERT(1 == dinfo->rec_outbuf_height);
+
+        // A sequential image has a single output pass, which takes rows as they arrive.
+        fStartedDecompress = true;
+        fInOutputPass = !dinfo->buffered_image;
+    }
+
+    for (;;) {
+        if (fInOutputPass) {
+            if (!this->readIncrementalRows()) {
+                if (rowsDecoded) {
+                    *rowsDecoded = this->incrementalRowsDecoded();
+                }
+                return kIncompleteInput;
+            }
+
+            if (!dinfo->buffered_image) {
+                // As in onGetPixels(), we do not call jpeg_finish_decompress().
+                return kSuccess;
+            }
+
+            // readRows() moved the jump location, so set it again.
+            if (setjmp(fDecoderMgr->getJmpBuf())) {
+                return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
+            }
+
+            fInOutputPass = false;
+            fFinishedOutputPass = true;
+            fFinishingOutput = true;
+        }
+
+        if (fFinishingOutput) {
+            // This reads ahead to the next scan, so it may suspend.
+            while (!jpeg_finish_output(dinfo)) {
+                if (!srcMgr->fetchMoreData()) {
+                    if (rowsDecoded) {
+                        *rowsDecoded = this->incrementalRowsDecoded();
+                    }
+                    return kIncompleteInput;
+                }
+            }
+            fFinishingOutput = false;
+
+            if (jpeg_input_complete(dinfo) &&
+                    dinfo->output_scan_number == dinfo->input_scan_number) {
+                // The last pass used every scan, so the image is final.
+                return kSuccess;
+            }
+        }
+
+        // Take in all of the data we have, noting the last scan to be completed.
+        while (!jpeg_input_complete(dinfo)) {
+            const int status = jpeg_consume_input(dinfo);
+            if (JPEG_SUSPENDED == status) {
+                if (!srcMgr->fetchMoreData()) {
+                    break;
+                }
+            } else if (JPEG_SCAN_COMPLETED == status) {
+                fLastCompletedScan = dinfo->input_scan_number;
+            }
+        }
+
+        const int scan = jpeg_input_complete(dinfo) ? dinfo->input_scan_number
+                                                    : fLastCompletedScan;
+        if (scan <= dinfo->output_scan_number) {
+            // Nothing new to show yet.
+            if (rowsDecoded) {
+                *rowsDecoded = this->incrementalRowsDecoded();
+            }
+            return kIncompleteInput;
+        }
+
+        // Every scan up to this one has arrived, so starting the pass will not suspend, and
+        // neither will reading its rows.
+        SkAssertResult(jpeg_start_output(dinfo, scan));
+        fInOutputPass = true;
+    }
+}
+
 static bool is_yuv_supported(jpeg_decompress_struct* dinfo) {
     // Scaling is not supported in raw data mode.
     SkASSERT(dinfo->scale_num == dinfo->scale_denom);
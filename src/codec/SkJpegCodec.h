@@ -114,7 +114,36 @@ private:
     void initializeSwizzler(const SkImageInfo& dstInfo, const Options& options,
                             bool needsCMYKToRGB);
     void allocateStorage(const SkImageInfo& dstInfo);
+    // How many bytes does each row of scratch space, for libjpeg-turbo's output and for the
+    // color xform's input, need to be?
+    void getStorageSizes(const SkImageInfo& dstInfo, size_t* swizzleBytes, size_t* xformBytes);
     int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&);
+    int readRows(JpegDecoderMgr*, uint8_t* swizzleSrcRow, uint32_t* colorXformSrcRow,
+                 const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count,
+                 const Options&);
+
+    /*
+     * Decodes bands of rows concurrently on options.fExecutor, using the restart markers in
+     * the encoded data to start each band partway through the image.
+     *
+     * Returns false without decoding anything if the image can't be split this way, in which
+     * case the caller should decode it serially.  Otherwise sets *result (and *rowsDecoded if
+     * the input was incomplete).
+     */
+    bool decodeBands(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+                     const Options& options, int* rowsDecoded, Result* result);
+
+    /*
+     * Decodes one band from a standalone JPEG made by decodeBands().  Discards the first
+     * skipRows rows of output, which are only there as context for upsampling, then writes
+     * up to count rows to dst.  Returns the number of rows written.
+     */
+    int decodeBand(const uint8_t* data, size_t length, const SkImageInfo& dstInfo, void* dst,
+                   size_t rowBytes, int skipRows, int count, const Options&);
+
+    // How many rows does the decoder output for the first imageRows rows of the image, at the
+    // current scale?
+    int scaledRows(int imageRows) const;
 
     /*
      * Scanline decoding.
@@ -125,6 +154,24 @@ private:
     int onGetScanlines(void* dst, int count, size_t rowBytes) override;
     bool onSkipScanlines(int count) override;
 
+    /*
+     * Incremental decoding.  Progressive images are decoded in libjpeg-turbo's buffered-image
+     * mode: each time another scan has arrived, the whole image is output again at the
+     * fidelity of the scans received so far.  Subsets are not supported.
+     */
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+            const Options&, SkPMColor*, int*) override;
+    Result onIncrementalDecode(int* rowsDecoded) override;
+
+    /*
+     * Decodes the rest of the current output pass into fIncrementalDst, leaving out the
+     * rows the sampler skips.  Returns false if the input runs out first.
+     */
+    bool readIncrementalRows();
+
+    // How many rows of fIncrementalDst have been written, by this output pass or an earlier one?
+    int incrementalRowsDecoded() const;
+
     std::unique_ptr<JpegDecoderMgr>    fDecoderMgr;
 
     // We will save the state of the decompress struct after reading the header.
@@ -143,6 +190,15 @@ private:
 
     std::unique_ptr<SkSwizzler>        fSwizzler;
 
+    // Incremental decoding state.
+    void*                              fIncrementalDst;
+    size_t                             fIncrementalRowBytes;
+    bool                               fStartedDecompress;
+    bool                               fInOutputPass;
+    bool                               fFinishingOutput;
+    bool                               fFinishedOutputPass;
+    int                                fLastCompletedScan;
+
     friend class SkRawCodec;
 
     typedef SkCodec INHERITED;
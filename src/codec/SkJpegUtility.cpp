@@ -16,6 +16,19 @@ static void sk_init_source(j_decompress_ptr dinfo) {
     skjpeg_source_mgr* src = (skjpeg_source_mgr*) dinfo->src;
     src->next_input_byte = (const JOCTET*) src->fBuffer;
     src->bytes_in_buffer = 0;
+
+    // If the stream is already in memory, let libjpeg read all of it in place.
+    SkStream* stream = src->fStream;
+    const void* memoryBase = stream->getMemoryBase();
+    if (memoryBase && stream->hasPosition() && stream->hasLength()) {
+        const size_t position = stream->getPosition();
+        const size_t length = stream->getLength();
+        if (position <= length && stream->seek(length)) {
+            src->next_input_byte = SkTAddOffset<const JOCTET>(memoryBase, position);
+            src->bytes_in_buffer = length - position;
+            src->fInMemory = true;
+        }
+    }
 }
 
 /*
@@ -23,6 +36,11 @@ static void sk_init_source(j_decompress_ptr dinfo) {
  */
 static boolean sk_fill_input_buffer(j_decompress_ptr dinfo) {
     skjpeg_source_mgr* src = (skjpeg_source_mgr*) dinfo->src;
+    if (src->fSuspending) {
+        // Make libjpeg back up and return, so the client can wait for more data.
+        return false;
+    }
+
     size_t bytes = src->fStream->read(src->fBuffer, skjpeg_source_mgr::kBufferSize);
 
     // libjpeg is still happy with a less than full read, as long as the result is non-zero
@@ -42,7 +60,12 @@ static void sk_skip_input_data(j_decompress_ptr dinfo, long numBytes) {
     skjpeg_source_mgr* src = (skjpeg_source_mgr*) dinfo->src;
     size_t bytes = (size_t) numBytes;
 
-    if (bytes > src->bytes_in_buffer) {
+    if (bytes > src->bytes_in_buffer && src->fSuspending) {
+        // We cannot suspend here, so skip the rest once more data has arrived.
+        src->fBytesToSkip += bytes - src->bytes_in_buffer;
+        src->next_input_byte += src->bytes_in_buffer;
+        src->bytes_in_buffer = 0;
+    } else if (bytes > src->bytes_in_buffer) {
         size_t bytesToSkip = bytes - src->bytes_in_buffer;
         if (bytesToSkip != src->fStream->skip(bytesToSkip)) {
             SkCodecPrintf("Failure to skip.\n");
@@ -75,6 +98,10 @@ static void sk_term_source(j_decompress_ptr dinfo)
  */
 skjpeg_source_mgr::skjpeg_source_mgr(SkStream* stream)
     : fStream(stream)
+    , fSuspendBufferSize(0)
+    , fBytesToSkip(0)
+    , fSuspending(false)
+    , fInMemory(false)
 {
     init_source = sk_init_source;
     fill_input_buffer = sk_fill_input_buffer;
@@ -83,6 +110,43 @@ skjpeg_source_mgr::skjpeg_source_mgr(SkStream* stream)
     term_source = sk_term_source;
 }
 
+void skjpeg_source_mgr::startSuspending() {
+    fSuspending = true;
+}
+
+bool skjpeg_source_mgr::fetchMoreData() {
+    SkASSERT(fSuspending);
+    if (fInMemory) {
+        // libjpeg already has all of the data.
+        return false;
+    }
+
+    while (fBytesToSkip > 0) {
+        size_t skipped = fStream->skip(fBytesToSkip);
+        if (0 == skipped) {
+            return false;
+        }
+        fBytesToSkip -= skipped;
+    }
+
+    // Move the unread bytes to the front, growing the buffer if they leave too little room.
+    const size_t unread = bytes_in_buffer;
+    if (unread + kSuspendingReadSize > fSuspendBufferSize) {
+        const size_t size = SkTMax(2 * fSuspendBufferSize, unread + kSuspendingReadSize);
+        SkAutoTMalloc<uint8_t> buffer(size);
+        memcpy(buffer.get(), next_input_byte, unread);
+        fSuspendBuffer = std::move(buffer);
+        fSuspendBufferSize = size;
+    } else {
+        memmove(fSuspendBuffer.get(), next_input_byte, unread);
+    }
+
+    size_t bytes = fStream->read(fSuspendBuffer.get() + unread, fSuspendBufferSize - unread);
+    next_input_byte = (const JOCTET*) fSuspendBuffer.get();
+    bytes_in_buffer = unread + bytes;
+    return bytes > 0;
+}
+
 /*
  * Call longjmp to continue execution on an error
  */
@@ -11,6 +11,7 @@
 
 #include "SkJpegPriv.h"
 #include "SkStream.h"
+#include "SkTemplates.h"
 
 #include <setjmp.h>
 // stdio is needed for jpeglib
@@ -32,13 +33,39 @@ void skjpeg_err_exit(j_common_ptr cinfo);
 struct skjpeg_source_mgr : jpeg_source_mgr {
     skjpeg_source_mgr(SkStream* stream);
 
+    /*
+     * Switch to suspending input, for decoding while the stream is still arriving.
+     * From now on, running out of data suspends libjpeg, which then backs up to the
+     * start of the marker or MCU it was reading.  Call fetchMoreData() before retrying.
+     */
+    void startSuspending();
+
+    /*
+     * Keeps the bytes libjpeg has not consumed yet and appends whatever more the stream
+     * has.  Returns false if the stream had nothing new.
+     */
+    bool fetchMoreData();
+
     SkStream* fStream; // unowned
     enum {
         // TODO (msarett): Experiment with different buffer sizes.
         // This size was chosen because it matches SkImageDecoder.
-        kBufferSize = 1024
+        kBufferSize = 1024,
+
+        // How much more data to ask the stream for each time libjpeg suspends.
+        kSuspendingReadSize = 16 * 1024,
     };
     uint8_t fBuffer[kBufferSize];
+
+    // Used instead of fBuffer when suspending, since it must hold everything libjpeg
+    // may back up to.
+    SkAutoTMalloc<uint8_t> fSuspendBuffer;
+    size_t                 fSuspendBufferSize;
+    // Bytes libjpeg asked to skip beyond the end of the data we have.
+    size_t                 fBytesToSkip;
+    bool                   fSuspending;
+    // Set when libjpeg reads directly from the stream's memory, rather than from a copy.
+    bool                   fInMemory;
 };
 
 #endif
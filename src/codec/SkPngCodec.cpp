@@ -14,6 +14,7 @@
 #include "SkMath.h"
 #include "SkOpts.h"
 #include "SkPngCodec.h"
+#include "SkPngRowIndex.h"
 #include "SkPoint3.h"
 #include "SkSize.h"
 #include "SkStream.h"
@@ -130,6 +131,18 @@ static inline bool is_chunk(const png_byte* chunk, const char* tag) {
 
 static inline bool process_data(png_structp png_ptr, png_infop info_ptr,
         SkStream* stream, void* buffer, size_t bufferSize, size_t length) {
+    if (const void* memoryBase = stream->getMemoryBase()) {
+        // Let libpng read the data in place. Move the stream first, as read() would have,
+        // since libpng may longjmp out once it has decoded the rows we want.
+        const size_t position = stream->getPosition();
+        const size_t bytesToProcess = std::min(length, stream->getLength() - position);
+        stream->move(bytesToProcess);
+        png_process_data(png_ptr, info_ptr,
+                         SkTAddOffset<png_byte>(const_cast<void*>(memoryBase), position),
+                         bytesToProcess);
+        return bytesToProcess == length;
+    }
+
     while (length > 0) {
         const size_t bytesToProcess = std::min(bufferSize, length);
         const size_t bytesRead = stream->read(buffer, bytesToProcess);
@@ -524,6 +537,9 @@ private:
     int                         fLastRow;
     int                         fRowsNeeded;
 
+    // Lets subset decodes skip inflating most of the rows above the subset.
+    std::unique_ptr<SkPngRowIndex> fRowIndex;
+
     typedef SkPngCodec INHERITED;
 
     static SkPngNormalDecoder* GetDecoder(png_structp png_ptr) {
@@ -560,6 +576,11 @@ private:
         fDst = SkTAddOffset<void>(fDst, fRowBytes);
     }
 
+    bool onBuildSubsetIndex(int rowInterval) override {
+        fRowIndex = SkPngRowIndex::Make(this->stream(), rowInterval);
+        return fRowIndex != nullptr;
+    }
+
     void setRange(int firstRow, int lastRow, void* dst, size_t rowBytes) override {
         png_set_progressive_read_fn(this->png_ptr(), this, nullptr, RowCallback, nullptr);
         fFirstRow = firstRow;
@@ -575,7 +596,20 @@ private:
             const int sampleY = this->swizzler()->sampleY();
             fRowsNeeded = get_scaled_dimension(fLastRow - fFirstRow + 1, sampleY);
         }
-        this->processData();
+
+        if (fRowIndex && fRowIndex->startRow(fFirstRow) > 0) {
+            // The index only accepts images whose rows libpng would not transform, so its rows
+            // can go straight to the swizzler.  It only fails on corrupt data, so do not start
+            // over once rows have been written.
+            if (0 == fRowsWrittenToOutput) {
+                fRowIndex->decodeRows(this->stream(), fFirstRow,
+                        [this](int rowNum, const uint8_t* row) {
+                            return this->processRow(row, rowNum);
+                        });
+            }
+        } else {
+            this->processData();
+        }
 
         if (fRowsWrittenToOutput == fRowsNeeded) {
             return SkCodec::kSuccess;
@@ -588,10 +622,11 @@ private:
         return SkCodec::kIncompleteInput;
     }
 
-    void rowCallback(png_bytep row, int rowNum) {
+    // Returns false once all of the rows in the range have been written.
+    bool processRow(const void* row, int rowNum) {
         if (rowNum < fFirstRow) {
             // Ignore this row.
-            return;
+            return true;
         }
 
         SkASSERT(rowNum <= fLastRow);
@@ -604,7 +639,11 @@ private:
             fRowsWrittenToOutput++;
         }
 
-        if (fRowsWrittenToOutput == fRowsNeeded) {
+        return fRowsWrittenToOutput < fRowsNeeded;
+    }
+
+    void rowCallback(png_bytep row, int rowNum) {
+        if (!this->processRow(row, rowNum)) {
             // Fake error to stop decoding scanlines.
             longjmp(PNG_JMPBUF(this->png_ptr()), kStopDecoding);
         }
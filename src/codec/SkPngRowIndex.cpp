@@ -0,0 +1,478 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPngRowIndex.h"
+#include "SkStream.h"
+#include "SkTemplates.h"
+
+#include "zlib.h"
+#include <algorithm>
+
+static uint32_t read_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static bool is_chunk(const uint8_t* chunk, const char* tag) {
+    return memcmp(chunk + 4, tag, 4) == 0;
+}
+
+static bool read_exactly(SkStream* stream, void* buffer, size_t size) {
+    return stream->read(buffer, size) == size;
+}
+
+static bool skip_exactly(SkStream* stream, size_t size) {
+    return stream->skip(size) == size;
+}
+
+static int paeth(int a, int b, int c) {
+    const int pa = SkTAbs(b - c);
+    const int pb = SkTAbs(a - c);
+    const int pc = SkTAbs(a + b - 2 * c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// Undoes the filter of |row| in place.  |prior| is the unfiltered row above, or zeros.
+static bool unfilter_row(int filter, uint8_t* row, const uint8_t* prior, size_t rowBytes,
+                         int bpp) {
+    switch (filter) {
+        case 0:
+            break;
+        case 1:
+            for (size_t i = bpp; i < rowBytes; i++) {
+                row[i] += row[i - bpp];
+            }
+            break;
+        case 2:
+            for (size_t i = 0; i < rowBytes; i++) {
+                row[i] += prior[i];
+            }
+            break;
+        case 3:
+            for (int i = 0; i < bpp; i++) {
+                row[i] += prior[i] >> 1;
+            }
+            for (size_t i = bpp; i < rowBytes; i++) {
+                row[i] += (row[i - bpp] + prior[i]) >> 1;
+            }
+            break;
+        case 4:
+            for (int i = 0; i < bpp; i++) {
+                row[i] += prior[i];
+            }
+            for (size_t i = bpp; i < rowBytes; i++) {
+                row[i] += paeth(row[i - bpp], prior[i], prior[i - bpp]);
+            }
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Reads the concatenated data of the IDAT chunks, skipping chunk headers and CRCs.
+class SkPngRowIndex::IdatReader {
+public:
+    IdatReader(SkStream* stream, const SkTArray<Chunk>& chunks, size_t idatOffset)
+        : fStream(stream)
+        , fChunks(chunks)
+        , fChunk(0)
+        , fOffset(idatOffset)
+        , fNeedsSeek(true)
+    {
+        const Chunk* begin = chunks.begin();
+        const Chunk* found = std::upper_bound(begin, chunks.end(), idatOffset,
+                [](size_t offset, const Chunk& chunk) { return offset < chunk.fIdatOffset; });
+        fChunk = SkTMax(0, (int)(found - begin) - 1);
+    }
+
+    size_t offset() const { return fOffset; }
+
+    // Reads up to |size| bytes, but no further than the end of the current chunk.  Returns 0
+    // at the end of the data or on error.
+    size_t read(void* buffer, size_t size) {
+        while (fChunk < fChunks.count() &&
+               fOffset == fChunks[fChunk].fIdatOffset + fChunks[fChunk].fLength) {
+            fChunk++;
+            fNeedsSeek = true;
+        }
+        if (fChunk == fChunks.count()) {
+            return 0;
+        }
+
+        const Chunk& chunk = fChunks[fChunk];
+        if (fNeedsSeek) {
+            if (!fStream->seek(chunk.fStreamOffset + fOffset - chunk.fIdatOffset)) {
+                return 0;
+            }
+            fNeedsSeek = false;
+        }
+        size = SkTMin(size, chunk.fIdatOffset + chunk.fLength - fOffset);
+        const size_t bytesRead = fStream->read(buffer, size);
+        fOffset += bytesRead;
+        return bytesRead;
+    }
+
+    // Consumes the two byte zlib header.
+    bool readZlibHeader() {
+        uint8_t header[2];
+        for (size_t bytes = 0; bytes < 2;) {
+            const size_t bytesRead = this->read(header + bytes, 2 - bytes);
+            if (!bytesRead) {
+                return false;
+            }
+            bytes += bytesRead;
+        }
+        // Deflate, a window of at most 32K, no preset dictionary, and a valid check value.
+        return (header[0] & 0x0F) == 8 && (header[0] >> 4) <= 7 && !(header[1] & 0x20) &&
+               ((header[0] << 8) | header[1]) % 31 == 0;
+    }
+
+private:
+    SkStream*              fStream;
+    const SkTArray<Chunk>& fChunks;
+    int                    fChunk;
+    size_t                 fOffset;
+    bool                   fNeedsSeek;
+};
+
+// Inflates the IDAT data one row at a time, undoing the filters.
+class SkPngRowIndex::RowInflater {
+public:
+    enum Result {
+        kRow_Result,        // completedRow() holds the next unfiltered row.
+        kBlockEnd_Result,   // A deflate block ended partway through a row.
+        kError_Result,
+    };
+
+    RowInflater(size_t rowBytes, int bytesPerPixel)
+        : fRowBytes(rowBytes)
+        , fBytesPerPixel(bytesPerPixel)
+        , fStorage(2 * (rowBytes + 1))
+        , fRow(fStorage.get())
+        , fPrior(fStorage.get() + rowBytes + 1)
+        , fPartialRowBytes(0)
+        , fInput(kInputSize)
+        , fLastByte(0)
+    {
+        sk_bzero(fStorage.get(), 2 * (rowBytes + 1));
+        memset(&fZStream, 0, sizeof(fZStream));
+        fValid = Z_OK == inflateInit2(&fZStream, -15);
+    }
+
+    ~RowInflater() {
+        if (fValid) {
+            inflateEnd(&fZStream);
+        }
+    }
+
+    bool valid() const { return fValid; }
+
+    const uint8_t* completedRow() const { return fPrior + 1; }
+
+    bool atBlockBoundary() const {
+        return (fZStream.data_type & 128) && !(fZStream.data_type & 64);
+    }
+
+    Result next(IdatReader* reader, bool stopAtBlocks) {
+        const size_t stride = fRowBytes + 1;
+        while (true) {
+            if (0 == fZStream.avail_in) {
+                if (fZStream.next_in) {
+                    fLastByte = fZStream.next_in[-1];
+                }
+                const size_t bytesRead = reader->read(fInput.get(), kInputSize);
+                if (!bytesRead) {
+                    return kError_Result;
+                }
+                fZStream.next_in = fInput.get();
+                fZStream.avail_in = (uInt) bytesRead;
+            }
+
+            fZStream.next_out = fRow + fPartialRowBytes;
+            fZStream.avail_out = (uInt) (stride - fPartialRowBytes);
+            const int ret = inflate(&fZStream, stopAtBlocks ? Z_BLOCK : Z_NO_FLUSH);
+            if (Z_OK != ret && Z_STREAM_END != ret) {
+                return kError_Result;
+            }
+
+            fPartialRowBytes = stride - fZStream.avail_out;
+            if (stride == fPartialRowBytes) {
+                fPartialRowBytes = 0;
+                if (!unfilter_row(fRow[0], fRow + 1, fPrior + 1, fRowBytes, fBytesPerPixel)) {
+                    return kError_Result;
+                }
+                std::swap(fRow, fPrior);
+                return kRow_Result;
+            }
+            if (Z_STREAM_END == ret) {
+                // The data ended partway through a row.
+                return kError_Result;
+            }
+            if (stopAtBlocks && this->atBlockBoundary()) {
+                return kBlockEnd_Result;
+            }
+        }
+    }
+
+    bool save(Checkpoint* checkpoint, int row, const IdatReader& reader) {
+        uInt windowSize = 0;
+        if (Z_OK != inflateGetDictionary(&fZStream, nullptr, &windowSize)) {
+            return false;
+        }
+
+        checkpoint->fRow = row;
+        checkpoint->fIdatOffset = reader.offset() - fZStream.avail_in;
+        checkpoint->fBits = fZStream.data_type & 7;
+        checkpoint->fPrimeByte = fZStream.next_in > fInput.get() ? fZStream.next_in[-1]
+                                                                 : fLastByte;
+        checkpoint->fWindowSize = windowSize;
+        checkpoint->fPartialRowBytes = fPartialRowBytes;
+        checkpoint->fData.reset(new uint8_t[windowSize + fPartialRowBytes + fRowBytes]);
+
+        uint8_t* data = checkpoint->fData.get();
+        if (Z_OK != inflateGetDictionary(&fZStream, data, &windowSize)) {
+            return false;
+        }
+        memcpy(data + windowSize, fRow, fPartialRowBytes);
+        memcpy(data + windowSize + fPartialRowBytes, fPrior + 1, fRowBytes);
+        return true;
+    }
+
+    bool restore(const Checkpoint& checkpoint) {
+        const int bits = checkpoint.fBits;
+        if (bits && Z_OK != inflatePrime(&fZStream, bits, checkpoint.fPrimeByte >> (8 - bits))) {
+            return false;
+        }
+
+        const uint8_t* data = checkpoint.fData.get();
+        if (checkpoint.fWindowSize &&
+                Z_OK != inflateSetDictionary(&fZStream, data, (uInt) checkpoint.fWindowSize)) {
+            return false;
+        }
+        fPartialRowBytes = checkpoint.fPartialRowBytes;
+        memcpy(fRow, data + checkpoint.fWindowSize, fPartialRowBytes);
+        memcpy(fPrior + 1, data + checkpoint.fWindowSize + fPartialRowBytes, fRowBytes);
+        return true;
+    }
+
+private:
+    static constexpr size_t kInputSize = 32 * 1024;
+
+    const size_t           fRowBytes;
+    const int              fBytesPerPixel;
+    SkAutoTMalloc<uint8_t> fStorage;
+    uint8_t*               fRow;            // Filter type byte, then the row being inflated.
+    uint8_t*               fPrior;          // Filter type byte, then the last completed row.
+    size_t                 fPartialRowBytes;
+    SkAutoTMalloc<uint8_t> fInput;
+    uint8_t                fLastByte;       // Last byte of the previous input buffer.
+    z_stream               fZStream;
+    bool                   fValid;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Restores the stream's position when it goes out of scope.
+class AutoRestorePosition : SkNoncopyable {
+public:
+    explicit AutoRestorePosition(SkStream* stream)
+        : fStream(stream)
+        , fPosition(stream->getPosition())
+    {}
+
+    ~AutoRestorePosition() {
+        fStream->seek(fPosition);
+    }
+
+private:
+    SkStream*    fStream;
+    const size_t fPosition;
+};
+
+}  // namespace
+
+std::unique_ptr<SkPngRowIndex> SkPngRowIndex::Make(SkStream* stream, int rowInterval) {
+    if (rowInterval <= 0 || !stream->hasPosition()) {
+        return nullptr;
+    }
+
+    AutoRestorePosition autoRestore(stream);
+    if (!stream->seek(0)) {
+        return nullptr;
+    }
+
+    static constexpr uint8_t kSignature[] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+    uint8_t buffer[13];
+    if (!read_exactly(stream, buffer, sizeof(kSignature)) ||
+            memcmp(buffer, kSignature, sizeof(kSignature))) {
+        return nullptr;
+    }
+
+    uint32_t width = 0, height = 0;
+    int bitDepth = 0, colorType = 0, interlace = 0;
+    bool hasIHDR = false, hasTRNS = false;
+    SkTArray<Chunk> chunks;
+    size_t idatLength = 0;
+    while (true) {
+        if (!read_exactly(stream, buffer, 8)) {
+            return nullptr;
+        }
+        const size_t length = read_be32(buffer);
+        if (is_chunk(buffer, "IEND")) {
+            break;
+        }
+
+        if (is_chunk(buffer, "IHDR")) {
+            if (13 != length || !read_exactly(stream, buffer, 13)) {
+                return nullptr;
+            }
+            width = read_be32(buffer);
+            height = read_be32(buffer + 4);
+            bitDepth = buffer[8];
+            colorType = buffer[9];
+            interlace = buffer[12];
+            hasIHDR = true;
+            if (!skip_exactly(stream, 4)) {
+                return nullptr;
+            }
+            continue;
+        }
+
+        if (is_chunk(buffer, "IDAT")) {
+            chunks.push_back({ stream->getPosition(), length, idatLength });
+            idatLength += length;
+        } else if (is_chunk(buffer, "tRNS")) {
+            hasTRNS = true;
+        }
+        if (!skip_exactly(stream, length + 4)) {
+            return nullptr;
+        }
+    }
+
+    if (!hasIHDR || !width || !height || height > (uint32_t) SK_MaxS32 || interlace ||
+            chunks.empty()) {
+        return nullptr;
+    }
+
+    // Only accept images whose rows SkPngCodec passes through libpng unchanged.
+    int channels;
+    switch (colorType) {
+        case 0: channels = 1; break;  // Gray
+        case 2: channels = 3; break;  // RGB
+        case 3: channels = 1; break;  // Palette
+        case 4: channels = 2; break;  // Gray + alpha
+        case 6: channels = 4; break;  // RGBA
+        default: return nullptr;
+    }
+    const bool sixteenBitColor = 16 == bitDepth && (2 == colorType || 6 == colorType);
+    if ((8 != bitDepth && !sixteenBitColor) || (hasTRNS && 3 != colorType)) {
+        return nullptr;
+    }
+
+    const int bytesPerPixel = channels * bitDepth / 8;
+    if (width > (SIZE_MAX - 1) / bytesPerPixel) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SkPngRowIndex> index(new SkPngRowIndex(height, width * bytesPerPixel,
+                                                           bytesPerPixel));
+    index->fChunks = std::move(chunks);
+    if (!index->scan(stream, rowInterval)) {
+        return nullptr;
+    }
+    return index;
+}
+
+bool SkPngRowIndex::scan(SkStream* stream, int rowInterval) {
+    IdatReader reader(stream, fChunks, 0);
+    RowInflater inflater(fRowBytes, fBytesPerPixel);
+    if (!inflater.valid() || !reader.readZlibHeader()) {
+        return false;
+    }
+
+    int row = 0;
+    int nextCheckpoint = rowInterval;
+    while (row < fHeight) {
+        switch (inflater.next(&reader, true)) {
+            case RowInflater::kRow_Result:
+                row++;
+                break;
+            case RowInflater::kBlockEnd_Result:
+                break;
+            case RowInflater::kError_Result:
+                return false;
+        }
+
+        if (row >= nextCheckpoint && row < fHeight && inflater.atBlockBoundary()) {
+            if (!inflater.save(&fCheckpoints.push_back(), row, reader)) {
+                return false;
+            }
+            nextCheckpoint = row + rowInterval;
+        }
+    }
+    return true;
+}
+
+const SkPngRowIndex::Checkpoint* SkPngRowIndex::find(int row) const {
+    const Checkpoint* begin = fCheckpoints.begin();
+    const Checkpoint* found = std::upper_bound(begin, fCheckpoints.end(), row,
+            [](int row, const Checkpoint& checkpoint) { return row < checkpoint.fRow; });
+    return found == begin ? nullptr : found - 1;
+}
+
+int SkPngRowIndex::startRow(int row) const {
+    const Checkpoint* checkpoint = this->find(row);
+    return checkpoint ? checkpoint->fRow : 0;
+}
+
+bool SkPngRowIndex::decodeRows(SkStream* stream, int firstRow,
+        const std::function<bool(int rowNum, const uint8_t* row)>& rowProc) const {
+    SkASSERT(0 <= firstRow && firstRow < fHeight);
+    const Checkpoint* checkpoint = this->find(firstRow);
+
+    IdatReader reader(stream, fChunks, checkpoint ? checkpoint->fIdatOffset : 0);
+    RowInflater inflater(fRowBytes, fBytesPerPixel);
+    if (!inflater.valid()) {
+        return false;
+    }
+
+    int row = 0;
+    if (checkpoint) {
+        if (!inflater.restore(*checkpoint)) {
+            return false;
+        }
+        row = checkpoint->fRow;
+    } else if (!reader.readZlibHeader()) {
+        return false;
+    }
+
+    for (; row < fHeight; row++) {
+        if (RowInflater::kRow_Result != inflater.next(&reader, false)) {
+            return false;
+        }
+        if (row >= firstRow && !rowProc(row, inflater.completedRow())) {
+            break;
+        }
+    }
+    return true;
+}
+
+size_t SkPngRowIndex::bytesUsed() const {
+    size_t bytes = sizeof(SkPngRowIndex) + fChunks.count() * sizeof(Chunk);
+    for (const Checkpoint& checkpoint : fCheckpoints) {
+        bytes += sizeof(Checkpoint) + checkpoint.fWindowSize + checkpoint.fPartialRowBytes +
+                 fRowBytes;
+    }
+    return bytes;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPngRowIndex_DEFINED
+#define SkPngRowIndex_DEFINED
+
+#include "SkTArray.h"
+#include "SkTypes.h"
+
+#include <functional>
+#include <memory>
+
+class SkStream;
+
+/**
+ *  Restart points into the IDAT data of a non-interlaced PNG, so that rows near the bottom of
+ *  the image can be decoded without inflating every row above them.
+ *
+ *  Building the index inflates and unfilters the whole image once.  At the first deflate block
+ *  boundary after every rowInterval rows, it records a checkpoint: the position in the
+ *  compressed data, the inflater's window, the partly inflated row and the previous unfiltered
+ *  row, which the Up, Average and Paeth filters of the next row refer to.
+ */
+class SkPngRowIndex : SkNoncopyable {
+public:
+    /**
+     *  Scans the PNG at the start of |stream|, which must support seek() and getPosition().
+     *  The stream's position is restored before returning.
+     *
+     *  Returns nullptr if the stream is not seekable, the image is interlaced, the data is
+     *  incomplete or corrupt, or SkPngCodec has libpng transform the rows (bit depths below 8,
+     *  16-bit gray, or tRNS on non-palette images), since the index yields untransformed rows.
+     */
+    static std::unique_ptr<SkPngRowIndex> Make(SkStream* stream, int rowInterval);
+
+    /**
+     *  The row decodeRows() will start inflating from to reach |row|.  Zero if there is no
+     *  checkpoint above it, in which case the index saves nothing.
+     */
+    int startRow(int row) const;
+
+    /**
+     *  Decodes from the last checkpoint at or above |firstRow|, passing each row from firstRow
+     *  on to |rowProc|, in the format libpng would produce, until it returns false or the image
+     *  ends.  Returns false if the data could not be read or inflated.
+     *
+     *  Leaves |stream| at an arbitrary position.
+     */
+    bool decodeRows(SkStream* stream, int firstRow,
+                    const std::function<bool(int rowNum, const uint8_t* row)>& rowProc) const;
+
+    int count() const { return fCheckpoints.count(); }
+    size_t bytesUsed() const;
+
+private:
+    struct Chunk {
+        size_t fStreamOffset;   // Start of the chunk's data in the stream.
+        size_t fLength;
+        size_t fIdatOffset;     // Start of the chunk's data in the concatenated IDAT data.
+    };
+
+    struct Checkpoint {
+        int                        fRow;         // The row being inflated.
+        size_t                     fIdatOffset;  // Next whole byte of compressed data.
+        int                        fBits;        // Bits of the preceding byte still unused.
+        uint8_t                    fPrimeByte;   // That preceding byte, if fBits is non-zero.
+        size_t                     fWindowSize;
+        size_t                     fPartialRowBytes;
+        // The window, then the prefix of fRow, then the unfiltered row above fRow.
+        std::unique_ptr<uint8_t[]> fData;
+    };
+
+    class IdatReader;
+    class RowInflater;
+
+    SkPngRowIndex(int height, size_t rowBytes, int bytesPerPixel)
+        : fHeight(height)
+        , fRowBytes(rowBytes)
+        , fBytesPerPixel(bytesPerPixel)
+    {}
+
+    bool scan(SkStream* stream, int rowInterval);
+    const Checkpoint* find(int row) const;
+
+    const int              fHeight;
+    const size_t           fRowBytes;       // Unfiltered, i.e. without the filter type byte.
+    const int              fBytesPerPixel;
+    SkTArray<Chunk>        fChunks;
+    SkTArray<Checkpoint>   fCheckpoints;
+};
+
+#endif // SkPngRowIndex_DEFINED
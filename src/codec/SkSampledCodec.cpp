@@ -8,6 +8,7 @@
 #include "SkCodec.h"
 #include "SkCodecPriv.h"
 #include "SkMath.h"
+#include "SkResampler.h"
 #include "SkSampledCodec.h"
 #include "SkSampler.h"
 #include "SkTemplates.h"
@@ -349,3 +350,83 @@ SkCodec::Result SkSampledCodec::sampledDecode(const SkImageInfo& info, void* pix
             return SkCodec::kUnimplemented;
     }
 }
+
+SkCodec::Result SkSampledCodec::onGetResizedPixels(const SkPixmap& dst, int sampleSize) {
+    const SkISize sampledSize = this->getSampledDimensions(sampleSize);
+    SkISize nativeSize = this->codec()->getInfo().dimensions();
+    if (sampleSize > 1) {
+        int remainingSampleSize = sampleSize;
+        nativeSize = this->accountForNativeScaling(&remainingSampleSize);
+    }
+    const int sampleX = nativeSize.width() / sampledSize.width();
+    const int sampleY = nativeSize.height() / sampledSize.height();
+
+    SkCodec::Options codecOptions;
+    codecOptions.fPremulBehavior = SkTransferFunctionBehavior::kIgnore;
+    const SkImageInfo nativeInfo = dst.info().makeWH(nativeSize.width(), nativeSize.height());
+    SkCodec::Result result = this->codec()->startScanlineDecode(nativeInfo, &codecOptions,
+                                                                 nullptr, nullptr);
+    if (SkCodec::kUnimplemented == result ||
+            (SkCodec::kSuccess == result &&
+             SkCodec::kTopDown_SkScanlineOrder != this->codec()->getScanlineOrder())) {
+        // Codecs that only decode incrementally (or bottom up) need the whole sampled image.
+        return INHERITED::onGetResizedPixels(dst, sampleSize);
+    }
+    if (SkCodec::kSuccess != result) {
+        return result;
+    }
+
+    if (sampleX > 1) {
+        SkSampler* sampler = this->codec()->getSampler(true);
+        if (!sampler) {
+            return SkCodec::kUnimplemented;
+        }
+        if (sampler->setSampleX(sampleX) != sampledSize.width()) {
+            return SkCodec::kInvalidScale;
+        }
+    }
+    if (get_scaled_dimension(nativeSize.height(), sampleY) != sampledSize.height()) {
+        return SkCodec::kInvalidScale;
+    }
+
+    // Resize each sampled row as soon as it is decoded, so we only hold the rows that the
+    // vertical filter still needs, rather than the whole sampled image.
+    std::unique_ptr<SkResampler> resampler = SkResampler::Make(dst, sampledSize,
+                                                               SkBitmapScaler::RESIZE_MITCHELL);
+    if (!resampler) {
+        return SkCodec::kInvalidScale;
+    }
+
+    const SkImageInfo rowInfo = dst.info().makeWH(sampledSize.width(), 1);
+    SkAutoTMalloc<uint8_t> row(rowInfo.minRowBytes());
+    const int rowsNeeded = SkTMin(resampler->sourceRowsNeeded(), sampledSize.height());
+
+    int y = 0;
+    if (this->codec()->skipScanlines(get_start_coord(sampleY))) {
+        for (; y < rowsNeeded; y++) {
+            if (1 != this->codec()->getScanlines(row.get(), 1, rowInfo.minRowBytes())) {
+                // getScanlines() filled the row.
+                resampler->pushRow(row.get());
+                y++;
+                break;
+            }
+            resampler->pushRow(row.get());
+            if (y < rowsNeeded - 1 && !this->codec()->skipScanlines(sampleY - 1)) {
+                y++;
+                break;
+            }
+        }
+    }
+    if (y == rowsNeeded) {
+        SkASSERT(resampler->isComplete());
+        return SkCodec::kSuccess;
+    }
+
+    const uint64_t fillValue = this->codec()->getFillValue(rowInfo);
+    SkSampler::Fill(rowInfo, row.get(), rowInfo.minRowBytes(), fillValue,
+                    SkCodec::kNo_ZeroInitialized);
+    for (; y < rowsNeeded; y++) {
+        resampler->pushRow(row.get());
+    }
+    return SkCodec::kIncompleteInput;
+}
@@ -30,6 +30,12 @@ protected:
     SkCodec::Result onGetAndroidPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
             const AndroidOptions& options) override;
 
+    /**
+     *  Streams the decoded rows through the resize filters, when fCodec supports top-down
+     *  scanline decoding.
+     */
+    SkCodec::Result onGetResizedPixels(const SkPixmap& dst, int sampleSize) override;
+
 private:
     /**
      *  Find the best way to account for native scaling.
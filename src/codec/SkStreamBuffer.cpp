@@ -12,6 +12,7 @@ SkStreamBuffer::SkStreamBuffer(SkStream* stream)
     , fPosition(0)
     , fBytesBuffered(0)
     , fHasLengthAndPosition(stream->hasLength() && stream->hasPosition())
+    , fMemoryBase(fHasLengthAndPosition ? (const char*) stream->getMemoryBase() : nullptr)
     , fTrulyBuffered(0)
 {}
 
@@ -23,14 +24,23 @@ const char* SkStreamBuffer::get() const {
     SkASSERT(fBytesBuffered >= 1);
     if (fHasLengthAndPosition && fTrulyBuffered < fBytesBuffered) {
         const size_t bytesToBuffer = fBytesBuffered - fTrulyBuffered;
-        char* dst = SkTAddOffset<char>(const_cast<char*>(fBuffer), fTrulyBuffered);
-        SkDEBUGCODE(const size_t bytesRead =)
         // This stream is rewindable, so it should be safe to call the non-const
-        // read()
-        const_cast<SkStream*>(fStream.get())->read(dst, bytesToBuffer);
-        SkASSERT(bytesRead == bytesToBuffer);
+        // read() and move()
+        SkStream* stream = const_cast<SkStream*>(fStream.get());
+        if (fMemoryBase) {
+            // Leave the stream where reading would have, but point into its memory.
+            stream->move(bytesToBuffer);
+        } else {
+            char* dst = SkTAddOffset<char>(const_cast<char*>(fBuffer), fTrulyBuffered);
+            SkDEBUGCODE(const size_t bytesRead =)
+            stream->read(dst, bytesToBuffer);
+            SkASSERT(bytesRead == bytesToBuffer);
+        }
         fTrulyBuffered = fBytesBuffered;
     }
+    if (fMemoryBase) {
+        return fMemoryBase + fStream->getPosition() - fBytesBuffered;
+    }
     return fBuffer;
 }
 
@@ -74,6 +84,10 @@ sk_sp<SkData> SkStreamBuffer::getDataAtPosition(size_t position, size_t length)
 
     SkASSERT(position + length <= fStream->getLength());
 
+    if (fMemoryBase) {
+        return SkData::MakeWithoutCopy(fMemoryBase + position, length);
+    }
+
     const size_t oldPosition = fStream->getPosition();
     if (!fStream->seek(position)) {
         return nullptr;
@@ -21,6 +21,9 @@
  *
  *  Buffers up to 256 * 3 bytes (256 colors, with 3 bytes each) to support GIF.
  *  FIXME (scroggo): Make this more general purpose?
+ *
+ *  If the stream is in memory, nothing is copied: get() and getDataAtPosition()
+ *  point directly into the stream's memory.
  */
 class SkStreamBuffer : SkNoncopyable {
 public:
@@ -84,7 +87,8 @@ public:
      *
      *  @param position Position to retrieve data, as marked by markPosition().
      *  @param length   Amount of data required at position.
-     *  @return SkData The data at position.
+     *  @return SkData The data at position. This may share the stream's memory, so
+     *      it must not outlive this SkStreamBuffer.
      */
     sk_sp<SkData> getDataAtPosition(size_t position, size_t length);
 
@@ -100,6 +104,8 @@ private:
     // - During parsing, we can store the position and size of data that is
     //   needed later during decoding.
     const bool                  fHasLengthAndPosition;
+    // Non-null if the stream's data is in memory, which we can use without buffering.
+    const char* const           fMemoryBase;
     // When fHasLengthAndPosition is true, we do not need to actually buffer
     // inside buffer(). We'll buffer inside get(). This keeps track of how many
     // bytes we've buffered inside get(), for the (non-existent) case of:
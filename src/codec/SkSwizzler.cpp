@@ -622,6 +622,17 @@ static void swizzle_rgba16_to_rgba_premul(
     }
 }
 
+static void fast_swizzle_rgba16_to_rgba_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_rgbA((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgba16_to_bgra_unpremul(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -652,6 +663,17 @@ static void swizzle_rgba16_to_bgra_premul(
     }
 }
 
+static void fast_swizzle_rgba16_to_bgra_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_bgrA((uint32_t*) dst, src + offset, width);
+}
+
 // kCMYK
 //
 // CMYK is stored as four bytes per pixel.
@@ -1040,8 +1062,12 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                 switch (dstInfo.colorType()) {
                     case kRGBA_8888_SkColorType:
                         if (16 == encodedInfo.bitsPerComponent()) {
-                            proc = premultiply ? &swizzle_rgba16_to_rgba_premul :
-                                                 &swizzle_rgba16_to_rgba_unpremul;
+                            if (premultiply) {
+                                proc = &swizzle_rgba16_to_rgba_premul;
+                                fastProc = &fast_swizzle_rgba16_to_rgba_premul;
+                            } else {
+                                proc = &swizzle_rgba16_to_rgba_unpremul;
+                            }
                             break;
                         }
 
@@ -1067,8 +1093,12 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                         break;
                     case kBGRA_8888_SkColorType:
                         if (16 == encodedInfo.bitsPerComponent()) {
-                            proc = premultiply ? &swizzle_rgba16_to_bgra_premul :
-                                                 &swizzle_rgba16_to_bgra_unpremul;
+                            if (premultiply) {
+                                proc = &swizzle_rgba16_to_bgra_premul;
+                                fastProc = &fast_swizzle_rgba16_to_bgra_premul;
+                            } else {
+                                proc = &swizzle_rgba16_to_bgra_unpremul;
+                            }
                             break;
                         }
 
@@ -44,3 +44,10 @@ SkCodec::Result SkWebpAdapterCodec::onGetAndroidPixels(const SkImageInfo& info,
     return this->codec()->getPixels(info, pixels, rowBytes, &codecOptions, options.fColorPtr,
             options.fColorCount);
 }
+
+SkCodec::Result SkWebpAdapterCodec::onGetResizedPixels(const SkPixmap& dst, int) {
+    SkCodec::Options codecOptions;
+    codecOptions.fPremulBehavior = SkTransferFunctionBehavior::kIgnore;
+    return this->codec()->getPixels(dst.info(), dst.writable_addr(), dst.rowBytes(),
+                                    &codecOptions, nullptr, nullptr);
+}
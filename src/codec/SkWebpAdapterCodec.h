@@ -30,6 +30,11 @@ protected:
     SkCodec::Result onGetAndroidPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
             const AndroidOptions& options) override;
 
+    /**
+     *  libwebp scales to any size while decoding, so this needs no extra resize.
+     */
+    SkCodec::Result onGetResizedPixels(const SkPixmap& dst, int sampleSize) override;
+
 private:
 
     typedef SkAndroidCodec INHERITED;
@@ -8,6 +8,7 @@
 #include "SkCodecPriv.h"
 #include "SkColorSpaceXform.h"
 #include "SkSampler.h"
+#include "SkStream.h"
 #include "SkStreamPriv.h"
 #include "SkTemplates.h"
 #include "SkWebpCodec.h"
@@ -41,25 +42,35 @@ SkCodec* SkWebpCodec::NewFromStream(SkStream* stream) {
 
     // Webp demux needs a contiguous data buffer.
     sk_sp<SkData> data = nullptr;
+    std::unique_ptr<SkStream> pendingStream;
     if (stream->getMemoryBase()) {
         // It is safe to make without copy because we'll hold onto the stream.
         data = SkData::MakeWithoutCopy(stream->getMemoryBase(), stream->getLength());
     } else {
         data = SkCopyStreamToData(stream);
 
-        // If we are forced to copy the stream to a data, we can go ahead and delete the stream.
-        streamDeleter.reset(nullptr);
+        // If we are forced to copy the stream to a data, the codec does not need the stream.
+        // We only keep it (below) if the data turns out to be incomplete.
+        pendingStream = std::move(streamDeleter);
     }
 
     // It's a little strange that the |demux| will outlive |webpData|, though it needs the
     // pointer in |webpData| to remain valid.  This works because the pointer remains valid
     // until the SkData is freed.
     WebPData webpData = { data->bytes(), data->size() };
-    SkAutoTCallVProc<WebPDemuxer, WebPDemuxDelete> demux(WebPDemuxPartial(&webpData, nullptr));
+    WebPDemuxState demuxState;
+    SkAutoTCallVProc<WebPDemuxer, WebPDemuxDelete> demux(WebPDemuxPartial(&webpData,
+                                                                           &demuxState));
     if (nullptr == demux) {
         return nullptr;
     }
 
+    // If the copied data is incomplete, hold onto the stream so that an incremental decode
+    // can pick up the rest of the data as it arrives.
+    if (WEBP_DEMUX_DONE == demuxState) {
+        pendingStream.reset(nullptr);
+    }
+
     const int width = WebPDemuxGetI(demux, WEBP_FF_CANVAS_WIDTH);
     const int height = WebPDemuxGetI(demux, WEBP_FF_CANVAS_HEIGHT);
 
@@ -140,7 +151,7 @@ SkCodec* SkWebpCodec::NewFromStream(SkStream* stream) {
     SkEncodedInfo info = SkEncodedInfo::Make(color, alpha, 8);
     SkWebpCodec* codecOut = new SkWebpCodec(width, height, info, std::move(colorSpace),
                                             streamDeleter.release(), demux.release(),
-                                            std::move(data));
+                                            std::move(data), std::move(pendingStream));
     codecOut->setUnsupportedICC(unsupportedICC);
     return codecOut;
 }
@@ -191,25 +202,69 @@ bool SkWebpCodec::onGetValidSubset(SkIRect* desiredSubset) const {
     return true;
 }
 
-SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
-                                         const Options& options, SkPMColor*, int*,
-                                         int* rowsDecodedPtr) {
+struct SkWebpCodec::Decode {
+    Decode()
+        : fIDec(nullptr)
+        , fXformDst(nullptr)
+        , fXformSrc(nullptr)
+        , fXformRowBytes(0)
+        , fXformSrcRowBytes(0)
+        , fXformColorFormat(SkColorSpaceXform::kRGBA_8888_ColorFormat)
+        , fXformAlphaType(kUnknown_SkAlphaType)
+        , fDstY(0)
+        , fScaledWidth(0)
+        , fScaledHeight(0)
+        , fRowsXformed(0)
+    {
+        // WebPFreeDecBuffer() is safe to call on a zeroed buffer.
+        sk_bzero(&fConfig, sizeof(fConfig));
+    }
+
+    ~Decode() {
+        // The decoder must be deleted before its output buffer is freed.
+        fIDec.reset(nullptr);
+        WebPFreeDecBuffer(&fConfig.output);
+    }
+
+    // libwebp holds a pointer to fConfig.output, so a Decode must not move.
+    WebPDecoderConfig                           fConfig;
+
+    // Null if there is nothing to decode (e.g. the frame is outside of the subset).
+    SkAutoTCallVProc<WebPIDecoder, WebPIDelete> fIDec;
+
+    // libwebp decodes into this instead of the dst when the color transform needs a
+    // differently sized pixel.
+    SkAutoTMalloc<uint32_t>                     fPixels;
+
+    // Where the color transform reads and writes the first row of the frame.
+    void*                                       fXformDst;
+    uint32_t*                                   fXformSrc;
+    size_t                                      fXformRowBytes;
+    size_t                                      fXformSrcRowBytes;
+    SkColorSpaceXform::ColorFormat              fXformColorFormat;
+    SkAlphaType                                 fXformAlphaType;
+
+    int                                         fDstY;
+    int                                         fScaledWidth;
+    int                                         fScaledHeight;
+    int                                         fRowsXformed;
+};
+
+SkCodec::Result SkWebpCodec::initDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                        const Options& options, Decode* decode) {
     if (!conversion_possible(dstInfo, this->getInfo()) ||
         !this->initializeColorXform(dstInfo, options.fPremulBehavior))
     {
         return kInvalidConversion;
     }
 
-    WebPDecoderConfig config;
+    WebPDecoderConfig& config = decode->fConfig;
     if (0 == WebPInitDecoderConfig(&config)) {
         // ABI mismatch.
         // FIXME: New enum for this?
         return kInvalidInput;
     }
 
-    // Free any memory associated with the buffer. Must be called last, so we declare it first.
-    SkAutoTCallVProc<WebPDecBuffer, WebPFreeDecBuffer> autoFree(&(config.output));
-
     WebPIterator frame;
     SkAutoTCallVProc<WebPIterator, WebPDemuxReleaseIterator> autoFrame(&frame);
     // If this succeeded in NewFromStream(), it should succeed again here.
@@ -291,6 +346,9 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
         config.options.scaled_height = scaledHeight;
     }
 
+    // libwebp filters lossy images on a second thread, one macroblock row behind the decode.
+    config.options.use_threads = options.fUseThreads ? 1 : 0;
+
     // Swizzling between RGBA and BGRA is zero cost in a color transform.  So when we have a
     // color transform, we should decode to whatever is easiest for libwebp, and then let the
     // color transform swizzle if necessary.
@@ -300,13 +358,12 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
             webp_decode_mode(dstInfo.colorType(), dstInfo.alphaType() == kPremul_SkAlphaType);
     config.output.is_external_memory = 1;
 
-    // We will decode the entire image and then perform the color transform.  libwebp
-    // does not provide a row-by-row API.  This is a shame particularly when we do not want
-    // 8888, since we will need to create another image sized buffer.
-    SkAutoTMalloc<uint32_t> pixels;
+    // libwebp does not provide a row-by-row API, so the rows it finishes are color transformed
+    // as they become available.  This is a shame particularly when we do not want 8888, since
+    // we will need to create another image sized buffer.
     bool needsCopy = this->colorXform() && kRGBA_8888_SkColorType != dstInfo.colorType() &&
                                            kBGRA_8888_SkColorType != dstInfo.colorType();
-    void* webpDst = needsCopy ? pixels.reset(dstInfo.width() * dstInfo.height()) : dst;
+    void* webpDst = needsCopy ? decode->fPixels.reset(dstInfo.width() * dstInfo.height()) : dst;
     size_t webpRowBytes = needsCopy ? dstInfo.width() * sizeof(uint32_t) : rowBytes;
     size_t totalBytes = needsCopy ? webpRowBytes * dstInfo.height()
                                   : dstInfo.getSafeSize(webpRowBytes);
@@ -318,24 +375,51 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
     config.output.u.RGBA.stride = (int) webpRowBytes;
     config.output.u.RGBA.size = totalBytes - offset;
 
-    SkAutoTCallVProc<WebPIDecoder, WebPIDelete> idec(WebPIDecode(nullptr, 0, &config));
-    if (!idec) {
+    decode->fIDec.reset(WebPIDecode(nullptr, 0, &config));
+    if (!decode->fIDec) {
         return kInvalidInput;
     }
 
+    if (this->colorXform()) {
+        decode->fXformDst = SkTAddOffset<void>(dst, dstBpp * dstX + rowBytes * dstY);
+        decode->fXformSrc = (uint32_t*) config.output.u.RGBA.rgba;
+        decode->fXformRowBytes = rowBytes;
+        decode->fXformSrcRowBytes = webpRowBytes;
+        decode->fXformColorFormat = select_xform_format(dstInfo.colorType());
+        decode->fXformAlphaType = select_xform_alpha(dstInfo.alphaType(),
+                                                     this->getInfo().alphaType());
+    }
+    decode->fDstY = dstY;
+    decode->fScaledWidth = scaledWidth;
+    decode->fScaledHeight = scaledHeight;
+    return kSuccess;
+}
+
+SkCodec::Result SkWebpCodec::continueDecode(Decode* decode, int* rowsDecodedPtr) {
+    if (!decode->fIDec) {
+        return kSuccess;
+    }
+
+    WebPIterator frame;
+    SkAutoTCallVProc<WebPIterator, WebPDemuxReleaseIterator> autoFrame(&frame);
+    SkAssertResult(WebPDemuxGetFrame(fDemux, 1, &frame));
+
+    // WebPIUpdate() expects all of the data so far, which may have moved since the last call.
     int rowsDecoded = 0;
     SkCodec::Result result;
-    switch (WebPIUpdate(idec, frame.fragment.bytes, frame.fragment.size)) {
+    switch (WebPIUpdate(decode->fIDec, frame.fragment.bytes, frame.fragment.size)) {
         case VP8_STATUS_OK:
-            rowsDecoded = scaledHeight;
+            rowsDecoded = decode->fScaledHeight;
             result = kSuccess;
             break;
         case VP8_STATUS_SUSPENDED:
-            if (!WebPIDecGetRGB(idec, &rowsDecoded, nullptr, nullptr, nullptr)
-                    || rowsDecoded <= 0) {
-                return kInvalidInput;
+            // This fails if libwebp has not yet read enough to allocate its output.
+            if (!WebPIDecGetRGB(decode->fIDec, &rowsDecoded, nullptr, nullptr, nullptr)) {
+                rowsDecoded = 0;
+            }
+            if (rowsDecodedPtr) {
+                *rowsDecodedPtr = rowsDecoded + decode->fDstY;
             }
-            *rowsDecodedPtr = rowsDecoded + dstY;
             result = kIncompleteInput;
             break;
         default:
@@ -343,29 +427,120 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
     }
 
     if (this->colorXform()) {
-        SkColorSpaceXform::ColorFormat dstColorFormat = select_xform_format(dstInfo.colorType());
-        SkAlphaType xformAlphaType = select_xform_alpha(dstInfo.alphaType(),
-                                                        this->getInfo().alphaType());
-
-        uint32_t* xformSrc = (uint32_t*) config.output.u.RGBA.rgba;
-        void* xformDst = SkTAddOffset<void>(dst, dstBpp * dstX + rowBytes * dstY);
-        size_t srcRowBytes = config.output.u.RGBA.stride;
-        for (int y = 0; y < rowsDecoded; y++) {
-            SkAssertResult(this->colorXform()->apply(dstColorFormat, xformDst,
-                    SkColorSpaceXform::kBGRA_8888_ColorFormat, xformSrc, scaledWidth,
-                    xformAlphaType));
-            xformDst = SkTAddOffset<void>(xformDst, rowBytes);
-            xformSrc = SkTAddOffset<uint32_t>(xformSrc, srcRowBytes);
+        void* xformDst = SkTAddOffset<void>(decode->fXformDst,
+                                            decode->fXformRowBytes * decode->fRowsXformed);
+        uint32_t* xformSrc = SkTAddOffset<uint32_t>(
+                decode->fXformSrc, decode->fXformSrcRowBytes * decode->fRowsXformed);
+        for (int y = decode->fRowsXformed; y < rowsDecoded; y++) {
+            SkAssertResult(this->colorXform()->apply(decode->fXformColorFormat, xformDst,
+                    SkColorSpaceXform::kBGRA_8888_ColorFormat, xformSrc, decode->fScaledWidth,
+                    decode->fXformAlphaType));
+            xformDst = SkTAddOffset<void>(xformDst, decode->fXformRowBytes);
+            xformSrc = SkTAddOffset<uint32_t>(xformSrc, decode->fXformSrcRowBytes);
+        }
+    }
+    decode->fRowsXformed = SkTMax(decode->fRowsXformed, rowsDecoded);
+
+    return result;
+}
+
+bool SkWebpCodec::readMoreData() {
+    if (!fPendingStream) {
+        return false;
+    }
+
+    SkDynamicMemoryWStream newData;
+    char buffer[4096];
+    size_t bytesRead;
+    do {
+        bytesRead = fPendingStream->read(buffer, sizeof(buffer));
+        newData.write(buffer, bytesRead);
+    } while (bytesRead > 0);
+
+    if (0 == newData.bytesWritten()) {
+        return false;
+    }
+
+    const size_t oldSize = fData->size();
+    sk_sp<SkData> data = SkData::MakeUninitialized(oldSize + newData.bytesWritten());
+    memcpy(data->writable_data(), fData->data(), oldSize);
+    newData.copyTo(SkTAddOffset<void>(data->writable_data(), oldSize));
+
+    WebPData webpData = { data->bytes(), data->size() };
+    WebPDemuxState demuxState;
+    WebPDemuxer* demux = WebPDemuxPartial(&webpData, &demuxState);
+    if (!demux) {
+        return false;
+    }
+
+    // Replace the demuxer before the data it points into.
+    fDemux.reset(demux);
+    fData = std::move(data);
+    if (WEBP_DEMUX_DONE == demuxState) {
+        fPendingStream.reset(nullptr);
+    }
+    return true;
+}
+
+SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                         const Options& options, SkPMColor*, int*,
+                                         int* rowsDecodedPtr) {
+    this->readMoreData();
+
+    Decode decode;
+    SkCodec::Result result = this->initDecode(dstInfo, dst, rowBytes, options, &decode);
+    if (kSuccess != result) {
+        return result;
+    }
+
+    result = this->continueDecode(&decode, rowsDecodedPtr);
+    if (kIncompleteInput == result && 0 == decode.fRowsXformed) {
+        // Without any rows, there is nothing worth drawing.
+        return kInvalidInput;
+    }
+    return result;
+}
+
+SkCodec::Result SkWebpCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+        size_t rowBytes, const SkCodec::Options& options, SkPMColor*, int*) {
+    // Unlike getPixels(), SkCodec does not check that we can decode this exact subset.
+    if (options.fSubset) {
+        SkIRect subset = *options.fSubset;
+        if (!this->getValidSubset(&subset) || subset != *options.fSubset) {
+            return kInvalidParameters;
         }
     }
 
+    std::unique_ptr<Decode> decode(new Decode);
+    const SkCodec::Result result = this->initDecode(dstInfo, dst, rowBytes, options,
+                                                    decode.get());
+    if (kSuccess != result) {
+        fIncrementalDecode.reset(nullptr);
+        return result;
+    }
+
+    fIncrementalDecode = std::move(decode);
+    return kSuccess;
+}
+
+SkCodec::Result SkWebpCodec::onIncrementalDecode(int* rowsDecoded) {
+    SkASSERT(fIncrementalDecode);
+    this->readMoreData();
+
+    const SkCodec::Result result = this->continueDecode(fIncrementalDecode.get(), rowsDecoded);
+    if (kIncompleteInput != result) {
+        fIncrementalDecode.reset(nullptr);
+    }
     return result;
 }
 
 SkWebpCodec::SkWebpCodec(int width, int height, const SkEncodedInfo& info,
                          sk_sp<SkColorSpace> colorSpace, SkStream* stream, WebPDemuxer* demux,
-                         sk_sp<SkData> data)
+                         sk_sp<SkData> data, std::unique_ptr<SkStream> pendingStream)
     : INHERITED(width, height, info, stream, std::move(colorSpace))
     , fDemux(demux)
     , fData(std::move(data))
+    , fPendingStream(std::move(pendingStream))
 {}
+
+SkWebpCodec::~SkWebpCodec() {}
@@ -27,6 +27,8 @@ public:
     // Assumes IsWebp was called and returned true.
     static SkCodec* NewFromStream(SkStream*);
     static bool IsWebp(const void*, size_t);
+
+    ~SkWebpCodec() override;
 protected:
     Result onGetPixels(const SkImageInfo&, void*, size_t, const Options&, SkPMColor*, int*, int*)
             override;
@@ -37,9 +39,35 @@ protected:
     bool onDimensionsSupported(const SkISize&) override;
 
     bool onGetValidSubset(SkIRect* /* desiredSubset */) const override;
+
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+            const SkCodec::Options&, SkPMColor*, int*) override;
+
+    Result onIncrementalDecode(int*) override;
 private:
     SkWebpCodec(int width, int height, const SkEncodedInfo&, sk_sp<SkColorSpace>, SkStream*,
-                WebPDemuxer*, sk_sp<SkData>);
+                WebPDemuxer*, sk_sp<SkData>, std::unique_ptr<SkStream> pendingStream);
+
+    // The state of one decode into a dst, defined in SkWebpCodec.cpp.
+    struct Decode;
+
+    /*
+     *  Sets up |decode| to decode the first frame into |dst|.
+     */
+    Result initDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, const Options&,
+                      Decode* decode);
+
+    /*
+     *  Passes all of the data we have to |decode|'s decoder, and color transforms any rows
+     *  that it finished.  On kIncompleteInput, sets |rowsDecoded| (if not null).
+     */
+    Result continueDecode(Decode* decode, int* rowsDecoded);
+
+    /*
+     *  If the encoded data was incomplete when we copied it out of the stream, appends
+     *  whatever has arrived since and demuxes it again.  Returns true if there is new data.
+     */
+    bool readMoreData();
 
     SkAutoTCallVProc<WebPDemuxer, WebPDemuxDelete> fDemux;
 
@@ -47,6 +75,12 @@ private:
     // This should not be freed until the decode is completed.
     sk_sp<SkData> fData;
 
+    // Only set if the stream had to be copied to fData and the data was incomplete.
+    std::unique_ptr<SkStream> fPendingStream;
+
+    // Set up by onStartIncrementalDecode(), and continued by each onIncrementalDecode().
+    std::unique_ptr<Decode> fIncrementalDecode;
+
     typedef SkCodec INHERITED;
 };
 #endif // SkWebpCodec_DEFINED
@@ -143,6 +143,7 @@ private:
     friend class SkDrawIter;
     friend class SkDeviceFilteredPaint;
     friend class SkSurface_Raster;
+    friend class SkThreadedBMPDevice;    // for fBitmap and fRCStack
 
     class BDDraw;
 
@@ -253,3 +253,12 @@ bool SkBitmapScaler::Resize(SkBitmap* resultPtr, const SkPixmap& source, ResizeM
     SkASSERT(resultPtr->getPixels());
     return true;
 }
+
+void SkBitmapScaler::ComputeFilters(ResizeMethod method, const SkISize& srcSize,
+                                    const SkISize& dstSize, SkConvolutionFilter1D* xFilter,
+                                    SkConvolutionFilter1D* yFilter) {
+    SkResizeFilter filter(method, srcSize.width(), srcSize.height(),
+                          dstSize.width(), dstSize.height(), SkRect::Make(dstSize));
+    *xFilter = filter.xFilter();
+    *yFilter = filter.yFilter();
+}
@@ -41,6 +41,13 @@ public:
      */
     static bool Resize(SkBitmap* result, const SkPixmap& src, ResizeMethod method,
                        int dest_width, int dest_height, SkBitmap::Allocator* = nullptr);
+
+    /**
+     *  Computes the filters that Resize() would use to scale an image of srcSize to dstSize,
+     *  e.g. for SkResampler.
+     */
+    static void ComputeFilters(ResizeMethod method, const SkISize& srcSize, const SkISize& dstSize,
+                               SkConvolutionFilter1D* xFilter, SkConvolutionFilter1D* yFilter);
 };
 
 #endif
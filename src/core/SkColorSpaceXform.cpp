@@ -1064,6 +1064,20 @@ bool SkColorSpaceXform_XYZ<kCSM>
                 return true;
             }
         }
+
+        // With linear gamma and no gamut change, 16-bit sources only need widening to F16.
+        if (kRGBA_F16_ColorFormat == dstColorFormat && kLinear_SrcGamma == fSrcGamma) {
+            if (kRGBA_U16_BE_ColorFormat == srcColorFormat) {
+                auto proc = kPremul_SkAlphaType == alphaType ? SkOpts::RGBA16_to_F16_premul
+                                                             : SkOpts::RGBA16_to_F16;
+                proc((uint64_t*) dst, src, len);
+                return true;
+            }
+            if (kRGB_U16_BE_ColorFormat == srcColorFormat) {
+                SkOpts::RGB16_to_F16((uint64_t*) dst, src, len);
+                return true;
+            }
+        }
     }
 
     if (kRGBA_F32_ColorFormat == dstColorFormat ||
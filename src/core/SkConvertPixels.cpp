@@ -366,13 +366,14 @@ static void convert_with_pipeline(const SkImageInfo& dstInfo, void* dstRow, size
             break;
     }
 
-    for (int y = 0; y < srcInfo.height(); ++y) {
-        pipeline.run(0,srcInfo.width());
-        // The pipeline has pointers to srcRow and dstRow, so we just need to update them in the
-        // loop to move between rows of src/dst.
-        dstRow = SkTAddOffset<void>(dstRow, dstRB);
-        srcRow = SkTAddOffset<const void>(srcRow, srcRB);
-    }
+    // The pipeline has pointers to srcRow and dstRow, so we just need to update them
+    // to move between rows of src/dst.
+    void* const       dstTop = dstRow;
+    const void* const srcTop = srcRow;
+    pipeline.run_2d(0,0, srcInfo.width(), srcInfo.height(), [&](size_t y) {
+        dstRow = SkTAddOffset<void>      (dstTop, y * dstRB);
+        srcRow = SkTAddOffset<const void>(srcTop, y * srcRB);
+    });
 }
 
 void SkConvertPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRB,
@@ -11,14 +11,17 @@
 #include "SkArenaAlloc.h"
 #include "SkBlendModePriv.h"
 #include "SkBlitter.h"
+#include "SkCachedData.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
 #include "SkColorShader.h"
 #include "SkDevice.h"
 #include "SkDeviceLooper.h"
+#include "SkExecutor.h"
 #include "SkFindAndPlaceGlyph.h"
 #include "SkFixed.h"
 #include "SkLocalMatrixShader.h"
+#include "SkMaskCache.h"
 #include "SkMaskFilter.h"
 #include "SkMatrix.h"
 #include "SkPaint.h"
@@ -48,6 +51,110 @@
 // See SkFindAndPlaceGlyph.h for more details.
 void FixGCC49Arm64Bug(int v) { }
 
+// Keeps a blitter inside an SkDraw's fBlitterClip.  Callers write straight to the pixels of a
+// blitter that is just an opaque color, so this one never claims to be.
+class SkBlitterClipBlitter : public SkRectClipBlitter {
+public:
+    // paint is the one blitter was chosen for, with dst and matrix.  Without it, pairs of pixels
+    // that straddle the clip are split into blitAntiH() calls.
+    SkBlitterClipBlitter(SkBlitter* blitter, const SkIRect& clip, const SkPixmap& dst,
+                         const SkMatrix& matrix, const SkPaint* paint, bool drawCoverage)
+        : fRealBlitter(blitter)
+        , fClip(clip)
+        , fDst(dst)
+        , fMatrix(matrix)
+        , fPaint(paint)
+        , fDrawCoverage(drawCoverage) {
+        this->init(blitter, clip);
+    }
+
+    void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override {
+        if (y < fClip.fTop || y >= fClip.fBottom) {
+            return;
+        }
+        const bool in0 = x     >= fClip.fLeft && x     < fClip.fRight;
+        const bool in1 = x + 1 >= fClip.fLeft && x + 1 < fClip.fRight;
+        if (in0 && in1) {
+            fRealBlitter->blitAntiH2(x, y, a0, a1);
+        } else if (in0 || in1) {
+            this->blitStraddlingPair(x, y, 1, 0, a0, a1, in0);
+        }
+    }
+
+    void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override {
+        if (x < fClip.fLeft || x >= fClip.fRight) {
+            return;
+        }
+        const bool in0 = y     >= fClip.fTop && y     < fClip.fBottom;
+        const bool in1 = y + 1 >= fClip.fTop && y + 1 < fClip.fBottom;
+        if (in0 && in1) {
+            fRealBlitter->blitAntiV2(x, y, a0, a1);
+        } else if (in0 || in1) {
+            this->blitStraddlingPair(x, y, 0, 1, a0, a1, in0);
+        }
+    }
+
+    const SkPixmap* justAnOpaqueColor(uint32_t*) override { return nullptr; }
+
+private:
+    // The pair (x, y), (x + dx, y + dy) has one pixel inside the clip, the first if in0.
+    // Solid color blitters may blend a pair differently than they blitAntiH() its pixels, so for
+    // those we blit the whole pair, with a blitter chosen just like the real one, into a scratch
+    // copy of the pixels, and copy back only the one inside.  The scratch pixels start at a
+    // multiple of 8, so that blitters which dither see the same pattern.  Shaders don't blit
+    // pairs any differently, so blitAntiH() on the real blitter matches them exactly.
+    void blitStraddlingPair(int x, int y, int dx, int dy, U8CPU a0, U8CPU a1, bool in0) {
+        const int insideX = in0 ? x : x + dx;
+        const int insideY = in0 ? y : y + dy;
+        if (!fPaint || fPaint->getShader()) {
+            int16_t runs[2] = { 1, 0 };
+            uint8_t aa[1] = { SkToU8(in0 ? a0 : a1) };
+            fRealBlitter->blitAntiH(insideX, insideY, aa, runs);
+            return;
+        }
+
+        const int left = x & ~7;
+        const int top = y & ~7;
+        const SkImageInfo info = fDst.info().makeWH(x - left + 2, y - top + 2);
+        uint64_t pixels[9 * 9];     // Up to 9x9 pixels of at most 8 bytes each.
+        SkASSERT(info.getSafeSize(info.minRowBytes()) <= sizeof(pixels));
+        SkPixmap scratch(info, pixels, info.minRowBytes());
+        sk_bzero(pixels, sizeof(pixels));
+
+        const size_t bpp = info.bytesPerPixel();
+        void* scratchPixel = scratch.writable_addr(insideX - left, insideY - top);
+        memcpy(scratchPixel, fDst.addr(insideX, insideY), bpp);
+
+        SkMatrix matrix = fMatrix;
+        matrix.postTranslate(SkIntToScalar(-left), SkIntToScalar(-top));
+        char storage[kSkBlitterContextSize];
+        SkArenaAlloc alloc{storage};
+        SkBlitter* blitter = SkBlitter::Choose(scratch, matrix, *fPaint, &alloc, fDrawCoverage);
+        if (dx) {
+            blitter->blitAntiH2(x - left, y - top, a0, a1);
+        } else {
+            blitter->blitAntiV2(x - left, y - top, a0, a1);
+        }
+        memcpy(fDst.writable_addr(insideX, insideY), scratchPixel, bpp);
+    }
+
+    SkBlitter*      fRealBlitter;
+    SkIRect         fClip;
+    SkPixmap        fDst;
+    SkMatrix        fMatrix;
+    const SkPaint*  fPaint;
+    bool            fDrawCoverage;
+};
+
+static SkBlitter* clip_blitter(SkBlitter* blitter, const SkIRect* clip, SkArenaAlloc* alloc,
+                               const SkPixmap& dst, const SkMatrix& matrix = SkMatrix::I(),
+                               const SkPaint* paint = nullptr, bool drawCoverage = false) {
+    if (!clip || clip->isEmpty()) {
+        return blitter;
+    }
+    return alloc->make<SkBlitterClipBlitter>(blitter, *clip, dst, matrix, paint, drawCoverage);
+}
+
 /** Helper for allocating small blitters on the stack.
  */
 class SkAutoBlitterChoose : SkNoncopyable {
@@ -55,18 +162,23 @@ public:
     SkAutoBlitterChoose() {
         fBlitter = nullptr;
     }
-    SkAutoBlitterChoose(const SkPixmap& dst, const SkMatrix& matrix,
-                        const SkPaint& paint, bool drawCoverage = false) {
-        fBlitter = SkBlitter::Choose(dst, matrix, paint, &fAlloc, drawCoverage);
+    SkAutoBlitterChoose(const SkDraw& draw, const SkPaint& paint, bool drawCoverage = false) {
+        fBlitter = nullptr;
+        this->choose(draw, paint, drawCoverage);
     }
 
     SkBlitter*  operator->() { return fBlitter; }
     SkBlitter*  get() const { return fBlitter; }
 
-    void choose(const SkPixmap& dst, const SkMatrix& matrix,
-                const SkPaint& paint, bool drawCoverage = false) {
+    void choose(const SkDraw& draw, const SkPaint& paint, bool drawCoverage = false) {
+        this->choose(draw.fDst, *draw.fMatrix, paint, drawCoverage, draw.fBlitterClip);
+    }
+
+    void choose(const SkPixmap& dst, const SkMatrix& matrix, const SkPaint& paint,
+                bool drawCoverage, const SkIRect* clip) {
         SkASSERT(!fBlitter);
-        fBlitter = SkBlitter::Choose(dst, matrix, paint, &fAlloc, drawCoverage);
+        fBlitter = clip_blitter(SkBlitter::Choose(dst, matrix, paint, &fAlloc, drawCoverage),
+                                clip, &fAlloc, dst, matrix, &paint, drawCoverage);
     }
 
 private:
@@ -252,7 +364,10 @@ void SkDraw::drawPaint(const SkPaint& paint) const {
 
             SkRegion::Iterator iter(fRC->bwRgn());
             while (!iter.done()) {
-                CallBitmapXferProc(fDst, iter.rect(), proc, procData);
+                SkIRect rect = iter.rect();
+                if (!fBlitterClip || rect.intersect(*fBlitterClip)) {
+                    CallBitmapXferProc(fDst, rect, proc, procData);
+                }
                 iter.next();
             }
             return;
@@ -260,7 +375,7 @@ void SkDraw::drawPaint(const SkPaint& paint) const {
     }
 
     // normal case: use a blitter
-    SkAutoBlitterChoose blitter(fDst, *fMatrix, paint);
+    SkAutoBlitterChoose blitter(*this, paint);
     SkScan::FillIRect(devRect, *fRC, blitter.get());
 }
 
@@ -534,7 +649,7 @@ void SkDraw::drawPoints(SkCanvas::PointMode mode, size_t count,
 
     PtProcRec rec;
     if (!device && rec.init(mode, paint, fMatrix, fRC)) {
-        SkAutoBlitterChoose blitter(fDst, *fMatrix, paint);
+        SkAutoBlitterChoose blitter(*this, paint);
 
         SkPoint             devPts[MAX_DEV_PTS];
         const SkMatrix*     matrix = fMatrix;
@@ -832,7 +947,16 @@ void SkDraw::drawRect(const SkRect& prePaintRect, const SkPaint& paint,
         SkMatrix localMatrix;
         looper.mapMatrix(&localMatrix, *matrix);
 
-        SkAutoBlitterChoose blitterStorage(looper.getPixmap(), localMatrix, paint);
+        SkIRect localBlitterClip;
+        if (fBlitterClip) {
+            SkRect clip;
+            looper.mapRect(&clip, SkRect::Make(*fBlitterClip));
+            localBlitterClip = clip.round();
+        }
+
+        SkAutoBlitterChoose blitterStorage;
+        blitterStorage.choose(looper.getPixmap(), localMatrix, paint, false,
+                              fBlitterClip ? &localBlitterClip : nullptr);
         const SkRasterClip& clip = looper.getRC();
         SkBlitter*          blitter = blitterStorage.get();
 
@@ -881,7 +1005,7 @@ void SkDraw::drawDevMask(const SkMask& srcM, const SkPaint& paint) const {
     }
     SkAutoMaskFreeImage ami(dstM.fImage);
 
-    SkAutoBlitterChoose blitterChooser(fDst, *fMatrix, paint);
+    SkAutoBlitterChoose blitterChooser(*this, paint);
     SkBlitter* blitter = blitterChooser.get();
 
     SkAAClipBlitterWrapper wrapper;
@@ -959,7 +1083,7 @@ void SkDraw::drawRRect(const SkRRect& rrect, const SkPaint& paint) const {
         // Transform the rrect into device space.
         SkRRect devRRect;
         if (rrect.transform(*fMatrix, &devRRect)) {
-            SkAutoBlitterChoose blitter(fDst, *fMatrix, paint);
+            SkAutoBlitterChoose blitter(*this, paint);
             if (paint.getMaskFilter()->filterRRect(devRRect, *fMatrix, *fRC, blitter.get())) {
                 return; // filterRRect() called the blitter, so we're done
             }
@@ -1010,10 +1134,23 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
         }
     }
 
+    // Huge fills may be split into bands on the default executor, each with a blitter of its own.
+    // Tiles are already drawn concurrently, so they don't band their fills again.
+    if (doFill && nullptr == customBlitter && nullptr == fBlitterClip && !paint.getMaskFilter() &&
+            gSkUseBandedFill.load()) {
+        auto makeBlitter = [&](SkArenaAlloc* alloc) {
+            return SkBlitter::Choose(fDst, *fMatrix, paint, alloc, drawCoverage);
+        };
+        if (SkScan::FillPathInBands(devPath, *fRC, paint.isAntiAlias(), makeBlitter,
+                                    &SkExecutor::GetDefault())) {
+            return;
+        }
+    }
+
     SkBlitter* blitter = nullptr;
     SkAutoBlitterChoose blitterStorage;
     if (nullptr == customBlitter) {
-        blitterStorage.choose(fDst, *fMatrix, paint, drawCoverage);
+        blitterStorage.choose(*this, paint, drawCoverage);
         blitter = blitterStorage.get();
     } else {
         blitter = customBlitter;
@@ -1027,6 +1164,13 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
         }
     }
 
+    // A tile's blitter only writes the tile, so only the tile's rows of a fill are scan converted.
+    if (doFill && nullptr == customBlitter && fBlitterClip &&
+            SkScan::FillPathRows(devPath, *fRC, paint.isAntiAlias(), fBlitterClip->fTop,
+                                 fBlitterClip->fBottom, blitter)) {
+        return;
+    }
+
     void (*proc)(const SkPath&, const SkRasterClip&, SkBlitter*);
     if (doFill) {
         if (paint.isAntiAlias()) {
@@ -1154,6 +1298,13 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         return;
     }
 
+    // A path the caller keeps (i.e. not one of our temporaries, or one it lets us mutate) may
+    // be drawn again, so it is worth caching its coverage.
+    if (doFill && pathPtr == &origSrcPath && !pathIsMutable && !drawCoverage && !customBlitter &&
+            this->drawCachedPath(origSrcPath, *paint, *matrix)) {
+        return;
+    }
+
     // avoid possibly allocating a new path in transform if we can
     SkPath* devPathPtr = pathIsMutable ? pathPtr : &tmpPath;
 
@@ -1304,7 +1455,7 @@ void SkDraw::drawBitmap(const SkBitmap& bitmap, const SkMatrix& prematrix,
             SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, *paint, pmap, ix, iy, &allocator);
             if (blitter) {
                 SkScan::FillIRect(SkIRect::MakeXYWH(ix, iy, pmap.width(), pmap.height()),
-                                  *fRC, blitter);
+                                  *fRC, clip_blitter(blitter, fBlitterClip, &allocator, fDst));
                 return;
             }
             // if !blitter, then we fall-through to the slower case
@@ -1360,7 +1511,7 @@ void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& ori
         SkArenaAlloc allocator{storage};
         SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, paint, pmap, x, y, &allocator);
         if (blitter) {
-            SkScan::FillIRect(bounds, *fRC, blitter);
+            SkScan::FillIRect(bounds, *fRC, clip_blitter(blitter, fBlitterClip, &allocator, fDst));
             return;
         }
     }
@@ -1579,7 +1730,7 @@ void SkDraw::drawText(const char text[], size_t byteLength, SkScalar x, SkScalar
     SkAutoGlyphCache cache(paint, props, this->scalerContextFlags(), fMatrix);
 
     // The Blitter Choose needs to be live while using the blitter below.
-    SkAutoBlitterChoose    blitterChooser(fDst, *fMatrix, paint);
+    SkAutoBlitterChoose    blitterChooser(*this, paint);
     SkAAClipBlitterWrapper wrapper(*fRC, blitterChooser.get());
     DrawOneGlyph           drawOneGlyph(*this, paint, cache.get(), wrapper.getBlitter());
 
@@ -1657,7 +1808,7 @@ void SkDraw::drawPosText(const char text[], size_t byteLength, const SkScalar po
     SkAutoGlyphCache cache(paint, props, this->scalerContextFlags(), fMatrix);
 
     // The Blitter Choose needs to be live while using the blitter below.
-    SkAutoBlitterChoose    blitterChooser(fDst, *fMatrix, paint);
+    SkAutoBlitterChoose    blitterChooser(*this, paint);
     SkAAClipBlitterWrapper wrapper(*fRC, blitterChooser.get());
     DrawOneGlyph           drawOneGlyph(*this, paint, cache.get(), wrapper.getBlitter());
     SkPaint::Align         textAlignment = paint.getTextAlign();
@@ -1996,7 +2147,7 @@ void SkDraw::drawVertices(SkCanvas::VertexMode vmode, int count,
         }
     }
 
-    SkAutoBlitterChoose blitter(fDst, *fMatrix, p);
+    SkAutoBlitterChoose blitter(*this, p);
     // Abort early if we failed to create a shader context.
     if (blitter->isNullBlitter()) {
         return;
@@ -2033,7 +2184,7 @@ void SkDraw::drawVertices(SkCanvas::VertexMode vmode, int count,
                         ? alloc.makeSkSp<SkComposeShader>(triShader, std::move(texShader), bmode)
                         : std::move(texShader));
 
-                    blitterPtr = alloc.make<SkAutoBlitterChoose>(fDst, *fMatrix, localPaint)->get();
+                    blitterPtr = alloc.make<SkAutoBlitterChoose>(*this, localPaint)->get();
                     if (blitterPtr->isNullBlitter()) {
                         continue;
                     }
@@ -2130,12 +2281,16 @@ static bool compute_bounds(const SkPath& devPath, const SkIRect* clipBounds,
 }
 
 static void draw_into_mask(const SkMask& mask, const SkPath& devPath,
-                           SkStrokeRec::InitStyle style) {
+                           SkStrokeRec::InitStyle style, bool antiAlias = true) {
     SkDraw draw;
     if (!draw.fDst.reset(mask)) {
         return;
     }
 
+    // Masks are not themselves drawn through the path mask cache.
+    SkPath path(devPath);
+    path.setIsVolatile(true);
+
     SkRasterClip    clip;
     SkMatrix        matrix;
     SkPaint         paint;
@@ -2146,7 +2301,7 @@ static void draw_into_mask(const SkMask& mask, const SkPath& devPath,
 
     draw.fRC        = &clip;
     draw.fMatrix    = &matrix;
-    paint.setAntiAlias(true);
+    paint.setAntiAlias(antiAlias);
     switch (style) {
         case SkStrokeRec::kHairline_InitStyle:
             SkASSERT(!paint.getStrokeWidth());
@@ -2157,7 +2312,7 @@ static void draw_into_mask(const SkMask& mask, const SkPath& devPath,
             break;
 
     }
-    draw.drawPath(devPath, paint);
+    draw.drawPath(path, paint);
 }
 
 bool SkDraw::DrawToMask(const SkPath& devPath, const SkIRect* clipBounds,
@@ -2187,3 +2342,72 @@ bool SkDraw::DrawToMask(const SkPath& devPath, const SkIRect* clipBounds,
 
     return true;
 }
+
+// Beyond this translation, whole pixels no longer fit in an int, and floats have no subpixels.
+static constexpr SkScalar kMaxCachedPathMaskTranslate = 1 << 22;
+
+// Draws a filled path by blitting its cached coverage mask, rendering and caching the mask the
+// second time the path is drawn.  Returns false if the path should be drawn as usual.
+//
+// Where the clip cuts a path, scan conversion chops its edges at the clip and the mask does not,
+// so only paths inside a rectangular clip are drawn from their masks.  Even then a mask blit
+// rounds its blend a little differently than scan conversion's run blits, so anti-aliased edges
+// may be off by a unit.  A threaded device's tiles skip the cache, rather than each render the
+// same whole mask at once.
+bool SkDraw::drawCachedPath(const SkPath& path, const SkPaint& paint,
+                            const SkMatrix& matrix) const {
+    if (path.isVolatile() || path.isInverseFillType() || path.isEmpty() ||
+            matrix.hasPerspective() || paint.getMaskFilter() || fBlitterClip ||
+            !fRC->isBW() || !fRC->isRect() ||
+            !(SkScalarAbs(matrix.getTranslateX()) < kMaxCachedPathMaskTranslate) ||
+            !(SkScalarAbs(matrix.getTranslateY()) < kMaxCachedPathMaskTranslate)) {
+        return false;
+    }
+    const size_t maxBytes = SkMaskCache::GetPathMaskSingleAllocationByteLimit();
+    if (0 == maxBytes) {
+        return false;
+    }
+
+    // Outset for any pixels scan conversion may clip that the mask leaves blank.
+    auto clipContains = [this](const SkIRect& bounds) {
+        return fRC->getBounds().contains(bounds.makeOutset(1, 1));
+    };
+
+    const bool aa = paint.isAntiAlias();
+    SkMask mask;
+    bool seenBefore;
+    SkCachedData* data = SkMaskCache::FindAndRef(path, matrix, aa, &mask, &seenBefore);
+    if (data && !clipContains(mask.fBounds)) {
+        data->unref();
+        return false;
+    }
+    if (!data) {
+        if (!seenBefore) {
+            return false;
+        }
+
+        SkPath devPath;
+        path.transform(matrix, &devPath);
+        if (!devPath.isFinite() ||
+                !compute_bounds(devPath, nullptr, nullptr, nullptr, &mask.fBounds) ||
+                !clipContains(mask.fBounds)) {
+            return false;
+        }
+        mask.fFormat = SkMask::kA8_Format;
+        mask.fRowBytes = mask.fBounds.width();
+        const size_t size = mask.computeImageSize();
+        if (0 == size || size > maxBytes) {
+            return false;
+        }
+
+        data = new SkCachedData(sk_malloc_throw(size), size);
+        mask.fImage = (uint8_t*)data->writable_data();
+        memset(mask.fImage, 0, size);
+        draw_into_mask(mask, devPath, SkStrokeRec::kFill_InitStyle, aa);
+        SkMaskCache::Add(path, matrix, aa, mask, data);
+    }
+
+    this->drawDevMask(mask, paint);
+    data->unref();
+    return true;
+}
@@ -129,6 +129,7 @@ private:
                      SkBlitter* customBlitter = NULL) const;
 
     void drawLine(const SkPoint[2], const SkPaint&) const;
+    bool drawCachedPath(const SkPath& path, const SkPaint& paint, const SkMatrix& matrix) const;
     void drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawCoverage,
                      SkBlitter* customBlitter, bool doFill) const;
     /**
@@ -149,6 +150,9 @@ public:
     SkPixmap        fDst;
     const SkMatrix* fMatrix;        // required
     const SkRasterClip* fRC;        // required
+    // If not null, only pixels inside these bounds are written.  Unlike fRC, this does not
+    // change how anything is rasterized, so tiles drawn with it match one untiled draw exactly.
+    const SkIRect*  fBlitterClip;
 
 #ifdef SK_DEBUG
     void validate() const;
@@ -11,8 +11,11 @@
 #include "SkSemaphore.h"
 #include "SkSpinlock.h"
 #include "SkTArray.h"
+#include "SkTLS.h"
 #include "SkThreadUtils.h"
 
+#include <atomic>
+
 #if defined(_MSC_VER)
     #include <windows.h>
     static int num_cores() {
@@ -29,11 +32,22 @@
 
 SkExecutor::~SkExecutor() {}
 
+void SkExecutor::batch(int N, std::function<void(int)> fn) {
+    for (int i = 0; i < N; i++) {
+        this->add([=] { fn(i); });
+    }
+}
+
 // The default default SkExecutor is an SkTrivialExecutor, which just runs the work right away.
 class SkTrivialExecutor final : public SkExecutor {
     void add(std::function<void(void)> work) override {
         work();
     }
+    void batch(int N, std::function<void(int)> fn) override {
+        for (int i = 0; i < N; i++) {
+            fn(i);
+        }
+    }
 };
 
 static SkTrivialExecutor gTrivial;
@@ -119,6 +133,270 @@ private:
     SkSemaphore                         fWorkAvailable;
 };
 
+// An SkWorkStealingPool gives each of its threads a fixed-size Chase-Lev deque of work.
+// Work added from one of those threads goes onto its own deque, where it's popped LIFO,
+// so nested work stays hot in that thread's cache; idle threads steal FIFO from the others.
+// Work added from any other thread goes onto a shared, locked list.
+//
+// A batch is queued as a single [start,end) range over one std::function.  Whoever runs a
+// range pushes its upper half back onto the queue until only one index is left, so a batch
+// of N costs one allocation and at most O(log N) deque entries at a time.
+class SkWorkStealingPool final : public SkExecutor {
+public:
+    explicit SkWorkStealingPool(int threads)
+        : fWorkers(new Worker[threads])
+        , fWorkerCount(threads)
+        , fShuttingDown(false) {
+        for (int i = 0; i < threads; i++) {
+            fWorkers[i].fPool  = this;
+            fWorkers[i].fIndex = i;
+            fThreads.emplace_back(new SkThread(&Loop, &fWorkers[i]));
+            fThreads.back()->start();
+        }
+    }
+
+    ~SkWorkStealingPool() override {
+        // Each thread drains all the work it can find before it looks at fShuttingDown.
+        fShuttingDown.store(true, std::memory_order_release);
+        fWorkAvailable.signal(fThreads.count());
+        for (int i = 0; i < fThreads.count(); i++) {
+            fThreads[i]->join();
+        }
+    }
+
+    void add(std::function<void(void)> work) override {
+        this->push({ new Work(std::move(work)), 0, 1 }, this->currentIndex());
+    }
+
+    void batch(int N, std::function<void(int)> fn) override {
+        if (N > 0) {
+            this->push({ new Work(N, std::move(fn)), 0, N }, this->currentIndex());
+        }
+    }
+
+    void borrow() override {
+        int me = this->currentIndex();
+        Task task;
+        if (this->findWork(&task, me)) {
+            this->run(task, me);
+        }
+    }
+
+private:
+    // Either a single std::function<void(void)>, or a batch sharing one std::function<void(int)>.
+    // Deletes itself once each of its indices has run.
+    class Work {
+    public:
+        explicit Work(std::function<void(void)> fn) : fFn(std::move(fn)), fRemaining(1) {}
+        Work(int N, std::function<void(int)> fn) : fBatchFn(std::move(fn)), fRemaining(N) {}
+
+        void run(int i) {
+            if (fFn) {
+                fFn();
+            } else {
+                fBatchFn(i);
+            }
+            if (1 == fRemaining.fetch_add(-1, std::memory_order_acq_rel)) {
+                delete this;
+            }
+        }
+
+    private:
+        std::function<void(void)> fFn;
+        std::function<void(int)>  fBatchFn;
+        std::atomic<int>          fRemaining;
+    };
+
+    struct Task {
+        Work* fWork;
+        int   fStart, fEnd;
+    };
+
+    // A bounded Chase-Lev deque, following Le et al., "Correct and Efficient Work-Stealing
+    // for Weak Memory Models".  Only the owning thread may push() and pop(); anyone may steal().
+    // Every store to fBottom is a release (rather than the paper's release fence in push()) so
+    // that any bottom a thief acquires publishes the tasks below it, in a way TSAN understands.
+    class Deque {
+    public:
+        Deque() : fTop(0), fBottom(0) {}
+
+        // Returns false if the deque is full.
+        bool push(const Task& task) {
+            int64_t b = fBottom.load(std::memory_order_relaxed),
+                    t = fTop   .load(std::memory_order_acquire);
+            if (b - t >= kCapacity) {
+                return false;
+            }
+            this->store(b, task);
+            fBottom.store(b + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool pop(Task* task) {
+            int64_t b = fBottom.load(std::memory_order_relaxed) - 1;
+            fBottom.store(b, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = fTop.load(std::memory_order_relaxed);
+
+            bool found = false;
+            if (t <= b) {
+                *task = this->load(b);
+                found = true;
+                if (t == b) {
+                    // Last entry: race any thieves for it.
+                    found = fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                                   std::memory_order_relaxed);
+                    fBottom.store(b + 1, std::memory_order_release);
+                }
+            } else {
+                fBottom.store(b + 1, std::memory_order_release);
+            }
+            return found;
+        }
+
+        enum StealResult { kEmpty_StealResult, kLostRace_StealResult, kSuccess_StealResult };
+
+        StealResult steal(Task* task) {
+            int64_t t = fTop.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t b = fBottom.load(std::memory_order_acquire);
+            if (t >= b) {
+                return kEmpty_StealResult;
+            }
+            // This read may race with the owner's push() once we've lost the CAS below,
+            // which is why each slot is made of atomics.  We only use it if we win.
+            Task stolen = this->load(t);
+            if (!fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                        std::memory_order_relaxed)) {
+                return kLostRace_StealResult;
+            }
+            *task = stolen;
+            return kSuccess_StealResult;
+        }
+
+    private:
+        static constexpr int kCapacity = 1024;  // Must be a power of two.
+
+        struct Slot {
+            std::atomic<Work*> fWork;
+            std::atomic<int>   fStart, fEnd;
+        };
+
+        void store(int64_t i, const Task& task) {
+            Slot& slot = fSlots[i & (kCapacity - 1)];
+            slot.fWork .store(task.fWork,  std::memory_order_relaxed);
+            slot.fStart.store(task.fStart, std::memory_order_relaxed);
+            slot.fEnd  .store(task.fEnd,   std::memory_order_relaxed);
+        }
+        Task load(int64_t i) const {
+            const Slot& slot = fSlots[i & (kCapacity - 1)];
+            return { slot.fWork .load(std::memory_order_relaxed),
+                     slot.fStart.load(std::memory_order_relaxed),
+                     slot.fEnd  .load(std::memory_order_relaxed) };
+        }
+
+        std::atomic<int64_t> fTop, fBottom;
+        Slot                 fSlots[kCapacity];
+    };
+
+    struct Worker {
+        SkWorkStealingPool* fPool;
+        int                 fIndex;
+        Deque               fDeque;
+    };
+
+    // Each of our threads keeps a pointer to its Worker in SkTLS, so that work it adds from inside
+    // other work can tell which deque is its own.  Loop() passes its index along explicitly.
+    static void* NewWorkerSlot() { return new Worker*(nullptr); }
+    static void DeleteWorkerSlot(void* slot) { delete (Worker**)slot; }
+
+    // Returns the current thread's index in this pool, or -1 if it's not one of ours.
+    int currentIndex() const {
+        auto slot = (Worker**)SkTLS::Find(NewWorkerSlot);
+        return slot && *slot && (*slot)->fPool == this ? (*slot)->fIndex : -1;
+    }
+
+    // me is the index of the calling thread in this pool, or -1.
+    void push(const Task& task, int me) {
+        if (me < 0 || !fWorkers[me].fDeque.push(task)) {
+            SkAutoExclusive lock(fSharedLock);
+            fShared.push_back(task);
+        }
+        fWorkAvailable.signal(1);
+    }
+
+    bool findWork(Task* task, int me) {
+        if (me >= 0 && fWorkers[me].fDeque.pop(task)) {
+            return true;
+        }
+        {
+            SkAutoExclusive lock(fSharedLock);
+            if (!fShared.empty()) {
+                *task = fShared.back();
+                fShared.pop_back();
+                return true;
+            }
+        }
+        // Steal, starting with our neighbor so thieves spread out.  If we lost any race,
+        // there may still be work out there, so look again.
+        for (bool lostRace = true; lostRace;) {
+            lostRace = false;
+            for (int i = 1; i <= fWorkerCount; i++) {
+                int victim = (me + i + fWorkerCount) % fWorkerCount;
+                if (victim == me) {
+                    continue;
+                }
+                switch (fWorkers[victim].fDeque.steal(task)) {
+                    case Deque::kSuccess_StealResult:  return true;
+                    case Deque::kLostRace_StealResult: lostRace = true; break;
+                    case Deque::kEmpty_StealResult:    break;
+                }
+            }
+        }
+        return false;
+    }
+
+    void run(Task task, int me) {
+        // Leave the upper halves of a batch for others (or for later), then run one index.
+        while (task.fEnd - task.fStart > 1) {
+            int mid = task.fStart + (task.fEnd - task.fStart) / 2;
+            this->push({ task.fWork, mid, task.fEnd }, me);
+            task.fEnd = mid;
+        }
+        task.fWork->run(task.fStart);
+    }
+
+    static void Loop(void* ctx) {
+        auto worker = (Worker*)ctx;
+        auto pool   = worker->fPool;
+        int  me     = worker->fIndex;
+        *(Worker**)SkTLS::Get(NewWorkerSlot, DeleteWorkerSlot) = worker;
+
+        for (;;) {
+            pool->fWorkAvailable.wait();
+            Task task;
+            while (pool->findWork(&task, me)) {
+                pool->run(task, me);
+            }
+            if (pool->fShuttingDown.load(std::memory_order_acquire)) {
+                break;
+            }
+        }
+    }
+
+    std::unique_ptr<Worker[]>           fWorkers;
+    int                                 fWorkerCount;
+    SkTArray<std::unique_ptr<SkThread>> fThreads;
+    SkSpinlock                          fSharedLock;
+    SkTArray<Task>                      fShared;
+    SkSemaphore                         fWorkAvailable;
+    std::atomic<bool>                   fShuttingDown;
+};
+
 std::unique_ptr<SkExecutor> SkExecutor::MakeThreadPool(int threads) {
     return skstd::make_unique<SkThreadPool>(threads > 0 ? threads : num_cores());
 }
+
+std::unique_ptr<SkExecutor> SkExecutor::MakeWorkStealingPool(int threads) {
+    return skstd::make_unique<SkWorkStealingPool>(threads > 0 ? threads : num_cores());
+}
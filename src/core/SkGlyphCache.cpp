@@ -44,16 +44,25 @@ SkGlyphCache::SkGlyphCache(const SkDescriptor* desc, std::unique_ptr<SkScalerCon
     fScalerContext->getFontMetrics(&fFontMetrics);
 
     fMemoryUsed = sizeof(*this);
+    fAccountedMemoryUsed = 0;
+    fSharedCount = 0;
+    fShared = false;
 }
 
 SkGlyphCache::~SkGlyphCache() {
-    fGlyphMap.foreach([](SkGlyph* g) {
+    fGlyphMap.foreach([](SkGlyph** glyph) {
+        SkGlyph* g = *glyph;
         if (g->fPathData) {
             delete g->fPathData->fPath;
         }
     });
 }
 
+void SkGlyphCache::addMemoryUsed(size_t bytes) {
+    fMemoryUsed.store(fMemoryUsed.load(std::memory_order_relaxed) + bytes,
+                      std::memory_order_relaxed);
+}
+
 SkGlyphCache::CharGlyphRec* SkGlyphCache::getCharGlyphRec(SkPackedUnicharID packedUnicharID) {
     if (!fPackedUnicharIDToPackedGlyphID) {
         fPackedUnicharIDToPackedGlyphID.reset(new CharGlyphRec[kHashCount]);
@@ -71,6 +80,7 @@ SkGlyphCache::CharGlyphRec* SkGlyphCache::getCharGlyphRec(SkPackedUnicharID pack
 #endif
 
 SkGlyphID SkGlyphCache::unicharToGlyph(SkUnichar charCode) {
+    SkAutoMutexAcquire lock(this->sharedMutex());
     VALIDATE();
     SkPackedUnicharID packedUnicharID(charCode);
     CharGlyphRec* rec = this->getCharGlyphRec(packedUnicharID);
@@ -88,25 +98,30 @@ SkGlyphID SkGlyphCache::unicharToGlyph(SkUnichar charCode) {
 }
 
 SkUnichar SkGlyphCache::glyphToUnichar(SkGlyphID glyphID) {
+    SkAutoMutexAcquire lock(this->sharedMutex());
     return fScalerContext->glyphIDToChar(glyphID);
 }
 
 unsigned SkGlyphCache::getGlyphCount() const {
+    SkAutoMutexAcquire lock(this->sharedMutex());
     return fScalerContext->getGlyphCount();
 }
 
 int SkGlyphCache::countCachedGlyphs() const {
+    SkAutoMutexAcquire lock(this->sharedMutex());
     return fGlyphMap.count();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 const SkGlyph& SkGlyphCache::getUnicharAdvance(SkUnichar charCode) {
+    SkAutoMutexAcquire lock(this->sharedMutex());
     VALIDATE();
     return *this->lookupByChar(charCode, kJustAdvance_MetricsType);
 }
 
 const SkGlyph& SkGlyphCache::getGlyphIDAdvance(uint16_t glyphID) {
+    SkAutoMutexAcquire lock(this->sharedMutex());
     VALIDATE();
     SkPackedGlyphID packedGlyphID(glyphID);
     return *this->lookupByPackedGlyphID(packedGlyphID, kJustAdvance_MetricsType);
@@ -115,22 +130,26 @@ const SkGlyph& SkGlyphCache::getGlyphIDAdvance(uint16_t glyphID) {
 ///////////////////////////////////////////////////////////////////////////////
 
 const SkGlyph& SkGlyphCache::getUnicharMetrics(SkUnichar charCode) {
+    SkAutoMutexAcquire lock(this->sharedMutex());
     VALIDATE();
     return *this->lookupByChar(charCode, kFull_MetricsType);
 }
 
 const SkGlyph& SkGlyphCache::getUnicharMetrics(SkUnichar charCode, SkFixed x, SkFixed y) {
+    SkAutoMutexAcquire lock(this->sharedMutex());
     VALIDATE();
     return *this->lookupByChar(charCode, kFull_MetricsType, x, y);
 }
 
 const SkGlyph& SkGlyphCache::getGlyphIDMetrics(uint16_t glyphID) {
+    SkAutoMutexAcquire lock(this->sharedMutex());
     VALIDATE();
     SkPackedGlyphID packedGlyphID(glyphID);
     return *this->lookupByPackedGlyphID(packedGlyphID, kFull_MetricsType);
 }
 
 const SkGlyph& SkGlyphCache::getGlyphIDMetrics(uint16_t glyphID, SkFixed x, SkFixed y) {
+    SkAutoMutexAcquire lock(this->sharedMutex());
     VALIDATE();
     SkPackedGlyphID packedGlyphID(glyphID, x, y);
     return *this->lookupByPackedGlyphID(packedGlyphID, kFull_MetricsType);
@@ -147,27 +166,32 @@ SkGlyph* SkGlyphCache::lookupByChar(SkUnichar charCode, MetricsType type, SkFixe
 }
 
 SkGlyph* SkGlyphCache::lookupByPackedGlyphID(SkPackedGlyphID packedGlyphID, MetricsType type) {
-    SkGlyph* glyph = fGlyphMap.find(packedGlyphID);
+    SkGlyph** found = fGlyphMap.find(packedGlyphID);
+    SkGlyph* glyph = found ? *found : nullptr;
 
     if (nullptr == glyph) {
         glyph = this->allocateNewGlyph(packedGlyphID, type);
     } else {
         if (type == kFull_MetricsType && glyph->isJustAdvance()) {
-           fScalerContext->getMetrics(glyph);
+            if (fShared) {
+                // Other threads may be reading this glyph without the lock, so it mustn't
+                // change.  Replace it with one that has full metrics; the old one stays in
+                // fAlloc, unchanged, for as long as the strike does.
+                glyph = this->allocateNewGlyph(packedGlyphID, type);
+            } else {
+                fScalerContext->getMetrics(glyph);
+            }
         }
     }
     return glyph;
 }
 
 SkGlyph* SkGlyphCache::allocateNewGlyph(SkPackedGlyphID packedGlyphID, MetricsType mtype) {
-    fMemoryUsed += sizeof(SkGlyph);
+    this->addMemoryUsed(sizeof(SkGlyph));
 
-    SkGlyph* glyphPtr;
-    {
-        SkGlyph glyph;
-        glyph.initWithGlyphID(packedGlyphID);
-        glyphPtr = fGlyphMap.set(glyph);
-    }
+    SkGlyph* glyphPtr = fAlloc.make<SkGlyph>();
+    glyphPtr->initWithGlyphID(packedGlyphID);
+    fGlyphMap.set(glyphPtr);
 
     if (kJustAdvance_MetricsType == mtype) {
         fScalerContext->getAdvance(glyphPtr);
@@ -181,6 +205,7 @@ SkGlyph* SkGlyphCache::allocateNewGlyph(SkPackedGlyphID packedGlyphID, MetricsTy
 }
 
 const void* SkGlyphCache::findImage(const SkGlyph& glyph) {
+    SkAutoMutexAcquire lock(this->sharedMutex());
     if (glyph.fWidth > 0 && glyph.fWidth < kMaxGlyphWidth) {
         if (nullptr == glyph.fImage) {
             size_t  size = const_cast<SkGlyph&>(glyph).allocImage(&fAlloc);
@@ -191,7 +216,7 @@ const void* SkGlyphCache::findImage(const SkGlyph& glyph) {
                 // getImage (e.g. from AA or LCD to BW) which means we may have
                 // overallocated the buffer. Check if the new computedImageSize
                 // is smaller, and if so, strink the alloc size in fImageAlloc.
-                fMemoryUsed += size;
+                this->addMemoryUsed(size);
             }
         }
     }
@@ -199,6 +224,7 @@ const void* SkGlyphCache::findImage(const SkGlyph& glyph) {
 }
 
 const SkPath* SkGlyphCache::findPath(const SkGlyph& glyph) {
+    SkAutoMutexAcquire lock(this->sharedMutex());
     if (glyph.fWidth) {
         if (glyph.fPathData == nullptr) {
             SkGlyph::PathData* pathData = fAlloc.make<SkGlyph::PathData>();
@@ -206,7 +232,7 @@ const SkPath* SkGlyphCache::findPath(const SkGlyph& glyph) {
             pathData->fIntercept = nullptr;
             SkPath* path = pathData->fPath = new SkPath;
             fScalerContext->getPath(glyph.getPackedID(), path);
-            fMemoryUsed += sizeof(SkPath) + path->countPoints() * sizeof(SkPoint);
+            this->addMemoryUsed(sizeof(SkPath) + path->countPoints() * sizeof(SkPoint));
         }
     }
     return glyph.fPathData ? glyph.fPathData->fPath : nullptr;
@@ -312,6 +338,7 @@ const SkGlyph::Intercept* SkGlyphCache::MatchBounds(const SkGlyph* glyph,
 
 void SkGlyphCache::findIntercepts(const SkScalar bounds[2], SkScalar scale, SkScalar xPos,
         bool yAxis, SkGlyph* glyph, SkScalar* array, int* count) {
+    SkAutoMutexAcquire lock(this->sharedMutex());
     const SkGlyph::Intercept* match = MatchBounds(glyph, bounds);
 
     if (match) {
@@ -380,6 +407,7 @@ void SkGlyphCache::findIntercepts(const SkScalar bounds[2], SkScalar scale, SkSc
 }
 
 void SkGlyphCache::dump() const {
+    SkAutoMutexAcquire lock(this->sharedMutex());
     const SkTypeface* face = fScalerContext->getTypeface();
     const SkScalerContextRec& rec = fScalerContext->getRec();
     SkMatrix matrix;
@@ -453,6 +481,18 @@ void SkGlyphCache_Globals::purgeAll() {
     this->internalPurge(fTotalMemoryUsed);
 }
 
+bool SkGlyphCache_Globals::setShared(bool shared) {
+    SkAutoExclusive ac(fLock);
+    bool prev = fShared;
+    fShared = shared;
+    return prev;
+}
+
+bool SkGlyphCache_Globals::isShared() const {
+    SkAutoExclusive ac(fLock);
+    return fShared;
+}
+
 /*  This guy calls the visitor from within the mutext lock, so the visitor
     cannot:
     - take too much time
@@ -467,6 +507,15 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
     if (!typeface) {
         typeface = SkTypeface::GetDefaultTypeface();
     }
+    return get_globals().visitCache(typeface, effects, desc, proc, context);
+}
+
+SkGlyphCache* SkGlyphCache_Globals::visitCache(SkTypeface* typeface,
+                                               const SkScalerContextEffects& effects,
+                                               const SkDescriptor* desc,
+                                               bool (*proc)(const SkGlyphCache*, void*),
+                                               void* context) {
+    SkASSERT(typeface);
     SkASSERT(desc);
 
     // Precondition: the typeface id must be the fFontID in the descriptor
@@ -479,19 +528,27 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
         SkASSERT(typeface->uniqueID() == rec->fFontID);
     )
 
-    SkGlyphCache_Globals& globals = get_globals();
-    SkGlyphCache*         cache;
+    SkGlyphCache* cache;
+    bool          shared;
 
     {
-        SkAutoExclusive ac(globals.fLock);
+        SkAutoExclusive ac(fLock);
 
-        globals.validate();
+        this->validate();
 
-        for (cache = globals.internalGetHead(); cache != nullptr; cache = cache->fNext) {
+        shared = this->internalIsShared();
+        for (cache = this->internalGetHead(); cache != nullptr; cache = cache->fNext) {
             if (*cache->fDesc == *desc) {
-                globals.internalDetachCache(cache);
+                if (shared) {
+                    return this->internalVisitShared(cache, proc, context);
+                }
+                if (cache->fSharedCount > 0) {
+                    // Still in use by threads from before sharing was turned off.
+                    continue;
+                }
+                this->internalDetachCache(cache);
                 if (!proc(cache, context)) {
-                    globals.internalAttachCacheToHead(cache);
+                    this->internalAttachCacheToHead(cache);
                     cache = nullptr;
                 }
                 return cache;
@@ -507,17 +564,33 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
         // so we can try the purge.
         std::unique_ptr<SkScalerContext> ctx = typeface->createScalerContext(effects, desc, true);
         if (!ctx) {
-            get_globals().purgeAll();
+            this->purgeAll();
             ctx = typeface->createScalerContext(effects, desc, false);
             SkASSERT(ctx);
         }
         cache = new SkGlyphCache(desc, std::move(ctx));
     }
 
-    AutoValidate av(cache);
+    SkGlyphCache::AutoValidate av(cache);
+
+    if (shared) {
+        SkAutoExclusive ac(fLock);
+
+        // Another thread may have built the same strike while we weren't holding the lock.
+        // If so, use theirs, so we never hold two copies of the same glyphs.
+        for (SkGlyphCache* other = this->internalGetHead(); other; other = other->fNext) {
+            if (*other->fDesc == *desc) {
+                av.forget();
+                delete cache;
+                return this->internalVisitShared(other, proc, context);
+            }
+        }
+        this->internalAttachCacheToHead(cache);
+        return this->internalVisitShared(cache, proc, context);
+    }
 
     if (!proc(cache, context)) {   // need to reattach
-        globals.attachCacheToHead(cache);
+        this->attachCacheToHead(cache);
         cache = nullptr;
     }
     return cache;
@@ -525,7 +598,6 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
 
 void SkGlyphCache::AttachCache(SkGlyphCache* cache) {
     SkASSERT(cache);
-    SkASSERT(cache->fNext == nullptr);
 
     get_globals().attachCacheToHead(cache);
 }
@@ -614,10 +686,40 @@ void SkGlyphCache_Globals::attachCacheToHead(SkGlyphCache* cache) {
     this->validate();
     cache->validate();
 
-    this->internalAttachCacheToHead(cache);
+    if (cache->fSharedCount > 0) {
+        // This strike never left the list; just let go of it, and count what it's grown by.
+        cache->fSharedCount -= 1;
+        if (cache->fSharedCount == 0) {
+            cache->fShared = false;
+        }
+        size_t used = cache->getMemoryUsed();
+        fTotalMemoryUsed += used - cache->fAccountedMemoryUsed;
+        cache->fAccountedMemoryUsed = used;
+    } else {
+        SkASSERT(cache->fNext == nullptr);
+        this->internalAttachCacheToHead(cache);
+    }
     this->internalPurge();
 }
 
+SkGlyphCache* SkGlyphCache_Globals::internalVisitShared(SkGlyphCache* cache,
+                                                        bool (*proc)(const SkGlyphCache*, void*),
+                                                        void* context) {
+    // Move the strike to the head of the list to keep it in LRU order.
+    this->internalDetachCache(cache);
+    this->internalAttachCacheToHead(cache);
+
+    if (!proc(cache, context)) {
+        return nullptr;
+    }
+    if (cache->fSharedCount == 0) {
+        // Nobody else holds the strike yet, so nobody can be reading fShared.
+        cache->fShared = true;
+    }
+    cache->fSharedCount += 1;
+    return cache;
+}
+
 SkGlyphCache* SkGlyphCache_Globals::internalGetTail() const {
     SkGlyphCache* cache = fHead;
     if (cache) {
@@ -662,7 +764,12 @@ size_t SkGlyphCache_Globals::internalPurge(size_t minBytesNeeded) {
     while (cache != nullptr &&
            (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
         SkGlyphCache* prev = cache->fPrev;
-        bytesFreed += cache->fMemoryUsed;
+        if (cache->fSharedCount > 0) {
+            // Some thread is still using this strike.
+            cache = prev;
+            continue;
+        }
+        bytesFreed += cache->fAccountedMemoryUsed;
         countFreed += 1;
 
         this->internalDetachCache(cache);
@@ -690,14 +797,18 @@ void SkGlyphCache_Globals::internalAttachCacheToHead(SkGlyphCache* cache) {
     }
     fHead = cache;
 
+    // A shared strike may be growing on another thread; we count what it's grown by so far,
+    // and attachCacheToHead() counts the rest when the last thread lets go.
+    cache->fAccountedMemoryUsed = cache->getMemoryUsed();
+
     fCacheCount += 1;
-    fTotalMemoryUsed += cache->fMemoryUsed;
+    fTotalMemoryUsed += cache->fAccountedMemoryUsed;
 }
 
 void SkGlyphCache_Globals::internalDetachCache(SkGlyphCache* cache) {
     SkASSERT(fCacheCount > 0);
     fCacheCount -= 1;
-    fTotalMemoryUsed -= cache->fMemoryUsed;
+    fTotalMemoryUsed -= cache->fAccountedMemoryUsed;
 
     if (cache->fPrev) {
         cache->fPrev->fNext = cache->fNext;
@@ -733,7 +844,7 @@ void SkGlyphCache_Globals::validate() const {
 
     const SkGlyphCache* head = fHead;
     while (head != nullptr) {
-        computedBytes += head->fMemoryUsed;
+        computedBytes += head->fAccountedMemoryUsed;
         computedCount += 1;
         head = head->fNext;
     }
@@ -775,6 +886,14 @@ int SkGraphics::GetFontCacheCountUsed() {
     return get_globals().getCacheCountUsed();
 }
 
+bool SkGraphics::SetFontCacheShared(bool shared) {
+    return get_globals().setShared(shared);
+}
+
+bool SkGraphics::GetFontCacheShared() {
+    return get_globals().isShared();
+}
+
 void SkGraphics::PurgeFontCache() {
     get_globals().purgeAll();
     SkTypefaceCache::PurgeAll();
@@ -11,11 +11,13 @@
 #include "SkBitmap.h"
 #include "SkDescriptor.h"
 #include "SkGlyph.h"
+#include "SkMutex.h"
 #include "SkPaint.h"
 #include "SkTHash.h"
 #include "SkScalerContext.h"
 #include "SkTemplates.h"
 #include "SkTDArray.h"
+#include <atomic>
 #include <memory>
 
 class SkTraceMemoryDump;
@@ -31,6 +33,12 @@ class SkGlyphCache_Globals;
 
     The strikes are held in a global list, available to all threads. To interact with one, call
     either VisitCache() or DetachCache().
+
+    When SkGraphics::SetFontCacheShared(true) is in effect many threads may use one strike at
+    once; while a strike is held that way it guards its glyphs with its own lock. Glyphs never
+    move once created, so the references returned here stay valid for as long as the caller
+    holds the strike. A shared strike never fills in the metrics of a glyph it has handed out;
+    asking for more than its advance gets a new glyph instead.
 */
 class SkGlyphCache {
 public:
@@ -106,7 +114,7 @@ public:
     }
 
     /** Return the approx RAM usage for this cache. */
-    size_t getMemoryUsed() const { return fMemoryUsed; }
+    size_t getMemoryUsed() const { return fMemoryUsed.load(std::memory_order_relaxed); }
 
     void dump() const;
 
@@ -122,6 +130,7 @@ public:
 
     /** Given a strike that was returned by either VisitCache() or DetachCache() add it back into
         the global cache list (after which the caller should not reference it anymore.
+        If the strike is shared, this instead releases the caller's hold on it.
     */
     static void AttachCache(SkGlyphCache*);
     using AttachCacheFunctor = SkFunctionWrapper<void, SkGlyphCache, AttachCache>;
@@ -132,6 +141,10 @@ public:
         descriptor, a different strike will be generated. This is fine. It does mean we can have
         more than 1 strike for the same descriptor, but that will eventually get purged, and the
         win is that different thread will never block each other while a strike is being used.
+
+        If the font cache is shared (see SkGraphics::SetFontCacheShared()), the strike is not
+        removed from the global list. Other threads asking for the same descriptor get the same
+        strike, and it will not be purged until every one of them has called AttachCache().
     */
     static SkGlyphCache* DetachCache(SkTypeface* typeface, const SkScalerContextEffects& effects,
                                      const SkDescriptor* desc) {
@@ -192,6 +205,17 @@ private:
         SkPackedGlyphID fPackedGlyphID;
     };
 
+    // fGlyphMap holds pointers into fAlloc, so growing the map never moves a glyph out from
+    // under a reader on another thread.
+    struct GlyphPtrHashTraits {
+        static SkPackedGlyphID GetKey(const SkGlyph* glyph) {
+            return glyph->getPackedID();
+        }
+        static uint32_t Hash(SkPackedGlyphID glyphId) {
+            return glyphId.hash();
+        }
+    };
+
     SkGlyphCache(const SkDescriptor*, std::unique_ptr<SkScalerContext>);
     ~SkGlyphCache();
 
@@ -209,6 +233,12 @@ private:
 
     static bool DetachProc(const SkGlyphCache*, void*) { return true; }
 
+    // Call with sharedMutex() held.
+    void addMemoryUsed(size_t bytes);
+
+    // A strike held by only one thread needs no lock, so this is nullptr unless it is shared.
+    SkMutex* sharedMutex() const { return fShared ? &fMu : nullptr; }
+
     // The id arg is a combined id generated by MakeID.
     CharGlyphRec* getCharGlyphRec(SkPackedUnicharID id);
 
@@ -226,6 +256,9 @@ private:
     static const SkGlyph::Intercept* MatchBounds(const SkGlyph* glyph,
                                                  const SkScalar bounds[2]);
 
+    // Guards everything below that changes after construction, while the strike is shared.
+    mutable SkMutex        fMu;
+
     SkGlyphCache*          fNext;
     SkGlyphCache*          fPrev;
     const std::unique_ptr<SkDescriptor> fDesc;
@@ -233,7 +266,7 @@ private:
     SkPaint::FontMetrics   fFontMetrics;
 
     // Map from a combined GlyphID and sub-pixel position to a SkGlyph.
-    SkTHashTable<SkGlyph, SkPackedGlyphID, SkGlyph::HashTraits> fGlyphMap;
+    SkTHashTable<SkGlyph*, SkPackedGlyphID, GlyphPtrHashTraits> fGlyphMap;
 
     // so we don't grow our arrays a lot
     static constexpr size_t kMinGlyphCount = 8;
@@ -245,7 +278,13 @@ private:
     std::unique_ptr<CharGlyphRec[]> fPackedUnicharIDToPackedGlyphID;
 
     // used to track (approx) how much ram is tied-up in this cache
-    size_t                  fMemoryUsed;
+    std::atomic<size_t>     fMemoryUsed;
+
+    // These are guarded by SkGlyphCache_Globals::fLock rather than fMu.
+    size_t                  fAccountedMemoryUsed;  // fMemoryUsed as last seen by the globals.
+    int                     fSharedCount;          // Threads holding this strike while shared.
+    // fSharedCount > 0, but only written while no thread holds the strike, so holders can read it.
+    bool                    fShared;
 };
 
 class SkAutoGlyphCache : public std::unique_ptr<SkGlyphCache, SkGlyphCache::AttachCacheFunctor> {
@@ -31,6 +31,7 @@ public:
         fCacheSizeLimit = SK_DEFAULT_FONT_CACHE_LIMIT;
         fCacheCount = 0;
         fCacheCountLimit = SK_DEFAULT_FONT_CACHE_COUNT_LIMIT;
+        fShared = false;
     }
 
     ~SkGlyphCache_Globals() {
@@ -64,12 +65,26 @@ public:
 
     void purgeAll(); // does not change budget
 
-    // call when a glyphcache is available for caching (i.e. not in use)
+    bool setShared(bool shared);
+    bool isShared() const;
+
+    // SkGlyphCache::VisitCache() on this list of strikes, for a typeface that is not null.
+    SkGlyphCache* visitCache(SkTypeface*, const SkScalerContextEffects&, const SkDescriptor*,
+                             bool (*proc)(const SkGlyphCache*, void*), void* context);
+
+    // call when a glyphcache is available for caching (i.e. not in use),
+    // or when a thread is done with a shared glyphcache
     void attachCacheToHead(SkGlyphCache*);
 
     // can only be called when the mutex is already held
     void internalDetachCache(SkGlyphCache*);
     void internalAttachCacheToHead(SkGlyphCache*);
+    bool internalIsShared() const { return fShared; }
+
+    // Hands a strike that stays in the list to proc(), and if proc() returns true, to one
+    // more thread.  Can only be called when the mutex is already held.
+    SkGlyphCache* internalVisitShared(SkGlyphCache*, bool (*proc)(const SkGlyphCache*, void*),
+                                      void* context);
 
 private:
     SkGlyphCache* fHead;
@@ -77,6 +92,7 @@ private:
     size_t  fCacheSizeLimit;
     int32_t fCacheCountLimit;
     int32_t fCacheCount;
+    bool    fShared;
 
     // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
     // and attempt to purge caches to match.
@@ -14,6 +14,7 @@
 #include "SkGeometry.h"
 #include "SkGlyphCache.h"
 #include "SkImageFilter.h"
+#include "SkMaskCache.h"
 #include "SkMath.h"
 #include "SkMatrix.h"
 #include "SkOpts.h"
@@ -60,6 +61,7 @@ void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
     SkImageFilter::PurgeCache();
+    SkMaskCache::PurgePathMasks();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
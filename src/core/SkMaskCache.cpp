@@ -5,7 +5,12 @@
  * found in the LICENSE file.
  */
 
+#include "SkGraphics.h"
 #include "SkMaskCache.h"
+#include "SkMutex.h"
+#include "SkScan.h"
+
+#include <atomic>
 
 #define CHECK_LOCAL(localCache, localName, globalName, ...) \
     ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
@@ -188,3 +193,179 @@ void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
     RectsBlurKey key(sigma, style, quality, rects, count);
     return CHECK_LOCAL(localCache, add, Add, new RectsBlurRec(key, mask, data));
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SK_DEFAULT_PATH_MASK_CACHE_LIMIT
+    #define SK_DEFAULT_PATH_MASK_CACHE_LIMIT    (2 * 1024 * 1024)
+#endif
+
+// A mask bigger than this fraction of the budget would evict too many others to be worth it.
+// Big masks are also slower to blit than scan converting their paths, whose solid spans are cheap.
+static constexpr size_t kPathMaskSingleAllocationDivisor = 64;
+
+SK_DECLARE_STATIC_MUTEX(gPathMaskMutex);
+static std::atomic<size_t> gPathMaskByteLimit{SK_DEFAULT_PATH_MASK_CACHE_LIMIT};
+
+// Must be called with gPathMaskMutex held.
+static SkResourceCache* path_mask_cache() {
+    static SkResourceCache* gCache;
+    if (nullptr == gCache) {
+        gCache = new SkResourceCache(gPathMaskByteLimit.load());
+    }
+    return gCache;
+}
+
+// Hashes of keys that recently missed, so that a path's mask is only made the second time it is
+// drawn.  Colliding keys just get cached a draw early or late.  Guarded by gPathMaskMutex.
+static constexpr int kSeenPathMaskKeyCount = 256;
+static uint32_t gSeenPathMaskKeys[kSeenPathMaskKeyCount];
+
+static int path_mask_aa_mode(bool antiAlias) {
+    // Anti-aliased coverage also depends on which scan converter draws it.
+    if (!antiAlias) {
+        return 0;
+    }
+    return 1 | (gSkUseAnalyticAA.load() << 1) | (gSkForceAnalyticAA.load() << 2)
+             | (gSkUseDeltaAA.load() << 3) | (gSkForceDeltaAA.load() << 4);
+}
+
+static SkIPoint whole_pixel_translate(const SkMatrix& matrix) {
+    return SkIPoint::Make(SkScalarFloorToInt(matrix.getTranslateX()),
+                          SkScalarFloorToInt(matrix.getTranslateY()));
+}
+
+namespace {
+static unsigned gPathMaskKeyNamespaceLabel;
+
+struct PathMaskKey : public SkResourceCache::Key {
+public:
+    PathMaskKey(const SkPath& path, const SkMatrix& matrix, bool antiAlias)
+        : fGenID(path.getGenerationID())
+        , fFillType(path.getFillType())
+        , fAAMode(path_mask_aa_mode(antiAlias))
+    {
+        fMatrix[0] = matrix.getScaleX();
+        fMatrix[1] = matrix.getSkewX();
+        fMatrix[2] = matrix.getSkewY();
+        fMatrix[3] = matrix.getScaleY();
+
+        // Whole pixels of translation only move the mask, so just the rest is part of the key.
+        const SkIPoint whole = whole_pixel_translate(matrix);
+        fSubpixel[0] = matrix.getTranslateX() - SkIntToScalar(whole.fX);
+        fSubpixel[1] = matrix.getTranslateY() - SkIntToScalar(whole.fY);
+
+        this->init(&gPathMaskKeyNamespaceLabel, 0,
+                   sizeof(fGenID) + sizeof(fFillType) + sizeof(fAAMode) + sizeof(fMatrix) +
+                   sizeof(fSubpixel));
+    }
+
+    uint32_t    fGenID;
+    int32_t     fFillType;
+    int32_t     fAAMode;
+    SkScalar    fMatrix[4];
+    SkScalar    fSubpixel[2];
+};
+
+struct PathMaskValue {
+    MaskValue   fValue;
+    SkIPoint    fOrigin;    // the whole pixel translation the mask's bounds were made with
+};
+
+struct PathMaskRec : public SkResourceCache::Rec {
+    PathMaskRec(const PathMaskKey& key, const SkIPoint& origin, const SkMask& mask,
+                SkCachedData* data)
+        : fKey(key)
+    {
+        fValue.fValue.fMask = mask;
+        fValue.fValue.fData = data;
+        fValue.fValue.fData->attachToCacheAndRef();
+        fValue.fOrigin = origin;
+    }
+    ~PathMaskRec() override {
+        fValue.fValue.fData->detachFromCacheAndUnref();
+    }
+
+    PathMaskKey     fKey;
+    PathMaskValue   fValue;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fValue.fValue.fData->size(); }
+    const char* getCategory() const override { return "path-mask"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fValue.fValue.fData->diagnostic_only_getDiscardable();
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PathMaskRec& rec = static_cast<const PathMaskRec&>(baseRec);
+        PathMaskValue* result = static_cast<PathMaskValue*>(contextData);
+
+        SkCachedData* tmpData = rec.fValue.fValue.fData;
+        tmpData->ref();
+        if (nullptr == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = rec.fValue;
+        return true;
+    }
+};
+} // namespace
+
+SkCachedData* SkMaskCache::FindAndRef(const SkPath& path, const SkMatrix& matrix, bool antiAlias,
+                                      SkMask* mask, bool* seenBefore,
+                                      SkResourceCache* localCache) {
+    PathMaskValue result;
+    PathMaskKey key(path, matrix, antiAlias);
+    SkAutoMutexAcquire am(gPathMaskMutex);
+    if (!(localCache ? localCache : path_mask_cache())->find(key, PathMaskRec::Visitor, &result)) {
+        uint32_t& seen = gSeenPathMaskKeys[key.hash() % kSeenPathMaskKeyCount];
+        *seenBefore = seen == key.hash();
+        seen = key.hash();
+        return nullptr;
+    }
+
+    const SkIPoint whole = whole_pixel_translate(matrix);
+    *seenBefore = true;
+    *mask = result.fValue.fMask;
+    mask->fBounds.offset(whole.fX - result.fOrigin.fX, whole.fY - result.fOrigin.fY);
+    mask->fImage = (uint8_t*)(result.fValue.fData->data());
+    return result.fValue.fData;
+}
+
+void SkMaskCache::Add(const SkPath& path, const SkMatrix& matrix, bool antiAlias,
+                      const SkMask& mask, SkCachedData* data, SkResourceCache* localCache) {
+    PathMaskKey key(path, matrix, antiAlias);
+    PathMaskRec* rec = new PathMaskRec(key, whole_pixel_translate(matrix), mask, data);
+    if (localCache) {
+        localCache->add(rec);
+    } else {
+        SkAutoMutexAcquire am(gPathMaskMutex);
+        path_mask_cache()->add(rec);
+    }
+}
+
+size_t SkMaskCache::GetPathMaskSingleAllocationByteLimit() {
+    return gPathMaskByteLimit.load() / kPathMaskSingleAllocationDivisor;
+}
+
+void SkMaskCache::PurgePathMasks() {
+    SkAutoMutexAcquire am(gPathMaskMutex);
+    path_mask_cache()->purgeAll();
+    sk_bzero(gSeenPathMaskKeys, sizeof(gSeenPathMaskKeys));
+}
+
+size_t SkGraphics::GetPathMaskCacheBytesUsed() {
+    SkAutoMutexAcquire am(gPathMaskMutex);
+    return path_mask_cache()->getTotalBytesUsed();
+}
+
+size_t SkGraphics::GetPathMaskCacheByteLimit() {
+    return gPathMaskByteLimit.load();
+}
+
+size_t SkGraphics::SetPathMaskCacheByteLimit(size_t newLimit) {
+    SkAutoMutexAcquire am(gPathMaskMutex);
+    path_mask_cache()->setTotalByteLimit(newLimit);
+    return gPathMaskByteLimit.exchange(newLimit);
+}
@@ -11,6 +11,7 @@
 #include "SkBlurTypes.h"
 #include "SkCachedData.h"
 #include "SkMask.h"
+#include "SkPath.h"
 #include "SkRect.h"
 #include "SkResourceCache.h"
 #include "SkRRect.h"
@@ -39,6 +40,32 @@ public:
     static void Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
                     const SkRect rects[], int count, const SkMask& mask, SkCachedData* data,
                     SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Coverage masks of filled paths, keyed by the path's generation ID and fill type, the
+     *  matrix's scale, skew and subpixel translation, and whether it is anti-aliased, along with
+     *  which scan converter that selects.
+     *
+     *  The mask is found wherever the matrix translates it to by whole pixels: FindAndRef()
+     *  offsets its bounds from where it was added to where |matrix| puts it.  A path drawn only
+     *  once is not worth a mask, so when FindAndRef() misses it sets |seenBefore| to whether the
+     *  same key missed recently.  Without a |localCache|, these masks live in their own cache,
+     *  budgeted by SkGraphics::SetPathMaskCacheByteLimit(), rather than in the global
+     *  SkResourceCache.
+     */
+    static SkCachedData* FindAndRef(const SkPath& path, const SkMatrix& matrix, bool antiAlias,
+                                    SkMask* mask, bool* seenBefore,
+                                    SkResourceCache* localCache = nullptr);
+    static void Add(const SkPath& path, const SkMatrix& matrix, bool antiAlias,
+                    const SkMask& mask, SkCachedData* data, SkResourceCache* localCache = nullptr);
+
+    /**
+     *  The largest path mask, in bytes, that is worth adding to the path mask cache, or 0 if it
+     *  is disabled.
+     */
+    static size_t GetPathMaskSingleAllocationByteLimit();
+
+    static void PurgePathMasks();
 };
 
 #endif
@@ -10,11 +10,17 @@
 #include "SkColorPriv.h"
 #include "SkHalf.h"
 #include "SkMathPriv.h"
+#include "SkMutex.h"
 #include "SkNx.h"
 #include "SkPM4fPriv.h"
 #include "SkSRGB.h"
+#include "SkTArray.h"
+#include "SkTaskGroup.h"
+#include "SkTemplates.h"
 #include "SkTypes.h"
 
+#include <atomic>
+
 //
 // ColorTypeFilter is the "Type" we pass to some downsample template functions.
 // It controls how we expand a pixel into a large type, with space between each component,
@@ -384,102 +390,154 @@ size_t SkMipMap::AllocLevelsSize(int levelCount, size_t pixelSize) {
     return sk_64_asS32(size);
 }
 
-SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDestinationSurfaceColorMode colorMode,
-                          SkDiscardableFactoryProc fact) {
-    typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
-
-    FilterProc* proc_1_2 = nullptr;
-    FilterProc* proc_1_3 = nullptr;
-    FilterProc* proc_2_1 = nullptr;
-    FilterProc* proc_2_2 = nullptr;
-    FilterProc* proc_2_3 = nullptr;
-    FilterProc* proc_3_1 = nullptr;
-    FilterProc* proc_3_2 = nullptr;
-    FilterProc* proc_3_3 = nullptr;
-
-    const SkColorType ct = src.colorType();
-    const SkAlphaType at = src.alphaType();
+typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
+
+struct FilterProcs {
+    FilterProc* proc_1_2;
+    FilterProc* proc_1_3;
+    FilterProc* proc_2_1;
+    FilterProc* proc_2_2;
+    FilterProc* proc_2_3;
+    FilterProc* proc_3_1;
+    FilterProc* proc_3_2;
+    FilterProc* proc_3_3;
+
+    // Picks the filter that downsamples a level of this size to the next level.
+    FilterProc* choose(int width, int height) const {
+        if (height & 1) {
+            if (height == 1) {        // src-height is 1
+                if (width & 1) {      // src-width is 3
+                    return proc_3_1;
+                } else {              // src-width is 2
+                    return proc_2_1;
+                }
+            } else {                  // src-height is 3
+                if (width & 1) {
+                    if (width == 1) { // src-width is 1
+                        return proc_1_3;
+                    } else {          // src-width is 3
+                        return proc_3_3;
+                    }
+                } else {              // src-width is 2
+                    return proc_2_3;
+                }
+            }
+        } else {                      // src-height is 2
+            if (width & 1) {
+                if (width == 1) {     // src-width is 1
+                    return proc_1_2;
+                } else {              // src-width is 3
+                    return proc_3_2;
+                }
+            } else {                  // src-width is 2
+                return proc_2_2;
+            }
+        }
+    }
+};
+
+template <typename F>
+static void set_filter_procs(FilterProcs* procs) {
+    procs->proc_1_2 = downsample_1_2<F>;
+    procs->proc_1_3 = downsample_1_3<F>;
+    procs->proc_2_1 = downsample_2_1<F>;
+    procs->proc_2_2 = downsample_2_2<F>;
+    procs->proc_2_3 = downsample_2_3<F>;
+    procs->proc_3_1 = downsample_3_1<F>;
+    procs->proc_3_2 = downsample_3_2<F>;
+    procs->proc_3_3 = downsample_3_3<F>;
+}
+
+static bool choose_filter_procs(const SkImageInfo& info, SkDestinationSurfaceColorMode colorMode,
+                                FilterProcs* procs) {
     const bool srgbGamma = (SkDestinationSurfaceColorMode::kGammaAndColorSpaceAware == colorMode)
-                            && src.info().gammaCloseToSRGB();
+                            && info.gammaCloseToSRGB();
 
-    switch (ct) {
+    switch (info.colorType()) {
         case kRGBA_8888_SkColorType:
         case kBGRA_8888_SkColorType:
             if (srgbGamma) {
-                proc_1_2 = downsample_1_2<ColorTypeFilter_S32>;
-                proc_1_3 = downsample_1_3<ColorTypeFilter_S32>;
-                proc_2_1 = downsample_2_1<ColorTypeFilter_S32>;
-                proc_2_2 = downsample_2_2_srgb;
-                proc_2_3 = downsample_2_3<ColorTypeFilter_S32>;
-                proc_3_1 = downsample_3_1<ColorTypeFilter_S32>;
-                proc_3_2 = downsample_3_2<ColorTypeFilter_S32>;
-                proc_3_3 = downsample_3_3<ColorTypeFilter_S32>;
+                set_filter_procs<ColorTypeFilter_S32>(procs);
+                procs->proc_2_2 = downsample_2_2_srgb;
             } else {
-                proc_1_2 = downsample_1_2<ColorTypeFilter_8888>;
-                proc_1_3 = downsample_1_3<ColorTypeFilter_8888>;
-                proc_2_1 = downsample_2_1<ColorTypeFilter_8888>;
-                proc_2_2 = downsample_2_2<ColorTypeFilter_8888>;
-                proc_2_3 = downsample_2_3<ColorTypeFilter_8888>;
-                proc_3_1 = downsample_3_1<ColorTypeFilter_8888>;
-                proc_3_2 = downsample_3_2<ColorTypeFilter_8888>;
-                proc_3_3 = downsample_3_3<ColorTypeFilter_8888>;
+                set_filter_procs<ColorTypeFilter_8888>(procs);
             }
-            break;
+            return true;
         case kRGB_565_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_565>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_565>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_565>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_565>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_565>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_565>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_565>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_565>;
-            break;
+            set_filter_procs<ColorTypeFilter_565>(procs);
+            return true;
         case kARGB_4444_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_4444>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_4444>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_4444>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_4444>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_4444>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_4444>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_4444>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_4444>;
-            break;
+            set_filter_procs<ColorTypeFilter_4444>(procs);
+            return true;
         case kAlpha_8_SkColorType:
         case kGray_8_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_8>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_8>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_8>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_8>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_8>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_8>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8>;
-            break;
+            set_filter_procs<ColorTypeFilter_8>(procs);
+            return true;
         case kRGBA_F16_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_F16>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_F16>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_F16>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_F16>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_F16>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_F16>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_F16>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_F16>;
-            break;
+            set_filter_procs<ColorTypeFilter_F16>(procs);
+            return true;
         default:
             // TODO: We could build miplevels for kIndex8 if the levels were in 8888.
             //       Means using more ram, but the quality would be fine.
-            return nullptr;
+            return false;
     }
+}
+
+// Fills dst, the next level down from src.  Each dst row depends only on its own few src rows,
+// so with an executor we split big levels into bands of rows and filter those concurrently.
+static void downsample_level(const FilterProcs& procs, const SkPixmap& src, const SkPixmap& dst,
+                             SkExecutor* executor) {
+    FilterProc* proc = procs.choose(src.width(), src.height());
+    const size_t srcRB = src.rowBytes(),
+                 dstRB = dst.rowBytes();
+    const int    width = dst.width();
+
+    auto filterRows = [&](int start, int end) {
+        const char* srcRow = (const char*)src.addr() + 2 * start * srcRB;
+        char* dstRow = (char*)dst.writable_addr() + start * dstRB;
+        for (int y = start; y < end; y++) {
+            proc(dstRow, srcRow, srcRB, width);
+            srcRow += srcRB * 2; // jump two rows
+            dstRow += dstRB;
+        }
+    };
+
+    // Bands smaller than this cost more to hand out than they'd save.
+    static constexpr int kMinPixelsPerBand = 16 * 1024;
+    const int rowsPerBand = SkTMax(1, kMinPixelsPerBand / width);
+    if (executor && dst.height() > rowsPerBand) {
+        SkTaskGroup tg(*executor);
+        tg.parallel_for(dst.height(), rowsPerBand, filterRows);
+        tg.wait();
+    } else {
+        filterRows(0, dst.height());
+    }
+}
+
+struct SkMipMap::LazyState {
+    SkBitmap         fSrc;          // Kept until every level has been built.
+    FilterProcs      fProcs;
+    SkExecutor*      fExecutor;
+    SkMutex          fMutex;        // Guards fSrc and writes to levels, never held while building.
+    std::atomic<int> fBuiltCount;   // Levels [0, fBuiltCount) have their pixels.
+};
+
+SkMipMap::SkMipMap(void* malloc, size_t size) : INHERITED(malloc, size) {}
+SkMipMap::SkMipMap(size_t size, SkDiscardableMemory* dm) : INHERITED(size, dm) {}
+SkMipMap::~SkMipMap() {}
 
-    if (src.width() <= 1 && src.height() <= 1) {
+SkMipMap* SkMipMap::AllocLevels(const SkImageInfo& srcInfo, SkDiscardableFactoryProc fact) {
+    const SkColorType ct = srcInfo.colorType();
+    const SkAlphaType at = srcInfo.alphaType();
+
+    if (srcInfo.width() <= 1 && srcInfo.height() <= 1) {
         return nullptr;
     }
     // whip through our loop to compute the exact size needed
     size_t size = 0;
-    int countLevels = ComputeLevelCount(src.width(), src.height());
+    int countLevels = ComputeLevelCount(srcInfo.width(), srcInfo.height());
     for (int currentMipLevel = countLevels; currentMipLevel >= 0; currentMipLevel--) {
-        SkISize mipSize = ComputeLevelSize(src.width(), src.height(), currentMipLevel);
+        SkISize mipSize = ComputeLevelSize(srcInfo.width(), srcInfo.height(), currentMipLevel);
         size += SkColorTypeMinRowBytes(ct, mipSize.fWidth) * mipSize.fHeight;
     }
 
@@ -500,7 +558,7 @@ SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDestinationSurfaceColorMode col
     }
 
     // init
-    mipmap->fCS = sk_ref_sp(src.info().colorSpace());
+    mipmap->fCS = sk_ref_sp(srcInfo.colorSpace());
     mipmap->fCount = countLevels;
     mipmap->fLevels = (Level*)mipmap->writable_data();
     SkASSERT(mipmap->fLevels);
@@ -508,42 +566,11 @@ SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDestinationSurfaceColorMode col
     Level* levels = mipmap->fLevels;
     uint8_t*    baseAddr = (uint8_t*)&levels[countLevels];
     uint8_t*    addr = baseAddr;
-    int         width = src.width();
-    int         height = src.height();
+    int         width = srcInfo.width();
+    int         height = srcInfo.height();
     uint32_t    rowBytes;
-    SkPixmap    srcPM(src);
 
     for (int i = 0; i < countLevels; ++i) {
-        FilterProc* proc;
-        if (height & 1) {
-            if (height == 1) {        // src-height is 1
-                if (width & 1) {      // src-width is 3
-                    proc = proc_3_1;
-                } else {              // src-width is 2
-                    proc = proc_2_1;
-                }
-            } else {                  // src-height is 3
-                if (width & 1) {
-                    if (width == 1) { // src-width is 1
-                        proc = proc_1_3;
-                    } else {          // src-width is 3
-                        proc = proc_3_3;
-                    }
-                } else {              // src-width is 2
-                    proc = proc_2_3;
-                }
-            }
-        } else {                      // src-height is 2
-            if (width & 1) {
-                if (width == 1) {     // src-width is 1
-                    proc = proc_1_2;
-                } else {              // src-width is 3
-                    proc = proc_3_2;
-                }
-            } else {                  // src-width is 2
-                proc = proc_2_2;
-            }
-        }
         width = SkTMax(1, width >> 1);
         height = SkTMax(1, height >> 1);
         rowBytes = SkToU32(SkColorTypeMinRowBytes(ct, width));
@@ -552,28 +579,118 @@ SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDestinationSurfaceColorMode col
         // will not be deleted in a controlled fashion. When the caller is given the pixmap for
         // a given level, we augment this pixmap with fCS (which we do manage).
         new (&levels[i].fPixmap) SkPixmap(SkImageInfo::Make(width, height, ct, at), addr, rowBytes);
-        levels[i].fScale  = SkSize::Make(SkIntToScalar(width)  / src.width(),
-                                         SkIntToScalar(height) / src.height());
-
-        const SkPixmap& dstPM = levels[i].fPixmap;
-        const void* srcBasePtr = srcPM.addr();
-        void* dstBasePtr = dstPM.writable_addr();
-
-        const size_t srcRB = srcPM.rowBytes();
-        for (int y = 0; y < height; y++) {
-            proc(dstBasePtr, srcBasePtr, srcRB, width);
-            srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
-            dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
-        }
-        srcPM = dstPM;
+        levels[i].fScale  = SkSize::Make(SkIntToScalar(width)  / srcInfo.width(),
+                                         SkIntToScalar(height) / srcInfo.height());
         addr += height * rowBytes;
     }
     SkASSERT(addr == baseAddr + size);
 
+    return mipmap;
+}
+
+SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDestinationSurfaceColorMode colorMode,
+                          SkDiscardableFactoryProc fact, SkExecutor* executor) {
+    FilterProcs procs;
+    if (!choose_filter_procs(src.info(), colorMode, &procs)) {
+        return nullptr;
+    }
+
+    SkMipMap* mipmap = AllocLevels(src.info(), fact);
+    if (!mipmap) {
+        return nullptr;
+    }
+
+    const Level* levels = mipmap->fLevels;
+    for (int i = 0; i < mipmap->fCount; ++i) {
+        downsample_level(procs, i > 0 ? levels[i - 1].fPixmap : src, levels[i].fPixmap, executor);
+    }
+
     SkASSERT(mipmap->fLevels);
     return mipmap;
 }
 
+SkMipMap* SkMipMap::BuildLazy(const SkBitmap& src, SkDestinationSurfaceColorMode colorMode,
+                              SkDiscardableFactoryProc fact, SkExecutor* executor) {
+    FilterProcs procs;
+    if (!choose_filter_procs(src.info(), colorMode, &procs)) {
+        return nullptr;
+    }
+
+    SkMipMap* mipmap = AllocLevels(src.info(), fact);
+    if (!mipmap) {
+        return nullptr;
+    }
+
+    mipmap->fLazy.reset(new LazyState);
+    mipmap->fLazy->fSrc      = src;
+    mipmap->fLazy->fProcs    = procs;
+    mipmap->fLazy->fExecutor = executor;
+    mipmap->fLazy->fBuiltCount.store(0, std::memory_order_relaxed);
+    return mipmap;
+}
+
+bool SkMipMap::buildLevelsThrough(int index) const {
+    if (!fLazy || fLazy->fBuiltCount.load(std::memory_order_acquire) > index) {
+        return true;
+    }
+
+    // The levels are built without holding fMutex: waiting on the executor may run other tasks
+    // on this thread, and those may ask for this mipmap's levels too.
+    SkBitmap srcBitmap;
+    int built;
+    {
+        SkAutoMutexAcquire lock(fLazy->fMutex);
+        built = fLazy->fBuiltCount.load(std::memory_order_relaxed);
+        if (built > index) {
+            return true;    // Someone else got here first.
+        }
+        if (0 == built) {
+            srcBitmap = fLazy->fSrc;
+        }
+    }
+
+    // Other threads may be building the same levels, so build ours into scratch memory, and
+    // only copy the ones still missing into place once we're done.
+    size_t scratchSize = 0;
+    for (int i = built; i <= index; i++) {
+        scratchSize += fLevels[i].fPixmap.getSafeSize();
+    }
+    SkAutoTMalloc<char> scratch(scratchSize);
+    SkTArray<SkPixmap> scratchLevels(index - built + 1);
+    {
+        SkAutoPixmapUnlock srcUnlocker;
+        if (0 == built) {
+            if (!srcBitmap.requestLock(&srcUnlocker) || !srcUnlocker.pixmap().addr()) {
+                return false;
+            }
+        }
+        char* addr = scratch.get();
+        for (int i = built; i <= index; i++) {
+            const SkPixmap& level = fLevels[i].fPixmap;
+            scratchLevels.emplace_back(level.info(), addr, level.rowBytes());
+            addr += level.getSafeSize();
+
+            const SkPixmap& src = i > built ? scratchLevels[i - built - 1]
+                                : i > 0     ? fLevels[i - 1].fPixmap
+                                            : srcUnlocker.pixmap();
+            downsample_level(fLazy->fProcs, src, scratchLevels.back(), fLazy->fExecutor);
+        }
+    }
+
+    SkAutoMutexAcquire lock(fLazy->fMutex);
+    const int publishedCount = fLazy->fBuiltCount.load(std::memory_order_relaxed);
+    for (int i = publishedCount; i <= index; i++) {
+        memcpy(fLevels[i].fPixmap.writable_addr(), scratchLevels[i - built].addr(),
+               scratchLevels[i - built].getSafeSize());
+    }
+    if (publishedCount <= index) {
+        // Only level 0 reads the base level, so we can let go of it now.
+        fLazy->fSrc.reset();
+        fLazy->fBuiltCount.store(index + 1, std::memory_order_release);
+    }
+    return true;
+}
+
 int SkMipMap::ComputeLevelCount(int baseWidth, int baseHeight) {
     if (baseWidth < 1 || baseHeight < 1) {
         return 0;
@@ -669,6 +786,9 @@ bool SkMipMap::extractLevel(const SkSize& scaleSize, Level* levelPtr) const {
     if (level > fCount) {
         level = fCount;
     }
+    if (!this->buildLevelsThrough(level - 1)) {
+        return false;
+    }
     if (levelPtr) {
         *levelPtr = fLevels[level - 1];
         // need to augment with our colorspace
@@ -680,7 +800,7 @@ bool SkMipMap::extractLevel(const SkSize& scaleSize, Level* levelPtr) const {
 // Helper which extracts a pixmap from the src bitmap
 //
 SkMipMap* SkMipMap::Build(const SkBitmap& src, SkDestinationSurfaceColorMode colorMode,
-                          SkDiscardableFactoryProc fact) {
+                          SkDiscardableFactoryProc fact, SkExecutor* executor) {
     SkAutoPixmapUnlock srcUnlocker;
     if (!src.requestLock(&srcUnlocker)) {
         return nullptr;
@@ -690,7 +810,7 @@ SkMipMap* SkMipMap::Build(const SkBitmap& src, SkDestinationSurfaceColorMode col
     if (nullptr == srcPixmap.addr()) {
         sk_throw();
     }
-    return Build(srcPixmap, colorMode, fact);
+    return Build(srcPixmap, colorMode, fact, executor);
 }
 
 int SkMipMap::countLevels() const {
@@ -707,6 +827,9 @@ bool SkMipMap::getLevel(int index, Level* levelPtr) const {
     if (index > fCount - 1) {
         return false;
     }
+    if (!this->buildLevelsThrough(index)) {
+        return false;
+    }
     if (levelPtr) {
         *levelPtr = fLevels[index];
     }
@@ -14,8 +14,11 @@
 #include "SkSize.h"
 #include "SkShader.h"
 
+#include <memory>
+
 class SkBitmap;
 class SkDiscardableMemory;
+class SkExecutor;
 
 typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
 
@@ -28,10 +31,20 @@ typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
  */
 class SkMipMap : public SkCachedData {
 public:
+    // If executor is not null, big levels are split into bands of rows built on that executor.
     static SkMipMap* Build(const SkPixmap& src, SkDestinationSurfaceColorMode,
-                           SkDiscardableFactoryProc);
+                           SkDiscardableFactoryProc, SkExecutor* executor = nullptr);
     static SkMipMap* Build(const SkBitmap& src, SkDestinationSurfaceColorMode,
-                           SkDiscardableFactoryProc);
+                           SkDiscardableFactoryProc, SkExecutor* executor = nullptr);
+
+    // Like Build(), but each level's pixels are only built the first time extractLevel() or
+    // getLevel() asks for that level or a smaller one.  Until level 0 is built, the returned
+    // SkMipMap keeps a ref on src's pixels.  Threads that ask for missing levels at the same time
+    // may each build them, but only one thread's pixels are kept.
+    static SkMipMap* BuildLazy(const SkBitmap& src, SkDestinationSurfaceColorMode,
+                               SkDiscardableFactoryProc, SkExecutor* executor = nullptr);
+
+    ~SkMipMap() override;
 
     static SkDestinationSurfaceColorMode DeduceColorMode(const SkShader::ContextRec& rec) {
         return (SkShader::ContextRec::kPMColor_DstType == rec.fPreferredDstType)
@@ -70,15 +83,24 @@ protected:
     }
 
 private:
+    struct LazyState;
+
     sk_sp<SkColorSpace> fCS;
     Level*              fLevels;    // managed by the baseclass, may be null due to onDataChanged.
     int                 fCount;
+    std::unique_ptr<LazyState> fLazy;   // null unless built by BuildLazy().
 
-    SkMipMap(void* malloc, size_t size) : INHERITED(malloc, size) {}
-    SkMipMap(size_t size, SkDiscardableMemory* dm) : INHERITED(size, dm) {}
+    SkMipMap(void* malloc, size_t size);
+    SkMipMap(size_t size, SkDiscardableMemory* dm);
 
     static size_t AllocLevelsSize(int levelCount, size_t pixelSize);
 
+    // Allocates an SkMipMap with every level's size and address set up, but no pixels yet.
+    static SkMipMap* AllocLevels(const SkImageInfo& srcInfo, SkDiscardableFactoryProc);
+
+    // Makes sure levels [0, index] have their pixels.  Only BuildLazy() leaves any work to do.
+    bool buildLevelsThrough(int index) const;
+
     typedef SkCachedData INHERITED;
 };
 
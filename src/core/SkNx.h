@@ -105,6 +105,9 @@ struct SkNx {
     AI SkNx operator*(const SkNx& y) const { return { fLo * y.fLo, fHi * y.fHi }; }
     AI SkNx operator/(const SkNx& y) const { return { fLo / y.fLo, fHi / y.fHi }; }
 
+    // For unsigned integers, the high half of each full-width product.
+    AI SkNx mulHi(const SkNx& y) const { return { fLo.mulHi(y.fLo), fHi.mulHi(y.fHi) }; }
+
     AI SkNx operator&(const SkNx& y) const { return { fLo & y.fLo, fHi & y.fHi }; }
     AI SkNx operator|(const SkNx& y) const { return { fLo | y.fLo, fHi | y.fHi }; }
     AI SkNx operator^(const SkNx& y) const { return { fLo ^ y.fLo, fHi ^ y.fHi }; }
@@ -194,6 +197,10 @@ struct SkNx<1,T> {
     AI SkNx operator*(const SkNx& y) const { return fVal * y.fVal; }
     AI SkNx operator/(const SkNx& y) const { return fVal / y.fVal; }
 
+    AI SkNx mulHi(const SkNx& y) const {
+        return (T)(((uint64_t)fVal * (uint64_t)y.fVal) >> (8 * sizeof(T)));
+    }
+
     AI SkNx operator&(const SkNx& y) const { return FromBits(ToBits(fVal) & ToBits(y.fVal)); }
     AI SkNx operator|(const SkNx& y) const { return FromBits(ToBits(fVal) | ToBits(y.fVal)); }
     AI SkNx operator^(const SkNx& y) const { return FromBits(ToBits(fVal) ^ ToBits(y.fVal)); }
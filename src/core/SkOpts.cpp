@@ -79,6 +79,11 @@ namespace SkOpts {
     DEFINE_DEFAULT(grayA_to_rgbA);
     DEFINE_DEFAULT(inverted_CMYK_to_RGB1);
     DEFINE_DEFAULT(inverted_CMYK_to_BGR1);
+    DEFINE_DEFAULT(RGBA16_to_rgbA);
+    DEFINE_DEFAULT(RGBA16_to_bgrA);
+    DEFINE_DEFAULT(RGB16_to_F16);
+    DEFINE_DEFAULT(RGBA16_to_F16);
+    DEFINE_DEFAULT(RGBA16_to_F16_premul);
 
     DEFINE_DEFAULT(srcover_srgb_srgb);
 
@@ -89,6 +94,7 @@ namespace SkOpts {
     DEFINE_DEFAULT(convolve_vertically);
     DEFINE_DEFAULT(convolve_horizontally);
     DEFINE_DEFAULT(convolve_4_rows_horizontally);
+    DEFINE_DEFAULT(resample_row_8888);
 
 #undef DEFINE_DEFAULT
 
@@ -49,6 +49,16 @@ namespace SkOpts {
                         inverted_CMYK_to_RGB1, // i.e. convert color space
                         inverted_CMYK_to_BGR1; // i.e. convert color space
 
+    // Swizzle big-endian 16-bit-per-channel RGBA, keeping the high byte of each channel.
+    extern Swizzle_8888 RGBA16_to_rgbA,        // i.e. strip to 8 bits and premultiply
+                        RGBA16_to_bgrA;        // i.e. strip to 8 bits, swap RB and premultiply
+
+    // Swizzle big-endian 16-bit-per-channel input into F16 RGBA, mapping 0xFFFF to 1.0.
+    typedef void (*Swizzle_F16)(uint64_t*, const void*, int);
+    extern Swizzle_F16 RGB16_to_F16,           // i.e. convert and insert an opaque alpha
+                       RGBA16_to_F16,          // i.e. just convert
+                       RGBA16_to_F16_premul;   // i.e. convert and premultiply
+
     // Blend ndst src pixels over dst, where both src and dst point to sRGB pixels (RGBA or BGRA).
     // If nsrc < ndst, we loop over src to create a pattern.
     extern void (*srcover_srgb_srgb)(uint32_t* dst, const uint32_t* src, int ndst, int nsrc);
@@ -69,6 +79,12 @@ namespace SkOpts {
                                                 unsigned char* out_row[4], size_t out_row_bytes);
     extern void (*convolve_horizontally)(const unsigned char* src_data, const SkConvolutionFilter1D& filter,
                                          unsigned char* out_row, bool has_alpha);
+
+    // Resamples a row of 8888 pixels, each channel independently, to |width| pixels:
+    //   dst[x] = sum(src[offsets[x] + i] * weights[x*taps + i] for i in [0, taps))
+    // with weights in SkConvolutionFilter1D's fixed point, and each channel clamped to [0,255].
+    extern void (*resample_row_8888)(uint32_t* dst, int width, const uint32_t* src,
+                                     const int32_t* offsets, const int16_t* weights, int taps);
 }
 
 #endif//SkOpts_DEFINED
@@ -150,7 +150,7 @@ void SkPath::resetFields() {
 }
 
 SkPath::SkPath(const SkPath& that)
-    : fPathRef(SkRef(that.fPathRef.get())) {
+    : fPathRef(that.fPathRef->refOrCopy()) {
     this->copyFields(that);
     SkDEBUGCODE(that.validate();)
 }
@@ -163,7 +163,8 @@ SkPath& SkPath::operator=(const SkPath& that) {
     SkDEBUGCODE(that.validate();)
 
     if (this != &that) {
-        fPathRef.reset(SkRef(that.fPathRef.get()));
+        // Copies of temporary paths in an arena get their own path ref, which may outlive it.
+        fPathRef.reset(that.fPathRef->refOrCopy());
         this->copyFields(that);
     }
     SkDEBUGCODE(this->validate();)
@@ -10,6 +10,8 @@
 
 #include "SkPath.h"
 
+class SkArenaAlloc;
+
 class SkPathPriv {
 public:
     enum FirstDirection {
@@ -121,6 +123,24 @@ public:
     static const SkScalar* ConicWeightData(const SkPath& path) {
         return path.fPathRef->conicWeights();
     }
+
+    /**
+     * Empties the path and gives it storage in the arena for reserveVerbs verbs and reservePoints
+     * points, so that building a temporary path does not touch the heap. rewind() keeps that
+     * storage, reset() does not. Copies of the path are made on the heap, but the path itself
+     * must not outlive the arena.
+     */
+    static void ResetInArena(SkPath* path, SkArenaAlloc* alloc, int reserveVerbs = 0,
+                             int reservePoints = 0) {
+        path->fPathRef.reset(SkPathRef::CreateInArena(alloc, reserveVerbs, reservePoints));
+        path->resetFields();
+    }
+
+    /**
+     * For tests and benchmarks: returns how many heap allocations, of path refs or of their
+     * points and verbs, this thread has made since it first called this.
+     */
+    static int64_t ThreadHeapAllocationCount();
 };
 
 #endif
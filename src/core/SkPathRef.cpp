@@ -5,10 +5,15 @@
  * found in the LICENSE file.
  */
 
+#include "SkArenaAlloc.h"
 #include "SkBuffer.h"
 #include "SkOnce.h"
 #include "SkPath.h"
+#include "SkPathPriv.h"
 #include "SkPathRef.h"
+#include "SkTLS.h"
+#include <atomic>
+#include <cstddef>
 #include <limits>
 
 //////////////////////////////////////////////////////////////////////////////
@@ -19,7 +24,9 @@ SkPathRef::Editor::Editor(sk_sp<SkPathRef>* pathRef,
     if ((*pathRef)->unique()) {
         (*pathRef)->incReserve(incReserveVerbs, incReservePoints);
     } else {
-        SkPathRef* copy = new SkPathRef;
+        SkPathRef* copy = CreateWithStorage(nullptr,
+                                            (*pathRef)->countVerbs() + incReserveVerbs,
+                                            (*pathRef)->countPoints() + incReservePoints);
         copy->copy(**pathRef, incReserveVerbs, incReservePoints);
         pathRef->reset(copy);
     }
@@ -31,10 +38,166 @@ SkPathRef::Editor::Editor(sk_sp<SkPathRef>* pathRef,
 
 //////////////////////////////////////////////////////////////////////////////
 
+// Heap allocations are only counted on threads that have asked SkPathPriv for their count.
+static std::atomic<bool> gCountingHeapAllocations{false};
+
+static void* create_heap_allocation_count() {
+    return new int64_t(0);
+}
+
+static void delete_heap_allocation_count(void* count) {
+    delete static_cast<int64_t*>(count);
+}
+
+static void count_heap_allocation() {
+    if (gCountingHeapAllocations.load(std::memory_order_relaxed)) {
+        if (auto count = static_cast<int64_t*>(SkTLS::Find(create_heap_allocation_count))) {
+            *count += 1;
+        }
+    }
+}
+
+int64_t SkPathPriv::ThreadHeapAllocationCount() {
+    gCountingHeapAllocations.store(true, std::memory_order_relaxed);
+    return *static_cast<int64_t*>(SkTLS::Get(create_heap_allocation_count,
+                                             delete_heap_allocation_count));
+}
+
+// Every SkPathRef is preceded by a header that says where its memory came from, so that the last
+// unref() of a path ref in an arena destroys it without freeing the memory, and how much storage
+// for points and verbs follows it.
+namespace {
+    struct alignas(alignof(std::max_align_t)) PathRefHeader {
+        bool     fInArena;
+        uint32_t fInlineStorageSize;
+    };
+    static_assert(alignof(SkPathRef) <= alignof(PathRefHeader), "");
+    static_assert(sizeof(SkPathRef) % alignof(SkPoint) == 0, "");
+}
+
+void* SkPathRef::operator new(size_t size) {
+    return operator new(size, nullptr, 0);
+}
+
+void* SkPathRef::operator new(size_t size, SkArenaAlloc* alloc, size_t inlineStorageSize) {
+    size += inlineStorageSize;
+    PathRefHeader* header;
+    if (alloc) {
+        header = alloc->makeArrayDefault<PathRefHeader>(
+                1 + (size + sizeof(PathRefHeader) - 1) / sizeof(PathRefHeader));
+    } else {
+        count_heap_allocation();
+        header = static_cast<PathRefHeader*>(sk_malloc_throw(sizeof(PathRefHeader) + size));
+    }
+    header->fInArena = SkToBool(alloc);
+    header->fInlineStorageSize = SkToU32(inlineStorageSize);
+    return header + 1;
+}
+
+void SkPathRef::operator delete(void* ptr) {
+    auto header = static_cast<PathRefHeader*>(ptr) - 1;
+    if (!header->fInArena) {
+        sk_free(header);
+    }
+}
+
+void SkPathRef::operator delete(void* ptr, SkArenaAlloc*, size_t) {
+    SkPathRef::operator delete(ptr);
+}
+
+bool SkPathRef::isInArena() const {
+    return (reinterpret_cast<const PathRefHeader*>(this) - 1)->fInArena;
+}
+
+uint8_t* SkPathRef::inlineStorage() {
+    return reinterpret_cast<uint8_t*>(this + 1);
+}
+
+size_t SkPathRef::inlineStorageSize() const {
+    return (reinterpret_cast<const PathRefHeader*>(this) - 1)->fInlineStorageSize;
+}
+
+SkPathRef* SkPathRef::CreateWithStorage(SkArenaAlloc* alloc, int reserveVerbs, int reservePoints) {
+    size_t size = SkAlign8(sizeof(uint8_t) * reserveVerbs + sizeof(SkPoint) * reservePoints);
+    size_t inlineStorageSize;
+    if (alloc) {
+        // Arena memory is temporary, so there is always room for a short path.
+        inlineStorageSize = SkTMax(size, static_cast<size_t>(kMaxInlineStorageSize));
+    } else {
+        inlineStorageSize = size <= kMaxInlineStorageSize ? size : 0;
+    }
+    // The inline storage is taken up by the first makeSpace() that fits in it.
+    return new (alloc, inlineStorageSize) SkPathRef;
+}
+
+SkPathRef* SkPathRef::CreateInArena(SkArenaAlloc* alloc, int reserveVerbs, int reservePoints) {
+    return CreateWithStorage(alloc, reserveVerbs, reservePoints);
+}
+
+SkPathRef* SkPathRef::refOrCopy() const {
+    if (!this->isInArena()) {
+        return SkRef(const_cast<SkPathRef*>(this));
+    }
+    SkPathRef* copy = CreateWithStorage(nullptr, fVerbCnt, fPointCnt);
+    copy->copy(*this, 0, 0);
+    return copy;
+}
+
+void SkPathRef::growSpace(ptrdiff_t growSize) {
+    SkASSERT(growSize > 0);
+    if (!fPoints && static_cast<size_t>(growSize) <= this->inlineStorageSize()) {
+        fPoints = reinterpret_cast<SkPoint*>(this->inlineStorage());
+        fVerbs = this->inlineStorage() + this->inlineStorageSize();
+        fFreeSpace = this->inlineStorageSize();
+        return;
+    }
+
+    size_t oldSize = this->currSize();
+    // round to next multiple of 8 bytes
+    growSize = (growSize + 7) & ~static_cast<size_t>(7);
+    // we always at least double the allocation
+    if (static_cast<size_t>(growSize) < oldSize) {
+        growSize = oldSize;
+    }
+    if (growSize < kMinSize) {
+        growSize = kMinSize;
+    }
+    size_t newSize = oldSize + growSize;
+    size_t oldVerbSize = fVerbCnt * sizeof(uint8_t);
+    count_heap_allocation();
+    if (fOwnsStorage) {
+        // Note that realloc could memcpy more than we need. It seems to be a win anyway. TODO:
+        // encapsulate this.
+        fPoints = reinterpret_cast<SkPoint*>(sk_realloc_throw(fPoints, newSize));
+        void* newVerbsDst = reinterpret_cast<void*>(
+                                reinterpret_cast<intptr_t>(fPoints) + newSize - oldVerbSize);
+        void* oldVerbsSrc = reinterpret_cast<void*>(
+                                reinterpret_cast<intptr_t>(fPoints) + oldSize - oldVerbSize);
+        memmove(newVerbsDst, oldVerbsSrc, oldVerbSize);
+    } else {
+        // Inline and arena storage cannot grow, so move to the heap.
+        SkPoint* points = reinterpret_cast<SkPoint*>(sk_malloc_throw(newSize));
+        sk_careful_memcpy(points, fPoints, fPointCnt * sizeof(SkPoint));
+        sk_careful_memcpy(reinterpret_cast<uint8_t*>(points) + newSize - oldVerbSize,
+                          fVerbs - oldVerbSize, oldVerbSize);
+        fPoints = points;
+        fOwnsStorage = true;
+    }
+    fVerbs = reinterpret_cast<uint8_t*>(reinterpret_cast<intptr_t>(fPoints) + newSize);
+    fFreeSpace += growSize;
+}
+
+void SkPathRef::freeStorage() {
+    if (fOwnsStorage) {
+        sk_free(fPoints);
+        fOwnsStorage = false;
+    }
+}
+
 SkPathRef::~SkPathRef() {
     this->callGenIDChangeListeners();
     SkDEBUGCODE(this->validate();)
-    sk_free(fPoints);
+    this->freeStorage();
 
     SkDEBUGCODE(fPoints = nullptr;)
     SkDEBUGCODE(fVerbs = nullptr;)
@@ -117,15 +280,14 @@ void SkPathRef::CreateTransformedCopy(sk_sp<SkPathRef>* dst,
     SkDEBUGCODE(src.validate();)
     if (matrix.isIdentity()) {
         if (dst->get() != &src) {
-            src.ref();
-            dst->reset(const_cast<SkPathRef*>(&src));
+            dst->reset(src.refOrCopy());
             SkDEBUGCODE((*dst)->validate();)
         }
         return;
     }
 
     if (!(*dst)->unique()) {
-        dst->reset(new SkPathRef);
+        dst->reset(CreateWithStorage(nullptr, src.fVerbCnt, src.fPointCnt));
     }
 
     if (dst->get() != &src) {
@@ -307,7 +469,7 @@ void SkPathRef::Rewind(sk_sp<SkPathRef>* pathRef) {
     } else {
         int oldVCnt = (*pathRef)->countVerbs();
         int oldPCnt = (*pathRef)->countPoints();
-        pathRef->reset(new SkPathRef);
+        pathRef->reset(CreateWithStorage(nullptr, oldVCnt, oldPCnt));
         (*pathRef)->resetToSize(0, 0, 0, oldVCnt, oldPCnt);
     }
 }
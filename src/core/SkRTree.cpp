@@ -6,19 +6,34 @@
  */
 
 #include "SkRTree.h"
+#include "SkTSort.h"
 
-SkRTree::SkRTree(SkScalar aspectRatio) : fCount(0), fAspectRatio(aspectRatio) {}
+SkRTree::SkRTree(SkScalar aspectRatio)
+    : fCount(0), fAspectRatio(aspectRatio), fRoot(-1), fInOrder(true) {}
 
 SkRect SkRTree::getRootBound() const {
     if (fCount) {
-        return fRoot.fBounds;
+        return this->nodeBounds(fRoot);
     } else {
         return SkRect::MakeEmpty();
     }
 }
 
+SkRect SkRTree::nodeBounds(int node) const {
+    const Node& n = fNodes[node];
+    SkRect bounds = n.fBounds[0];
+    for (int i = 1; i < n.fNumChildren; ++i) {
+        bounds.join(n.fBounds[i]);
+    }
+    return bounds;
+}
+
 void SkRTree::insert(const SkRect boundsArray[], int N) {
     SkASSERT(0 == fCount);
+    fNodes.reset();
+    fFreeNodes.reset();
+    fRoot = -1;
+    fInOrder = true;
 
     SkTDArray<Branch> branches;
     branches.setReserve(N);
@@ -31,32 +46,46 @@ void SkRTree::insert(const SkRect boundsArray[], int N) {
 
         Branch* b = branches.push();
         b->fBounds = bounds;
-        b->fOpIndex = i;
+        b->fIndex = i;
+    }
+
+    fLeafForOp.setCount(N);
+    for (int i = 0; i < N; i++) {
+        fLeafForOp[i] = -1;
     }
 
     fCount = branches.count();
     if (fCount) {
         if (1 == fCount) {
             fNodes.setReserve(1);
-            Node* n = this->allocateNodeAtLevel(0);
-            n->fNumChildren = 1;
-            n->fChildren[0] = branches[0];
-            fRoot.fSubtree = n;
-            fRoot.fBounds  = branches[0].fBounds;
+            fRoot = this->allocateNodeAtLevel(0);
+            this->addChild(fRoot, branches[0]);
         } else {
             fNodes.setReserve(CountNodes(fCount, fAspectRatio));
-            fRoot = this->bulkLoad(&branches);
+            fRoot = this->bulkLoad(&branches).fIndex;
         }
+        fNodes[fRoot].fParent = -1;
     }
 }
 
-SkRTree::Node* SkRTree::allocateNodeAtLevel(uint16_t level) {
-    SkDEBUGCODE(Node* p = fNodes.begin());
-    Node* out = fNodes.push();
-    SkASSERT(fNodes.begin() == p);  // If this fails, we didn't setReserve() enough.
+int SkRTree::allocateNodeAtLevel(uint16_t level) {
+    int index;
+    if (fFreeNodes.count()) {
+        fFreeNodes.pop(&index);
+    } else {
+        index = fNodes.count();
+        fNodes.push();
+    }
+    Node* out = &fNodes[index];
     out->fNumChildren = 0;
     out->fLevel = level;
-    return out;
+    out->fParent = -1;
+    return index;
+}
+
+void SkRTree::freeNode(int node) {
+    fNodes[node].fNumChildren = 0;
+    fFreeNodes.push(node);
 }
 
 // This function parallels bulkLoad, but just counts how many nodes bulkLoad would allocate.
@@ -140,17 +169,18 @@ SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
                     remainder -= kMaxChildren - kMinChildren;
                 }
             }
-            Node* n = allocateNodeAtLevel(level);
-            n->fNumChildren = 1;
-            n->fChildren[0] = (*branches)[currentBranch];
+            int n = this->allocateNodeAtLevel(level);
             Branch b;
             b.fBounds = (*branches)[currentBranch].fBounds;
-            b.fSubtree = n;
-            ++currentBranch;
-            for (int k = 1; k < incrementBy && currentBranch < branches->count(); ++k) {
-                b.fBounds.join((*branches)[currentBranch].fBounds);
-                n->fChildren[k] = (*branches)[currentBranch];
-                ++n->fNumChildren;
+            b.fIndex = n;
+            for (int k = 0; k < incrementBy && currentBranch < branches->count(); ++k) {
+                const Branch& child = (*branches)[currentBranch];
+                b.fBounds.join(child.fBounds);
+                Node& node = fNodes[n];
+                node.fBounds  [node.fNumChildren] = child.fBounds;
+                node.fChildren[node.fNumChildren] = child.fIndex;
+                node.fNumChildren++;
+                this->setParent(n, child.fIndex);
                 ++currentBranch;
             }
             (*branches)[newBranches] = b;
@@ -161,19 +191,349 @@ SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
     return this->bulkLoad(branches, level + 1);
 }
 
+void SkRTree::setParent(int node, int child) {
+    if (0 == fNodes[node].fLevel) {
+        fLeafForOp[child] = node;
+    } else {
+        fNodes[child].fParent = node;
+    }
+}
+
+int SkRTree::slotInParent(int node) const {
+    const Node& parent = fNodes[fNodes[node].fParent];
+    for (int i = 0; i < parent.fNumChildren; ++i) {
+        if (parent.fChildren[i] == node) {
+            return i;
+        }
+    }
+    SkASSERT(false);
+    return -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static SkScalar area(const SkRect& r) {
+    return r.width() * r.height();
+}
+
+static SkRect joined(SkRect a, const SkRect& b) {
+    a.join(b);
+    return a;
+}
+
+void SkRTree::insert(int opIndex, const SkRect& bounds) {
+    SkASSERT(opIndex >= 0);
+    SkASSERT(opIndex >= fLeafForOp.count() || fLeafForOp[opIndex] < 0);
+    if (bounds.isEmpty()) {
+        return;
+    }
+    while (fLeafForOp.count() <= opIndex) {
+        fLeafForOp.push(-1);
+    }
+    if (fRoot < 0) {
+        fRoot = this->allocateNodeAtLevel(0);
+    }
+    // Once we start choosing leaves by area, a depth-first walk no longer visits ops in order.
+    if (fCount) {
+        fInOrder = false;
+    }
+    this->insertBranch({ opIndex, bounds }, 0);
+    fCount++;
+}
+
+// Guttman's ChooseLeaf, generalized to stop at any level: follow the child that needs the least
+// enlargement to hold the new bounds, breaking ties by smallest area.
+void SkRTree::insertBranch(const Branch& branch, int level) {
+    SkASSERT(fNodes[fRoot].fLevel >= level);
+    int node = fRoot;
+    while (fNodes[node].fLevel > level) {
+        const Node& n = fNodes[node];
+        int best = 0;
+        SkScalar bestGrowth = SK_ScalarMax,
+                 bestArea   = SK_ScalarMax;
+        for (int i = 0; i < n.fNumChildren; ++i) {
+            SkScalar childArea = area(n.fBounds[i]),
+                     growth    = area(joined(n.fBounds[i], branch.fBounds)) - childArea;
+            if (growth < bestGrowth || (growth == bestGrowth && childArea < bestArea)) {
+                best = i;
+                bestGrowth = growth;
+                bestArea = childArea;
+            }
+        }
+        node = n.fChildren[best];
+    }
+    this->addChild(node, branch);
+}
+
+void SkRTree::addChild(int node, const Branch& branch) {
+    Node& n = fNodes[node];
+    if (n.fNumChildren == kMaxChildren) {
+        this->split(node, branch);
+        return;
+    }
+    n.fBounds  [n.fNumChildren] = branch.fBounds;
+    n.fChildren[n.fNumChildren] = branch.fIndex;
+    n.fNumChildren++;
+    this->setParent(node, branch.fIndex);
+    this->growAncestors(node, branch.fBounds);
+}
+
+// Guttman's quadratic split: seed two groups with the pair of entries that would waste the most
+// area together, then hand out the rest one at a time, most decisive first.
+void SkRTree::split(int node, const Branch& branch) {
+    const int kCount = kMaxChildren + 1;
+    Branch entries[kCount];
+    {
+        const Node& n = fNodes[node];
+        for (int i = 0; i < kMaxChildren; ++i) {
+            entries[i] = { n.fChildren[i], n.fBounds[i] };
+        }
+        entries[kMaxChildren] = branch;
+    }
+
+    int seedA = 0, seedB = 1;
+    SkScalar worstWaste = -SK_ScalarMax;
+    for (int i = 0; i < kCount; ++i) {
+        for (int j = i + 1; j < kCount; ++j) {
+            SkScalar waste = area(joined(entries[i].fBounds, entries[j].fBounds))
+                           - area(entries[i].fBounds) - area(entries[j].fBounds);
+            if (waste > worstWaste) {
+                worstWaste = waste;
+                seedA = i;
+                seedB = j;
+            }
+        }
+    }
+
+    bool assigned[kCount] = { false };
+    bool inB[kCount] = { false };
+    assigned[seedA] = assigned[seedB] = true;
+    inB[seedB] = true;
+    SkRect boundsA = entries[seedA].fBounds,
+           boundsB = entries[seedB].fBounds;
+    int countA = 1, countB = 1;
+    for (int remaining = kCount - 2; remaining > 0; --remaining) {
+        // If one group needs everything that's left to reach kMinChildren, it gets it all.
+        bool forceA = countA + remaining == kMinChildren,
+             forceB = countB + remaining == kMinChildren;
+
+        int next = -1;
+        SkScalar growA = 0, growB = 0, bestDiff = -1;
+        for (int i = 0; i < kCount; ++i) {
+            if (assigned[i]) {
+                continue;
+            }
+            SkScalar a = area(joined(boundsA, entries[i].fBounds)) - area(boundsA),
+                     b = area(joined(boundsB, entries[i].fBounds)) - area(boundsB);
+            if (SkScalarAbs(a - b) > bestDiff) {
+                bestDiff = SkScalarAbs(a - b);
+                next = i;
+                growA = a;
+                growB = b;
+            }
+        }
+
+        bool toB;
+        if (forceA || forceB) {
+            toB = forceB;
+        } else if (growA != growB) {
+            toB = growB < growA;
+        } else if (area(boundsA) != area(boundsB)) {
+            toB = area(boundsB) < area(boundsA);
+        } else {
+            toB = countB < countA;
+        }
+        assigned[next] = true;
+        inB[next] = toB;
+        if (toB) {
+            boundsB.join(entries[next].fBounds);
+            countB++;
+        } else {
+            boundsA.join(entries[next].fBounds);
+            countA++;
+        }
+    }
+
+    // node keeps group A, and a new sibling takes group B.
+    const int level = fNodes[node].fLevel;
+    int sibling = this->allocateNodeAtLevel(level);
+    fNodes[node].fNumChildren = 0;
+    for (int i = 0; i < kCount; ++i) {
+        Node& n = fNodes[inB[i] ? sibling : node];
+        n.fBounds  [n.fNumChildren] = entries[i].fBounds;
+        n.fChildren[n.fNumChildren] = entries[i].fIndex;
+        n.fNumChildren++;
+        this->setParent(inB[i] ? sibling : node, entries[i].fIndex);
+    }
+
+    int parent = fNodes[node].fParent;
+    if (parent < 0) {
+        // Splitting the root grows the tree by a level.
+        fRoot = this->allocateNodeAtLevel(level + 1);
+        fNodes[fRoot].fBounds[0] = boundsA;
+        fNodes[fRoot].fChildren[0] = node;
+        fNodes[fRoot].fNumChildren = 1;
+        fNodes[node].fParent = fRoot;
+        this->addChild(fRoot, { sibling, boundsB });
+        return;
+    }
+
+    // Group A may have shrunk, but everything above parent now has to hold the new branch.
+    fNodes[parent].fBounds[this->slotInParent(node)] = boundsA;
+    this->growAncestors(parent, branch.fBounds);
+    this->addChild(parent, { sibling, boundsB });
+}
+
+void SkRTree::growAncestors(int node, const SkRect& bounds) {
+    for (int parent = fNodes[node].fParent; parent >= 0; parent = fNodes[node].fParent) {
+        SkRect& slot = fNodes[parent].fBounds[this->slotInParent(node)];
+        if (slot.contains(bounds)) {
+            return;  // ... and so do all the slots above it.
+        }
+        slot.join(bounds);
+        node = parent;
+    }
+}
+
+void SkRTree::tightenAncestors(int node) {
+    for (int parent = fNodes[node].fParent; parent >= 0; parent = fNodes[node].fParent) {
+        SkRect& slot = fNodes[parent].fBounds[this->slotInParent(node)];
+        SkRect bounds = this->nodeBounds(node);
+        if (slot == bounds) {
+            return;
+        }
+        slot = bounds;
+        node = parent;
+    }
+}
+
+void SkRTree::removeSlot(int node, int slot) {
+    Node& n = fNodes[node];
+    // Children are unordered, so the last one can fill the hole.
+    n.fNumChildren--;
+    n.fBounds  [slot] = n.fBounds  [n.fNumChildren];
+    n.fChildren[slot] = n.fChildren[n.fNumChildren];
+    if (slot != n.fNumChildren) {
+        fInOrder = false;
+    }
+}
+
+bool SkRTree::remove(int opIndex) {
+    if (opIndex < 0 || opIndex >= fLeafForOp.count() || fLeafForOp[opIndex] < 0) {
+        return false;
+    }
+    int leaf = fLeafForOp[opIndex];
+    fLeafForOp[opIndex] = -1;
+    const Node& n = fNodes[leaf];
+    for (int i = 0; i < n.fNumChildren; ++i) {
+        if (n.fChildren[i] == opIndex) {
+            this->removeSlot(leaf, i);
+            break;
+        }
+    }
+    fCount--;
+    this->condense(leaf);
+    return true;
+}
+
+void SkRTree::collectOps(int node, SkTDArray<Branch>* ops) {
+    const Node& n = fNodes[node];
+    for (int i = 0; i < n.fNumChildren; ++i) {
+        if (0 == n.fLevel) {
+            ops->push({ n.fChildren[i], n.fBounds[i] });
+        } else {
+            this->collectOps(n.fChildren[i], ops);
+        }
+    }
+    this->freeNode(node);
+}
+
+// Guttman's CondenseTree.  Nodes left with too few children are dissolved on the way up.  We
+// reinsert all the ops below them one by one rather than reinserting whole subtrees at their
+// own level, which is simpler when the tree shrinks, and underflow is rare anyway.
+void SkRTree::condense(int node) {
+    SkTDArray<Branch> orphans;
+    while (node != fRoot) {
+        int parent = fNodes[node].fParent;
+        if (fNodes[node].fNumChildren < kMinChildren) {
+            this->removeSlot(parent, this->slotInParent(node));
+            this->collectOps(node, &orphans);
+        } else {
+            fNodes[parent].fBounds[this->slotInParent(node)] = this->nodeBounds(node);
+        }
+        node = parent;
+    }
+
+    if (0 == fNodes[fRoot].fNumChildren) {
+        // Everything left is an orphan, so start over from an empty leaf.
+        fNodes[fRoot].fLevel = 0;
+    }
+    for (const Branch& orphan : orphans) {
+        this->insertBranch(orphan, 0);
+    }
+
+    // A root with a single child is just a longer path to it.
+    while (fNodes[fRoot].fLevel > 0 && 1 == fNodes[fRoot].fNumChildren) {
+        int child = fNodes[fRoot].fChildren[0];
+        this->freeNode(fRoot);
+        fRoot = child;
+        fNodes[fRoot].fParent = -1;
+    }
+    if (0 == fCount) {
+        fNodes.reset();
+        fFreeNodes.reset();
+        fRoot = -1;
+        fInOrder = true;
+    }
+}
+
+void SkRTree::update(int opIndex, const SkRect& bounds) {
+    SkASSERT(opIndex >= 0);
+    if (opIndex >= fLeafForOp.count() || fLeafForOp[opIndex] < 0) {
+        this->insert(opIndex, bounds);
+        return;
+    }
+    if (bounds.isEmpty()) {
+        this->remove(opIndex);
+        return;
+    }
+
+    int leaf = fLeafForOp[opIndex];
+    Node& n = fNodes[leaf];
+    int slot = 0;
+    while (n.fChildren[slot] != opIndex) {
+        slot++;
+    }
+    // If the leaf already covers the new bounds, nothing has to move.
+    if (leaf == fRoot || fNodes[n.fParent].fBounds[this->slotInParent(leaf)].contains(bounds)) {
+        n.fBounds[slot] = bounds;
+        this->tightenAncestors(leaf);
+        return;
+    }
+    this->remove(opIndex);
+    this->insert(opIndex, bounds);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void SkRTree::search(const SkRect& query, SkTDArray<int>* results) const {
-    if (fCount > 0 && SkRect::Intersects(fRoot.fBounds, query)) {
-        this->search(fRoot.fSubtree, query, results);
+    if (fCount > 0) {
+        int start = results->count();
+        this->search(fRoot, query, results);
+        if (!fInOrder && results->count() - start > 1) {
+            SkTQSort(results->begin() + start, results->end() - 1);
+        }
     }
 }
 
-void SkRTree::search(Node* node, const SkRect& query, SkTDArray<int>* results) const {
-    for (int i = 0; i < node->fNumChildren; ++i) {
-        if (SkRect::Intersects(node->fChildren[i].fBounds, query)) {
-            if (0 == node->fLevel) {
-                results->push(node->fChildren[i].fOpIndex);
+void SkRTree::search(int nodeIndex, const SkRect& query, SkTDArray<int>* results) const {
+    const Node& node = fNodes[nodeIndex];
+    for (int i = 0; i < node.fNumChildren; ++i) {
+        if (SkRect::Intersects(node.fBounds[i], query)) {
+            if (0 == node.fLevel) {
+                results->push(node.fChildren[i]);
             } else {
-                this->search(node->fChildren[i].fSubtree, query, results);
+                this->search(node.fChildren[i], query, results);
             }
         }
     }
@@ -183,6 +543,45 @@ size_t SkRTree::bytesUsed() const {
     size_t byteCount = sizeof(SkRTree);
 
     byteCount += fNodes.reserved() * sizeof(Node);
+    byteCount += fFreeNodes.reserved() * sizeof(int);
+    byteCount += fLeafForOp.reserved() * sizeof(int);
 
     return byteCount;
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkRTree::isValid() const {
+    if (0 == fCount) {
+        return fRoot < 0;
+    }
+    SkRect bounds;
+    int count = 0;
+    return fNodes[fRoot].fParent < 0 && this->isValid(fRoot, &bounds, &count) && count == fCount;
+}
+
+bool SkRTree::isValid(int nodeIndex, SkRect* bounds, int* count) const {
+    const Node& node = fNodes[nodeIndex];
+    if (node.fNumChildren < (nodeIndex == fRoot ? 1 : kMinChildren)) {
+        return false;
+    }
+    for (int i = 0; i < node.fNumChildren; ++i) {
+        int child = node.fChildren[i];
+        if (0 == node.fLevel) {
+            if (fLeafForOp[child] != nodeIndex) {
+                return false;
+            }
+            (*count)++;
+        } else {
+            SkRect childBounds;
+            if (fNodes[child].fParent != nodeIndex ||
+                fNodes[child].fLevel != node.fLevel - 1 ||
+                !this->isValid(child, &childBounds, count) ||
+                childBounds != node.fBounds[i]) {
+                return false;
+            }
+        }
+    }
+    *bounds = this->nodeBounds(nodeIndex);
+    return true;
+}
@@ -16,8 +16,14 @@
  * An R-Tree implementation. In short, it is a balanced n-ary tree containing a hierarchy of
  * bounding rectangles.
  *
- * It only supports bulk-loading, i.e. creation from a batch of bounding rectangles.
- * This performs a bottom-up bulk load using the STR (sort-tile-recursive) algorithm.
+ * It is usually created from a batch of bounding rectangles with a bottom-up bulk load using the
+ * STR (sort-tile-recursive) algorithm.  After that, single entries can be inserted, removed, or
+ * moved in place (with Guttman's quadratic split and condense-tree), so a picture that changes a
+ * little every frame doesn't need to rebuild its whole hierarchy.
+ *
+ * Nodes live in one array and refer to each other by index, and each node keeps its children's
+ * bounds together, so search() walks a few contiguous blocks of memory rather than chasing
+ * pointers all over the heap.
  *
  * TODO: Experiment with other bulk-load algorithms (in particular the Hilbert pack variant,
  * which groups rects by position on the Hilbert curve, is probably worth a look). There also
@@ -27,6 +33,8 @@
  *
  *  Beckmann, N.; Kriegel, H. P.; Schneider, R.; Seeger, B. (1990). "The R*-tree:
  *      an efficient and robust access method for points and rectangles"
+ *
+ *  Guttman, A. (1984). "R-trees: a dynamic index structure for spatial searching"
  */
 class SkRTree : public SkBBoxHierarchy {
 public:
@@ -40,42 +48,64 @@ public:
     explicit SkRTree(SkScalar aspectRatio = 1);
     ~SkRTree() override {}
 
+    // Bulk-loads an empty tree.  Entry i has bounds rects[i], and empty rects are skipped.
     void insert(const SkRect[], int N) override;
+    // Results are always in increasing order, as SkRecordDraw expects.
     void search(const SkRect& query, SkTDArray<int>* results) const override;
     size_t bytesUsed() const override;
 
+    /**
+     *  Adds a single entry.  opIndex must not already be in the tree.  Like the bulk load,
+     *  this ignores empty bounds.
+     */
+    void insert(int opIndex, const SkRect& bounds);
+
+    /**
+     *  Removes a single entry.  Returns false if opIndex wasn't in the tree.
+     */
+    bool remove(int opIndex);
+
+    /**
+     *  Moves an entry to new bounds, inserting it if it wasn't in the tree, or removing it if the
+     *  new bounds are empty.  When the new bounds stay inside the entry's leaf, this only has to
+     *  tighten the bounds above it.
+     */
+    void update(int opIndex, const SkRect& bounds);
+
     // Methods and constants below here are only public for tests.
 
     // Return the depth of the tree structure.
-    int getDepth() const { return fCount ? fRoot.fSubtree->fLevel + 1 : 0; }
+    int getDepth() const { return fCount ? fNodes[fRoot].fLevel + 1 : 0; }
     // Insertion count (not overall node count, which may be greater).
     int getCount() const { return fCount; }
 
     // Get the root bound.
     SkRect getRootBound() const override;
 
+    // Are the bounds above every node exactly the union of its children's, does every non-root
+    // node have at least kMinChildren children, and do the parent and leaf links all agree?
+    bool isValid() const;
+
     // These values were empirically determined to produce reasonable performance in most cases.
     static const int kMinChildren = 6,
                      kMaxChildren = 11;
 
 private:
-    struct Node;
-
+    // A child of a node: either another node, or at level 0 an op index.
     struct Branch {
-        union {
-            Node* fSubtree;
-            int fOpIndex;
-        };
+        int    fIndex;
         SkRect fBounds;
     };
 
     struct Node {
         uint16_t fNumChildren;
         uint16_t fLevel;
-        Branch fChildren[kMaxChildren];
+        int      fParent;                  // -1 for the root.
+        SkRect   fBounds[kMaxChildren];    // Together, so search() scans one block.
+        int      fChildren[kMaxChildren];  // Node indices, or op indices at level 0.
     };
 
-    void search(Node* root, const SkRect& query, SkTDArray<int>* results) const;
+    void search(int node, const SkRect& query, SkTDArray<int>* results) const;
 
     // Consumes the input array.
     Branch bulkLoad(SkTDArray<Branch>* branches, int level = 0);
@@ -83,13 +113,38 @@ private:
     // How many times will bulkLoad() call allocateNodeAtLevel()?
     static int CountNodes(int branches, SkScalar aspectRatio);
 
-    Node* allocateNodeAtLevel(uint16_t level);
+    int allocateNodeAtLevel(uint16_t level);
+    void freeNode(int node);
+
+    // Records that node is now the parent of child, a node or (at level 0) an op index.
+    void setParent(int node, int child);
+    // Which of its parent's children is node?
+    int slotInParent(int node) const;
+    SkRect nodeBounds(int node) const;
+
+    void insertBranch(const Branch&, int level);
+    void addChild(int node, const Branch&);
+    void split(int node, const Branch&);
+    // Grows the bounds above node to include bounds.
+    void growAncestors(int node, const SkRect& bounds);
+    // Recomputes the bounds above node after it has shrunk.
+    void tightenAncestors(int node);
+    void removeSlot(int node, int slot);
+    // Fixes up the tree after removing a child from node, which may leave it too small.
+    void condense(int node);
+    void collectOps(int node, SkTDArray<Branch>* ops);
+
+    bool isValid(int node, SkRect* bounds, int* count) const;
 
     // This is the count of data elements (rather than total nodes in the tree)
     int fCount;
     SkScalar fAspectRatio;
-    Branch fRoot;
+    int fRoot;                  // -1 if there are no nodes.
     SkTDArray<Node> fNodes;
+    SkTDArray<int> fFreeNodes;
+    SkTDArray<int> fLeafForOp;  // Which leaf holds each op index, or -1.
+    // Does a depth-first walk visit op indices in increasing order?  True after a bulk load.
+    bool fInOrder;
 
     typedef SkBBoxHierarchy INHERITED;
 };
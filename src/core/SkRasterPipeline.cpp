@@ -7,23 +7,42 @@
 
 #include "SkOpts.h"
 #include "SkRasterPipeline.h"
+#include "SkRefCnt.h"
 
 SkRasterPipeline::SkRasterPipeline() {}
 
+SkRasterPipeline::SkRasterPipeline(const SkRasterPipeline& that) : fStages(that.fStages) {}
+
+SkRasterPipeline& SkRasterPipeline::operator=(const SkRasterPipeline& that) {
+    fStages = that.fStages;
+    this->forget_jumper_stages();
+    return *this;
+}
+
+SkRasterPipeline::~SkRasterPipeline() {
+    SkSafeUnref(fJumperStages.load());
+}
+
+void SkRasterPipeline::forget_jumper_stages() {
+    SkSafeUnref(fJumperStages.exchange(nullptr));
+}
+
 void SkRasterPipeline::append(StockStage stage, void* ctx) {
     SkASSERT(stage != from_srgb);
     fStages.push_back({stage, ctx});
+    this->forget_jumper_stages();
 }
 
 void SkRasterPipeline::extend(const SkRasterPipeline& src) {
     fStages.insert(fStages.end(),
                    src.fStages.begin(), src.fStages.end());
+    this->forget_jumper_stages();
 }
 
 void SkRasterPipeline::run(size_t x, size_t n) const {
     if (!fStages.empty()) {
     #if defined(SK_JUMPER)
-        if (this->run_with_jumper(x, n)) {
+        if (this->run_with_jumper(x,0,n,1, nullptr)) {
             return;
         }
     #endif
@@ -31,6 +50,47 @@ void SkRasterPipeline::run(size_t x, size_t n) const {
     }
 }
 
+void SkRasterPipeline::run_2d(size_t x, size_t y, size_t w, size_t h,
+                              const std::function<void(size_t)>& setRow) const {
+    if (!fStages.empty() && w > 0) {
+    #if defined(SK_JUMPER)
+        if (this->run_with_jumper(x,y,w,h, &setRow)) {
+            return;
+        }
+    #endif
+        // SkOpts::run_pipeline() builds its program on each call, so this path still pays
+        // the per-row setup.  It's only used for stages SkJumper doesn't implement yet.
+        for (size_t row = 0; row < h; row++) {
+            setRow(y+row);
+            SkOpts::run_pipeline(x,w, fStages.data(), SkToInt(fStages.size()));
+        }
+    }
+}
+
+std::function<void(size_t, size_t)> SkRasterPipeline::compile() const {
+    if (fStages.empty()) {
+        return [](size_t, size_t) {};
+    }
+#if defined(SK_JUMPER)
+    if (auto fn = this->compile_with_jumper()) {
+        return fn;
+    }
+#endif
+    std::vector<Stage> stages = fStages;
+    return [stages](size_t x, size_t n) {
+        SkOpts::run_pipeline(x,n, stages.data(), SkToInt(stages.size()));
+    };
+}
+
+#if !defined(SK_JUMPER)
+    // Without SkJumper there's nothing to cache.
+    SkRasterPipeline::ProgramCacheStats SkRasterPipeline::GetProgramCacheStats() {
+        return { 0, 0 };
+    }
+    void SkRasterPipeline::SetProgramCacheEnabled(bool) {}
+    void SkRasterPipeline::PurgeProgramCache() {}
+#endif
+
 void SkRasterPipeline::dump() const {
     SkDebugf("SkRasterPipeline, %d stages\n", SkToInt(fStages.size()));
     for (auto&& st : fStages) {
@@ -56,6 +116,7 @@ void SkRasterPipeline::dump() const {
 void SkRasterPipeline::append_from_srgb(SkAlphaType at) {
     //this->append(from_srgb);
     fStages.push_back({from_srgb, nullptr});
+    this->forget_jumper_stages();
 
     if (at == kPremul_SkAlphaType) {
         this->append(SkRasterPipeline::clamp_a);
@@ -12,8 +12,12 @@
 #include "SkNx.h"
 #include "SkTArray.h"
 #include "SkTypes.h"
+#include <atomic>
+#include <functional>
 #include <vector>
 
+class SkRefCnt;
+
 /**
  * SkRasterPipeline provides a cheap way to chain together a pixel processing pipeline.
  *
@@ -105,6 +109,9 @@
 class SkRasterPipeline {
 public:
     SkRasterPipeline();
+    SkRasterPipeline(const SkRasterPipeline&);
+    SkRasterPipeline& operator=(const SkRasterPipeline&);
+    ~SkRasterPipeline();
 
     enum StockStage {
     #define M(stage) stage,
@@ -120,6 +127,29 @@ public:
     // Runs the pipeline walking x through [x,x+n).
     void run(size_t x, size_t n) const;
 
+    // Runs the pipeline over the w x h rectangle at (x,y), walking x through [x,x+w) per row.
+    // The program is built once for the whole rectangle rather than once per row.
+    // Before each row we call setRow(y), which should point any per-row contexts
+    // (e.g. the pointers behind load and store stages, or seed_shader's y) at that row.
+    void run_2d(size_t x, size_t y, size_t w, size_t h,
+                const std::function<void(size_t y)>& setRow) const;
+
+    // Builds this pipeline into a reusable function that runs it walking x through [x,x+n).
+    // Stage contexts are read each time the function runs, so callers may keep changing what
+    // they point to between calls.  The function does not refer back to this pipeline.
+    std::function<void(size_t x, size_t n)> compile() const;
+
+    // The first run or compile of a pipeline consults a process-wide cache keyed by its sequence
+    // of stages, so pipelines that differ only in their contexts share that work.  The pipeline
+    // keeps what it found until another stage is added, so running it again skips the cache.
+    struct ProgramCacheStats {
+        int hits;
+        int misses;
+    };
+    static ProgramCacheStats GetProgramCacheStats();
+    static void SetProgramCacheEnabled(bool);  // On by default; turning it off is for benchmarks.
+    static void PurgeProgramCache();
+
     void dump() const;
 
     struct Stage {
@@ -134,9 +164,15 @@ public:
     bool empty() const { return fStages.empty(); }
 
 private:
-    bool run_with_jumper(size_t x, size_t n) const;
+    bool run_with_jumper(size_t x, size_t y, size_t w, size_t h,
+                         const std::function<void(size_t)>* setRow) const;
+    std::function<void(size_t, size_t)> compile_with_jumper() const;
+    void forget_jumper_stages();
 
     std::vector<Stage> fStages;
+
+    // What SkJumper looked up for fStages, or null until the first run or compile.
+    mutable std::atomic<SkRefCnt*> fJumperStages{nullptr};
 };
 
 #endif//SkRasterPipeline_DEFINED
@@ -30,6 +30,7 @@ public:
     {}
 
     void blitH    (int x, int y, int w)                            override;
+    void blitRect (int x, int y, int w, int h)                     override;
     void blitAntiH(int x, int y, const SkAlpha[], const int16_t[]) override;
     void blitMask (const SkMask&, const SkIRect& clip)             override;
 
@@ -38,6 +39,7 @@ public:
     // blits using something like a SkRasterPipeline::runFew() method.
 
 private:
+    void build_blitH();
     void append_load_d(SkRasterPipeline*) const;
     void append_blend (SkRasterPipeline*) const;
     void maybe_clamp  (SkRasterPipeline*) const;
@@ -52,13 +54,13 @@ private:
     bool     fCanMemsetInBlitH = false;
     uint64_t fMemsetColor      = 0;     // Big enough for largest dst format, F16.
 
-    // Built lazily on first use.
-    SkRasterPipeline fBlitH,
-                     fBlitAntiH,
-                     fBlitMaskA8,
-                     fBlitMaskLCD16;
+    // Compiled lazily on first use.
+    std::function<void(size_t, size_t)> fBlitH,
+                                        fBlitAntiH,
+                                        fBlitMaskA8,
+                                        fBlitMaskLCD16;
 
-    // These values are pointed to by the blit pipelines above,
+    // These values are pointed to by the blit functions above,
     // which allows us to adjust them from call to call.
     void*       fDstPtr          = nullptr;
     const void* fMaskPtr         = nullptr;
@@ -223,8 +225,31 @@ void SkRasterPipelineBlitter::blitH(int x, int y, int w) {
         }
     }
 
-    auto& p = fBlitH;
-    if (p.empty()) {
+    this->build_blitH();
+    fBlitH(x,w);
+}
+
+void SkRasterPipelineBlitter::blitRect(int x, int y, int w, int h) {
+    if (fCanMemsetInBlitH) {
+        for (int ys = y; ys < y + h; ys++) {
+            this->blitH(x, ys, w);
+        }
+        return;
+    }
+
+    // Skip blitH()'s per-row checks and run the compiled blitH function directly.  It's built
+    // once per blitter, where run_2d() would build its program again for every rect.
+    this->build_blitH();
+    for (int ys = y; ys < y + h; ys++) {
+        fDstPtr = fDst.writable_addr(0,ys);
+        fCurrentY = ys;
+        fBlitH(x,w);
+    }
+}
+
+void SkRasterPipelineBlitter::build_blitH() {
+    if (!fBlitH) {
+        SkRasterPipeline p;
         p.extend(fShader);
         if (fBlend != SkBlendMode::kSrc) {
             this->append_load_d(&p);
@@ -232,13 +257,13 @@ void SkRasterPipelineBlitter::blitH(int x, int y, int w) {
             this->maybe_clamp(&p);
         }
         this->append_store(&p);
+        fBlitH = p.compile();
     }
-    p.run(x,w);
 }
 
 void SkRasterPipelineBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const int16_t runs[]) {
-    auto& p = fBlitAntiH;
-    if (p.empty()) {
+    if (!fBlitAntiH) {
+        SkRasterPipeline p;
         p.extend(fShader);
         if (fBlend == SkBlendMode::kSrcOver) {
             p.append(SkRasterPipeline::scale_1_float, &fCurrentCoverage);
@@ -251,6 +276,7 @@ void SkRasterPipelineBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const
         }
         this->maybe_clamp(&p);
         this->append_store(&p);
+        fBlitAntiH = p.compile();
     }
 
     fDstPtr = fDst.writable_addr(0,y);
@@ -261,7 +287,7 @@ void SkRasterPipelineBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const
             case 0xff: this->blitH(x,y,run); break;
             default:
                 fCurrentCoverage = *aa * (1/255.0f);
-                p.run(x,run);
+                fBlitAntiH(x,run);
         }
         x    += run;
         runs += run;
@@ -275,8 +301,8 @@ void SkRasterPipelineBlitter::blitMask(const SkMask& mask, const SkIRect& clip)
         return INHERITED::blitMask(mask, clip);
     }
 
-    if (mask.fFormat == SkMask::kA8_Format && fBlitMaskA8.empty()) {
-        auto& p = fBlitMaskA8;
+    if (mask.fFormat == SkMask::kA8_Format && !fBlitMaskA8) {
+        SkRasterPipeline p;
         p.extend(fShader);
         if (fBlend == SkBlendMode::kSrcOver) {
             p.append(SkRasterPipeline::scale_u8, &fMaskPtr);
@@ -289,16 +315,18 @@ void SkRasterPipelineBlitter::blitMask(const SkMask& mask, const SkIRect& clip)
         }
         this->maybe_clamp(&p);
         this->append_store(&p);
+        fBlitMaskA8 = p.compile();
     }
 
-    if (mask.fFormat == SkMask::kLCD16_Format && fBlitMaskLCD16.empty()) {
-        auto& p = fBlitMaskLCD16;
+    if (mask.fFormat == SkMask::kLCD16_Format && !fBlitMaskLCD16) {
+        SkRasterPipeline p;
         p.extend(fShader);
         this->append_load_d(&p);
         this->append_blend(&p);
         p.append(SkRasterPipeline::lerp_565, &fMaskPtr);
         this->maybe_clamp(&p);
         this->append_store(&p);
+        fBlitMaskLCD16 = p.compile();
     }
 
     int x = clip.left();
@@ -309,11 +337,11 @@ void SkRasterPipelineBlitter::blitMask(const SkMask& mask, const SkIRect& clip)
         switch (mask.fFormat) {
             case SkMask::kA8_Format:
                 fMaskPtr = mask.getAddr8(x,y)-x;
-                fBlitMaskA8.run(x,clip.width());
+                fBlitMaskA8(x,clip.width());
                 break;
             case SkMask::kLCD16_Format:
                 fMaskPtr = mask.getAddrLCD16(x,y)-x;
-                fBlitMaskLCD16.run(x,clip.width());
+                fBlitMaskLCD16(x,clip.width());
                 break;
             default:
                 // TODO
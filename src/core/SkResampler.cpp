@@ -0,0 +1,322 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkConvolver.h"
+#include "SkHalf.h"
+#include "SkNx.h"
+#include "SkOpts.h"
+#include "SkResampler.h"
+#include "SkTaskGroup.h"
+
+// Bands of destination rows resized concurrently by Resize().  Each band filters the source
+// rows its vertical filters overlap with its neighbors' again, so bands should not be too thin.
+static constexpr int kMinBandHeight = 64;
+static constexpr int kMaxBands      = 32;
+
+static constexpr float kFixedToFloat = 1.0f / (1 << SkConvolutionFilter1D::kShiftBits);
+
+static size_t bytes_per_filtered_pixel(SkColorType colorType) {
+    // F16 is filtered in float, the rest in their own format.
+    return kRGBA_F16_SkColorType == colorType ? 4 * sizeof(float)
+                                              : SkColorTypeBytesPerPixel(colorType);
+}
+
+struct SkResampler::Filters : public SkNVRefCnt<Filters> {
+    SkColorType           fColorType;
+    bool                  fHasAlpha;
+    int                   fSrcWidth;
+
+    // Every destination column reads fTaps source columns, starting at its offset, so the
+    // horizontal filters need no per column lengths.  Filters are zero padded to fTaps.
+    int                   fTaps;
+    SkTDArray<int32_t>    fOffsets;
+    SkTDArray<int16_t>    fWeights;
+
+    SkConvolutionFilter1D fFilterY;
+};
+
+std::unique_ptr<SkResampler> SkResampler::Make(const SkPixmap& dst, const SkISize& srcSize,
+                                               SkBitmapScaler::ResizeMethod method) {
+    if (!dst.addr()) {
+        return nullptr;
+    }
+    sk_sp<const Filters> filters = MakeFilters(dst.info(), srcSize, method);
+    if (!filters) {
+        return nullptr;
+    }
+    return std::unique_ptr<SkResampler>(new SkResampler(std::move(filters), dst, 0,
+                                                        dst.height()));
+}
+
+sk_sp<const SkResampler::Filters> SkResampler::MakeFilters(const SkImageInfo& dstInfo,
+                                                           const SkISize& srcSize,
+                                                           SkBitmapScaler::ResizeMethod method) {
+    switch (dstInfo.colorType()) {
+        case kN32_SkColorType:
+        case kAlpha_8_SkColorType:
+        case kRGBA_F16_SkColorType:
+            break;
+        default:
+            return nullptr;
+    }
+    if (dstInfo.isEmpty() || srcSize.isEmpty()) {
+        return nullptr;
+    }
+
+    sk_sp<Filters> filters(new Filters);
+    filters->fColorType = dstInfo.colorType();
+    filters->fHasAlpha = !dstInfo.isOpaque();
+    filters->fSrcWidth = srcSize.width();
+
+    SkConvolutionFilter1D filterX;
+    SkBitmapScaler::ComputeFilters(method, srcSize, dstInfo.dimensions(), &filterX,
+                                   &filters->fFilterY);
+
+    const int width = filterX.numValues();
+    const int taps = SkTMin(SkTMax(filterX.maxFilter(), 1), srcSize.width());
+    filters->fTaps = taps;
+    filters->fOffsets.setCount(width);
+    filters->fWeights.setCount(width * taps);
+    sk_bzero(filters->fWeights.begin(), filters->fWeights.bytes());
+    for (int x = 0; x < width; x++) {
+        int offset, length;
+        const SkConvolutionFilter1D::ConvolutionFixed* values =
+                filterX.FilterForValue(x, &offset, &length);
+
+        // Keep all taps inside the row, by starting shorter filters near the right edge early.
+        const int start = SkTMax(0, SkTMin(offset, srcSize.width() - taps));
+        SkASSERT(offset - start + length <= taps);
+        filters->fOffsets[x] = start;
+        for (int i = 0; i < length; i++) {
+            filters->fWeights[x * taps + offset - start + i] = values[i];
+        }
+    }
+    return std::move(filters);
+}
+
+SkResampler::SkResampler(sk_sp<const Filters> filters, const SkPixmap& dst, int dstTop,
+                         int dstBottom)
+    : fFilters(std::move(filters))
+    , fDst(dst)
+    , fNextSourceRow(0)
+    , fFirstSourceRow(0)
+    , fEndSourceRow(0)
+    , fNextDstRow(dstTop)
+    , fEndDstRow(dstBottom)
+{
+    // Find the source rows that these destination rows need, and how many filtered rows must
+    // be kept: each destination row is written once all of its own and all earlier rows'
+    // source rows are available, and then still needs its first source row.
+    const SkConvolutionFilter1D& filterY = fFilters->fFilterY;
+    int ringRows = 1;
+    fFirstSourceRow = SK_MaxS32;
+    for (int y = dstTop; y < dstBottom; y++) {
+        int offset, length;
+        filterY.FilterForValue(y, &offset, &length);
+        if (length > 0) {
+            fFirstSourceRow = SkTMin(fFirstSourceRow, offset);
+            fEndSourceRow = SkTMax(fEndSourceRow, offset + length);
+            ringRows = SkTMax(ringRows, fEndSourceRow - offset);
+        }
+    }
+    if (SK_MaxS32 == fFirstSourceRow) {
+        fFirstSourceRow = 0;
+    }
+
+    const int width = fDst.width();
+    const SkColorType colorType = fFilters->fColorType;
+
+    // Pad the filtered rows, as SkOpts::convolve_vertically may read up to 8 pixels at a time.
+    fFilteredRowBytes = (width + 8) * bytes_per_filtered_pixel(colorType);
+    fFilteredRowCount = ringRows;
+    fFilteredRows.reset(fFilteredRowBytes * fFilteredRowCount);
+    switch (colorType) {
+        case kAlpha_8_SkColorType:
+            fAccum.reset(width);
+            break;
+        case kRGBA_F16_SkColorType:
+            fSrcFloats.reset(4 * fFilters->fSrcWidth);
+            fAccumFloats.reset(4 * width);
+            break;
+        default:
+            break;
+    }
+
+    // Rows whose filters are all zeros need no source rows at all.
+    this->writeReadyRows();
+}
+
+SkResampler::~SkResampler() {}
+
+void SkResampler::pushRow(const void* row) {
+    const int y = fNextSourceRow++;
+    if (y < fFirstSourceRow || y >= fEndSourceRow) {
+        return;
+    }
+    this->filterRow(row, this->filteredRow(y));
+    this->writeReadyRows();
+}
+
+void SkResampler::writeReadyRows() {
+    const SkConvolutionFilter1D& filterY = fFilters->fFilterY;
+    for (; fNextDstRow < fEndDstRow; fNextDstRow++) {
+        int offset, length;
+        filterY.FilterForValue(fNextDstRow, &offset, &length);
+        if (length > 0 && offset + length > fNextSourceRow) {
+            break;
+        }
+        this->writeDstRow(fNextDstRow);
+    }
+}
+
+void SkResampler::filterRow(const void* src, uint8_t* dst) {
+    const Filters& filters = *fFilters;
+    const int width = fDst.width();
+    const int taps = filters.fTaps;
+    const int32_t* offsets = filters.fOffsets.begin();
+    const int16_t* weights = filters.fWeights.begin();
+
+    switch (filters.fColorType) {
+        case kN32_SkColorType:
+            SkOpts::resample_row_8888((uint32_t*)dst, width, (const uint32_t*)src, offsets,
+                                      weights, taps);
+            break;
+        case kAlpha_8_SkColorType: {
+            auto alphas = (const uint8_t*)src;
+            for (int x = 0; x < width; x++) {
+                const uint8_t* px = alphas + offsets[x];
+                const int16_t* w = weights + x * taps;
+                int accum = 0;
+                for (int i = 0; i < taps; i++) {
+                    accum += w[i] * px[i];
+                }
+                dst[x] = SkTPin(accum >> SkConvolutionFilter1D::kShiftBits, 0, 255);
+            }
+            break;
+        }
+        case kRGBA_F16_SkColorType: {
+            // Each source pixel is read by several taps, so convert the row to float once.
+            auto halfs = (const uint64_t*)src;
+            float* floats = fSrcFloats.get();
+            for (int x = 0; x < filters.fSrcWidth; x++) {
+                SkHalfToFloat_finite_ftz(halfs[x]).store(floats + 4 * x);
+            }
+
+            auto out = (float*)dst;
+            for (int x = 0; x < width; x++) {
+                const float* px = floats + 4 * offsets[x];
+                const int16_t* w = weights + x * taps;
+                Sk4f accum(0.0f);
+                for (int i = 0; i < taps; i++) {
+                    accum = accum + Sk4f::Load(px + 4 * i) * (w[i] * kFixedToFloat);
+                }
+                accum.store(out + 4 * x);
+            }
+            break;
+        }
+        default:
+            SkASSERT(false);
+            break;
+    }
+}
+
+void SkResampler::writeDstRow(int dstY) {
+    const Filters& filters = *fFilters;
+    const int width = fDst.width();
+    int offset, length;
+    const SkConvolutionFilter1D::ConvolutionFixed* weights =
+            filters.fFilterY.FilterForValue(dstY, &offset, &length);
+
+    // The filtered rows are indexed by source row, so gather this row's in order.
+    SkAutoSTMalloc<16, uint8_t*> rows(length);
+    for (int i = 0; i < length; i++) {
+        rows[i] = this->filteredRow(offset + i);
+    }
+
+    void* dst = fDst.writable_addr(0, dstY);
+    switch (filters.fColorType) {
+        case kN32_SkColorType:
+            SkOpts::convolve_vertically(weights, length, rows.get(), width, (uint8_t*)dst,
+                                        filters.fHasAlpha);
+            break;
+        case kAlpha_8_SkColorType: {
+            // Accumulate whole rows at a time, which vectorizes well.
+            int32_t* accum = fAccum.get();
+            sk_bzero(accum, width * sizeof(int32_t));
+            for (int i = 0; i < length; i++) {
+                const int w = weights[i];
+                const uint8_t* row = rows[i];
+                for (int x = 0; x < width; x++) {
+                    accum[x] += w * row[x];
+                }
+            }
+            auto out = (uint8_t*)dst;
+            for (int x = 0; x < width; x++) {
+                out[x] = SkTPin(accum[x] >> SkConvolutionFilter1D::kShiftBits, 0, 255);
+            }
+            break;
+        }
+        case kRGBA_F16_SkColorType: {
+            float* accum = fAccumFloats.get();
+            sk_bzero(accum, 4 * width * sizeof(float));
+            for (int i = 0; i < length; i++) {
+                const float w = weights[i] * kFixedToFloat;
+                auto row = (const float*)rows[i];
+                for (int j = 0; j < 4 * width; j++) {
+                    accum[j] += w * row[j];
+                }
+            }
+
+            // Ringing in the filters may push alpha out of range.  Color is left alone, as
+            // F16 may hold colors outside of [0,1] on purpose.
+            auto out = (uint64_t*)dst;
+            for (int x = 0; x < width; x++) {
+                float px[4];
+                Sk4f::Load(accum + 4 * x).store(px);
+                px[3] = filters.fHasAlpha ? SkTPin(px[3], 0.0f, 1.0f) : 1.0f;
+                SkFloatToHalf_finite_ftz(Sk4f::Load(px)).store(out + x);
+            }
+            break;
+        }
+        default:
+            SkASSERT(false);
+            break;
+    }
+}
+
+bool SkResampler::Resize(const SkPixmap& dst, const SkPixmap& src,
+                         SkBitmapScaler::ResizeMethod method, SkExecutor* executor) {
+    if (!dst.addr() || !src.addr() || dst.colorType() != src.colorType()) {
+        return false;
+    }
+    sk_sp<const Filters> filters = MakeFilters(dst.info(), src.info().dimensions(), method);
+    if (!filters) {
+        return false;
+    }
+
+    auto resizeBand = [&](int top, int bottom) {
+        SkResampler band(filters, dst, top, bottom);
+        band.fNextSourceRow = band.fFirstSourceRow;
+        for (int y = band.fFirstSourceRow; y < band.fEndSourceRow; y++) {
+            band.pushRow(src.addr(0, y));
+        }
+        SkASSERT(band.isComplete());
+    };
+
+    const int bandCount = executor ? SkTMin(dst.height() / kMinBandHeight, kMaxBands) : 1;
+    if (bandCount <= 1) {
+        resizeBand(0, dst.height());
+        return true;
+    }
+
+    SkTaskGroup tg(*executor);
+    tg.batch(bandCount, [&](int i) {
+        resizeBand(dst.height() * i / bandCount, dst.height() * (i + 1) / bandCount);
+    });
+    tg.wait();
+    return true;
+}
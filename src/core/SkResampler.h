@@ -0,0 +1,107 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkResampler_DEFINED
+#define SkResampler_DEFINED
+
+#include "SkBitmapScaler.h"
+#include "SkPixmap.h"
+#include "SkRefCnt.h"
+#include "SkTemplates.h"
+
+#include <memory>
+
+class SkExecutor;
+
+/**
+ *  Resizes an image one source row at a time, e.g. as a decoder produces them.
+ *
+ *  Each pushed row is filtered horizontally right away, and each destination row is written
+ *  as soon as every source row its vertical filter covers has been pushed.  Only as many
+ *  filtered rows as the vertical filter is tall are held at once, so the source image never
+ *  needs to exist in full.
+ *
+ *  Supports kN32_SkColorType (premultiplied or opaque), kAlpha_8_SkColorType and
+ *  kRGBA_F16_SkColorType.  Source rows must have the destination's color type.
+ */
+class SkResampler : SkNoncopyable {
+public:
+    /**
+     *  Returns nullptr if |dst| has no pixels or an unsupported color type, or if either size
+     *  is empty.  |dst| must stay valid until the resampler is complete.
+     */
+    static std::unique_ptr<SkResampler> Make(const SkPixmap& dst, const SkISize& srcSize,
+                                             SkBitmapScaler::ResizeMethod method);
+
+    ~SkResampler();
+
+    /**
+     *  The number of source rows that affect the destination.  Rows past this need not be
+     *  decoded or pushed.
+     */
+    int sourceRowsNeeded() const { return fEndSourceRow; }
+
+    /**
+     *  Filters the next source row, starting from row 0, and writes any destination rows that
+     *  now have all of their source rows.  Rows that no filter covers are ignored.
+     */
+    void pushRow(const void* row);
+
+    /**
+     *  True once every destination row has been written.
+     */
+    bool isComplete() const { return fNextDstRow == fEndDstRow; }
+
+    /**
+     *  Resizes all of |src| into |dst|, which must have the same color type.  If |executor| is
+     *  not null and |dst| is tall enough, bands of destination rows are resized concurrently
+     *  on it, each filtering only the source rows it covers.
+     */
+    static bool Resize(const SkPixmap& dst, const SkPixmap& src,
+                       SkBitmapScaler::ResizeMethod method, SkExecutor* executor = nullptr);
+
+private:
+    struct Filters;
+
+    static sk_sp<const Filters> MakeFilters(const SkImageInfo& dstInfo, const SkISize& srcSize,
+                                            SkBitmapScaler::ResizeMethod method);
+
+    // Resamples destination rows [dstTop, dstBottom) only.
+    SkResampler(sk_sp<const Filters>, const SkPixmap& dst, int dstTop, int dstBottom);
+
+    // Returns the filtered row that holds source row |y|.
+    uint8_t* filteredRow(int y) const {
+        return fFilteredRows.get() + (y % fFilteredRowCount) * fFilteredRowBytes;
+    }
+
+    void filterRow(const void* src, uint8_t* dst);
+    void writeReadyRows();
+    void writeDstRow(int dstY);
+
+    sk_sp<const Filters>   fFilters;
+    const SkPixmap         fDst;
+
+    // Source rows [fFirstSourceRow, fEndSourceRow) cover destination rows [fNextDstRow,
+    // fEndDstRow).
+    int                    fNextSourceRow;
+    int                    fFirstSourceRow;
+    int                    fEndSourceRow;
+    int                    fNextDstRow;
+    const int              fEndDstRow;
+
+    // A ring of horizontally filtered rows, indexed by source row.
+    SkAutoTMalloc<uint8_t> fFilteredRows;
+    size_t                 fFilteredRowBytes;
+    int                    fFilteredRowCount;
+
+    // Scratch space: source rows converted to float (F16), and accumulators (A8, F16).
+    SkAutoTMalloc<float>   fSrcFloats;
+    SkAutoTMalloc<int32_t> fAccum;
+    SkAutoTMalloc<float>   fAccumFloats;
+};
+
+#endif
@@ -5,14 +5,17 @@
  * found in the LICENSE file.
  */
 
+#include "SkChecksum.h"
 #include "SkMessageBus.h"
 #include "SkMipMap.h"
 #include "SkMutex.h"
+#include "SkOnce.h"
 #include "SkOpts.h"
 #include "SkPixelRef.h"
 #include "SkResourceCache.h"
 #include "SkTraceMemoryDump.h"
 
+#include <atomic>
 #include <stddef.h>
 #include <stdlib.h>
 
@@ -381,6 +384,15 @@ void SkResourceCache::visitAll(Visitor visitor, void* context) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+void SkResourceCache::purgeToByteLimit(size_t byteLimit) {
+    Rec* rec = fTail;
+    while (rec && fTotalBytesUsed > byteLimit) {
+        Rec* prev = rec->fPrev;
+        this->remove(rec);
+        rec = prev;
+    }
+}
+
 size_t SkResourceCache::setTotalByteLimit(size_t newLimit) {
     size_t prevLimit = fTotalByteLimit;
     fTotalByteLimit = newLimit;
@@ -550,91 +562,219 @@ void SkResourceCache::checkMessages() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-SK_DECLARE_STATIC_MUTEX(gMutex);
-static SkResourceCache* gResourceCache = nullptr;
+#ifndef SK_MAX_RESOURCE_CACHE_SHARDS
+    #define SK_MAX_RESOURCE_CACHE_SHARDS 16
+#endif
+
+/*  The global cache is split into gShardCount shards, each an SkResourceCache behind its own
+    mutex, with keys assigned to shards by hash.  With one shard (the default) this is exactly
+    the single global cache behind a single mutex.
+
+    Each shard is allowed the whole byte limit so that any one Rec that fits the global budget
+    fits its shard, and after an Add() we trim shards back toward an even split of the budget if
+    together they've gone over it.
+
+    gShardCount only changes while every shard's mutex is held, so holding any one of them is
+    enough to read it reliably.
+*/
+namespace {
+    struct Shard {
+        SkMutex             fMutex;
+        SkResourceCache*    fCache = nullptr;  // Created on first use, with fMutex held.
+        std::atomic<size_t> fBytesUsed{0};     // Mirrors fCache->getTotalBytesUsed().
+    };
+}
+
+static std::atomic<int>    gShardCount{1};
+static std::atomic<size_t> gTotalByteLimit{SK_DEFAULT_IMAGE_CACHE_LIMIT};
+static std::atomic<size_t> gSingleAllocationByteLimit{0};
 
-/** Must hold gMutex when calling. */
-static SkResourceCache* get_cache() {
-    // gMutex is always held when this is called, so we don't need to be fancy in here.
-    gMutex.assertHeld();
-    if (nullptr == gResourceCache) {
+static Shard* get_shards() {
+    static SkOnce once;
+    static Shard* shards;
+    once([]{ shards = new Shard[SK_MAX_RESOURCE_CACHE_SHARDS]; });
+    return shards;
+}
+
+namespace {
+    // Locks one shard, creating its cache if needed, and keeps fBytesUsed up to date.
+    class AutoShard : SkNoncopyable {
+    public:
+        // Lock the shard at this index.
+        explicit AutoShard(int index) : fShard(&get_shards()[index]) {
+            fShard->fMutex.acquire();
+        }
+
+        // Lock the shard that holds Recs with this key hash.
+        explicit AutoShard(uint32_t hash) {
+            for (;;) {
+                int count = gShardCount.load();
+                fShard = &get_shards()[SkChecksum::Mix(hash) % count];
+                fShard->fMutex.acquire();
+                if (count == gShardCount.load()) {
+                    break;
+                }
+                // The shard count changed while we waited.  Try again.
+                fShard->fMutex.release();
+            }
+        }
+
+        ~AutoShard() {
+            if (fShard->fCache) {
+                fShard->fBytesUsed.store(fShard->fCache->getTotalBytesUsed());
+            }
+            fShard->fMutex.release();
+        }
+
+        SkResourceCache* cache() {
+            fShard->fMutex.assertHeld();
+            if (nullptr == fShard->fCache) {
 #ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
-        gResourceCache = new SkResourceCache(SkDiscardableMemory::Create);
+                fShard->fCache = new SkResourceCache(SkDiscardableMemory::Create);
 #else
-        gResourceCache = new SkResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
+                fShard->fCache = new SkResourceCache(gTotalByteLimit.load());
 #endif
+                fShard->fCache->setSingleAllocationByteLimit(gSingleAllocationByteLimit.load());
+            }
+            return fShard->fCache;
+        }
+
+        SkResourceCache* operator->() { return this->cache(); }
+
+    private:
+        Shard* fShard;
+    };
+}
+
+// Calls fn(SkResourceCache*) for every shard in use, one at a time.
+template <typename Fn>
+static void for_each_shard(Fn&& fn) {
+    for (int i = 0; i < SK_MAX_RESOURCE_CACHE_SHARDS; i++) {
+        AutoShard shard(i);
+        if (i < gShardCount.load()) {
+            fn(shard.cache());
+        }
+    }
+}
+
+static size_t total_bytes_used() {
+    size_t total = 0;
+    for (int i = 0; i < SK_MAX_RESOURCE_CACHE_SHARDS; i++) {
+        total += get_shards()[i].fBytesUsed.load();
     }
-    return gResourceCache;
+    return total;
+}
+
+static void purge_shards_to_budget() {
+#ifndef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
+    const int count = gShardCount.load();
+    if (count == 1) {
+        return;  // The lone shard's own limit is the whole budget.
+    }
+
+    const size_t limit = gTotalByteLimit.load();
+    if (total_bytes_used() <= limit) {
+        return;
+    }
+    const size_t share = limit / count;
+    for (int i = 0; i < count; i++) {
+        if (get_shards()[i].fBytesUsed.load() > share) {
+            AutoShard(i)->purgeToByteLimit(share);
+        }
+    }
+#endif
 }
 
 size_t SkResourceCache::GetTotalBytesUsed() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalBytesUsed();
+    return total_bytes_used();
 }
 
 size_t SkResourceCache::GetTotalByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalByteLimit();
+    return AutoShard(0)->getTotalByteLimit();
 }
 
 size_t SkResourceCache::SetTotalByteLimit(size_t newLimit) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setTotalByteLimit(newLimit);
+    size_t prevLimit = AutoShard(0)->getTotalByteLimit();
+    gTotalByteLimit.store(newLimit);
+    for_each_shard([=](SkResourceCache* cache) { cache->setTotalByteLimit(newLimit); });
+    purge_shards_to_budget();
+    return prevLimit;
+}
+
+int SkResourceCache::GetShardCount() {
+    return gShardCount.load();
+}
+
+int SkResourceCache::SetShardCount(int count) {
+    count = SkTPin(count, 1, SK_MAX_RESOURCE_CACHE_SHARDS);
+
+    Shard* shards = get_shards();
+    for (int i = 0; i < SK_MAX_RESOURCE_CACHE_SHARDS; i++) {
+        shards[i].fMutex.acquire();
+    }
+    int prevCount = gShardCount.load();
+    if (count != prevCount) {
+        // Every Rec might now belong in a different shard, so start over.
+        for (int i = 0; i < SK_MAX_RESOURCE_CACHE_SHARDS; i++) {
+            if (shards[i].fCache) {
+                shards[i].fCache->purgeAll();
+                shards[i].fBytesUsed.store(0);
+            }
+        }
+        gShardCount.store(count);
+    }
+    for (int i = SK_MAX_RESOURCE_CACHE_SHARDS - 1; i >= 0; i--) {
+        shards[i].fMutex.release();
+    }
+    return prevCount;
 }
 
 SkResourceCache::DiscardableFactory SkResourceCache::GetDiscardableFactory() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->discardableFactory();
+    return AutoShard(0)->discardableFactory();
 }
 
 SkBitmap::Allocator* SkResourceCache::GetAllocator() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->allocator();
+    return AutoShard(0)->allocator();
 }
 
 SkCachedData* SkResourceCache::NewCachedData(size_t bytes) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->newCachedData(bytes);
+    return AutoShard(0)->newCachedData(bytes);
 }
 
 void SkResourceCache::Dump() {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->dump();
+    for_each_shard([](SkResourceCache* cache) { cache->dump(); });
 }
 
 size_t SkResourceCache::SetSingleAllocationByteLimit(size_t size) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setSingleAllocationByteLimit(size);
+    size_t prevLimit = AutoShard(0)->getSingleAllocationByteLimit();
+    gSingleAllocationByteLimit.store(size);
+    for_each_shard([=](SkResourceCache* cache) { cache->setSingleAllocationByteLimit(size); });
+    return prevLimit;
 }
 
 size_t SkResourceCache::GetSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getSingleAllocationByteLimit();
+    return AutoShard(0)->getSingleAllocationByteLimit();
 }
 
 size_t SkResourceCache::GetEffectiveSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getEffectiveSingleAllocationByteLimit();
+    return AutoShard(0)->getEffectiveSingleAllocationByteLimit();
 }
 
 void SkResourceCache::PurgeAll() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->purgeAll();
+    for_each_shard([](SkResourceCache* cache) { cache->purgeAll(); });
 }
 
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->find(key, visitor, context);
+    return AutoShard(key.hash())->find(key, visitor, context);
 }
 
 void SkResourceCache::Add(Rec* rec) {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->add(rec);
+    AutoShard(rec->getHash())->add(rec);
+    purge_shards_to_budget();
 }
 
 void SkResourceCache::VisitAll(Visitor visitor, void* context) {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->visitAll(visitor, context);
+    for_each_shard([&](SkResourceCache* cache) { cache->visitAll(visitor, context); });
 }
 
 void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
@@ -668,6 +808,14 @@ size_t SkGraphics::SetResourceCacheSingleAllocationByteLimit(size_t newLimit) {
     return SkResourceCache::SetSingleAllocationByteLimit(newLimit);
 }
 
+int SkGraphics::GetResourceCacheShardCount() {
+    return SkResourceCache::GetShardCount();
+}
+
+int SkGraphics::SetResourceCacheShardCount(int count) {
+    return SkResourceCache::SetShardCount(count);
+}
+
 void SkGraphics::PurgeResourceCache() {
     SkImageFilter::PurgeCache();
     return SkResourceCache::PurgeAll();
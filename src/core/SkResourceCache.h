@@ -151,6 +151,14 @@ public:
 
     static void PurgeAll();
 
+    /**
+     *  The global cache may be split into shards, each with its own lock and LRU, so threads
+     *  looking up different keys rarely wait on each other.  The total byte limit is shared
+     *  among the shards.  Changing the shard count purges the cache; returns the previous count.
+     */
+    static int SetShardCount(int);
+    static int GetShardCount();
+
     static void TestDumpMemoryStatistics();
 
     /** Dump memory usage statistics of every Rec in the cache using the
@@ -234,6 +242,12 @@ public:
 
     void purgeSharedID(uint64_t sharedID);
 
+    /**
+     *  Purge least recently used Recs until no more than byteLimit bytes remain,
+     *  without changing the limit itself.
+     */
+    void purgeToByteLimit(size_t byteLimit);
+
     void purgeAll() {
         this->purgeAsNeeded(true);
     }
@@ -18,6 +18,15 @@
 
 std::atomic<bool> gSkForceAnalyticAA{false};
 
+// Delta AA is opt-in: it trades some accuracy under nonzero windings beyond 127 for speed on
+// paths with many edges.
+std::atomic<bool> gSkUseDeltaAA{false};
+std::atomic<bool> gSkForceDeltaAA{false};
+
+// Banded fills are opt-in too: splitting a path's edges only pays off when the default
+// SkExecutor has threads to run the bands on.
+std::atomic<bool> gSkUseBandedFill{false};
+
 static inline void blitrect(SkBlitter* blitter, const SkIRect& r) {
     blitter->blitRect(r.fLeft, r.fTop, r.width(), r.height());
 }
@@ -12,7 +12,10 @@
 #include "SkFixed.h"
 #include "SkRect.h"
 #include <atomic>
+#include <functional>
 
+class SkArenaAlloc;
+class SkExecutor;
 class SkRasterClip;
 class SkRegion;
 class SkBlitter;
@@ -25,6 +28,9 @@ typedef SkIRect SkXRect;
 
 extern std::atomic<bool> gSkUseAnalyticAA;
 extern std::atomic<bool> gSkForceAnalyticAA;
+extern std::atomic<bool> gSkUseDeltaAA;
+extern std::atomic<bool> gSkForceDeltaAA;
+extern std::atomic<bool> gSkUseBandedFill;
 
 class AdditiveBlitter;
 
@@ -39,6 +45,12 @@ public:
     typedef void (*HairRgnProc)(const SkPoint[], int count, const SkRegion*, SkBlitter*);
     typedef void (*HairRCProc)(const SkPoint[], int count, const SkRasterClip&, SkBlitter*);
 
+    /*
+     *  Makes a new blitter for one band of FillPathInBands(), allocated in the given arena.
+     *  It is called once per band, possibly on several threads at once.
+     */
+    typedef std::function<SkBlitter*(SkArenaAlloc*)> BlitterFactory;
+
     static void FillPath(const SkPath&, const SkIRect&, SkBlitter*);
 
     ///////////////////////////////////////////////////////////////////////////
@@ -52,6 +64,28 @@ public:
     static void FillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void AAAFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
+    static void DAAFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
+    /*
+     *  Fills the path as FillPath() (or AntiFillPath(), if antiAlias) would, but splits its edges
+     *  into horizontal bands that are scan-converted concurrently on the executor, each into a
+     *  blitter of its own.  The pixels are the same as filling serially.
+     *
+     *  Returns false, having drawn nothing, if the fill isn't worth splitting or can't be split:
+     *  paths with few points, inverse fills, convex paths, anti-aliased clips, and fills that
+     *  analytic or delta AA would draw.  The caller should fill those serially.
+     */
+    static bool FillPathInBands(const SkPath&, const SkRasterClip&, bool antiAlias,
+                                const BlitterFactory&, SkExecutor*);
+    /*
+     *  Fills the path as FillPath() (or AntiFillPath(), if antiAlias) would, for a blitter that
+     *  only writes rows [blitTop, blitBottom).  The path's edges are walked no further down than
+     *  blitBottom, and nothing is blitted above blitTop.
+     *
+     *  Returns false, having drawn nothing, for inverse fills and fills that analytic or delta
+     *  AA would draw.  The caller should fill those as usual.
+     */
+    static bool FillPathRows(const SkPath&, const SkRasterClip&, bool antiAlias,
+                             int blitTop, int blitBottom, SkBlitter*);
     static void FrameRect(const SkRect&, const SkPoint& strokeSize,
                           const SkRasterClip&, SkBlitter*);
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -77,9 +111,11 @@ private:
     static void FillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
     static void AntiFillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
     static void AntiFillXRect(const SkXRect&, const SkRegion*, SkBlitter*);
-    static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*);
+    static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*,
+                         int blitTop = SK_MinS32, int blitBottom = SK_MaxS32);
     static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*,
-                             bool forceRLE = false);
+                             bool forceRLE = false,
+                             int blitTop = SK_MinS32, int blitBottom = SK_MaxS32);
     static void FillTriangle(const SkPoint pts[], const SkRegion*, SkBlitter*);
 
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -88,6 +124,11 @@ private:
     static void AntiHairLineRgn(const SkPoint[], int count, const SkRegion*, SkBlitter*);
     static void AAAFillPath(const SkPath& path, const SkRegion& origClip, SkBlitter* blitter,
                             bool forceRLE = false); // SkAAClip uses forceRLE
+    static void DAAFillPath(const SkPath& path, const SkRegion& origClip, SkBlitter* blitter);
+    static void FillPathInBands(const SkPath&, const SkRegion& clip, const BlitterFactory&,
+                                SkExecutor&);
+    static bool AntiFillPathInBands(const SkPath&, const SkRegion& clip, const BlitterFactory&,
+                                    SkExecutor&);
 };
 
 /** Assign an SkXRect from a SkIRect, by promoting the src rect's coordinates
@@ -30,9 +30,19 @@ private:
     const SkIRect*      fClipRect;
 };
 
+// Only rows [blitTop, blitBottom), before shifting, are blitted.  The path must not be inverse
+// filled if they limit it.
 void sk_fill_path(const SkPath& path, const SkIRect& clipRect,
                   SkBlitter* blitter, int start_y, int stop_y, int shiftEdgesUp,
-                  bool pathContainedInClip);
+                  bool pathContainedInClip,
+                  int blitTop = SK_MinS32, int blitBottom = SK_MaxS32);
+
+// Fills the path like sk_fill_path(), splitting rows [start_y, stop_y) into bands that are
+// walked concurrently on executor, each into its own blitter from makeBlitter.  Bands start
+// and end on whole rows before shifting.  The path must be neither inverse filled nor convex.
+void sk_fill_path_in_bands(const SkPath& path, const SkIRect& clipRect,
+                           const SkScan::BlitterFactory& makeBlitter, int start_y, int stop_y,
+                           int shiftEdgesUp, bool pathContainedInClip, SkExecutor& executor);
 
 // blit the rects above and below avoid, clipped to clip
 void sk_blit_above(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
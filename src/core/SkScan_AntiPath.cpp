@@ -7,6 +7,7 @@
 
 
 #include "SkScanPriv.h"
+#include "SkArenaAlloc.h"
 #include "SkPath.h"
 #include "SkMatrix.h"
 #include "SkBlitter.h"
@@ -622,7 +623,7 @@ static bool safeRoundOut(const SkRect& src, SkIRect* dst, int32_t maxInt) {
 }
 
 void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
-                          SkBlitter* blitter, bool forceRLE) {
+                          SkBlitter* blitter, bool forceRLE, int blitTop, int blitBottom) {
     if (origClip.isEmpty()) {
         return;
     }
@@ -658,7 +659,7 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
        }
     }
     if (rect_overflows_short_shift(clippedIR, SHIFT)) {
-        SkScan::FillPath(path, origClip, blitter);
+        SkScan::FillPath(path, origClip, blitter, blitTop, blitBottom);
         return;
     }
 
@@ -719,11 +720,11 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
         MaskSuperBlitter    superBlit(blitter, ir, *clipRgn, isInverse);
         SkASSERT(SkIntToScalar(ir.fTop) <= path.getBounds().fTop);
         sk_fill_path(path, clipRgn->getBounds(), &superBlit, ir.fTop, ir.fBottom, SHIFT,
-                superClipRect == nullptr);
+                superClipRect == nullptr, blitTop, blitBottom);
     } else {
         SuperBlitter    superBlit(blitter, ir, *clipRgn, isInverse);
         sk_fill_path(path, clipRgn->getBounds(), &superBlit, ir.fTop, ir.fBottom, SHIFT,
-                superClipRect == nullptr);
+                superClipRect == nullptr, blitTop, blitBottom);
     }
 
     if (isInverse) {
@@ -731,6 +732,59 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
     }
 }
 
+// Follows AntiFillPath() for paths that aren't inverse filled, but gives every band a
+// SuperBlitter of its own. A SuperBlitter's rows only depend on the blitH() calls for their
+// own SCALE supersampled rows, and the bands never share one.
+bool SkScan::AntiFillPathInBands(const SkPath& path, const SkRegion& origClip,
+                                 const BlitterFactory& makeBlitter, SkExecutor& executor) {
+    SkASSERT(!path.isInverseFillType());
+    if (origClip.isEmpty()) {
+        return true;
+    }
+
+    SkIRect ir;
+    if (!safeRoundOut(path.getBounds(), &ir, SK_MaxS32 >> SHIFT) || ir.isEmpty()) {
+        return true;
+    }
+
+    SkIRect clippedIR;
+    if (!clippedIR.intersect(ir, origClip.getBounds())) {
+        return true;
+    }
+    if (rect_overflows_short_shift(clippedIR, SHIFT)) {
+        SkScan::FillPathInBands(path, origClip, makeBlitter, executor);
+        return true;
+    }
+    // Small paths go to a MaskSuperBlitter, which is left to AntiFillPath().
+    if (MaskSuperBlitter::CanHandleRect(ir)) {
+        return false;
+    }
+
+    SkRegion tmpClipStorage;
+    const SkRegion* clipRgn = &origClip;
+    {
+        static const int32_t kMaxClipCoord = 32767;
+        const SkIRect& bounds = origClip.getBounds();
+        if (bounds.fRight > kMaxClipCoord || bounds.fBottom > kMaxClipCoord) {
+            SkIRect limit = { 0, 0, kMaxClipCoord, kMaxClipCoord };
+            tmpClipStorage.op(origClip, limit, SkRegion::kIntersect_Op);
+            clipRgn = &tmpClipStorage;
+        }
+    }
+    if (!SkIRect::Intersects(clipRgn->getBounds(), ir)) {
+        return true;
+    }
+
+    auto makeSuperBlitter = [&](SkArenaAlloc* alloc) -> SkBlitter* {
+        SkScanClipper* clipper = alloc->make<SkScanClipper>(makeBlitter(alloc), clipRgn, ir);
+        return alloc->make<SuperBlitter>(clipper->getBlitter(), ir, *clipRgn, false);
+    };
+    const bool pathContainedInClip = clipRgn->isRect() && clipRgn->getBounds().contains(ir);
+    sk_fill_path_in_bands(path, clipRgn->getBounds(), makeSuperBlitter, ir.fTop, ir.fBottom,
+                          SHIFT, pathContainedInClip, executor);
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "SkRasterClip.h"
@@ -766,8 +820,22 @@ static bool suitableForAAA(const SkPath& path) {
     return path.countPoints() < SkTMax(bounds.width(), bounds.height()) / 2 - 10;
 }
 
+static bool suitableForDAA(const SkPath& path) {
+    if (gSkForceDeltaAA.load()) {
+        return true;
+    }
+    // Delta AA walks each edge once, whatever the other edges do, so it pays off on the paths
+    // that are too complicated for Analytic AA.  Inverse fills are left to supersampling.
+    return !path.isInverseFillType() && !(gSkUseAnalyticAA.load() && suitableForAAA(path));
+}
+
 void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip,
                           SkBlitter* blitter) {
+    if (gSkUseDeltaAA.load() && suitableForDAA(path)) {
+        SkScan::DAAFillPath(path, clip, blitter);
+        return;
+    }
+
     // Do not use AAA if path is too complicated:
     // there won't be any speedup or significant visual improvement.
     if (gSkUseAnalyticAA.load() && suitableForAAA(path)) {
@@ -790,3 +858,60 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip,
         SkScan::AntiFillPath(path, tmp, &aaBlitter, true);
     }
 }
+
+// Below this many points, splitting a path into bands costs more than it saves.
+static constexpr int kMinPointsForBands = 512;
+
+bool SkScan::FillPathInBands(const SkPath& path, const SkRasterClip& clip, bool antiAlias,
+                             const BlitterFactory& makeBlitter, SkExecutor* executor) {
+    if (!executor || !clip.isBW() || path.isInverseFillType() || path.isConvex() ||
+        path.countPoints() < kMinPointsForBands) {
+        return false;
+    }
+    if (!antiAlias) {
+        FillPathInBands(path, clip.bwRgn(), makeBlitter, *executor);
+        return true;
+    }
+
+    // Only supersampling is split into bands, so leave the paths AntiFillPath() would give to
+    // delta or analytic AA alone.
+    if ((gSkUseDeltaAA.load() && suitableForDAA(path)) ||
+        (gSkUseAnalyticAA.load() && suitableForAAA(path))) {
+        return false;
+    }
+    return AntiFillPathInBands(path, clip.bwRgn(), makeBlitter, *executor);
+}
+
+bool SkScan::FillPathRows(const SkPath& path, const SkRasterClip& clip, bool antiAlias,
+                          int blitTop, int blitBottom, SkBlitter* blitter) {
+    if (path.isInverseFillType()) {
+        return false;
+    }
+    if (antiAlias && ((gSkUseDeltaAA.load() && suitableForDAA(path)) ||
+                      (gSkUseAnalyticAA.load() && suitableForAAA(path)))) {
+        return false;
+    }
+    if (clip.isEmpty()) {
+        return true;
+    }
+
+    if (clip.isBW()) {
+        if (antiAlias) {
+            AntiFillPath(path, clip.bwRgn(), blitter, false, blitTop, blitBottom);
+        } else {
+            FillPath(path, clip.bwRgn(), blitter, blitTop, blitBottom);
+        }
+    } else {
+        SkRegion        tmp;
+        SkAAClipBlitter aaBlitter;
+
+        tmp.setRect(clip.getBounds());
+        aaBlitter.init(blitter, &clip.aaRgn());
+        if (antiAlias) {
+            AntiFillPath(path, tmp, &aaBlitter, true, blitTop, blitBottom);
+        } else {
+            FillPath(path, tmp, &aaBlitter, blitTop, blitBottom);
+        }
+    }
+    return true;
+}
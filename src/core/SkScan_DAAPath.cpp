@@ -0,0 +1,524 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBlitter.h"
+#include "SkGeometry.h"
+#include "SkNx.h"
+#include "SkPath.h"
+#include "SkRasterClip.h"
+#include "SkRegion.h"
+#include "SkScan.h"
+#include "SkScanPriv.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
+#include "SkTemplates.h"
+
+/*
+    Delta AA: signed-area accumulation, in the style of font rasterizers.
+
+    Each edge adds the signed area it covers in each pixel row it crosses into an accumulation
+    buffer, stored as deltas from the pixel to its left: the pixel the edge passes through gets
+    the part of the area to the edge's right, and the pixel after it the rest.  A prefix sum
+    along the row then turns the deltas into the winding coverage of every pixel.  Walking an
+    edge never looks at the other edges, so there is no sorting by x and no per pixel coverage
+    arithmetic, which keeps this fast for paths with many edges (maps, charts), where analytic
+    AA and supersampling slow down.
+
+    Rows are resolved kStripRows at a time.  Within a strip the buffer is column-major, so the
+    prefix sum runs across the columns with one SIMD add for all of the strip's rows.  Columns
+    no edge touches keep the coverage to their left, so they are skipped, and their pixels turn
+    into runs for the blitter without being looked at one by one.
+
+    Heights are snapped to 1/256 of a pixel and full coverage is 256, so each contour's deltas
+    in a row sum to exactly zero and coverage never leaks past the path's right edge.  Deltas
+    and sums are 16 bits: under the nonzero rule, windings beyond +/-127 wrap around.  Even-odd
+    only depends on the low bits, so it is unaffected.
+
+    What a pixel ends up with is its average winding, which is its coverage unless edges cross
+    inside of it.  There, parts winding twice make up for parts not covered at all, as in font
+    rasterizers, whose glyphs rarely overlap themselves.
+*/
+
+static constexpr int kStripRows = 16;  // rows resolved together, one per lane of an Sk16h
+
+static constexpr int   kSubpixelBits      = 8;
+static constexpr int   kSubpixels         = 1 << kSubpixelBits;
+static constexpr float kFlattenTolerance  = 0.03125f;  // in pixels
+static constexpr int   kMaxSubdivisions   = 1 << 10;
+static constexpr float kConicTolerance    = 0.25f;
+
+namespace {
+
+// A line in strip-relative pixels, from its top to its bottom.
+struct DeltaSegment {
+    float fX0, fY0;         // a point on the line
+    float fDXDY;
+    int   fTop, fBottom;    // in subpixels, fTop < fBottom, clamped to the clip's rows
+    int   fWinding;         // +1 if the line went down, -1 if it went up
+
+    float xAt(int y) const {
+        return fX0 + (y * (1.0f / kSubpixels) - fY0) * fDXDY;
+    }
+};
+
+class SegmentBuilder {
+public:
+    SegmentBuilder(const SkIRect& bounds, SkTDArray<DeltaSegment>* segments)
+        : fOrigin(SkPoint::Make(SkIntToScalar(bounds.fLeft), SkIntToScalar(bounds.fTop)))
+        , fWidth(SkIntToScalar(bounds.width()))
+        , fHeight(SkIntToScalar(bounds.height()))
+        , fSegments(segments) {}
+
+    void addLine(const SkPoint& p0, const SkPoint& p1) {
+        // Split the line where it crosses the clip's left and right edges.  Outside of the clip,
+        // it covers the clip's pixels just as the nearest edge of the clip would.
+        SkScalar ts[2], xs[2];
+        int count = 0;
+        for (SkScalar edge : { 0.0f, fWidth }) {
+            if ((p0.fX < edge) != (p1.fX < edge)) {
+                ts[count] = (edge - p0.fX) / (p1.fX - p0.fX);
+                xs[count++] = edge;
+            }
+        }
+        if (2 == count && ts[0] > ts[1]) {
+            SkTSwap(ts[0], ts[1]);
+            SkTSwap(xs[0], xs[1]);
+        }
+        SkPoint prev = p0;
+        for (int i = 0; i < count; i++) {
+            const SkPoint p = SkPoint::Make(xs[i], p0.fY + ts[i] * (p1.fY - p0.fY));
+            this->addClippedLine(prev, p);
+            prev = p;
+        }
+        this->addClippedLine(prev, p1);
+    }
+
+    void addQuad(const SkPoint pts[3]) {
+        if (this->canUseChord(pts, 3)) {
+            this->addLine(pts[0], pts[2]);
+            return;
+        }
+        // A quad's second derivative is constant, 2(p0 - 2p1 + p2), so splitting it into n
+        // lines is off by at most |p0 - 2p1 + p2| / (4n^2).
+        const SkScalar dd = (pts[0] - pts[1] - pts[1] + pts[2]).length();
+        const int n = subdivisions(dd * 0.25f);
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; i++) {
+            const SkPoint p = SkEvalQuadAt(pts, SkIntToScalar(i) / n);
+            this->addLine(prev, p);
+            prev = p;
+        }
+        this->addLine(prev, pts[2]);
+    }
+
+    void addCubic(const SkPoint pts[4]) {
+        if (this->canUseChord(pts, 4)) {
+            this->addLine(pts[0], pts[3]);
+            return;
+        }
+        // A cubic's second derivative is at most 6 max|p_i - 2p_i+1 + p_i+2|, so splitting it
+        // into n lines is off by at most 3/4 of that over n^2.
+        const SkScalar dd = SkTMax((pts[0] - pts[1] - pts[1] + pts[2]).length(),
+                                   (pts[1] - pts[2] - pts[2] + pts[3]).length());
+        const int n = subdivisions(dd * 0.75f);
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; i++) {
+            SkPoint p;
+            SkEvalCubicAt(pts, SkIntToScalar(i) / n, &p, nullptr, nullptr);
+            this->addLine(prev, p);
+            prev = p;
+        }
+        this->addLine(prev, pts[3]);
+    }
+
+    // Points are made strip-relative as they are added.
+    SkPoint map(const SkPoint& p) const { return p - fOrigin; }
+
+private:
+    // Adds a line that lies entirely left of, inside, or right of the clip.  Lines right of
+    // the clip are kept on its right edge, so that each row's deltas still sum to zero.
+    void addClippedLine(SkPoint p0, SkPoint p1) {
+        const SkScalar midX = SkScalarHalf(p0.fX + p1.fX);
+        if (midX <= 0) {
+            p0.fX = p1.fX = 0;
+        } else if (midX >= fWidth) {
+            p0.fX = p1.fX = fWidth;
+        }
+        int winding = 1;
+        if (p0.fY > p1.fY) {
+            SkTSwap(p0, p1);
+            winding = -1;
+        }
+        const int top    = SkScalarRoundToInt(SkTPin(p0.fY, 0.0f, fHeight) * kSubpixels);
+        const int bottom = SkScalarRoundToInt(SkTPin(p1.fY, 0.0f, fHeight) * kSubpixels);
+        if (top == bottom) {
+            return;     // horizontal, or outside of the clip's rows
+        }
+        DeltaSegment* segment = fSegments->append();
+        segment->fX0 = p0.fX;
+        segment->fY0 = p0.fY;
+        segment->fDXDY = (p1.fX - p0.fX) / (p1.fY - p0.fY);
+        segment->fTop = top;
+        segment->fBottom = bottom;
+        segment->fWinding = winding;
+    }
+
+    static int subdivisions(SkScalar error) {
+        const SkScalar n = SkScalarCeilToScalar(SkScalarSqrt(error / kFlattenTolerance));
+        return SkScalarIsFinite(n) ? SkTPin((int)n, 1, kMaxSubdivisions) : 1;
+    }
+
+    // A curve entirely above, below, left or right of the clip covers its pixels just as its
+    // chord does: either not at all, or with the same winding across each row.
+    bool canUseChord(const SkPoint pts[], int count) const {
+        SkRect bounds;
+        bounds.set(pts, count);
+        return bounds.fBottom <= 0 || bounds.fTop >= fHeight ||
+               bounds.fRight <= 0 || bounds.fLeft >= fWidth;
+    }
+
+    const SkPoint              fOrigin;
+    const SkScalar             fWidth, fHeight;
+    SkTDArray<DeltaSegment>*   fSegments;
+};
+
+} // namespace
+
+static void build_segments(const SkPath& path, const SkIRect& bounds,
+                           SkTDArray<DeltaSegment>* segments) {
+    SegmentBuilder builder(bounds, segments);
+    SkPath::Iter iter(path, true);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+        for (int i = 0; i < 4; i++) {
+            pts[i] = builder.map(pts[i]);
+        }
+        switch (verb) {
+            case SkPath::kLine_Verb:
+                builder.addLine(pts[0], pts[1]);
+                break;
+            case SkPath::kQuad_Verb:
+                builder.addQuad(pts);
+                break;
+            case SkPath::kConic_Verb: {
+                SkAutoConicToQuads quadder;
+                const SkPoint* quadPts = quadder.computeQuads(pts, iter.conicWeight(),
+                                                              kConicTolerance);
+                for (int i = 0; i < quadder.countQuads(); i++) {
+                    builder.addQuad(quadPts + 2 * i);
+                }
+                break;
+            }
+            case SkPath::kCubic_Verb:
+                builder.addCubic(pts);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+namespace {
+
+// The deltas of kStripRows rows, column-major, and which columns have any.
+struct Strip {
+    int16_t* fCells;
+    uint8_t* fTouched;
+    int      fMinX, fMaxX;  // the first and last touched columns
+
+    void add(int row, int x, int delta) {
+        fCells[x * kStripRows + row] += delta;
+        fTouched[x] = 1;
+    }
+};
+
+// A run of columns that all have the coverage of the first, the only one with deltas.
+struct Span {
+    int fX, fWidth;
+};
+
+} // namespace
+
+// Adds the deltas of a line crossing one row, from x0 to x1 in subpixels, covering d subpixels
+// of the row's height (negative if it went up).
+static void accumulate_row(Strip* strip, int row, int x0, int x1, int d) {
+    if (x0 > x1) {
+        SkTSwap(x0, x1);
+    }
+    int c = x0 >> kSubpixelBits;
+    const int last = x1 > x0 ? (x1 - 1) >> kSubpixelBits : c;
+    strip->fMinX = SkTMin(strip->fMinX, c);
+    strip->fMaxX = SkTMax(strip->fMaxX, last + 1);
+
+    if (c == last) {
+        // The part of d to the right of the line's average x stays in this pixel.
+        const int f = ((x0 + x1) >> 1) - (c << kSubpixelBits);
+        const int e = (d * f) >> kSubpixelBits;
+        strip->add(row, c, d - e);
+        strip->add(row, c + 1, e);
+        return;
+    }
+
+    // Split d among the pixels the line crosses so the parts sum to d exactly.
+    const int64_t span = x1 - x0;
+    int left = x0, covered = 0;
+    for (; c <= last; c++) {
+        const int right = SkTMin(x1, (c + 1) << kSubpixelBits);
+        const int nextCovered = right == x1 ? d : (int)(d * (int64_t)(right - x0) / span);
+        const int dy = nextCovered - covered;
+        const int f = ((left + right) >> 1) - (c << kSubpixelBits);
+        const int e = (dy * f) >> kSubpixelBits;
+        strip->add(row, c, dy - e);
+        strip->add(row, c + 1, e);
+        left = right;
+        covered = nextCovered;
+    }
+}
+
+static void accumulate_segment(const DeltaSegment& segment, int stripTop, int stripBottom,
+                               int width, Strip* strip) {
+    const int top    = SkTMax(segment.fTop, stripTop << kSubpixelBits);
+    const int bottom = SkTMin(segment.fBottom, stripBottom << kSubpixelBits);
+    const SkScalar right = SkIntToScalar(width);
+    auto subpixel_x = [&](int y) {
+        return SkScalarRoundToInt(SkTPin(segment.xAt(y), 0.0f, right) * kSubpixels);
+    };
+
+    int x0 = subpixel_x(top);
+    for (int y = top; y < bottom;) {
+        const int row = y >> kSubpixelBits;
+        const int rowBottom = SkTMin((row + 1) << kSubpixelBits, bottom);
+        const int x1 = subpixel_x(rowBottom);
+        accumulate_row(strip, row - stripTop, x0, x1, (rowBottom - y) * segment.fWinding);
+        x0 = x1;
+        y = rowBottom;
+    }
+}
+
+// Prefix sums columns [fMinX, to] of a strip, all of its rows at once.  Columns without deltas
+// keep the coverage of the column to their left, so only the touched columns' alphas are stored,
+// one per span.  Returns the number of spans.
+template <bool kEvenOdd>
+static int resolve_strip(const Strip& strip, int to, uint8_t* alphas, Span* spans) {
+    Sk16h sum(0);
+    int count = 0;
+    for (int x = strip.fMinX; x <= to; x++) {
+        if (!strip.fTouched[x]) {
+            spans[count - 1].fWidth++;
+            continue;
+        }
+        sum = sum + Sk16h::Load(strip.fCells + x * kStripRows);
+        Sk16h coverage;
+        if (kEvenOdd) {
+            const Sk16h s = sum & Sk16h(2 * kSubpixels - 1);
+            coverage = Sk16h::Min(s, Sk16h(2 * kSubpixels) - s);
+        } else {
+            // The sum is signed, so as unsigned, the smaller of it and its negation is |sum|.
+            coverage = Sk16h::Min(sum, Sk16h(0) - sum);
+        }
+        SkNx_cast<uint8_t>(Sk16h::Min(coverage, Sk16h(255))).store(alphas + count * kStripRows);
+        spans[count++] = { x, 1 };
+    }
+    return count;
+}
+
+// Blits one row of a resolved strip as runs of equal alpha.  Long opaque runs, the inside of
+// the path, go to blitH(), which blitters fill faster.
+static void blit_row(SkBlitter* blitter, int left, int y, const uint8_t* alphas,
+                     const Span* spans, int count, SkAlpha* runAlphas, int16_t* runs) {
+    static constexpr int kMinOpaqueRun = 16;
+
+    int runStart = 0, runWidth = 0;     // the runs not blitted yet
+    auto flush = [&]() {
+        if (runWidth > 0) {
+            runs[runWidth] = 0;
+            blitter->blitAntiH(left + runStart, y, runAlphas, runs);
+            runWidth = 0;
+        }
+    };
+
+    for (int i = 0; i < count;) {
+        const SkAlpha alpha = alphas[i * kStripRows];
+        const int x = spans[i].fX;
+        int width = spans[i].fWidth;
+        while (++i < count && alphas[i * kStripRows] == alpha) {
+            width += spans[i].fWidth;
+        }
+
+        if (0 == alpha) {
+            flush();
+        } else if (0xFF == alpha && width >= kMinOpaqueRun) {
+            flush();
+            blitter->blitH(left + x, y, width);
+        } else {
+            if (0 == runWidth) {
+                runStart = x;
+            }
+            runAlphas[runWidth] = alpha;
+            runs[runWidth] = SkToS16(width);
+            runWidth += width;
+        }
+    }
+    flush();
+}
+
+static void daa_fill_path(const SkPath& path, const SkIRect& bounds, SkBlitter* blitter) {
+    SkTDArray<DeltaSegment> segments;
+    build_segments(path, bounds, &segments);
+    if (segments.isEmpty()) {
+        return;
+    }
+    SkTQSort(segments.begin(), segments.end() - 1,
+             [](const DeltaSegment& a, const DeltaSegment& b) { return a.fTop < b.fTop; });
+
+    // Lines on the clip's right edge land in column width, and each pixel's deltas also reach the
+    // pixel to its right, so there are two extra columns.
+    const int width = bounds.width();
+    const int height = bounds.height();
+    const int columns = width + 2;
+    SkAutoTMalloc<int16_t> cells(columns * kStripRows);
+    SkAutoTMalloc<uint8_t> touched(columns);
+    SkAutoTMalloc<uint8_t> alphas(columns * kStripRows);
+    SkAutoTMalloc<Span>    spans(columns);
+    SkAutoTMalloc<SkAlpha> runAlphas(width + 1);
+    SkAutoTMalloc<int16_t> runs(width + 1);
+    sk_bzero(cells.get(), columns * kStripRows * sizeof(int16_t));
+    sk_bzero(touched.get(), columns);
+    const bool evenOdd = SkPath::kEvenOdd_FillType == path.getFillType();
+
+    SkTDArray<const DeltaSegment*> active;
+    const DeltaSegment* next = segments.begin();
+    int stripTop = next->fTop >> kSubpixelBits;
+    while (stripTop < height) {
+        const int stripBottom = SkTMin(stripTop + kStripRows, height);
+        while (next < segments.end() && next->fTop < (stripBottom << kSubpixelBits)) {
+            *active.append() = next++;
+        }
+
+        Strip strip = { cells.get(), touched.get(), columns, -1 };
+        int kept = 0;
+        for (int i = 0; i < active.count(); i++) {
+            const DeltaSegment* segment = active[i];
+            accumulate_segment(*segment, stripTop, stripBottom, width, &strip);
+            if (segment->fBottom > (stripBottom << kSubpixelBits)) {
+                active[kept++] = segment;
+            }
+        }
+        active.setCount(kept);
+
+        // Every row's deltas sum to zero, so there is no coverage right of fMaxX.
+        const int to = SkTMin(strip.fMaxX, width - 1);
+        if (strip.fMinX <= to) {
+            const int count = evenOdd
+                    ? resolve_strip<true >(strip, to, alphas.get(), spans.get())
+                    : resolve_strip<false>(strip, to, alphas.get(), spans.get());
+            for (int y = stripTop; y < stripBottom; y++) {
+                blit_row(blitter, bounds.fLeft, bounds.fTop + y, alphas.get() + y - stripTop,
+                         spans.get(), count, runAlphas.get(), runs.get());
+            }
+        }
+        for (int x = strip.fMinX; x <= strip.fMaxX; x++) {
+            if (touched[x]) {
+                sk_bzero(cells.get() + x * kStripRows, kStripRows * sizeof(int16_t));
+                touched[x] = 0;
+            }
+        }
+
+        // Skip ahead over rows no line crosses.
+        stripTop = stripBottom;
+        if (active.isEmpty()) {
+            if (next == segments.end()) {
+                break;
+            }
+            stripTop = SkTMax(stripTop, next->fTop >> kSubpixelBits);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static bool fitsInsideLimit(const SkRect& r, SkScalar max) {
+    const SkScalar min = -max;
+    return  r.fLeft > min && r.fTop > min &&
+            r.fRight < max && r.fBottom < max;
+}
+
+static bool safeRoundOut(const SkRect& src, SkIRect* dst, int32_t maxInt) {
+    const SkScalar maxScalar = SkIntToScalar(maxInt);
+
+    if (fitsInsideLimit(src, maxScalar)) {
+        src.roundOut(dst);
+        return true;
+    }
+    return false;
+}
+
+void SkScan::DAAFillPath(const SkPath& path, const SkRegion& origClip, SkBlitter* blitter) {
+    if (origClip.isEmpty()) {
+        return;
+    }
+
+    if (path.isInverseFillType()) {
+        // Inverse fills cover the whole clip outside the path; leave them to supersampling.
+        SkScan::AntiFillPath(path, origClip, blitter);
+        return;
+    }
+
+    SkIRect ir;
+    if (!safeRoundOut(path.getBounds(), &ir, SK_MaxS32 >> 2)) {
+        return;
+    }
+    if (ir.isEmpty()) {
+        return;
+    }
+
+    // Our antialiasing can't handle a clip larger than 32767, so we restrict
+    // the clip to that limit here. (the runs[] uses int16_t for its index).
+    SkRegion tmpClipStorage;
+    const SkRegion* clipRgn = &origClip;
+    {
+        static const int32_t kMaxClipCoord = 32767;
+        const SkIRect& bounds = origClip.getBounds();
+        if (bounds.fRight > kMaxClipCoord || bounds.fBottom > kMaxClipCoord) {
+            SkIRect limit = { 0, 0, kMaxClipCoord, kMaxClipCoord };
+            tmpClipStorage.op(origClip, limit, SkRegion::kIntersect_Op);
+            clipRgn = &tmpClipStorage;
+        }
+    }
+    // for here down, use clipRgn, not origClip
+
+    SkIRect clippedIR;
+    if (!clippedIR.intersect(ir, clipRgn->getBounds())) {
+        return;
+    }
+
+    SkScanClipper clipper(blitter, clipRgn, ir);
+    if (clipper.getBlitter() == nullptr) { // clipped out
+        return;
+    }
+
+    daa_fill_path(path, clippedIR, clipper.getBlitter());
+}
+
+// This almost copies SkScan::AntiFillPath
+void SkScan::DAAFillPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter) {
+    if (clip.isEmpty()) {
+        return;
+    }
+
+    if (clip.isBW()) {
+        DAAFillPath(path, clip.bwRgn(), blitter);
+    } else {
+        SkRegion        tmp;
+        SkAAClipBlitter aaBlitter;
+
+        tmp.setRect(clip.getBounds());
+        aaBlitter.init(blitter, &clip.aaRgn());
+        DAAFillPath(path, tmp, &aaBlitter);
+    }
+}
@@ -6,6 +6,7 @@
  */
 
 #include "SkScanPriv.h"
+#include "SkArenaAlloc.h"
 #include "SkBlitter.h"
 #include "SkEdge.h"
 #include "SkEdgeBuilder.h"
@@ -14,6 +15,7 @@
 #include "SkQuadClipper.h"
 #include "SkRasterClip.h"
 #include "SkRegion.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTSort.h"
 
@@ -387,7 +389,8 @@ static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last) {
 
 // clipRect has not been shifted up
 void sk_fill_path(const SkPath& path, const SkIRect& clipRect, SkBlitter* blitter,
-                  int start_y, int stop_y, int shiftEdgesUp, bool pathContainedInClip) {
+                  int start_y, int stop_y, int shiftEdgesUp, bool pathContainedInClip,
+                  int blitTop, int blitBottom) {
     SkASSERT(blitter);
 
     SkIRect shiftedClip = clipRect;
@@ -458,6 +461,26 @@ void sk_fill_path(const SkPath& path, const SkIRect& clipRect, SkBlitter* blitte
         stop_y = shiftedClip.fBottom;
     }
 
+    // Rows above blitTop are still walked, just not blitted: where edges tie in x, the order they
+    // come in depends on the rows walked before.  Nothing below blitBottom is walked at all.
+    SkASSERT(!path.isInverseFillType() || (SK_MinS32 == blitTop && SK_MaxS32 == blitBottom));
+    SkRectClipBlitter rowBlitter;
+    if (blitBottom < (stop_y >> shiftEdgesUp)) {
+        stop_y = SkLeftShift(blitBottom, shiftEdgesUp);
+        if (stop_y <= start_y) {
+            return;
+        }
+    }
+    if (blitTop > (start_y >> shiftEdgesUp)) {
+        const int blit_start_y = SkLeftShift(blitTop, shiftEdgesUp);
+        if (blit_start_y >= stop_y) {
+            return;
+        }
+        rowBlitter.init(blitter, SkIRect::MakeLTRB(shiftedClip.fLeft, blit_start_y,
+                                                   shiftedClip.fRight, stop_y));
+        blitter = &rowBlitter;
+    }
+
     InverseBlitter  ib;
     PrePostProc     proc = nullptr;
 
@@ -476,6 +499,164 @@ void sk_fill_path(const SkPath& path, const SkIRect& clipRect, SkBlitter* blitte
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+// Bands are at least this many rows tall before shifting, and get at least this many edges
+// on average, or copying the edges that cross bands isn't paid for.
+static constexpr int kMinBandHeight   = 16;
+static constexpr int kMinEdgesPerBand = 64;
+static constexpr int kMaxBands        = 32;
+
+// One band's copy of the edge list, as walk_edges() had it at the start of the band's top row.
+struct EdgeBand {
+    EdgeBand() : fAlloc(4096) {}
+
+    SkArenaAlloc    fAlloc;
+    SkEdge          fHeadEdge;
+    SkEdge          fTailEdge;
+    int             fTop;
+    int             fBottom;
+};
+
+static void link_edges(SkEdge* headEdge, SkEdge* first, SkEdge* last, SkEdge* tailEdge) {
+    headEdge->fPrev = nullptr;
+    headEdge->fNext = first;
+    headEdge->fFirstY = kEDGE_HEAD_Y;
+    headEdge->fX = SK_MinS32;
+    first->fPrev = headEdge;
+
+    tailEdge->fPrev = last;
+    tailEdge->fNext = nullptr;
+    tailEdge->fFirstY = kEDGE_TAIL_Y;
+    last->fNext = tailEdge;
+}
+
+// Copies the edges that reach the band, keeping their order, ties in x included.
+static bool copy_edges_for_band(const SkEdge* edge, EdgeBand* band) {
+    SkEdge* first = nullptr;
+    SkEdge* last = nullptr;
+    // The edges already walked come first, followed by the rest sorted by their first row.
+    for (; edge->fFirstY < band->fBottom; edge = edge->fNext) {
+        SkEdge* copy;
+        if (edge->fCurveCount < 0) {
+            copy = band->fAlloc.make<SkCubicEdge>(*(const SkCubicEdge*)edge);
+        } else if (edge->fCurveCount > 0) {
+            copy = band->fAlloc.make<SkQuadraticEdge>(*(const SkQuadraticEdge*)edge);
+        } else {
+            copy = band->fAlloc.make<SkEdge>(*edge);
+        }
+        // walk_edges() steps fX down a line without moving its fFirstY.
+        copy->fFirstY = SkTMax(copy->fFirstY, band->fTop);
+
+        if (last) {
+            last->fNext = copy;
+            copy->fPrev = last;
+        } else {
+            first = copy;
+        }
+        last = copy;
+    }
+    if (!first) {
+        return false;
+    }
+    link_edges(&band->fHeadEdge, first, last, &band->fTailEdge);
+    return true;
+}
+
+// Walks the edges without drawing anything, to reach each band's top row with the edges in the
+// same order as a serial walk.  Ties in x are left in whatever order the walk happened to insert
+// them, and a different order may split the spans on either side of a tie differently.
+class BandSplitter : public SkNullBlitter {
+public:
+    BandSplitter(const SkEdge* headEdge, EdgeBand bands[], int bandCount,
+                 const std::function<void(EdgeBand*)>& startBand)
+        : fHeadEdge(headEdge), fBands(bands), fBandCount(bandCount), fNextBand(0)
+        , fStartBand(startBand) {}
+
+    static void PreProc(SkBlitter* blitter, int y, bool isStartOfScanline) {
+        BandSplitter* splitter = static_cast<BandSplitter*>(blitter);
+        if (isStartOfScanline && splitter->fNextBand < splitter->fBandCount &&
+                y == splitter->fBands[splitter->fNextBand].fTop) {
+            EdgeBand* band = &splitter->fBands[splitter->fNextBand++];
+            if (copy_edges_for_band(splitter->fHeadEdge->fNext, band)) {
+                splitter->fStartBand(band);
+            }
+        }
+    }
+
+private:
+    const SkEdge*                           fHeadEdge;
+    EdgeBand*                               fBands;
+    int                                     fBandCount;
+    int                                     fNextBand;
+    const std::function<void(EdgeBand*)>&   fStartBand;
+};
+
+// Only walking the edges is serial: each band is scan-converted, into a blitter of its own, as
+// soon as the walk reaches its top row, from the edges as they were then.  Those are the edges a
+// serial walk would have used for the band's rows, in the same order, and no blitter's row
+// depends on any other, so the bands' rows come out exactly as a serial walk's.
+void sk_fill_path_in_bands(const SkPath& path, const SkIRect& clipRect,
+                           const SkScan::BlitterFactory& makeBlitter, int start_y, int stop_y,
+                           int shiftEdgesUp, bool pathContainedInClip, SkExecutor& executor) {
+    SkASSERT(!path.isInverseFillType() && !path.isConvex());
+
+    SkIRect shiftedClip = clipRect;
+    shiftedClip.fLeft <<= shiftEdgesUp;
+    shiftedClip.fRight <<= shiftEdgesUp;
+    shiftedClip.fTop <<= shiftEdgesUp;
+    shiftedClip.fBottom <<= shiftEdgesUp;
+
+    SkEdgeBuilder builder;
+    SkIRect* builderClip = pathContainedInClip ? nullptr : &shiftedClip;
+    int count = builder.build(path, builderClip, shiftEdgesUp, true);
+    SkASSERT(count >= 0);
+    if (0 == count) {
+        return;
+    }
+
+    SkEdge headEdge, tailEdge, *last;
+    SkEdge* edge = sort_edges(builder.edgeList(), count, &last);
+    link_edges(&headEdge, edge, last, &tailEdge);
+
+    if (!pathContainedInClip) {
+        start_y = SkTMax(start_y, clipRect.fTop);
+        stop_y = SkTMin(stop_y, clipRect.fBottom);
+    }
+    const SkPath::FillType fillType = path.getFillType();
+    const int rightClip = shiftedClip.right();
+
+    const int bandCount = SkTMin(SkTMin((stop_y - start_y) / kMinBandHeight,
+                                        count / kMinEdgesPerBand), kMaxBands);
+    if (bandCount <= 1) {
+        SkArenaAlloc alloc(0);
+        walk_edges(&headEdge, fillType, makeBlitter(&alloc), SkLeftShift(start_y, shiftEdgesUp),
+                   SkLeftShift(stop_y, shiftEdgesUp), nullptr, rightClip);
+        return;
+    }
+
+    SkAutoTArray<EdgeBand> bands(bandCount);
+    for (int i = 0; i < bandCount; i++) {
+        bands[i].fTop = SkLeftShift(start_y + (stop_y - start_y) * i / bandCount, shiftEdgesUp);
+        bands[i].fBottom = SkLeftShift(start_y + (stop_y - start_y) * (i + 1) / bandCount,
+                                       shiftEdgesUp);
+    }
+
+    SkTaskGroup tg(executor);
+    std::function<void(EdgeBand*)> startBand = [&](EdgeBand* band) {
+        tg.add([&, band] {
+            // The band's blitter lives in alloc, so it is done (and flushed) when we return.
+            SkArenaAlloc alloc(0);
+            walk_edges(&band->fHeadEdge, fillType, makeBlitter(&alloc), band->fTop,
+                       band->fBottom, nullptr, rightClip);
+        });
+    };
+    BandSplitter splitter(&headEdge, bands.get(), bandCount, startBand);
+    walk_edges(&headEdge, fillType, &splitter, bands[0].fTop, bands[bandCount - 1].fTop + 1,
+               BandSplitter::PreProc, rightClip);
+    tg.wait();
+}
+
 void sk_blit_above(SkBlitter* blitter, const SkIRect& ir, const SkRegion& clip) {
     const SkIRect& cr = clip.getBounds();
     SkIRect tmp;
@@ -629,7 +810,7 @@ static void round_asymmetric_to_int(const SkRect& src, SkIRect* dst) {
 }
 
 void SkScan::FillPath(const SkPath& path, const SkRegion& origClip,
-                      SkBlitter* blitter) {
+                      SkBlitter* blitter, int blitTop, int blitBottom) {
     if (origClip.isEmpty()) {
         return;
     }
@@ -671,7 +852,7 @@ void SkScan::FillPath(const SkPath& path, const SkRegion& origClip,
         SkASSERT(clipper.getClipRect() == nullptr ||
                 *clipper.getClipRect() == clipPtr->getBounds());
         sk_fill_path(path, clipPtr->getBounds(), blitter, ir.fTop, ir.fBottom,
-                     0, clipper.getClipRect() == nullptr);
+                     0, clipper.getClipRect() == nullptr, blitTop, blitBottom);
         if (path.isInverseFillType()) {
             sk_blit_below(blitter, ir, *clipPtr);
         }
@@ -686,6 +867,37 @@ void SkScan::FillPath(const SkPath& path, const SkIRect& ir,
     FillPath(path, rgn, blitter);
 }
 
+void SkScan::FillPathInBands(const SkPath& path, const SkRegion& origClip,
+                             const BlitterFactory& makeBlitter, SkExecutor& executor) {
+    SkASSERT(!path.isInverseFillType());
+    if (origClip.isEmpty()) {
+        return;
+    }
+
+    const SkRegion* clipPtr = &origClip;
+    SkRegion finiteClip;
+    if (clip_to_limit(origClip, &finiteClip)) {
+        if (finiteClip.isEmpty()) {
+            return;
+        }
+        clipPtr = &finiteClip;
+    }
+
+    SkIRect ir;
+    round_asymmetric_to_int(path.getBounds(), &ir);
+    if (ir.isEmpty() || !SkIRect::Intersects(clipPtr->getBounds(), ir)) {
+        return;
+    }
+
+    // Every band clips its own blitter, just as FillPath() clips its one.
+    auto makeClippedBlitter = [&](SkArenaAlloc* alloc) {
+        return alloc->make<SkScanClipper>(makeBlitter(alloc), clipPtr, ir)->getBlitter();
+    };
+    const bool pathContainedInClip = clipPtr->isRect() && clipPtr->getBounds().contains(ir);
+    sk_fill_path_in_bands(path, clipPtr->getBounds(), makeClippedBlitter, ir.fTop, ir.fBottom,
+                          0, pathContainedInClip, executor);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static int build_tri_edges(SkEdge edge[], const SkPoint pts[],
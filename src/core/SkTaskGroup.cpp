@@ -19,14 +19,19 @@ void SkTaskGroup::add(std::function<void(void)> fn) {
 }
 
 void SkTaskGroup::batch(int N, std::function<void(int)> fn) {
-    // TODO: I really thought we had some sort of more clever chunking logic.
     fPending.fetch_add(+N, std::memory_order_relaxed);
-    for (int i = 0; i < N; i++) {
-        fExecutor.add([=] {
-            fn(i);
-            fPending.fetch_add(-1, std::memory_order_release);
-        });
-    }
+    fExecutor.batch(N, [=](int i) {
+        fn(i);
+        fPending.fetch_add(-1, std::memory_order_release);
+    });
+}
+
+void SkTaskGroup::parallel_for(int N, int grain, std::function<void(int, int)> fn) {
+    grain = SkTMax(grain, 1);
+    this->batch(ChunkCount(N, grain), [=](int i) {
+        int start = i * grain;
+        fn(start, SkTMin(start + grain, N));
+    });
 }
 
 void SkTaskGroup::wait() {
@@ -9,6 +9,7 @@
 #define SkTaskGroup_DEFINED
 
 #include "SkExecutor.h"
+#include "SkTArray.h"
 #include "SkTypes.h"
 #include <atomic>
 #include <functional>
@@ -25,6 +26,31 @@ public:
     // Add a batch of N tasks, all calling fn with different arguments.
     void batch(int N, std::function<void(int)> fn);
 
+    // Split [0,N) into chunks of grain indices (the last may be shorter), and add one task per
+    // chunk calling fn(start, end).  Larger grains amortize per-task overhead over more indices.
+    void parallel_for(int N, int grain, std::function<void(int start, int end)> fn);
+
+    // Map each chunk of [0,N), split as by parallel_for(), to a T with map(start, end), then
+    // fold those results in chunk order with reduce(), starting from identity.  The fold order
+    // does not depend on scheduling, so floating point reductions are deterministic.
+    // This wait()s for every task in this SkTaskGroup before it returns.
+    template <typename T, typename MapFn, typename ReduceFn>
+    T parallel_reduce(int N, int grain, T identity, MapFn&& map, ReduceFn&& reduce) {
+        grain = SkTMax(grain, 1);
+        SkTArray<T> partials;
+        partials.push_back_n(ChunkCount(N, grain), identity);
+        this->parallel_for(N, grain, [&](int start, int end) {
+            partials[start / grain] = map(start, end);
+        });
+        this->wait();
+
+        T result = identity;
+        for (const T& partial : partials) {
+            result = reduce(result, partial);
+        }
+        return result;
+    }
+
     // Block until all Tasks previously add()ed to this SkTaskGroup have run.
     // You may safely reuse this SkTaskGroup after wait() returns.
     void wait();
@@ -37,6 +63,8 @@ public:
     };
 
 private:
+    static int ChunkCount(int N, int grain) { return N > 0 ? (N - 1) / grain + 1 : 0; }
+
     std::atomic<int32_t> fPending;
     SkExecutor&          fExecutor;
 };
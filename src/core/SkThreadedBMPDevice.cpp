@@ -0,0 +1,262 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkThreadedBMPDevice.h"
+
+#include "SkData.h"
+#include "SkPath.h"
+#include "SkRRect.h"
+#include "SkSpecialImage.h"
+#include "SkTaskGroup.h"
+#include "SkVertices.h"
+
+SkThreadedBMPDevice::SkThreadedBMPDevice(const SkBitmap& bitmap,
+                                         const SkSurfaceProps& surfaceProps,
+                                         int tiles, SkExecutor* executor)
+    : INHERITED(bitmap, surfaceProps)
+    , fExecutor(executor ? executor : &SkExecutor::GetDefault())
+{
+    // Horizontal bands keep each tile's rows contiguous in memory.
+    const int height = bitmap.height();
+    tiles = SkTMax(1, SkTMin(tiles, height));
+    for (int i = 0; i < tiles; i++) {
+        fTileBounds.push_back(SkIRect::MakeLTRB(0,            height *  i      / tiles,
+                                                bitmap.width(), height * (i + 1) / tiles));
+    }
+}
+
+SkIRect SkThreadedBMPDevice::transformDrawBounds(const SkRect* localBounds,
+                                                 const SkPaint& paint) const {
+    const SkIRect& clipBounds = fRCStack.rc().getBounds();
+    if (!localBounds || !paint.canComputeFastBounds()) {
+        return clipBounds;
+    }
+
+    SkRect storage;
+    SkRect devBounds;
+    this->ctm().mapRect(&devBounds, paint.computeFastBounds(*localBounds, &storage));
+    if (!devBounds.isFinite()) {
+        return clipBounds;
+    }
+
+    // Outset by a pixel for anti-aliasing and hairlines, and intersect in float space
+    // before rounding so huge geometry can't overflow the integer bounds.
+    SkRect clip = SkRect::Make(clipBounds);
+    devBounds.outset(1, 1);
+    if (!devBounds.intersect(clip)) {
+        return SkIRect::MakeEmpty();
+    }
+    return devBounds.roundOut();
+}
+
+void SkThreadedBMPDevice::recordDraw(const SkIRect& drawBounds,
+                                     std::function<void(const SkDraw&)> drawFn) {
+    if (drawBounds.isEmpty() || fRCStack.rc().isEmpty()) {
+        return;
+    }
+    fQueue.push_back(DrawElement{ drawBounds, this->ctm(), fRCStack.rc(), std::move(drawFn) });
+}
+
+void SkThreadedBMPDevice::drawTile(const SkPixmap& dst, int tileIndex) const {
+    const SkIRect& tile = fTileBounds[tileIndex];
+    for (const DrawElement& element : fQueue) {
+        if (!SkIRect::Intersects(element.fDrawBounds, tile)) {
+            continue;
+        }
+
+        // Clipping to the tile would also clip paths' edges at the tile's seams, so only the
+        // blitters are limited to the tile.  Every tile rasterizes the draw like we would, but
+        // fills only walk their edges as far as the tile's rows.
+        SkDraw draw;
+        draw.fDst         = dst;
+        draw.fMatrix      = &element.fMatrix;
+        draw.fRC          = &element.fRC;
+        draw.fBlitterClip = &tile;
+        element.fDrawFn(draw);
+    }
+}
+
+void SkThreadedBMPDevice::flush() {
+    if (fQueue.empty()) {
+        return;
+    }
+
+    // Go straight to fBitmap: accessPixels() would recurse back into flush().
+    SkPixmap dst;
+    if (fBitmap.peekPixels(&dst)) {
+        SkTaskGroup tasks(*fExecutor);
+        tasks.batch(fTileBounds.count(), [this, &dst](int i) { this->drawTile(dst, i); });
+        tasks.wait();
+        fBitmap.notifyPixelsChanged();
+    }
+    fQueue.reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkThreadedBMPDevice::drawPaint(const SkPaint& paint) {
+    this->recordDraw(this->transformDrawBounds(nullptr, paint), [paint](const SkDraw& draw) {
+        draw.drawPaint(paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawPoints(SkCanvas::PointMode mode, size_t count,
+                                     const SkPoint pts[], const SkPaint& paint) {
+    SkRect bounds;
+    bounds.set(pts, SkToInt(count));
+    sk_sp<SkData> points = SkData::MakeWithCopy(pts, count * sizeof(SkPoint));
+    this->recordDraw(this->transformDrawBounds(&bounds, paint),
+                     [mode, count, points, paint](const SkDraw& draw) {
+        draw.drawPoints(mode, count, (const SkPoint*)points->data(), paint, nullptr);
+    });
+}
+
+void SkThreadedBMPDevice::drawRect(const SkRect& r, const SkPaint& paint) {
+    SkRect bounds = r;
+    bounds.sort();
+    this->recordDraw(this->transformDrawBounds(&bounds, paint), [r, paint](const SkDraw& draw) {
+        draw.drawRect(r, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawRRect(const SkRRect& rrect, const SkPaint& paint) {
+#ifdef SK_IGNORE_BLURRED_RRECT_OPT
+    INHERITED::drawRRect(rrect, paint);
+#else
+    this->recordDraw(this->transformDrawBounds(&rrect.getBounds(), paint),
+                     [rrect, paint](const SkDraw& draw) {
+        draw.drawRRect(rrect, paint);
+    });
+#endif
+}
+
+void SkThreadedBMPDevice::drawPath(const SkPath& path, const SkPaint& paint,
+                                   const SkMatrix* prePathMatrix, bool pathIsMutable) {
+    // Inverse fills and pre-path matrices can reach outside the path's own bounds.
+    const SkRect* bounds = (path.isInverseFillType() || prePathMatrix) ? nullptr
+                                                                        : &path.getBounds();
+    const bool hasPrePathMatrix = SkToBool(prePathMatrix);
+    const SkMatrix preMatrix = prePathMatrix ? *prePathMatrix : SkMatrix::I();
+    this->recordDraw(this->transformDrawBounds(bounds, paint),
+                     [path, paint, hasPrePathMatrix, preMatrix, pathIsMutable](const SkDraw& draw) {
+        // Every tile draws the same path, so a mutable one is copied for each of them.  It must
+        // still be drawn as mutable, since SkDraw only caches the masks of paths that aren't.
+        if (pathIsMutable) {
+            SkPath tilePath(path);
+            draw.drawPath(tilePath, paint, hasPrePathMatrix ? &preMatrix : nullptr, true);
+        } else {
+            draw.drawPath(path, paint, hasPrePathMatrix ? &preMatrix : nullptr, false);
+        }
+    });
+}
+
+void SkThreadedBMPDevice::drawBitmap(const SkBitmap& bitmap, const SkMatrix& matrix,
+                                     const SkPaint& paint) {
+    LogDrawScaleFactor(SkMatrix::Concat(this->ctm(), matrix), paint.getFilterQuality());
+
+    SkRect bounds;
+    matrix.mapRect(&bounds, SkRect::MakeIWH(bitmap.width(), bitmap.height()));
+    this->recordDraw(this->transformDrawBounds(&bounds, paint),
+                     [bitmap, matrix, paint](const SkDraw& draw) {
+        draw.drawBitmap(bitmap, matrix, nullptr, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& paint) {
+    // Sprites ignore the CTM, so their bounds are already in device space.
+    SkIRect bounds = SkIRect::MakeXYWH(x, y, bitmap.width(), bitmap.height());
+    if (!bounds.intersect(fRCStack.rc().getBounds())) {
+        return;
+    }
+    this->recordDraw(bounds, [bitmap, x, y, paint](const SkDraw& draw) {
+        draw.drawSprite(bitmap, x, y, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawText(const void* text, size_t len, SkScalar x, SkScalar y,
+                                   const SkPaint& paint) {
+    sk_sp<SkData> bytes = SkData::MakeWithCopy(text, len);
+    this->recordDraw(this->transformDrawBounds(nullptr, paint),
+                     [this, bytes, x, y, paint](const SkDraw& draw) {
+        draw.drawText((const char*)bytes->data(), bytes->size(), x, y, paint,
+                      &this->surfaceProps());
+    });
+}
+
+void SkThreadedBMPDevice::drawPosText(const void* text, size_t len, const SkScalar xpos[],
+                                      int scalarsPerPos, const SkPoint& offset,
+                                      const SkPaint& paint) {
+    const int glyphCount = paint.countText(text, len);
+    sk_sp<SkData> bytes = SkData::MakeWithCopy(text, len);
+    sk_sp<SkData> pos = SkData::MakeWithCopy(xpos, glyphCount * scalarsPerPos * sizeof(SkScalar));
+    this->recordDraw(this->transformDrawBounds(nullptr, paint),
+                     [this, bytes, pos, scalarsPerPos, offset, paint](const SkDraw& draw) {
+        draw.drawPosText((const char*)bytes->data(), bytes->size(),
+                         (const SkScalar*)pos->data(), scalarsPerPos, offset, paint,
+                         &this->surfaceProps());
+    });
+}
+
+void SkThreadedBMPDevice::drawVertices(const SkVertices* vertices, SkBlendMode bmode,
+                                       const SkPaint& paint) {
+    sk_sp<const SkVertices> verts = sk_ref_sp(vertices);
+    this->recordDraw(this->transformDrawBounds(&vertices->bounds(), paint),
+                     [verts, bmode, paint](const SkDraw& draw) {
+        draw.drawVertices(verts->mode(), verts->vertexCount(), verts->positions(),
+                          verts->texCoords(), verts->colors(), bmode,
+                          verts->indices(), verts->indexCount(), paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawBitmapRect(const SkBitmap& bitmap, const SkRect* src,
+                                         const SkRect& dst, const SkPaint& paint,
+                                         SkCanvas::SrcRectConstraint constraint) {
+    // SkBitmapDevice may draw this straight into our pixels, so it must come after the queue.
+    this->flush();
+    INHERITED::drawBitmapRect(bitmap, src, dst, paint, constraint);
+}
+
+void SkThreadedBMPDevice::drawDevice(SkBaseDevice* device, int x, int y, const SkPaint& paint) {
+    SkASSERT(!paint.getImageFilter());
+    // Layers are plain SkBitmapDevices, and the sprite keeps their pixels alive until it's drawn.
+    this->drawSprite(static_cast<SkBitmapDevice*>(device)->fBitmap, x, y, paint);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+sk_sp<SkSpecialImage> SkThreadedBMPDevice::snapSpecial() {
+    // The snapshot shares our pixels, e.g. for a layer's backdrop, so they must be up to date.
+    this->flush();
+    return INHERITED::snapSpecial();
+}
+
+bool SkThreadedBMPDevice::onReadPixels(const SkImageInfo& dstInfo, void* dstPixels,
+                                       size_t dstRowBytes, int x, int y) {
+    this->flush();
+    return INHERITED::onReadPixels(dstInfo, dstPixels, dstRowBytes, x, y);
+}
+
+bool SkThreadedBMPDevice::onWritePixels(const SkImageInfo& srcInfo, const void* srcPixels,
+                                        size_t srcRowBytes, int x, int y) {
+    this->flush();
+    return INHERITED::onWritePixels(srcInfo, srcPixels, srcRowBytes, x, y);
+}
+
+bool SkThreadedBMPDevice::onPeekPixels(SkPixmap* pmap) {
+    this->flush();
+    return INHERITED::onPeekPixels(pmap);
+}
+
+bool SkThreadedBMPDevice::onAccessPixels(SkPixmap* pmap) {
+    this->flush();
+    return INHERITED::onAccessPixels(pmap);
+}
+
+void SkThreadedBMPDevice::replaceBitmapBackendForRasterSurface(const SkBitmap& bm) {
+    this->flush();
+    INHERITED::replaceBitmapBackendForRasterSurface(bm);
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkThreadedBMPDevice_DEFINED
+#define SkThreadedBMPDevice_DEFINED
+
+#include "SkBitmapDevice.h"
+#include "SkDraw.h"
+#include "SkExecutor.h"
+#include "SkRasterClip.h"
+#include "SkTArray.h"
+
+#include <functional>
+
+/**
+ *  An SkBitmapDevice that splits its bitmap into horizontal tiles, records each draw (along with
+ *  the matrix and clip it was issued with), and only rasterizes on flush(), with every tile
+ *  replaying the draws that touch it on an SkExecutor.  Tiles are disjoint, so no two threads
+ *  ever write the same pixel, and each tile sees the draws in the order they were issued.
+ *
+ *  Draws that we don't know how to defer (layers, image filters, ...) flush the queue and then
+ *  run on the calling thread exactly as SkBitmapDevice would run them.
+ *
+ *  Every tile rasterizes each draw with its original clip, and only its blitters are limited to
+ *  the tile, so the pixels are exactly those SkBitmapDevice would draw.
+ */
+class SkThreadedBMPDevice : public SkBitmapDevice {
+public:
+    // If executor is null, tiles are rasterized on SkExecutor::GetDefault().
+    SkThreadedBMPDevice(const SkBitmap& bitmap, const SkSurfaceProps& surfaceProps,
+                        int tiles, SkExecutor* executor = nullptr);
+    ~SkThreadedBMPDevice() override { this->flush(); }
+
+    void flush() override;
+
+protected:
+    void drawPaint(const SkPaint& paint) override;
+    void drawPoints(SkCanvas::PointMode mode, size_t count,
+                    const SkPoint[], const SkPaint& paint) override;
+    void drawRect(const SkRect& r, const SkPaint& paint) override;
+    void drawRRect(const SkRRect& rr, const SkPaint& paint) override;
+
+    void drawPath(const SkPath&, const SkPaint&, const SkMatrix* prePathMatrix,
+                  bool pathIsMutable) override;
+    void drawBitmap(const SkBitmap&, const SkMatrix&, const SkPaint&) override;
+    void drawSprite(const SkBitmap&, int x, int y, const SkPaint&) override;
+
+    void drawText(const void* text, size_t len, SkScalar x, SkScalar y,
+                  const SkPaint&) override;
+    void drawPosText(const void* text, size_t len, const SkScalar pos[],
+                     int scalarsPerPos, const SkPoint& offset, const SkPaint& paint) override;
+    void drawVertices(const SkVertices*, SkBlendMode, const SkPaint&) override;
+
+    void drawBitmapRect(const SkBitmap&, const SkRect*, const SkRect&,
+                        const SkPaint&, SkCanvas::SrcRectConstraint) override;
+    void drawDevice(SkBaseDevice*, int x, int y, const SkPaint&) override;
+
+    // Anything that reads or replaces our pixels must see every recorded draw first.
+    sk_sp<SkSpecialImage> snapSpecial() override;
+    bool onReadPixels(const SkImageInfo&, void*, size_t, int x, int y) override;
+    bool onWritePixels(const SkImageInfo&, const void*, size_t, int, int) override;
+    bool onPeekPixels(SkPixmap*) override;
+    bool onAccessPixels(SkPixmap*) override;
+
+private:
+    struct DrawElement {
+        SkIRect                            fDrawBounds;
+        SkMatrix                           fMatrix;
+        SkRasterClip                       fRC;
+        std::function<void(const SkDraw&)> fDrawFn;
+    };
+
+    // Returns the device-space bounds of a draw, limited to the current clip.
+    // A null localBounds means the draw may touch anything inside the clip.
+    SkIRect transformDrawBounds(const SkRect* localBounds, const SkPaint&) const;
+
+    void recordDraw(const SkIRect& drawBounds, std::function<void(const SkDraw&)> drawFn);
+    void drawTile(const SkPixmap& dst, int tileIndex) const;
+
+    void replaceBitmapBackendForRasterSurface(const SkBitmap&) override;
+
+    SkExecutor*            fExecutor;
+    SkTArray<SkIRect>      fTileBounds;
+    SkTArray<DrawElement>  fQueue;
+
+    typedef SkBitmapDevice INHERITED;
+};
+
+#endif // SkThreadedBMPDevice_DEFINED
@@ -7,7 +7,10 @@
 
 
 #include "SkBlurMask.h"
+#include "SkExecutor.h"
 #include "SkMath.h"
+#include "SkNx.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkEndian.h"
 
@@ -471,6 +474,383 @@ static void clamp_with_orig(uint8_t dst[], int dstRowBytes,
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Big masks take a different route to the same pixels.  The passes across each row are run just
+// as above, minus the transposes, with bands of rows spread across SkExecutor::GetDefault().
+// Then, rather than blurring the transposed mask along its rows, we blur the untransposed mask
+// down its columns: each step adds one source row to a running sum per column, so sixteen
+// columns at a time go through SkNx, and every row we touch is contiguous.  Each pixel comes
+// out of exactly the same integer math as boxBlur() and boxBlurInterp().
+
+// Below this many source pixels, the single threaded transposing passes are just as fast.
+static constexpr int kMinPixelsForColumnBlur   = 128 * 128;
+// Below this many source pixels, handing the work out to other threads isn't worth it.
+static constexpr int kMinPixelsForThreadedBlur = 512 * 512;
+
+// An A8 image: fHeight rows of fWidth bytes, fRowBytes apart.
+struct BlurPlane {
+    uint8_t* fPixels;
+    int      fRowBytes;
+    int      fWidth;
+    int      fHeight;
+
+    uint8_t* row(int y) const { return fPixels + (size_t)y * fRowBytes; }
+};
+
+// One pass of boxBlur(), or of boxBlurInterp() if fOuterWeight < 255.
+struct BoxPass {
+    int     fLeftRadius;
+    int     fRightRadius;
+    uint8_t fOuterWeight;
+
+    int diameter() const { return fLeftRadius + fRightRadius; }
+    int growth() const { return 2 * SkTMax(fLeftRadius, fRightRadius); }
+    bool interp() const { return fOuterWeight < 255; }
+};
+
+// Runs fn(start, end) over [0,N) in chunks of at least grain, on executor if it's not null.
+static void for_each_chunk(SkExecutor* executor, int N, int grain,
+                           const std::function<void(int, int)>& fn) {
+    if (executor && N > grain) {
+        SkTaskGroup tg(*executor);
+        tg.parallel_for(N, grain, fn);
+        tg.wait();
+    } else {
+        fn(0, N);
+    }
+}
+
+// Blurs each row of src into the same row of dst, which is pass.growth() pixels wider.
+static void blur_rows(const BlurPlane& src, const BlurPlane& dst, const BoxPass& pass,
+                      SkExecutor* executor) {
+    SkASSERT(src.fHeight == dst.fHeight && src.fWidth + pass.growth() == dst.fWidth);
+    SkASSERT(dst.fRowBytes == dst.fWidth);
+    for_each_chunk(executor, src.fHeight, 32, [&](int startY, int endY) {
+        if (pass.interp()) {
+            boxBlurInterp(src.row(startY), src.fRowBytes, dst.row(startY), pass.fLeftRadius,
+                          src.fWidth, endY - startY, false, pass.fOuterWeight);
+        } else {
+            boxBlur(src.row(startY), src.fRowBytes, dst.row(startY),
+                    pass.fLeftRadius, pass.fRightRadius, src.fWidth, endY - startY, false);
+        }
+    });
+}
+
+static constexpr int kColumnStrip = 256;
+static const uint8_t gZeroRow[kColumnStrip] = { 0 };
+
+// The column blurs below keep running sums for a strip of columns.  When the box is no more
+// than 257 pixels tall its sums fit in 16 bits, and so does every partial product we need:
+// splitting each 32-bit scale into halves,
+//     sum * scale + (1<<23) == (sum*scaleHi + mulHi(sum, scaleLo) + (1<<7)) << 16
+//                            + lo16(sum * scaleLo),
+// and the low 16 bits can't carry into the 8 we keep.  Interpolated passes add two of those
+// products, whose low halves can carry into bit 16, so we add that carry back explicitly.
+static constexpr int kMax16BitKernel = 257;
+
+static Sk16h load_row(const uint8_t* p) {
+    return SkNx_cast<uint16_t>(Sk16b::Load(p));
+}
+
+static void box_columns(uint16_t sums[], const uint8_t* add, const uint8_t* sub,
+                        uint8_t* dst, int n, uint32_t scale) {
+    const Sk16h scaleHi(scale >> 16),
+                scaleLo(scale & 0xFFFF);
+    int x = 0;
+    for (; x + 16 <= n; x += 16) {
+        Sk16h sum = Sk16h::Load(sums + x) + load_row(add + x) - load_row(sub + x);
+        sum.store(sums + x);
+        SkNx_cast<uint8_t>((sum * scaleHi + sum.mulHi(scaleLo) + Sk16h(1 << 7)) >> 8)
+            .store(dst + x);
+    }
+    for (; x < n; x++) {
+        uint32_t sum = sums[x] += add[x] - sub[x];
+        dst[x] = (sum * scale + (1 << 23)) >> 24;
+    }
+}
+
+static void box_columns(uint32_t sums[], const uint8_t* add, const uint8_t* sub,
+                        uint8_t* dst, int n, uint32_t scale) {
+    for (int x = 0; x < n; x++) {
+        uint32_t sum = sums[x] += add[x] - sub[x];
+        dst[x] = (sum * scale + (1 << 23)) >> 24;
+    }
+}
+
+// The inner box is the outer box without its newest and oldest rows.
+static void interp_columns(uint16_t sums[], const uint8_t* add, const uint8_t* sub,
+                           const uint8_t* newest, const uint8_t* oldest, uint8_t* dst, int n,
+                           uint32_t outerScale, uint32_t innerScale) {
+    const Sk16h outerHi(outerScale >> 16), outerLo(outerScale & 0xFFFF),
+                innerHi(innerScale >> 16), innerLo(innerScale & 0xFFFF);
+    int x = 0;
+    for (; x + 16 <= n; x += 16) {
+        Sk16h outer = Sk16h::Load(sums + x) + load_row(add + x) - load_row(sub + x);
+        outer.store(sums + x);
+        Sk16h inner = outer - load_row(newest + x) - load_row(oldest + x);
+
+        Sk16h outerLow = outer * outerLo,
+              innerLow = inner * innerLo,
+              carry = ((outerLow >> 1) + (innerLow >> 1) + (outerLow & innerLow & 1)) >> 15;
+        Sk16h high = outer * outerHi + outer.mulHi(outerLo)
+                   + inner * innerHi + inner.mulHi(innerLo)
+                   + carry + Sk16h(1 << 7);
+        SkNx_cast<uint8_t>(high >> 8).store(dst + x);
+    }
+    for (; x < n; x++) {
+        uint32_t outer = sums[x] += add[x] - sub[x];
+        uint32_t inner = outer - newest[x] - oldest[x];
+        dst[x] = (outer * outerScale + inner * innerScale + (1 << 23)) >> 24;
+    }
+}
+
+static void interp_columns(uint32_t sums[], const uint8_t* add, const uint8_t* sub,
+                           const uint8_t* newest, const uint8_t* oldest, uint8_t* dst, int n,
+                           uint32_t outerScale, uint32_t innerScale) {
+    for (int x = 0; x < n; x++) {
+        uint32_t outer = sums[x] += add[x] - sub[x];
+        uint32_t inner = outer - newest[x] - oldest[x];
+        dst[x] = (outer * outerScale + inner * innerScale + (1 << 23)) >> 24;
+    }
+}
+
+// Blurs each column of src into the same column of dst, which is pass.growth() rows taller.
+template <typename Sum>
+static void blur_columns(const BlurPlane& src, const BlurPlane& dst, const BoxPass& pass,
+                         SkExecutor* executor) {
+    SkASSERT(src.fWidth == dst.fWidth && src.fHeight + pass.growth() == dst.fHeight);
+    // Output row o sums source rows [o - lag - diameter, o - lag].
+    const int diameter = pass.diameter(),
+              lag = SkTMax(0, pass.fRightRadius - pass.fLeftRadius);
+    uint32_t scale, innerScale = 0;
+    if (pass.interp()) {
+        // Just as in boxBlurInterp().
+        int outerWeight = pass.fOuterWeight,
+            innerWeight = 255 - outerWeight;
+        outerWeight += outerWeight >> 7;
+        innerWeight += innerWeight >> 7;
+        scale      = (outerWeight << 16) / (diameter + 1);
+        innerScale = (innerWeight << 16) / (diameter - 1);
+    } else {
+        scale = (1 << 24) / (diameter + 1);
+    }
+
+    auto srcRow = [&](int y, int x) {
+        return 0 <= y && y < src.fHeight ? src.row(y) + x : gZeroRow;
+    };
+    for_each_chunk(executor, src.fWidth, 64, [&](int startX, int endX) {
+        Sum sums[kColumnStrip];
+        for (int x = startX; x < endX; x += kColumnStrip) {
+            const int n = SkTMin(kColumnStrip, endX - x);
+            sk_bzero(sums, sizeof(sums));
+            for (int o = 0; o < dst.fHeight; o++) {
+                const uint8_t* add = srcRow(o - lag, x);
+                const uint8_t* sub = srcRow(o - lag - diameter - 1, x);
+                uint8_t* out = dst.row(o) + x;
+                if (pass.interp()) {
+                    // When the source is shorter than the box, boxBlurInterp() keeps leaving
+                    // the last source row out of the inner box until the outer box starts
+                    // to shrink, so we do too.
+                    const uint8_t* newest = o >= src.fHeight && o < diameter
+                                          ? srcRow(src.fHeight - 1, x) : add;
+                    interp_columns(sums, add, sub, newest, srcRow(o - diameter, x), out, n,
+                                   scale, innerScale);
+                } else {
+                    box_columns(sums, add, sub, out, n, scale);
+                }
+            }
+        }
+    });
+}
+
+// Runs passes across the rows of src, then the same passes down the columns, into dst.
+// scratch must hold two planes the size of dst.
+static void column_blur(const BlurPlane& src, const BlurPlane& dst,
+                        const BoxPass passes[], int passCount, uint8_t* scratch) {
+    SkExecutor* executor = src.fWidth * src.fHeight >= kMinPixelsForThreadedBlur
+                         ? &SkExecutor::GetDefault() : nullptr;
+    const size_t scratchSize = (size_t)dst.fRowBytes * dst.fHeight;
+    uint8_t* buffers[] = { scratch, scratch + scratchSize };
+    int next = 0;
+
+    BlurPlane cur = src;
+    for (int i = 0; i < passCount; i++) {
+        int width = cur.fWidth + passes[i].growth();
+        BlurPlane out = { buffers[next], width, width, cur.fHeight };
+        next ^= 1;
+        blur_rows(cur, out, passes[i], executor);
+        cur = out;
+    }
+    for (int i = 0; i < passCount; i++) {
+        BlurPlane out = { buffers[next], cur.fRowBytes, cur.fWidth,
+                          cur.fHeight + passes[i].growth() };
+        next ^= 1;
+        if (i == passCount - 1) {
+            out = dst;
+        }
+        if (passes[i].diameter() + 1 <= kMax16BitKernel) {
+            blur_columns<uint16_t>(cur, out, passes[i], executor);
+        } else {
+            blur_columns<uint32_t>(cur, out, passes[i], executor);
+        }
+        cur = out;
+    }
+    SkASSERT(cur.fWidth == dst.fWidth && cur.fHeight == dst.fHeight);
+}
+
+// Sigmas past twice this may be blurred at reduced resolution, if the caller allows it.
+// Shrinking so that we still blur by at least this many pixels keeps the error small.
+static constexpr SkScalar kMinDownsampledSigma = 16;
+
+// Returns the largest power of two we can shrink by when blurring with sigma.
+static int downsample_factor(SkScalar sigma) {
+    int factor = 1;
+    while (sigma >= 2 * factor * kMinDownsampledSigma) {
+        factor *= 2;
+    }
+    return factor;
+}
+
+// Averages each factor x factor block of src (treating pixels past its edges as 0) into
+// one pixel of a new mask at the origin.  Returns false if that mask can't be allocated.
+static bool shrink_mask(const SkMask& src, int factor, SkMask* small, SkExecutor* executor) {
+    const int sw = src.fBounds.width(),
+              sh = src.fBounds.height();
+    small->fBounds.set(0, 0, (sw + factor - 1) / factor, (sh + factor - 1) / factor);
+    small->fRowBytes = small->fBounds.width();
+    small->fFormat = SkMask::kA8_Format;
+    size_t size = small->computeImageSize();
+    if (0 == size) {
+        return false;
+    }
+    small->fImage = SkMask::AllocImage(size);
+
+    const unsigned area = factor * factor;
+    for_each_chunk(executor, small->fBounds.height(), 16, [&](int startY, int endY) {
+        SkAutoTMalloc<uint16_t> colSums(sw);
+        for (int y = startY; y < endY; y++) {
+            sk_bzero(colSums.get(), sw * sizeof(uint16_t));
+            for (int sy = y * factor; sy < SkTMin((y + 1) * factor, sh); sy++) {
+                const uint8_t* row = src.fImage + (size_t)sy * src.fRowBytes;
+                for (int x = 0; x < sw; x++) {
+                    colSums[x] += row[x];
+                }
+            }
+            uint8_t* dst = small->fImage + (size_t)y * small->fRowBytes;
+            for (int x = 0; x < small->fBounds.width(); x++) {
+                unsigned sum = 0;
+                for (int sx = x * factor; sx < SkTMin((x + 1) * factor, sw); sx++) {
+                    sum += colSums[sx];
+                }
+                dst[x] = (sum + area / 2) / area;
+            }
+        }
+    });
+    return true;
+}
+
+// Bilinearly scales the blur of a mask shrunk by factor back up into dst, which has the same
+// bounds as the full resolution blur: x and y here are relative to the unshrunk mask's origin,
+// and run from -padX and -padY.
+static void grow_mask(const SkMask& blurred, int factor, uint8_t* dst, int dstRowBytes,
+                      int dstW, int dstH, int padX, int padY, SkExecutor* executor) {
+    const int bw = blurred.fBounds.width(),
+              bh = blurred.fBounds.height();
+
+    // The center of full resolution pixel x lands at (x + 0.5) / factor - 0.5 in the small
+    // mask, which in 24.8 fixed point is exact for any factor up to 128.  Anything left of
+    // index -1 or right of index bw only ever samples zeros, so we clamp to those.
+    auto to_small = [factor](int x, int origin, int limit, int* index, unsigned* weight) {
+        int fixed = (2 * x + 1) * (128 / factor) - 128 - origin * 256;
+        *index  = fixed >> 8;
+        *weight = fixed & 0xFF;
+        if (*index < -1 || *index > limit) {
+            *index  = SkTPin(*index, -1, limit);
+            *weight = 0;
+        }
+    };
+
+    // First grow each row of blurred across to dstW pixels, keeping 8 bits of fraction.
+    // grown has a zero row on either end for rows -1 and bh.
+    SkAutoTMalloc<uint16_t> grown((size_t)(bh + 2) * dstW);
+    sk_bzero(grown.get(), sizeof(uint16_t) * dstW);
+    sk_bzero(grown.get() + (size_t)(bh + 1) * dstW, sizeof(uint16_t) * dstW);
+    {
+        SkAutoTMalloc<int>      xIndex(dstW);
+        SkAutoTMalloc<unsigned> xWeight(dstW);
+        for (int x = 0; x < dstW; x++) {
+            to_small(x - padX, blurred.fBounds.fLeft, bw, &xIndex[x], &xWeight[x]);
+        }
+        for_each_chunk(executor, bh, 16, [&](int startY, int endY) {
+            // One zero on the left for index -1, and two on the right for bw and bw+1.
+            SkAutoTMalloc<uint8_t> padded(bw + 3);
+            for (int y = startY; y < endY; y++) {
+                padded[0] = padded[bw + 1] = padded[bw + 2] = 0;
+                memcpy(padded.get() + 1, blurred.fImage + (size_t)y * blurred.fRowBytes, bw);
+                const uint8_t* row = padded.get() + 1;
+                uint16_t* out = grown.get() + (size_t)(y + 1) * dstW;
+                for (int x = 0; x < dstW; x++) {
+                    int i = xIndex[x];
+                    unsigned wx = xWeight[x];
+                    out[x] = row[i] * (256 - wx) + row[i + 1] * wx;
+                }
+            }
+        });
+    }
+
+    // Then blend pairs of those rows down, with 7 bit weights so that they fit in mulHi().
+    for_each_chunk(executor, dstH, 16, [&](int startY, int endY) {
+        for (int y = startY; y < endY; y++) {
+            int yIndex;
+            unsigned yWeight;
+            to_small(y - padY, blurred.fBounds.fTop, bh, &yIndex, &yWeight);
+            const uint16_t* top    = grown.get() + (size_t)(yIndex + 1) * dstW;
+            const uint16_t* bottom = top + dstW;
+            const uint16_t topWeight    = (256 - yWeight) << 7,
+                           bottomWeight = yWeight << 7;
+            uint8_t* out = dst + (size_t)y * dstRowBytes;
+
+            int x = 0;
+            for (; x + 16 <= dstW; x += 16) {
+                Sk16h blend = Sk16h::Load(top + x).mulHi(topWeight)
+                            + Sk16h::Load(bottom + x).mulHi(bottomWeight);
+                SkNx_cast<uint8_t>((blend + Sk16h(1 << 6)) >> 7).store(out + x);
+            }
+            for (; x < dstW; x++) {
+                unsigned blend = ((top[x] * topWeight) >> 16) + ((bottom[x] * bottomWeight) >> 16);
+                out[x] = (blend + (1 << 6)) >> 7;
+            }
+        }
+    });
+}
+
+// Blurs src by sigma at 1/factor resolution, and writes the normal style result into dst.
+static bool downsampled_blur(const SkMask& src, SkScalar sigma, SkBlurQuality quality,
+                             int factor, uint8_t* dst, int dstRowBytes, int dstW, int dstH,
+                             int padX, int padY) {
+    SkExecutor* executor = dstW * dstH >= kMinPixelsForThreadedBlur
+                         ? &SkExecutor::GetDefault() : nullptr;
+    SkMask small;
+    if (!shrink_mask(src, factor, &small, executor)) {
+        return false;
+    }
+    SkAutoMaskFreeImage autoSmall(small.fImage);
+
+    // Shrinking with a box and growing with a tent blur by about factor^2/4 in variance,
+    // so we take that out of what we ask for.
+    SkScalar smallSigma = SkScalarSqrt(sigma * sigma - factor * factor * 0.25f) / factor;
+    SkMask blurred;
+    if (!SkBlurMask::BoxBlur(&blurred, small, smallSigma, kNormal_SkBlurStyle, quality,
+                             nullptr, true)) {
+        return false;
+    }
+    SkAutoMaskFreeImage autoBlurred(blurred.fImage);
+
+    grow_mask(blurred, factor, dst, dstRowBytes, dstW, dstH, padX, padY, executor);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 // we use a local function to wrap the class static method to work around
 // a bug in gcc98
 void SkMask_FreeImage(uint8_t* image);
@@ -480,7 +860,7 @@ void SkMask_FreeImage(uint8_t* image) {
 
 bool SkBlurMask::BoxBlur(SkMask* dst, const SkMask& src,
                          SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
-                         SkIPoint* margin, bool force_quality) {
+                         SkIPoint* margin, bool force_quality, bool allowDownsample) {
 
     if (src.fFormat != SkMask::kA8_Format) {
         return false;
@@ -543,40 +923,69 @@ bool SkBlurMask::BoxBlur(SkMask* dst, const SkMask& src,
         uint8_t*        dp = SkMask::AllocImage(dstSize);
         SkAutoTCallVProc<uint8_t, SkMask_FreeImage> autoCall(dp);
 
-        // build the blurry destination
-        SkAutoTMalloc<uint8_t>  tmpBuffer(dstSize);
-        uint8_t*                tp = tmpBuffer.get();
-        int w = sw, h = sh;
-
-        if (outerWeight == 255) {
-            int loRadius, hiRadius;
-            get_adjusted_radii(passRadius, &loRadius, &hiRadius);
-            if (kHigh_SkBlurQuality == quality) {
-                // Do three X blurs, with a transpose on the final one.
-                w = boxBlur(sp, src.fRowBytes, tp, loRadius, hiRadius, w, h, false);
-                w = boxBlur(tp, w,             dp, hiRadius, loRadius, w, h, false);
-                w = boxBlur(dp, w,             tp, hiRadius, hiRadius, w, h, true);
-                // Do three Y blurs, with a transpose on the final one.
-                h = boxBlur(tp, h,             dp, loRadius, hiRadius, h, w, false);
-                h = boxBlur(dp, h,             tp, hiRadius, loRadius, h, w, false);
-                h = boxBlur(tp, h,             dp, hiRadius, hiRadius, h, w, true);
+        const int downsample = allowDownsample ? downsample_factor(sigma) : 1;
+        if (downsample > 1) {
+            if (!downsampled_blur(src, sigma, quality, downsample, dp, dst->fRowBytes,
+                                  dst->fBounds.width(), dst->fBounds.height(), padx, pady)) {
+                return false;
+            }
+        } else if (sw * sh >= kMinPixelsForColumnBlur) {
+            BoxPass passes[3];
+            if (outerWeight == 255) {
+                int loRadius, hiRadius;
+                get_adjusted_radii(passRadius, &loRadius, &hiRadius);
+                if (kHigh_SkBlurQuality == quality) {
+                    passes[0] = { loRadius, hiRadius, 255 };
+                    passes[1] = { hiRadius, loRadius, 255 };
+                    passes[2] = { hiRadius, hiRadius, 255 };
+                } else {
+                    passes[0] = { rx, rx, 255 };
+                }
             } else {
-                w = boxBlur(sp, src.fRowBytes, tp, rx, rx, w, h, true);
-                h = boxBlur(tp, h,             dp, ry, ry, h, w, true);
+                for (BoxPass& pass : passes) {
+                    pass = { rx, rx, (uint8_t)outerWeight };
+                }
             }
+            SkAutoTMalloc<uint8_t> scratch(2 * dstSize);
+            column_blur({ const_cast<uint8_t*>(sp), (int)src.fRowBytes, sw, sh },
+                        { dp, (int)dst->fRowBytes, dst->fBounds.width(), dst->fBounds.height() },
+                        passes, passCount, scratch.get());
         } else {
-            if (kHigh_SkBlurQuality == quality) {
-                // Do three X blurs, with a transpose on the final one.
-                w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, false, outerWeight);
-                w = boxBlurInterp(tp, w,             dp, rx, w, h, false, outerWeight);
-                w = boxBlurInterp(dp, w,             tp, rx, w, h, true, outerWeight);
-                // Do three Y blurs, with a transpose on the final one.
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, false, outerWeight);
-                h = boxBlurInterp(dp, h,             tp, ry, h, w, false, outerWeight);
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight);
+            // build the blurry destination
+            SkAutoTMalloc<uint8_t>  tmpBuffer(dstSize);
+            uint8_t*                tp = tmpBuffer.get();
+            int w = sw, h = sh;
+
+            if (outerWeight == 255) {
+                int loRadius, hiRadius;
+                get_adjusted_radii(passRadius, &loRadius, &hiRadius);
+                if (kHigh_SkBlurQuality == quality) {
+                    // Do three X blurs, with a transpose on the final one.
+                    w = boxBlur(sp, src.fRowBytes, tp, loRadius, hiRadius, w, h, false);
+                    w = boxBlur(tp, w,             dp, hiRadius, loRadius, w, h, false);
+                    w = boxBlur(dp, w,             tp, hiRadius, hiRadius, w, h, true);
+                    // Do three Y blurs, with a transpose on the final one.
+                    h = boxBlur(tp, h,             dp, loRadius, hiRadius, h, w, false);
+                    h = boxBlur(dp, h,             tp, hiRadius, loRadius, h, w, false);
+                    h = boxBlur(tp, h,             dp, hiRadius, hiRadius, h, w, true);
+                } else {
+                    w = boxBlur(sp, src.fRowBytes, tp, rx, rx, w, h, true);
+                    h = boxBlur(tp, h,             dp, ry, ry, h, w, true);
+                }
             } else {
-                w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, true, outerWeight);
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight);
+                if (kHigh_SkBlurQuality == quality) {
+                    // Do three X blurs, with a transpose on the final one.
+                    w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, false, outerWeight);
+                    w = boxBlurInterp(tp, w,             dp, rx, w, h, false, outerWeight);
+                    w = boxBlurInterp(dp, w,             tp, rx, w, h, true, outerWeight);
+                    // Do three Y blurs, with a transpose on the final one.
+                    h = boxBlurInterp(tp, h,             dp, ry, h, w, false, outerWeight);
+                    h = boxBlurInterp(dp, h,             tp, ry, h, w, false, outerWeight);
+                    h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight);
+                } else {
+                    w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, true, outerWeight);
+                    h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight);
+                }
             }
         }
 
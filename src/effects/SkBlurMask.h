@@ -30,10 +30,15 @@ public:
     // but also being able to predict precisely at what pixels the blurred profile of e.g. a
     // rectangle will lie.
 
+    //
+    // allowDownsample lets BoxBlur blur a reduced resolution copy of src when sigma is large, and
+    // scale the result back up.  The margin and bounds are the same either way.
+
     static bool SK_WARN_UNUSED_RESULT BoxBlur(SkMask* dst, const SkMask& src,
                                               SkScalar sigma, SkBlurStyle style, SkBlurQuality,
                                               SkIPoint* margin = nullptr,
-                                              bool forceQuality = false);
+                                              bool forceQuality = false,
+                                              bool allowDownsample = false);
 
     // the "ground truth" blur does a gaussian convolution; it's slow
     // but useful for comparison purposes.
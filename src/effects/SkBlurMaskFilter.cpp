@@ -316,7 +316,8 @@ bool SkBlurMaskFilterImpl::filterMask(SkMask* dst, const SkMask& src,
                                       const SkMatrix& matrix,
                                       SkIPoint* margin) const {
     SkScalar sigma = this->computeXformedSigma(matrix);
-    return SkBlurMask::BoxBlur(dst, src, sigma, fBlurStyle, this->getQuality(), margin);
+    return SkBlurMask::BoxBlur(dst, src, sigma, fBlurStyle, this->getQuality(), margin, false,
+                               SkToBool(fBlurFlags & SkBlurMaskFilter::kAllowDownsample_BlurFlag));
 }
 
 bool SkBlurMaskFilterImpl::filterRectMask(SkMask* dst, const SkRect& r,
@@ -1567,6 +1568,9 @@ void SkBlurMaskFilterImpl::toString(SkString* str) const {
         SkAddFlagToString(str,
                           SkToBool(fBlurFlags & SkBlurMaskFilter::kHighQuality_BlurFlag),
                           "HighQuality", &needSeparator);
+        SkAddFlagToString(str,
+                          SkToBool(fBlurFlags & SkBlurMaskFilter::kAllowDownsample_BlurFlag),
+                          "AllowDownsample", &needSeparator);
     } else {
         str->append("None");
     }
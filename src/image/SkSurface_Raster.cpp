@@ -10,6 +10,7 @@
 #include "SkCanvas.h"
 #include "SkDevice.h"
 #include "SkMallocPixelRef.h"
+#include "SkThreadedBMPDevice.h"
 
 static const size_t kIgnoreRowBytesValue = (size_t)~0;
 
@@ -29,10 +30,21 @@ public:
     void onCopyOnWrite(ContentChangeMode) override;
     void onRestoreBackingMutability() override;
 
+    // Rasterize through an SkThreadedBMPDevice instead of a plain SkBitmapDevice.
+    void setThreaded(int tiles, SkExecutor* executor) {
+        fTiles = tiles;
+        fExecutor = executor;
+    }
+
 private:
+    // Threaded canvases defer their draws, so flush them before handing out our pixels.
+    void flushThreadedCanvas();
+
     SkBitmap    fBitmap;
     size_t      fRowBytes;
     bool        fWeOwnThePixels;
+    int         fTiles = 0;
+    SkExecutor* fExecutor = nullptr;
 
     typedef SkSurface_Base INHERITED;
 };
@@ -119,7 +131,20 @@ SkSurface_Raster::SkSurface_Raster(sk_sp<SkPixelRef> pr, const SkSurfaceProps* p
     fWeOwnThePixels = true;
 }
 
-SkCanvas* SkSurface_Raster::onNewCanvas() { return new SkCanvas(fBitmap, this->props()); }
+SkCanvas* SkSurface_Raster::onNewCanvas() {
+    if (fTiles > 0) {
+        sk_sp<SkBaseDevice> device(new SkThreadedBMPDevice(fBitmap, this->props(),
+                                                           fTiles, fExecutor));
+        return new SkCanvas(device.get());
+    }
+    return new SkCanvas(fBitmap, this->props());
+}
+
+void SkSurface_Raster::flushThreadedCanvas() {
+    if (fTiles > 0) {
+        this->getCachedCanvas()->flush();
+    }
+}
 
 sk_sp<SkSurface> SkSurface_Raster::onNewSurface(const SkImageInfo& info) {
     return SkSurface::MakeRaster(info, &this->props());
@@ -127,10 +152,13 @@ sk_sp<SkSurface> SkSurface_Raster::onNewSurface(const SkImageInfo& info) {
 
 void SkSurface_Raster::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y,
                               const SkPaint* paint) {
+    this->flushThreadedCanvas();
     canvas->drawBitmap(fBitmap, x, y, paint);
 }
 
 sk_sp<SkImage> SkSurface_Raster::onNewImageSnapshot() {
+    this->flushThreadedCanvas();
+
     SkCopyPixelsMode cpm = kIfMutable_SkCopyPixelsMode;
     if (fWeOwnThePixels) {
         // SkImage_raster requires these pixels are immutable for its full lifetime.
@@ -218,3 +246,19 @@ sk_sp<SkSurface> SkSurface::MakeRaster(const SkImageInfo& info, size_t rowBytes,
     }
     return sk_make_sp<SkSurface_Raster>(std::move(pr), props);
 }
+
+sk_sp<SkSurface> SkSurface::MakeRasterThreaded(const SkImageInfo& info, int tiles,
+                                               SkExecutor* executor,
+                                               const SkSurfaceProps* props) {
+    if (!SkSurface_Raster::Valid(info)) {
+        return nullptr;
+    }
+
+    sk_sp<SkPixelRef> pr(SkMallocPixelRef::NewZeroed(info, 0, nullptr));
+    if (!pr) {
+        return nullptr;
+    }
+    sk_sp<SkSurface_Raster> surface = sk_make_sp<SkSurface_Raster>(std::move(pr), props);
+    surface->setThreaded(tiles, executor);
+    return surface;
+}
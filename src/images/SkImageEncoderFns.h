@@ -17,6 +17,7 @@
 #include "SkColorPriv.h"
 #include "SkColorSpace_Base.h"
 #include "SkICC.h"
+#include "SkOpts.h"
 #include "SkPreConfig.h"
 #include "SkRasterPipeline.h"
 #include "SkUnPreMultiply.h"
@@ -186,14 +187,7 @@ static inline void transform_scanline_sbgrA(char* SK_RESTRICT dst, const char* S
  */
 static inline void transform_scanline_BGRA(char* SK_RESTRICT dst, const char* SK_RESTRICT src,
                                            int width, int, const SkPMColor*) {
-    const uint32_t* srcP = (const SkPMColor*)src;
-    for (int i = 0; i < width; i++) {
-        uint32_t c = *srcP++;
-        *dst++ = (c >> 16) & 0xFF;
-        *dst++ = (c >>  8) & 0xFF;
-        *dst++ = (c >>  0) & 0xFF;
-        *dst++ = (c >> 24) & 0xFF;
-    }
+    SkOpts::RGBA_to_BGRA((uint32_t*) dst, (const uint32_t*) src, width);
 }
 
 /**
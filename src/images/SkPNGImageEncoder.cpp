@@ -14,13 +14,18 @@
 #include "SkDither.h"
 #include "SkImageEncoderFns.h"
 #include "SkMath.h"
+#include "SkNx.h"
+#include "SkPngEncoder.h"
 #include "SkStream.h"
 #include "SkString.h"
+#include "SkTaskGroup.h"
+#include "SkTDArray.h"
 #include "SkTemplates.h"
 #include "SkUnPreMultiply.h"
 #include "SkUtils.h"
 
 #include "png.h"
+#include "zlib.h"
 
 // Suppress most PNG warnings when calling image decode functions.
 static const bool c_suppressPNGImageDecoderWarnings = true;
@@ -178,9 +183,19 @@ static inline int pack_palette(SkColorTable* ctable, png_color* SK_RESTRICT pale
 }
 
 static bool do_encode(SkWStream*, const SkPixmap&, int, int, png_color_8&,
-                      SkTransferFunctionBehavior unpremulBehavior);
+                      const SkPngEncoder::Options&);
 
 bool SkEncodeImageAsPNG(SkWStream* stream, const SkPixmap& pixmap, const SkEncodeOptions& opts) {
+    SkPngEncoder::Options pngOptions;
+    pngOptions.fUnpremulBehavior = opts.fUnpremulBehavior;
+    return SkPngEncoder::Encode(stream, pixmap, pngOptions);
+}
+
+bool SkPngEncoder::Encode(SkWStream* stream, const SkPixmap& pixmap, const Options& opts) {
+    if ((opts.fFilterFlags & ~kAll_FilterFlag) || opts.fZLibLevel < 0 || opts.fZLibLevel > 9) {
+        return false;
+    }
+
     if (SkTransferFunctionBehavior::kRespect == opts.fUnpremulBehavior) {
         if (!pixmap.colorSpace() || (!pixmap.colorSpace()->gammaCloseToSRGB() &&
                                      !pixmap.colorSpace()->gammaIsLinear())) {
@@ -275,7 +290,7 @@ bool SkEncodeImageAsPNG(SkWStream* stream, const SkPixmap& pixmap, const SkEncod
         // or 4 bit indices.
     }
 
-    return do_encode(stream, pixmap, pngColorType, bitDepth, sig_bit, opts.fUnpremulBehavior);
+    return do_encode(stream, pixmap, pngColorType, bitDepth, sig_bit, opts);
 }
 
 static int num_components(int pngColorType) {
@@ -293,8 +308,294 @@ static int num_components(int pngColorType) {
     }
 }
 
+// The filters below produce the same bytes as libpng's, so a row filtered here and a row
+// filtered by png_write_rows() are interchangeable.  |prev| is the unfiltered previous row,
+// or zeros for the first row of the image.
+static void filter_none(uint8_t* dst, const uint8_t* cur, const uint8_t*, int n, int) {
+    memcpy(dst, cur, n);
+}
+
+static void filter_sub(uint8_t* dst, const uint8_t* cur, const uint8_t*, int n, int bpp) {
+    int i = 0;
+    for (; i < bpp; i++) {
+        dst[i] = cur[i];
+    }
+    for (; i + 16 <= n; i += 16) {
+        (Sk16b::Load(cur + i) - Sk16b::Load(cur + i - bpp)).store(dst + i);
+    }
+    for (; i < n; i++) {
+        dst[i] = cur[i] - cur[i - bpp];
+    }
+}
+
+static void filter_up(uint8_t* dst, const uint8_t* cur, const uint8_t* prev, int n, int) {
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        (Sk16b::Load(cur + i) - Sk16b::Load(prev + i)).store(dst + i);
+    }
+    for (; i < n; i++) {
+        dst[i] = cur[i] - prev[i];
+    }
+}
+
+static void filter_avg(uint8_t* dst, const uint8_t* cur, const uint8_t* prev, int n, int bpp) {
+    int i = 0;
+    for (; i < bpp; i++) {
+        dst[i] = cur[i] - (prev[i] >> 1);
+    }
+    for (; i + 16 <= n; i += 16) {
+        Sk16h left = SkNx_cast<uint16_t>(Sk16b::Load(cur + i - bpp)),
+              up   = SkNx_cast<uint16_t>(Sk16b::Load(prev + i));
+        (Sk16b::Load(cur + i) - SkNx_cast<uint8_t>((left + up) >> 1)).store(dst + i);
+    }
+    for (; i < n; i++) {
+        dst[i] = cur[i] - ((cur[i - bpp] + prev[i]) >> 1);
+    }
+}
+
+static inline uint8_t paeth_predictor(int a, int b, int c) {
+    int pa = SkTAbs(b - c),
+        pb = SkTAbs(a - c),
+        pc = SkTAbs(a + b - 2*c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+static void filter_paeth(uint8_t* dst, const uint8_t* cur, const uint8_t* prev, int n, int bpp) {
+    int i = 0;
+    for (; i < bpp; i++) {
+        dst[i] = cur[i] - prev[i];
+    }
+    for (; i < n; i++) {
+        dst[i] = cur[i] - paeth_predictor(cur[i - bpp], prev[i], prev[i - bpp]);
+    }
+}
+
+// libpng's heuristic for adaptive filtering: prefer the filtered row whose bytes, read as
+// signed, are closest to zero.
+static uint32_t filtered_row_cost(const uint8_t* row, int n) {
+    uint32_t sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += row[i] < 128 ? row[i] : 256 - row[i];
+    }
+    return sum;
+}
+
+// Writes one filter type byte followed by the |n| filtered bytes of |cur| to |dst|, choosing
+// among the filters in |filterFlags|.  |scratch| holds n bytes.
+static void filter_row(uint8_t* dst, const uint8_t* cur, const uint8_t* prev, int n, int bpp,
+                       int filterFlags, uint8_t* scratch) {
+    typedef void (*FilterProc)(uint8_t*, const uint8_t*, const uint8_t*, int, int);
+    static const struct {
+        int        fFlag;
+        uint8_t    fType;
+        FilterProc fProc;
+    } kFilters[] = {
+        { SkPngEncoder::kNone_FilterFlag,  PNG_FILTER_VALUE_NONE,  filter_none  },
+        { SkPngEncoder::kSub_FilterFlag,   PNG_FILTER_VALUE_SUB,   filter_sub   },
+        { SkPngEncoder::kUp_FilterFlag,    PNG_FILTER_VALUE_UP,    filter_up    },
+        { SkPngEncoder::kAvg_FilterFlag,   PNG_FILTER_VALUE_AVG,   filter_avg   },
+        { SkPngEncoder::kPaeth_FilterFlag, PNG_FILTER_VALUE_PAETH, filter_paeth },
+    };
+
+    uint32_t bestCost = SK_MaxU32;
+    bool haveBest = false;
+    for (const auto& filter : kFilters) {
+        if (!(filterFlags & filter.fFlag)) {
+            continue;
+        }
+
+        if (filterFlags == filter.fFlag) {
+            dst[0] = filter.fType;
+            filter.fProc(dst + 1, cur, prev, n, bpp);
+            return;
+        }
+
+        // Filter into whichever buffer is not holding the best row so far.
+        uint8_t* out = haveBest ? scratch : dst + 1;
+        filter.fProc(out, cur, prev, n, bpp);
+        uint32_t cost = filtered_row_cost(out, n);
+        if (!haveBest || cost < bestCost) {
+            if (haveBest) {
+                memcpy(dst + 1, scratch, n);
+            }
+            dst[0] = filter.fType;
+            bestCost = cost;
+            haveBest = true;
+        }
+    }
+}
+
+// Below this many filtered bytes per band, the cost of priming each band's dictionary and
+// flushing its output outweighs the parallelism.
+static constexpr size_t kMinBandBytes = 256 * 1024;
+static constexpr int    kMaxBands     = 32;
+static constexpr int    kWindowSize   = 1 << 15;
+
+static int rows_per_band(const SkPixmap& pixmap, size_t filteredRowBytes) {
+    int minRows = (int) SkTMin<size_t>(pixmap.height(),
+                                       (kMinBandBytes + filteredRowBytes - 1) / filteredRowBytes);
+    return SkTMax(minRows, (pixmap.height() + kMaxBands - 1) / kMaxBands);
+}
+
+struct DeflatedBand {
+    SkTDArray<uint8_t> fData;
+    uLong              fAdler;
+    size_t             fLength;   // uncompressed
+};
+
+// Deflates |length| bytes at |src| as raw deflate blocks.  The 32K preceding |src| (if any)
+// prime the compressor's window, so matches may reach back into the previous band just as
+// they would in a serial stream.  Every band but the last ends with a sync flush, so the bands
+// can be concatenated into one stream on byte boundaries.
+static bool deflate_band(const uint8_t* src, size_t length, size_t offset, bool last,
+                         int zlibLevel, DeflatedBand* band) {
+    z_stream stream;
+    sk_bzero(&stream, sizeof(stream));
+    if (Z_OK != deflateInit2(&stream, zlibLevel, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY)) {
+        return false;
+    }
+
+    size_t dictLength = SkTMin<size_t>(offset, kWindowSize);
+    if (dictLength &&
+        Z_OK != deflateSetDictionary(&stream, src - dictLength, (uInt) dictLength)) {
+        deflateEnd(&stream);
+        return false;
+    }
+
+    band->fAdler = adler32(adler32(0, nullptr, 0), src, (uInt) length);
+    band->fLength = length;
+    band->fData.setReserve((int) deflateBound(&stream, length) + 16);
+
+    stream.next_in = const_cast<uint8_t*>(src);
+    stream.avail_in = (uInt) length;
+    const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+    uint8_t buffer[4096];
+    int result;
+    do {
+        stream.next_out = buffer;
+        stream.avail_out = sizeof(buffer);
+        result = deflate(&stream, flush);
+        if (Z_STREAM_ERROR == result) {
+            break;
+        }
+        band->fData.append((int) (sizeof(buffer) - stream.avail_out), buffer);
+    } while (0 == stream.avail_out || (last && Z_STREAM_END != result));
+
+    deflateEnd(&stream);
+    return last ? Z_STREAM_END == result : Z_OK == result || Z_BUF_ERROR == result;
+}
+
+static void write_IDAT(png_structp png_ptr, const uint8_t* prefix, size_t prefixLength,
+                       const SkTDArray<uint8_t>& data, const uint8_t* suffix,
+                       size_t suffixLength) {
+    png_write_chunk_start(png_ptr, (png_const_bytep) "IDAT",
+                          (png_uint_32) (prefixLength + data.count() + suffixLength));
+    png_write_chunk_data(png_ptr, prefix, prefixLength);
+    png_write_chunk_data(png_ptr, data.begin(), data.count());
+    png_write_chunk_data(png_ptr, suffix, suffixLength);
+    png_write_chunk_end(png_ptr);
+}
+
+/*
+ *  Converts, filters and deflates bands of rows concurrently, then writes the bands as IDAT
+ *  chunks of one standard zlib stream, followed by IEND.  This replaces png_write_rows() and
+ *  png_write_end(), and must follow png_write_info().
+ *
+ *  |pngBytesPerPixel| is the size of a pixel written by |proc|.  If |stripFiller| is set, |proc|
+ *  writes 16-bit RGBA and the alpha channel is dropped, as png_set_filler() would.
+ */
+static bool write_banded_rows(png_structp png_ptr, const SkPixmap& pixmap,
+                              transform_scanline_proc proc, int pngBytesPerPixel,
+                              bool stripFiller, int filterFlags,
+                              const SkPngEncoder::Options& options) {
+    const int width = pixmap.width();
+    const int height = pixmap.height();
+    const int bpp = stripFiller ? 6 : pngBytesPerPixel;
+    const size_t rowBytes = width * bpp;
+    const size_t filteredRowBytes = rowBytes + 1;
+    const int rowsPerBand = rows_per_band(pixmap, filteredRowBytes);
+    const int bandCount = (height + rowsPerBand - 1) / rowsPerBand;
+
+    SkAutoTMalloc<uint8_t> filtered(filteredRowBytes * height);
+    if (!filtered.get()) {
+        return false;
+    }
+
+    auto convertRow = [&](uint8_t* dst, int y) {
+        const char* src = (const char*) pixmap.addr(0, y);
+        proc((char*) dst, src, width, SkColorTypeBytesPerPixel(pixmap.colorType()), nullptr);
+        if (stripFiller) {
+            for (int x = 0; x < width; x++) {
+                memmove(dst + 6 * x, dst + 8 * x, 6);
+            }
+        }
+    };
+
+    SkTaskGroup taskGroup(*options.fExecutor);
+    taskGroup.parallel_for(height, rowsPerBand, [&](int start, int end) {
+        // Rows are converted into a buffer sized for the unstripped pixels.
+        const size_t convertedRowBytes = width * pngBytesPerPixel;
+        SkAutoTMalloc<uint8_t> storage(3 * convertedRowBytes);
+        uint8_t* prev = storage.get();
+        uint8_t* cur = prev + convertedRowBytes;
+        uint8_t* scratch = cur + convertedRowBytes;
+        if (start > 0) {
+            convertRow(prev, start - 1);
+        } else {
+            sk_bzero(prev, rowBytes);
+        }
+        for (int y = start; y < end; y++) {
+            convertRow(cur, y);
+            filter_row(filtered.get() + y * filteredRowBytes, cur, prev, (int) rowBytes, bpp,
+                       filterFlags, scratch);
+            SkTSwap(prev, cur);
+        }
+    });
+    taskGroup.wait();
+
+    SkAutoTArray<DeflatedBand> bands(bandCount);
+    std::atomic<bool> succeeded(true);
+    taskGroup.batch(bandCount, [&](int i) {
+        size_t offset = i * rowsPerBand * filteredRowBytes;
+        size_t length = SkTMin(rowsPerBand, height - i * rowsPerBand) * filteredRowBytes;
+        if (!deflate_band(filtered.get() + offset, length, offset, i == bandCount - 1,
+                          options.fZLibLevel, &bands[i])) {
+            succeeded = false;
+        }
+    });
+    taskGroup.wait();
+    if (!succeeded) {
+        return false;
+    }
+
+    // The zlib header (RFC 1950): a 32K deflate window, and a hint of the compression level.
+    const int levelHint = options.fZLibLevel < 2 ? 0 :
+                          options.fZLibLevel < 6 ? 1 :
+                          options.fZLibLevel == 6 ? 2 : 3;
+    uint8_t header[2] = { 0x78, (uint8_t) (levelHint << 6) };
+    header[1] += 31 - (header[0] * 256 + header[1]) % 31;
+
+    uLong adler = bands[0].fAdler;
+    for (int i = 1; i < bandCount; i++) {
+        adler = adler32_combine(adler, bands[i].fAdler, (z_off_t) bands[i].fLength);
+    }
+    uint8_t trailer[4] = {
+        (uint8_t) (adler >> 24), (uint8_t) (adler >> 16), (uint8_t) (adler >> 8), (uint8_t) adler,
+    };
+
+    for (int i = 0; i < bandCount; i++) {
+        write_IDAT(png_ptr, header, 0 == i ? sizeof(header) : 0, bands[i].fData,
+                   trailer, bandCount - 1 == i ? sizeof(trailer) : 0);
+    }
+    png_write_chunk(png_ptr, (png_const_bytep) "IEND", nullptr, 0);
+    return true;
+}
+
 static bool do_encode(SkWStream* stream, const SkPixmap& pixmap, int pngColorType, int bitDepth,
-                      png_color_8& sig_bit, SkTransferFunctionBehavior unpremulBehavior) {
+                      png_color_8& sig_bit, const SkPngEncoder::Options& options) {
     png_structp png_ptr;
     png_infop info_ptr;
 
@@ -333,6 +634,14 @@ static bool do_encode(SkWStream* stream, const SkPixmap& pixmap, int pngColorTyp
                  PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE,
                  PNG_FILTER_TYPE_BASE);
 
+    // Palette indices do not filter well, so we never filter them.
+    int filterFlags = options.fFilterFlags;
+    if (0 == filterFlags || PNG_COLOR_TYPE_PALETTE == pngColorType) {
+        filterFlags = SkPngEncoder::kNone_FilterFlag;
+    }
+    png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, filterFlags);
+    png_set_compression_level(png_ptr, options.fZLibLevel);
+
     // set our colortable/trans arrays if needed
     png_color paletteColors[256];
     png_byte trans[256];
@@ -340,7 +649,7 @@ static bool do_encode(SkWStream* stream, const SkPixmap& pixmap, int pngColorTyp
         SkColorTable* colorTable = pixmap.ctable();
         SkASSERT(colorTable);
         int numTrans = pack_palette(colorTable, paletteColors, trans, pixmap.info(),
-                                    unpremulBehavior);
+                                    options.fUnpremulBehavior);
         png_set_PLTE(png_ptr, info_ptr, paletteColors, colorTable->count());
         if (numTrans > 0) {
             png_set_tRNS(png_ptr, info_ptr, trans, numTrans, nullptr);
@@ -359,17 +668,27 @@ static bool do_encode(SkWStream* stream, const SkPixmap& pixmap, int pngColorTyp
     png_set_sBIT(png_ptr, info_ptr, &sig_bit);
     png_write_info(png_ptr, info_ptr);
     int pngBytesPerPixel = num_components(pngColorType) * (bitDepth / 8);
+    bool stripFiller = false;
     if (kRGBA_F16_SkColorType == pixmap.colorType() && kOpaque_SkAlphaType == pixmap.alphaType()) {
         // For kOpaque, kRGBA_F16, we will keep the row as RGBA and tell libpng
         // to skip the alpha channel.
         png_set_filler(png_ptr, 0, PNG_FILLER_AFTER);
         pngBytesPerPixel = 8;
+        stripFiller = true;
+    }
+
+    transform_scanline_proc proc = choose_proc(pixmap.info(), options.fUnpremulBehavior);
+    if (options.fExecutor &&
+        rows_per_band(pixmap, pixmap.width() * pngBytesPerPixel + 1) < pixmap.height()) {
+        bool success = write_banded_rows(png_ptr, pixmap, proc, pngBytesPerPixel, stripFiller,
+                                         filterFlags, options);
+        png_destroy_write_struct(&png_ptr, &info_ptr);
+        return success;
     }
 
     SkAutoSTMalloc<1024, char> rowStorage(pixmap.width() * pngBytesPerPixel);
     char* storage = rowStorage.get();
     const char* srcImage = (const char*)pixmap.addr();
-    transform_scanline_proc proc = choose_proc(pixmap.info(), unpremulBehavior);
     for (int y = 0; y < pixmap.height(); y++) {
         png_bytep row_ptr = (png_bytep)storage;
         proc(storage, srcImage, pixmap.width(), SkColorTypeBytesPerPixel(pixmap.colorType()),
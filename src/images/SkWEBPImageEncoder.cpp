@@ -25,6 +25,7 @@
 #include "SkTemplates.h"
 #include "SkUnPreMultiply.h"
 #include "SkUtils.h"
+#include "SkWebpEncoder.h"
 
 // A WebP encoder only, on top of (subset of) libwebp
 // For more information on WebP image format, and libwebp library, see:
@@ -123,8 +124,7 @@ static int stream_writer(const uint8_t* data, size_t data_size,
   return stream->write(data, data_size) ? 1 : 0;
 }
 
-static bool do_encode(SkWStream* stream, const SkPixmap& pixmap, const SkEncodeOptions& opts,
-                      int quality) {
+bool SkWebpEncoder::Encode(SkWStream* stream, const SkPixmap& pixmap, const Options& opts) {
     if (SkTransferFunctionBehavior::kRespect == opts.fUnpremulBehavior) {
         if (!pixmap.colorSpace() || (!pixmap.colorSpace()->gammaCloseToSRGB() &&
                                      !pixmap.colorSpace()->gammaIsLinear())) {
@@ -166,7 +166,15 @@ static bool do_encode(SkWStream* stream, const SkPixmap& pixmap, const SkEncodeO
     }
 
     WebPConfig webp_config;
-    if (!WebPConfigPreset(&webp_config, WEBP_PRESET_DEFAULT, (float) quality)) {
+    if (!WebPConfigPreset(&webp_config, WEBP_PRESET_DEFAULT, opts.fQuality)) {
+        return false;
+    }
+
+    const bool lossless = Compression::kLossless == opts.fCompression;
+    webp_config.lossless = lossless ? 1 : 0;
+    webp_config.method = opts.fMethod;
+    webp_config.thread_level = opts.fUseThreads ? 1 : 0;
+    if (!WebPValidateConfig(&webp_config)) {
         return false;
     }
 
@@ -177,6 +185,9 @@ static bool do_encode(SkWStream* stream, const SkPixmap& pixmap, const SkEncodeO
     pic.height = pixmap.height();
     pic.writer = stream_writer;
 
+    // Lossless encodes work on ARGB.  Importing to YUV first would lose precision.
+    pic.use_argb = lossless ? 1 : 0;
+
     // If there is no need to embed an ICC profile, we write directly to the input stream.
     // Otherwise, we will first encode to |tmp| and use a mux to add the ICC chunk.  libwebp
     // forces us to have an encoded image before we can add a profile.
@@ -239,11 +250,15 @@ static bool do_encode(SkWStream* stream, const SkPixmap& pixmap, const SkEncodeO
 }
 
 bool SkEncodeImageAsWEBP(SkWStream* stream, const SkPixmap& src, int quality) {
-    return do_encode(stream, src, SkEncodeOptions(), quality);
+    SkWebpEncoder::Options webpOptions;
+    webpOptions.fQuality = (float) quality;
+    return SkWebpEncoder::Encode(stream, src, webpOptions);
 }
 
 bool SkEncodeImageAsWEBP(SkWStream* stream, const SkPixmap& src, const SkEncodeOptions& opts) {
-    return do_encode(stream, src, opts, 100);
+    SkWebpEncoder::Options webpOptions;
+    webpOptions.fUnpremulBehavior = opts.fUnpremulBehavior;
+    return SkWebpEncoder::Encode(stream, src, webpOptions);
 }
 
 #endif
@@ -8,8 +8,13 @@
 #include "SkColorPriv.h"
 #include "SkCpu.h"
 #include "SkJumper.h"
+#include "SkMutex.h"
+#include "SkOpts.h"
 #include "SkRasterPipeline.h"
+#include "SkRefCnt.h"
+#include "SkTHash.h"
 #include "SkTemplates.h"
+#include <atomic>
 
 // A debugging mode that helps prioritize porting stages to SkJumper.
 #if 0
@@ -227,83 +232,267 @@ static StageFn* lookup_portable(SkRasterPipeline::StockStage st) {
     }
 }
 
-bool SkRasterPipeline::run_with_jumper(size_t x, size_t n) const {
-#ifdef WHATS_NEXT
-    static SkOnce once;
-    once([] {
-        atexit([] {
-            for (int i = 0; i < (int)SK_ARRAY_COUNT(gMissing); i++) {
-                SkDebugf("%10d %s\n", gMissing[i].load(), gNames[i]);
-            }
-        });
-    });
-#endif
+using StartPipelineFn = size_t(size_t, void**, K*, size_t);
+
+namespace {
+    // Everything about a program that depends only on which stages it runs, not on their
+    // contexts.  We fill in the contexts each time we build a program from one of these.
+    struct StageFns : public SkRefCnt {
+        bool                  supported      = false;    // Can SkJumper run these stages?
+        size_t                min_stride     = 0;
+        StartPipelineFn*      start_pipeline = nullptr;  // Null if we only run portable code.
+        std::vector<StageFn*> fns,                       // One per stage, then just_return.
+                              portable;
+    };
 
-    SkAutoSTMalloc<64, void*> program(2*fStages.size() + 1);
-    const size_t limit = x+n;
+    struct StagesKey {
+        std::vector<SkRasterPipeline::StockStage> stages;
 
-    auto build_and_run = [&](size_t   min_stride,
-                             StageFn* (*lookup)(SkRasterPipeline::StockStage),
-                             StageFn* just_return,
-                             size_t   (*start_pipeline)(size_t, void**, K*, size_t)) {
-        if (x + min_stride <= limit) {
-            void** ip = program.get();
-            for (auto&& st : fStages) {
-                auto fn = lookup(st.stage);
-                if (!fn) {
-                    return false;
-                }
-                *ip++ = (void*)fn;
-                if (st.ctx) {
-                    *ip++ = st.ctx;
-                }
-            }
-            *ip = (void*)just_return;
+        bool operator==(const StagesKey& that) const { return stages == that.stages; }
+    };
+
+    struct StagesKeyHash {
+        uint32_t operator()(const StagesKey& key) const {
+            return SkOpts::hash(key.stages.data(), key.stages.size() * sizeof(key.stages[0]));
+        }
+    };
+
+    // A process-wide cache of StageFns, keyed by sequence of stages.  We usually see only a
+    // few dozen distinct pipelines, but just in case we start over rather than grow forever.
+    struct ProgramCache {
+        static const int kMaxEntries = 256;
+
+        SkMutex                                              mutex;
+        SkTHashMap<StagesKey, sk_sp<StageFns>, StagesKeyHash> map;
+    };
+}
+
+static std::atomic<bool> gProgramCacheEnabled{true};
+static std::atomic<int>  gProgramCacheHits{0},
+                         gProgramCacheMisses{0};
+
+static ProgramCache* program_cache() {
+    static ProgramCache* cache = new ProgramCache;
+    return cache;
+}
 
-            x = start_pipeline(x, program.get(), &kConstants, limit);
+static bool lookup_all(const std::vector<SkRasterPipeline::Stage>& stages,
+                       StageFn* (*lookup)(SkRasterPipeline::StockStage),
+                       StageFn* just_return,
+                       std::vector<StageFn*>* fns) {
+    fns->clear();
+    for (auto&& st : stages) {
+        auto fn = lookup(st.stage);
+        if (!fn) {
+            return false;
         }
-        return true;
+        fns->push_back(fn);
+    }
+    fns->push_back(just_return);
+    return true;
+}
+
+static sk_sp<StageFns> lookup_stage_fns(const std::vector<SkRasterPipeline::Stage>& stages) {
+    auto fns = sk_make_sp<StageFns>();
+
+    auto choose = [&](size_t           stride,
+                      StageFn*         (*lookup)(SkRasterPipeline::StockStage),
+                      StageFn*         just_return,
+                      StartPipelineFn* start_pipeline) {
+        fns->min_stride     = stride;
+        fns->start_pipeline = start_pipeline;
+        return lookup_all(stages, lookup, just_return, &fns->fns);
     };
 
-    // While possible, build and run at full vector stride.
+    // Pick the widest stride available.  Narrower vector strides would never get a turn:
+    // anything the widest one leaves behind is smaller than their stride too.
 #if __has_feature(memory_sanitizer)
     // We'll just run portable code.
 
 #elif defined(__aarch64__)
-    if (!build_and_run(4, lookup_aarch64, ASM(just_return,aarch64), ASM(start_pipeline,aarch64))) {
-        return false;
+    if (!choose(4, lookup_aarch64, ASM(just_return,aarch64), ASM(start_pipeline,aarch64))) {
+        return fns;
     }
 
 #elif defined(__arm__)
     if (1 && SkCpu::Supports(SkCpu::NEON|SkCpu::NEON_FMA|SkCpu::VFP_FP16)) {
-        if (!build_and_run(2, lookup_vfp4, ASM(just_return,vfp4), ASM(start_pipeline,vfp4))) {
-            return false;
+        if (!choose(2, lookup_vfp4, ASM(just_return,vfp4), ASM(start_pipeline,vfp4))) {
+            return fns;
         }
     }
 
 #elif defined(__x86_64__) || defined(_M_X64)
     if (1 && SkCpu::Supports(SkCpu::HSW)) {
-        if (!build_and_run(1, lookup_hsw, ASM(just_return,hsw), ASM(start_pipeline,hsw))) {
-            return false;
+        if (!choose(1, lookup_hsw, ASM(just_return,hsw), ASM(start_pipeline,hsw))) {
+            return fns;
         }
-    }
-    if (1 && SkCpu::Supports(SkCpu::AVX)) {
-        if (!build_and_run(1, lookup_avx, ASM(just_return,avx), ASM(start_pipeline,avx))) {
-            return false;
+    } else if (1 && SkCpu::Supports(SkCpu::AVX)) {
+        if (!choose(1, lookup_avx, ASM(just_return,avx), ASM(start_pipeline,avx))) {
+            return fns;
+        }
+    } else if (1 && SkCpu::Supports(SkCpu::SSE41)) {
+        if (!choose(4, lookup_sse41, ASM(just_return,sse41), ASM(start_pipeline,sse41))) {
+            return fns;
+        }
+    } else if (1 && SkCpu::Supports(SkCpu::SSE2)) {
+        if (!choose(4, lookup_sse2, ASM(just_return,sse2), ASM(start_pipeline,sse2))) {
+            return fns;
         }
     }
-    if (1 && SkCpu::Supports(SkCpu::SSE41)) {
-        if (!build_and_run(4, lookup_sse41, ASM(just_return,sse41), ASM(start_pipeline,sse41))) {
-            return false;
+#endif
+
+    // Finish up any leftover with portable code one pixel at a time.
+    fns->supported = lookup_all(stages, lookup_portable, sk_just_return, &fns->portable);
+    return fns;
+}
+
+static sk_sp<StageFns> find_or_lookup_stage_fns(const std::vector<SkRasterPipeline::Stage>& stages) {
+    if (!gProgramCacheEnabled.load(std::memory_order_relaxed)) {
+        return lookup_stage_fns(stages);
+    }
+
+    StagesKey key;
+    key.stages.reserve(stages.size());
+    for (auto&& st : stages) {
+        key.stages.push_back(st.stage);
+    }
+
+    ProgramCache* cache = program_cache();
+    {
+        SkAutoMutexAcquire lock(cache->mutex);
+        if (sk_sp<StageFns>* fns = cache->map.find(key)) {
+            gProgramCacheHits++;
+            return *fns;
         }
     }
-    if (1 && SkCpu::Supports(SkCpu::SSE2)) {
-        if (!build_and_run(4, lookup_sse2, ASM(just_return,sse2), ASM(start_pipeline,sse2))) {
-            return false;
+    gProgramCacheMisses++;
+
+    // Unsupported pipelines are cached too, so we don't keep looking them up just to fail.
+    sk_sp<StageFns> fns = lookup_stage_fns(stages);
+
+    SkAutoMutexAcquire lock(cache->mutex);
+    if (cache->map.count() >= ProgramCache::kMaxEntries) {
+        cache->map.reset();
+    }
+    cache->map.set(std::move(key), fns);
+    return fns;
+}
+
+// A pipeline keeps the StageFns it first finds, so running it again doesn't look them up again.
+static const StageFns& cached_stage_fns(const std::vector<SkRasterPipeline::Stage>& stages,
+                                        std::atomic<SkRefCnt*>* cached) {
+    if (SkRefCnt* fns = cached->load(std::memory_order_acquire)) {
+        return *static_cast<StageFns*>(fns);
+    }
+    SkRefCnt* fns      = find_or_lookup_stage_fns(stages).release();
+    SkRefCnt* expected = nullptr;
+    if (!cached->compare_exchange_strong(expected, fns, std::memory_order_acq_rel)) {
+        fns->unref();   // Another thread running this pipeline got there first.
+        fns = expected;
+    }
+    return *static_cast<StageFns*>(fns);
+}
+
+// Interleave stage functions with their contexts into a program start_pipeline() can run.
+static void fill_program(void** ip,
+                         const std::vector<SkRasterPipeline::Stage>& stages,
+                         const std::vector<StageFn*>& fns) {
+    SkASSERT(fns.size() == stages.size() + 1);
+    for (size_t i = 0; i < stages.size(); i++) {
+        *ip++ = (void*)fns[i];
+        if (stages[i].ctx) {
+            *ip++ = stages[i].ctx;
         }
     }
+    *ip = (void*)fns.back();
+}
+
+static void run_program(const StageFns& fns, void** program, void** portable,
+                        size_t x, size_t n) {
+    const size_t limit = x+n;
+    if (fns.start_pipeline && x + fns.min_stride <= limit) {
+        x = fns.start_pipeline(x, program, &kConstants, limit);
+    }
+    if (x < limit) {
+        sk_start_pipeline(x, portable, &kConstants, limit);
+    }
+}
+
+SkRasterPipeline::ProgramCacheStats SkRasterPipeline::GetProgramCacheStats() {
+    return { gProgramCacheHits.load(), gProgramCacheMisses.load() };
+}
+
+void SkRasterPipeline::SetProgramCacheEnabled(bool enabled) {
+    gProgramCacheEnabled.store(enabled);
+}
+
+void SkRasterPipeline::PurgeProgramCache() {
+    ProgramCache* cache = program_cache();
+    SkAutoMutexAcquire lock(cache->mutex);
+    cache->map.reset();
+}
+
+namespace {
+    // The programs a compiled pipeline runs, shared by every copy of its function.
+    struct CompiledProgram : public SkNVRefCnt<CompiledProgram> {
+        sk_sp<const StageFns> fns;
+        std::vector<void*>    program,
+                              portable;
+    };
+}
+
+std::function<void(size_t, size_t)> SkRasterPipeline::compile_with_jumper() const {
+    const StageFns& fns = cached_stage_fns(fStages, &fJumperStages);
+    if (!fns.supported) {
+        return nullptr;
+    }
+
+    auto compiled = sk_make_sp<CompiledProgram>();
+    compiled->fns = sk_ref_sp(&fns);
+    if (fns.start_pipeline) {
+        compiled->program.resize(2*fStages.size() + 1);
+        fill_program(compiled->program.data(), fStages, fns.fns);
+    }
+    compiled->portable.resize(2*fStages.size() + 1);
+    fill_program(compiled->portable.data(), fStages, fns.portable);
+
+    return [compiled](size_t x, size_t n) {
+        run_program(*compiled->fns, compiled->program.data(), compiled->portable.data(), x,n);
+    };
+}
+
+bool SkRasterPipeline::run_with_jumper(size_t x, size_t y, size_t w, size_t h,
+                                       const std::function<void(size_t)>* setRow) const {
+#ifdef WHATS_NEXT
+    static SkOnce once;
+    once([] {
+        atexit([] {
+            for (int i = 0; i < (int)SK_ARRAY_COUNT(gMissing); i++) {
+                SkDebugf("%10d %s\n", gMissing[i].load(), gNames[i]);
+            }
+        });
+    });
 #endif
 
-    // Finish up any leftover with portable code one pixel at a time.
-    return build_and_run(1, lookup_portable, sk_just_return, sk_start_pipeline);
+    const StageFns& fns = cached_stage_fns(fStages, &fJumperStages);
+    if (!fns.supported) {
+        return false;
+    }
+
+    // We build at most two programs, once, then run them over every row:
+    // one at the widest stride this CPU supports, and a portable one for leftovers.
+    SkAutoSTMalloc<64, void*> program (2*fStages.size() + 1),
+                              portable(2*fStages.size() + 1);
+    if (fns.start_pipeline) {
+        fill_program(program.get(), fStages, fns.fns);
+    }
+    fill_program(portable.get(), fStages, fns.portable);
+
+    for (size_t row = 0; row < h; row++) {
+        if (setRow) {
+            (*setRow)(y+row);
+        }
+        run_program(fns, program.get(), portable.get(), x,w);
+    }
+    return true;
 }
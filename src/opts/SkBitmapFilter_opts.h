@@ -935,6 +935,52 @@ namespace SK_OPTS_NS {
         }
     }
 
+    // Unlike the convolutions above, every output pixel reads the same number of taps, so
+    // the filter can be flattened into plain arrays.  See SkOpts::resample_row_8888.
+    void resample_row_8888(uint32_t* dst, int width, const uint32_t* src,
+                           const int32_t* offsets, const int16_t* weights, int taps) {
+        for (int x = 0; x < width; x++) {
+            const uint32_t* px = src + offsets[x];
+            const int16_t* w = weights + x * taps;
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+            // Two taps at a time, with each channel of the pair interlaced for _mm_madd_epi16.
+            __m128i accum = _mm_setzero_si128();
+            int i = 0;
+            for (; i + 2 <= taps; i += 2) {
+                __m128i pair = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(px + i)),
+                                                 _mm_setzero_si128());
+                pair = _mm_unpacklo_epi16(pair, _mm_srli_si128(pair, 8));
+                __m128i pairWeights = _mm_set1_epi32(*(const int32_t*)(w + i));
+                accum = _mm_add_epi32(accum, _mm_madd_epi16(pair, pairWeights));
+            }
+            if (i < taps) {
+                __m128i last = _mm_unpacklo_epi8(_mm_cvtsi32_si128(px[i]), _mm_setzero_si128());
+                last = _mm_unpacklo_epi16(last, _mm_setzero_si128());
+                __m128i lastWeight = _mm_set1_epi32(w[i] & 0xFFFF);
+                accum = _mm_add_epi32(accum, _mm_madd_epi16(last, lastWeight));
+            }
+            accum = _mm_srai_epi32(accum, SkConvolutionFilter1D::kShiftBits);
+            accum = _mm_packus_epi16(_mm_packs_epi32(accum, accum), accum);
+            dst[x] = _mm_cvtsi128_si32(accum);
+    #else
+            int accum[4] = {0};
+            for (int i = 0; i < taps; i++) {
+                const uint32_t p = px[i];
+                accum[0] += w[i] * (int)((p >>  0) & 0xFF);
+                accum[1] += w[i] * (int)((p >>  8) & 0xFF);
+                accum[2] += w[i] * (int)((p >> 16) & 0xFF);
+                accum[3] += w[i] * (int)((p >> 24) & 0xFF);
+            }
+            uint32_t result = 0;
+            for (int c = 0; c < 4; c++) {
+                result |= (uint32_t)SkTPin(accum[c] >> SkConvolutionFilter1D::kShiftBits, 0, 255)
+                          << (8 * c);
+            }
+            dst[x] = result;
+    #endif
+        }
+    }
+
 }  // namespace SK_OPTS_NS
 
 #endif//SkBitmapFilter_opts_DEFINED
@@ -300,6 +300,10 @@ public:
     AI SkNx operator + (const SkNx& o) const { return vaddq_u16(fVec, o.fVec); }
     AI SkNx operator - (const SkNx& o) const { return vsubq_u16(fVec, o.fVec); }
     AI SkNx operator * (const SkNx& o) const { return vmulq_u16(fVec, o.fVec); }
+    AI SkNx mulHi(const SkNx& o) const {
+        return vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16 (fVec), vget_low_u16 (o.fVec)), 16),
+                            vshrn_n_u32(vmull_u16(vget_high_u16(fVec), vget_high_u16(o.fVec)), 16));
+    }
     AI SkNx operator & (const SkNx& o) const { return vandq_u16(fVec, o.fVec); }
     AI SkNx operator | (const SkNx& o) const { return vorrq_u16(fVec, o.fVec); }
 
@@ -555,6 +559,14 @@ template<> AI /*static*/ Sk4i SkNx_cast<int32_t, uint16_t>(const Sk4h& src) {
     return vreinterpretq_s32_u32(vmovl_u16(src.fVec));
 }
 
+template<> AI /*static*/ Sk16h SkNx_cast<uint16_t, uint8_t>(const Sk16b& src) {
+    return { vmovl_u8(vget_low_u8(src.fVec)), vmovl_u8(vget_high_u8(src.fVec)) };
+}
+
+template<> AI /*static*/ Sk16b SkNx_cast<uint8_t, uint16_t>(const Sk16h& src) {
+    return vcombine_u8(vmovn_u16(src.fLo.fVec), vmovn_u16(src.fHi.fVec));
+}
+
 template<> AI /*static*/ Sk4h SkNx_cast<uint16_t, int32_t>(const Sk4i& src) {
     return vmovn_u32(vreinterpretq_u32_s32(src.fVec));
 }
@@ -392,6 +392,7 @@ public:
     AI SkNx operator + (const SkNx& o) const { return _mm_add_epi16(fVec, o.fVec); }
     AI SkNx operator - (const SkNx& o) const { return _mm_sub_epi16(fVec, o.fVec); }
     AI SkNx operator * (const SkNx& o) const { return _mm_mullo_epi16(fVec, o.fVec); }
+    AI SkNx mulHi(const SkNx& o) const { return _mm_mulhi_epu16(fVec, o.fVec); }
     AI SkNx operator & (const SkNx& o) const { return _mm_and_si128(fVec, o.fVec); }
     AI SkNx operator | (const SkNx& o) const { return _mm_or_si128(fVec, o.fVec); }
 
@@ -809,6 +810,15 @@ template<> AI /*static*/ Sk4i SkNx_cast<int32_t, uint16_t>(const Sk4h& src) {
     return _mm_unpacklo_epi16(src.fVec, _mm_setzero_si128());
 }
 
+template<> AI /*static*/ Sk16h SkNx_cast<uint16_t, uint8_t>(const Sk16b& src) {
+    return { _mm_unpacklo_epi8(src.fVec, _mm_setzero_si128()),
+             _mm_unpackhi_epi8(src.fVec, _mm_setzero_si128()) };
+}
+
+template<> AI /*static*/ Sk16b SkNx_cast<uint8_t, uint16_t>(const Sk16h& src) {
+    return _mm_packus_epi16(src.fLo.fVec, src.fHi.fVec);
+}
+
 template<> AI /*static*/ Sk4b SkNx_cast<uint8_t, int32_t>(const Sk4i& src) {
     return _mm_packus_epi16(_mm_packus_epi16(src.fVec, src.fVec), src.fVec);
 }
@@ -99,6 +99,423 @@ namespace hsw {
         }
     }
 
+    void resample_row_8888(uint32_t* dst, int width, const uint32_t* src,
+                           const int32_t* offsets, const int16_t* weights, int taps) {
+        // Interlaces the 16-bit channels of two pixels in each lane, r0r1 g0g1 b0b1 a0a1.
+        auto interlace = _mm256_setr_epi8(0,1,8,9, 2,3,10,11, 4,5,12,13, 6,7,14,15,
+                                          0,1,8,9, 2,3,10,11, 4,5,12,13, 6,7,14,15);
+        for (int x = 0; x < width; x++) {
+            const uint32_t* px = src + offsets[x];
+            const int16_t* w = weights + x * taps;
+
+            // Four taps per iteration: taps 0-1 in the low lane, 2-3 in the high lane,
+            // with each channel accumulated in signed 17.14 fixed point.
+            auto accum = _mm256_setzero_si256();
+            int i = 0;
+            for (; i + 4 <= taps; i += 4) {
+                auto pixels = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(px + i)));
+                pixels = _mm256_shuffle_epi8(pixels, interlace);
+                auto coeffs = _mm256_permutevar8x32_epi32(
+                        _mm256_castsi128_si256(_mm_loadl_epi64((const __m128i*)(w + i))),
+                        _mm256_setr_epi32(0,0,0,0, 1,1,1,1));
+                accum = _mm256_add_epi32(accum, _mm256_madd_epi16(pixels, coeffs));
+            }
+            auto sum = _mm_add_epi32(_mm256_castsi256_si128(accum),
+                                     _mm256_extracti128_si256(accum, 1));
+
+            // Up to three taps remain.
+            for (; i < taps; i++) {
+                auto pixel = _mm_cvtepu8_epi32(_mm_cvtsi32_si128((int)px[i]));
+                sum = _mm_add_epi32(sum, _mm_mullo_epi32(pixel, _mm_set1_epi32(w[i])));
+            }
+
+            sum = _mm_srai_epi32(sum, 14);
+            sum = _mm_packus_epi16(_mm_packs_epi32(sum, sum), sum);
+            dst[x] = (uint32_t)_mm_cvtsi128_si32(sum);
+        }
+    }
+
+    // Swizzles.  These mirror the SSSE3 and NEON versions in SkSwizzler_opts.h, eight or more
+    // pixels at a time, but can't share their portable tails: that header isn't ODR safe here.
+
+    // (x*y+127)/255 for 8-bit values in 16-bit lanes, as ((x*y+128)*257)>>16.
+    static __m256i scale(__m256i x, __m256i y) {
+        return _mm256_mulhi_epu16(_mm256_add_epi16(_mm256_mullo_epi16(x, y),
+                                                   _mm256_set1_epi16(128)),
+                                  _mm256_set1_epi16(257));
+    }
+    static uint8_t scale(uint8_t x, uint8_t y) { return (x*y+127)/255; }
+
+    static uint32_t pack(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+        return (uint32_t)a << 24 | (uint32_t)b << 16 | (uint32_t)g << 8 | (uint32_t)r << 0;
+    }
+
+    // The same shuffle applied to both 128-bit lanes.
+    static __m256i lanes(char b0, char b1, char b2,  char b3,  char b4,  char b5,  char b6,  char b7,
+                         char b8, char b9, char b10, char b11, char b12, char b13, char b14, char b15) {
+        return _mm256_setr_epi8(b0,b1,b2,b3, b4,b5,b6,b7, b8,b9,b10,b11, b12,b13,b14,b15,
+                                b0,b1,b2,b3, b4,b5,b6,b7, b8,b9,b10,b11, b12,b13,b14,b15);
+    }
+
+    // Multiplies the first three bytes of each of 16 pixels by its fourth, which is kept as is
+    // if kKeepLast, or made 0xFF if not.  |planar| gathers each lane's bytes by channel, and may
+    // reorder the channels too.
+    template <bool kKeepLast>
+    static void scale_by_last(__m256i* lo, __m256i* hi, __m256i planar) {
+        // Swizzle the pixels to 8-bit planar.
+        *lo = _mm256_shuffle_epi8(*lo, planar);                   // rrrrgggg bbbbaaaa
+        *hi = _mm256_shuffle_epi8(*hi, planar);                   // RRRRGGGG BBBBAAAA
+        auto rg = _mm256_unpacklo_epi32(*lo, *hi),                // rrrrRRRR ggggGGGG
+             ba = _mm256_unpackhi_epi32(*lo, *hi);                // bbbbBBBB aaaaAAAA
+
+        // Unpack to 16-bit planar.
+        auto r = _mm256_unpacklo_epi8(rg, _mm256_setzero_si256()),
+             g = _mm256_unpackhi_epi8(rg, _mm256_setzero_si256()),
+             b = _mm256_unpacklo_epi8(ba, _mm256_setzero_si256()),
+             a = _mm256_unpackhi_epi8(ba, _mm256_setzero_si256());
+
+        r = scale(r, a);
+        g = scale(g, a);
+        b = scale(b, a);
+        if (!kKeepLast) {
+            a = _mm256_set1_epi16(0xFF);
+        }
+
+        // Repack into interlaced pixels.
+        rg = _mm256_or_si256(r, _mm256_slli_epi16(g, 8));         // rgrgrgrg RGRGRGRG
+        ba = _mm256_or_si256(b, _mm256_slli_epi16(a, 8));         // babababa BABABABA
+        *lo = _mm256_unpacklo_epi16(rg, ba);                      // rgbargba rgbargba
+        *hi = _mm256_unpackhi_epi16(rg, ba);                      // RGBARGBA RGBARGBA
+    }
+
+    static __m256i planar(bool swapRB) {
+        return swapRB ? lanes(2,6,10,14, 1,5,9,13, 0,4,8,12, 3,7,11,15)
+                      : lanes(0,4,8,12, 1,5,9,13, 2,6,10,14, 3,7,11,15);
+    }
+
+    template <bool kSwapRB>
+    static void premul_should_swapRB(uint32_t* dst, const void* vsrc, int count) {
+        auto src = (const uint32_t*)vsrc;
+        while (count >= 16) {
+            auto lo = _mm256_loadu_si256((const __m256i*)(src + 0)),
+                 hi = _mm256_loadu_si256((const __m256i*)(src + 8));
+            scale_by_last<true>(&lo, &hi, planar(kSwapRB));
+            _mm256_storeu_si256((__m256i*)(dst + 0), lo);
+            _mm256_storeu_si256((__m256i*)(dst + 8), hi);
+            src += 16;
+            dst += 16;
+            count -= 16;
+        }
+        if (count >= 8) {
+            auto lo = _mm256_loadu_si256((const __m256i*)src),
+                 hi = _mm256_setzero_si256();
+            scale_by_last<true>(&lo, &hi, planar(kSwapRB));
+            _mm256_storeu_si256((__m256i*)dst, lo);
+            src += 8;
+            dst += 8;
+            count -= 8;
+        }
+        for (int i = 0; i < count; i++) {
+            uint8_t r = src[i] >> 0, g = src[i] >> 8, b = src[i] >> 16, a = src[i] >> 24;
+            dst[i] = kSwapRB ? pack(scale(b,a), scale(g,a), scale(r,a), a)
+                             : pack(scale(r,a), scale(g,a), scale(b,a), a);
+        }
+    }
+
+    void RGBA_to_rgbA(uint32_t* dst, const void* src, int count) {
+        premul_should_swapRB<false>(dst, src, count);
+    }
+
+    void RGBA_to_bgrA(uint32_t* dst, const void* src, int count) {
+        premul_should_swapRB<true>(dst, src, count);
+    }
+
+    void RGBA_to_BGRA(uint32_t* dst, const void* vsrc, int count) {
+        auto src = (const uint32_t*)vsrc;
+        auto swap = lanes(2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15);
+        while (count >= 8) {
+            auto px = _mm256_loadu_si256((const __m256i*)src);
+            _mm256_storeu_si256((__m256i*)dst, _mm256_shuffle_epi8(px, swap));
+            src += 8;
+            dst += 8;
+            count -= 8;
+        }
+        for (int i = 0; i < count; i++) {
+            dst[i] = (src[i] & 0xFF00FF00) | (src[i] >> 16 & 0xFF) | (src[i] & 0xFF) << 16;
+        }
+    }
+
+    template <bool kSwapRB>
+    static void insert_alpha_should_swaprb(uint32_t* dst, const void* vsrc, int count) {
+        auto src = (const uint8_t*)vsrc;
+
+        // Pixels 0-3 sit at the start of the low lane, pixels 4-7 at byte 4 of the high lane.
+        auto expand = kSwapRB
+            ? _mm256_setr_epi8(2,1,0,-1,  5, 4, 3,-1,  8, 7, 6,-1, 11,10, 9,-1,
+                               6,5,4,-1,  9, 8, 7,-1, 12,11,10,-1, 15,14,13,-1)
+            : _mm256_setr_epi8(0,1,2,-1,  3, 4, 5,-1,  6, 7, 8,-1,  9,10,11,-1,
+                               4,5,6,-1,  7, 8, 9,-1, 10,11,12,-1, 13,14,15,-1);
+        while (count >= 8) {
+            auto px = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(src + 0))),
+                                           _mm_loadu_si128((const __m128i*)(src + 8)), 1);
+            px = _mm256_or_si256(_mm256_shuffle_epi8(px, expand),
+                                 _mm256_set1_epi32(0xFF000000));
+            _mm256_storeu_si256((__m256i*)dst, px);
+            src += 8*3;
+            dst += 8;
+            count -= 8;
+        }
+        for (int i = 0; i < count; i++) {
+            dst[i] = kSwapRB ? pack(src[2], src[1], src[0], 0xFF)
+                             : pack(src[0], src[1], src[2], 0xFF);
+            src += 3;
+        }
+    }
+
+    void RGB_to_RGB1(uint32_t* dst, const void* src, int count) {
+        insert_alpha_should_swaprb<false>(dst, src, count);
+    }
+
+    void RGB_to_BGR1(uint32_t* dst, const void* src, int count) {
+        insert_alpha_should_swaprb<true>(dst, src, count);
+    }
+
+    void gray_to_RGB1(uint32_t* dst, const void* vsrc, int count) {
+        auto src = (const uint8_t*)vsrc;
+        auto _0_7  = _mm256_setr_epi8( 0, 0, 0,-1,  1, 1, 1,-1,  2, 2, 2,-1,  3, 3, 3,-1,
+                                       4, 4, 4,-1,  5, 5, 5,-1,  6, 6, 6,-1,  7, 7, 7,-1),
+             _8_15 = _mm256_setr_epi8( 8, 8, 8,-1,  9, 9, 9,-1, 10,10,10,-1, 11,11,11,-1,
+                                      12,12,12,-1, 13,13,13,-1, 14,14,14,-1, 15,15,15,-1),
+             alpha = _mm256_set1_epi32(0xFF000000);
+        while (count >= 16) {
+            auto gray = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)src));
+            _mm256_storeu_si256((__m256i*)(dst + 0),
+                                _mm256_or_si256(_mm256_shuffle_epi8(gray, _0_7), alpha));
+            _mm256_storeu_si256((__m256i*)(dst + 8),
+                                _mm256_or_si256(_mm256_shuffle_epi8(gray, _8_15), alpha));
+            src += 16;
+            dst += 16;
+            count -= 16;
+        }
+        if (count >= 8) {
+            auto gray = _mm256_broadcastsi128_si256(_mm_loadl_epi64((const __m128i*)src));
+            _mm256_storeu_si256((__m256i*)dst,
+                                _mm256_or_si256(_mm256_shuffle_epi8(gray, _0_7), alpha));
+            src += 8;
+            dst += 8;
+            count -= 8;
+        }
+        for (int i = 0; i < count; i++) {
+            dst[i] = pack(src[i], src[i], src[i], 0xFF);
+        }
+    }
+
+    template <bool kPremul>
+    static void expand_grayA(uint32_t* dst, const void* vsrc, int count) {
+        auto src = (const uint8_t*)vsrc;
+        auto expand = _mm256_setr_epi8(0,0,0,1,  2, 2, 2, 3,  4, 4, 4, 5,  6, 6, 6, 7,
+                                       8,8,8,9, 10,10,10,11, 12,12,12,13, 14,14,14,15);
+        while (count >= 16) {
+            auto ga = _mm256_loadu_si256((const __m256i*)src);
+            if (kPremul) {
+                auto g = _mm256_and_si256(ga, _mm256_set1_epi16(0x00FF)),
+                     a = _mm256_srli_epi16(ga, 8);
+                ga = _mm256_or_si256(scale(g, a), _mm256_slli_epi16(a, 8));
+            }
+
+            // Pixels 0-7 are in the low lane, 8-15 in the high lane.
+            auto lo = _mm256_permute2x128_si256(ga, ga, 0x00),
+                 hi = _mm256_permute2x128_si256(ga, ga, 0x11);
+            _mm256_storeu_si256((__m256i*)(dst + 0), _mm256_shuffle_epi8(lo, expand));
+            _mm256_storeu_si256((__m256i*)(dst + 8), _mm256_shuffle_epi8(hi, expand));
+            src += 16*2;
+            dst += 16;
+            count -= 16;
+        }
+        for (int i = 0; i < count; i++) {
+            uint8_t g = src[0],
+                    a = src[1];
+            src += 2;
+            if (kPremul) {
+                g = scale(g, a);
+            }
+            dst[i] = pack(g, g, g, a);
+        }
+    }
+
+    void grayA_to_RGBA(uint32_t* dst, const void* src, int count) {
+        expand_grayA<false>(dst, src, count);
+    }
+
+    void grayA_to_rgbA(uint32_t* dst, const void* src, int count) {
+        expand_grayA<true>(dst, src, count);
+    }
+
+    template <bool kSwapRB>
+    static void inverted_cmyk_should_swaprb(uint32_t* dst, const void* vsrc, int count) {
+        auto src = (const uint32_t*)vsrc;
+        while (count >= 16) {
+            auto lo = _mm256_loadu_si256((const __m256i*)(src + 0)),
+                 hi = _mm256_loadu_si256((const __m256i*)(src + 8));
+            scale_by_last<false>(&lo, &hi, planar(kSwapRB));
+            _mm256_storeu_si256((__m256i*)(dst + 0), lo);
+            _mm256_storeu_si256((__m256i*)(dst + 8), hi);
+            src += 16;
+            dst += 16;
+            count -= 16;
+        }
+        if (count >= 8) {
+            auto lo = _mm256_loadu_si256((const __m256i*)src),
+                 hi = _mm256_setzero_si256();
+            scale_by_last<false>(&lo, &hi, planar(kSwapRB));
+            _mm256_storeu_si256((__m256i*)dst, lo);
+            src += 8;
+            dst += 8;
+            count -= 8;
+        }
+        for (int i = 0; i < count; i++) {
+            uint8_t c = src[i] >> 0, m = src[i] >> 8, y = src[i] >> 16, k = src[i] >> 24;
+            dst[i] = kSwapRB ? pack(scale(y,k), scale(m,k), scale(c,k), 0xFF)
+                             : pack(scale(c,k), scale(m,k), scale(y,k), 0xFF);
+        }
+    }
+
+    void inverted_CMYK_to_RGB1(uint32_t* dst, const void* src, int count) {
+        inverted_cmyk_should_swaprb<false>(dst, src, count);
+    }
+
+    void inverted_CMYK_to_BGR1(uint32_t* dst, const void* src, int count) {
+        inverted_cmyk_should_swaprb<true>(dst, src, count);
+    }
+
+    // Strips eight pixels of big-endian 16-bit channels to 8-bit channels.
+    static __m256i strip_RGBA16(const uint8_t* src) {
+        // The high byte of each channel is the low byte of its 16-bit lane.
+        auto _0145 = _mm256_loadu_si256((const __m256i*)(src +  0)),
+             _2367 = _mm256_loadu_si256((const __m256i*)(src + 32));
+        _0145 = _mm256_and_si256(_0145, _mm256_set1_epi16(0x00FF));
+        _2367 = _mm256_and_si256(_2367, _mm256_set1_epi16(0x00FF));
+
+        // Packing interleaves the lanes as 0 1 4 5 | 2 3 6 7.
+        auto px = _mm256_packus_epi16(_0145, _2367);
+        return _mm256_permute4x64_epi64(px, 0xD8);
+    }
+
+    template <bool kSwapRB>
+    static void premul_RGBA16_should_swapRB(uint32_t* dst, const void* vsrc, int count) {
+        auto src = (const uint8_t*)vsrc;
+        while (count >= 16) {
+            auto lo = strip_RGBA16(src +  0),
+                 hi = strip_RGBA16(src + 64);
+            scale_by_last<true>(&lo, &hi, planar(kSwapRB));
+            _mm256_storeu_si256((__m256i*)(dst + 0), lo);
+            _mm256_storeu_si256((__m256i*)(dst + 8), hi);
+            src += 16*8;
+            dst += 16;
+            count -= 16;
+        }
+        if (count >= 8) {
+            auto lo = strip_RGBA16(src),
+                 hi = _mm256_setzero_si256();
+            scale_by_last<true>(&lo, &hi, planar(kSwapRB));
+            _mm256_storeu_si256((__m256i*)dst, lo);
+            src += 8*8;
+            dst += 8;
+            count -= 8;
+        }
+        for (int i = 0; i < count; i++) {
+            uint8_t r = src[0], g = src[2], b = src[4], a = src[6];
+            src += 8;
+            dst[i] = kSwapRB ? pack(scale(b,a), scale(g,a), scale(r,a), a)
+                             : pack(scale(r,a), scale(g,a), scale(b,a), a);
+        }
+    }
+
+    void RGBA16_to_rgbA(uint32_t* dst, const void* src, int count) {
+        premul_RGBA16_should_swapRB<false>(dst, src, count);
+    }
+
+    void RGBA16_to_bgrA(uint32_t* dst, const void* src, int count) {
+        premul_RGBA16_should_swapRB<true>(dst, src, count);
+    }
+
+    // Converts two pixels of byte-swapped 16-bit channels to half floats.
+    template <bool kPremul>
+    static __m128i u16_to_F16(__m128i px) {
+        auto f = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(px)),
+                               _mm256_set1_ps(1.0f / 65535.0f));
+        if (kPremul) {
+            auto a = _mm256_blend_ps(_mm256_permute_ps(f, 0xFF), _mm256_set1_ps(1.0f), 0x88);
+            f = _mm256_mul_ps(f, a);
+        }
+        return _mm256_cvtps_ph(f, _MM_FROUND_CUR_DIRECTION);
+    }
+
+    template <bool kPremul>
+    static void RGBA16_to_F16_should_premul(uint64_t* dst, const void* vsrc, int count) {
+        auto src = (const uint8_t*)vsrc;
+        auto bswap = lanes(1,0,3,2, 5,4,7,6, 9,8,11,10, 13,12,15,14);
+        while (count >= 4) {
+            auto px = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)src), bswap);
+            _mm_storeu_si128((__m128i*)(dst + 0),
+                             u16_to_F16<kPremul>(_mm256_castsi256_si128(px)));
+            _mm_storeu_si128((__m128i*)(dst + 2),
+                             u16_to_F16<kPremul>(_mm256_extracti128_si256(px, 1)));
+            src += 4*8;
+            dst += 4;
+            count -= 4;
+        }
+        while (count --> 0) {
+            auto px = _mm_shuffle_epi8(_mm_loadl_epi64((const __m128i*)src),
+                                       _mm256_castsi256_si128(bswap));
+            _mm_storel_epi64((__m128i*)dst, u16_to_F16<kPremul>(px));
+            src += 8;
+            dst += 1;
+        }
+    }
+
+    void RGBA16_to_F16(uint64_t* dst, const void* src, int count) {
+        RGBA16_to_F16_should_premul<false>(dst, src, count);
+    }
+
+    void RGBA16_to_F16_premul(uint64_t* dst, const void* src, int count) {
+        RGBA16_to_F16_should_premul<true>(dst, src, count);
+    }
+
+    void RGB16_to_F16(uint64_t* dst, const void* vsrc, int count) {
+        auto src = (const uint8_t*)vsrc;
+
+        // Byte swap each channel and open a gap for alpha, reading pixels 0-1 from the start
+        // of a 16 byte load and pixels 2-3 from byte 4 of a load 8 bytes further on.
+        auto _01 = _mm_setr_epi8(1,0,3,2,  5, 4,-1,-1,  7, 6, 9, 8, 11,10,-1,-1),
+             _23 = _mm_setr_epi8(5,4,7,6,  9, 8,-1,-1, 11,10,13,12, 15,14,-1,-1),
+             alpha = _mm_setr_epi16(0,0,0,-1, 0,0,0,-1);
+        while (count >= 4) {
+            auto lo = _mm_loadu_si128((const __m128i*)(src + 0)),
+                 hi = _mm_loadu_si128((const __m128i*)(src + 8));
+            lo = _mm_or_si128(_mm_shuffle_epi8(lo, _01), alpha);
+            hi = _mm_or_si128(_mm_shuffle_epi8(hi, _23), alpha);
+            _mm_storeu_si128((__m128i*)(dst + 0), u16_to_F16<false>(lo));
+            _mm_storeu_si128((__m128i*)(dst + 2), u16_to_F16<false>(hi));
+            src += 4*6;
+            dst += 4;
+            count -= 4;
+        }
+        while (count --> 0) {
+            uint16_t rgba[4] = {
+                (uint16_t)(src[0] << 8 | src[1]),
+                (uint16_t)(src[2] << 8 | src[3]),
+                (uint16_t)(src[4] << 8 | src[5]),
+                0xFFFF,
+            };
+            auto px = _mm_loadl_epi64((const __m128i*)rgba);
+            _mm_storel_epi64((__m128i*)dst, u16_to_F16<false>(px));
+            src += 6;
+            dst += 1;
+        }
+    }
+
 }
 
 namespace SkOpts {
@@ -106,8 +523,44 @@ namespace SkOpts {
     extern void (*convolve_vertically)(const int16_t* filter, int filterLen,
                                        uint8_t* const* srcRows, int width,
                                        uint8_t* out, bool hasAlpha);
+    // See SkOpts.h.
+    extern void (*resample_row_8888)(uint32_t* dst, int width, const uint32_t* src,
+                                     const int32_t* offsets, const int16_t* weights, int taps);
+    extern void (*RGBA_to_BGRA)         (uint32_t*, const void*, int);
+    extern void (*RGBA_to_rgbA)         (uint32_t*, const void*, int);
+    extern void (*RGBA_to_bgrA)         (uint32_t*, const void*, int);
+    extern void (*RGB_to_RGB1)          (uint32_t*, const void*, int);
+    extern void (*RGB_to_BGR1)          (uint32_t*, const void*, int);
+    extern void (*gray_to_RGB1)         (uint32_t*, const void*, int);
+    extern void (*grayA_to_RGBA)        (uint32_t*, const void*, int);
+    extern void (*grayA_to_rgbA)        (uint32_t*, const void*, int);
+    extern void (*inverted_CMYK_to_RGB1)(uint32_t*, const void*, int);
+    extern void (*inverted_CMYK_to_BGR1)(uint32_t*, const void*, int);
+    extern void (*RGBA16_to_rgbA)       (uint32_t*, const void*, int);
+    extern void (*RGBA16_to_bgrA)       (uint32_t*, const void*, int);
+    extern void (*RGB16_to_F16)         (uint64_t*, const void*, int);
+    extern void (*RGBA16_to_F16)        (uint64_t*, const void*, int);
+    extern void (*RGBA16_to_F16_premul) (uint64_t*, const void*, int);
+
     void Init_hsw() {
         convolve_vertically = hsw::convolve_vertically;
+        resample_row_8888   = hsw::resample_row_8888;
+
+        RGBA_to_BGRA          = hsw::RGBA_to_BGRA;
+        RGBA_to_rgbA          = hsw::RGBA_to_rgbA;
+        RGBA_to_bgrA          = hsw::RGBA_to_bgrA;
+        RGB_to_RGB1           = hsw::RGB_to_RGB1;
+        RGB_to_BGR1           = hsw::RGB_to_BGR1;
+        gray_to_RGB1          = hsw::gray_to_RGB1;
+        grayA_to_RGBA         = hsw::grayA_to_RGBA;
+        grayA_to_rgbA         = hsw::grayA_to_rgbA;
+        inverted_CMYK_to_RGB1 = hsw::inverted_CMYK_to_RGB1;
+        inverted_CMYK_to_BGR1 = hsw::inverted_CMYK_to_BGR1;
+        RGBA16_to_rgbA        = hsw::RGBA16_to_rgbA;
+        RGBA16_to_bgrA        = hsw::RGBA16_to_bgrA;
+        RGB16_to_F16          = hsw::RGB16_to_F16;
+        RGBA16_to_F16         = hsw::RGBA16_to_F16;
+        RGBA16_to_F16_premul  = hsw::RGBA16_to_F16_premul;
     }
 }
 
@@ -26,5 +26,10 @@ namespace SkOpts {
         grayA_to_rgbA         = ssse3::grayA_to_rgbA;
         inverted_CMYK_to_RGB1 = ssse3::inverted_CMYK_to_RGB1;
         inverted_CMYK_to_BGR1 = ssse3::inverted_CMYK_to_BGR1;
+        RGBA16_to_rgbA        = ssse3::RGBA16_to_rgbA;
+        RGBA16_to_bgrA        = ssse3::RGBA16_to_bgrA;
+        RGB16_to_F16          = ssse3::RGB16_to_F16;
+        RGBA16_to_F16         = ssse3::RGBA16_to_F16;
+        RGBA16_to_F16_premul  = ssse3::RGBA16_to_F16_premul;
     }
 }
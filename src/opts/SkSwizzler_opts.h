@@ -9,6 +9,7 @@
 #define SkSwizzler_opts_DEFINED
 
 #include "SkColorPriv.h"
+#include "SkHalf.h"
 
 #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
     #include <immintrin.h>
@@ -166,6 +167,55 @@ static void inverted_CMYK_to_BGR1_portable(uint32_t* dst, const void* vsrc, int
     }
 }
 
+static void RGBA16_to_RGBA_portable(uint32_t* dst, const void* vsrc, int count) {
+    const uint8_t* src = (const uint8_t*)vsrc;
+    for (int i = 0; i < count; i++) {
+        // Each channel is big-endian, so its high byte comes first.
+        uint8_t r = src[0],
+                g = src[2],
+                b = src[4],
+                a = src[6];
+        src += 8;
+        dst[i] = (uint32_t)a << 24
+               | (uint32_t)b << 16
+               | (uint32_t)g <<  8
+               | (uint32_t)r <<  0;
+    }
+}
+
+static void RGB16_to_F16_portable(uint64_t* dst, const void* vsrc, int count) {
+    const uint8_t* src = (const uint8_t*)vsrc;
+    for (int i = 0; i < count; i++) {
+        Sk4f rgba = Sk4f(src[0] << 8 | src[1],
+                         src[2] << 8 | src[3],
+                         src[4] << 8 | src[5],
+                         65535) * (1.0f / 65535.0f);
+        src += 6;
+        SkFloatToHalf_finite_ftz(rgba).store(dst + i);
+    }
+}
+
+static void RGBA16_to_F16_portable(uint64_t* dst, const void* vsrc, int count) {
+    const uint8_t* src = (const uint8_t*)vsrc;
+    for (int i = 0; i < count; i++) {
+        Sk4h px = Sk4h::Load(src);
+        src += 8;
+        Sk4f rgba = SkNx_cast<float>((px << 8) | (px >> 8)) * (1.0f / 65535.0f);
+        SkFloatToHalf_finite_ftz(rgba).store(dst + i);
+    }
+}
+
+static void RGBA16_to_F16_premul_portable(uint64_t* dst, const void* vsrc, int count) {
+    const uint8_t* src = (const uint8_t*)vsrc;
+    for (int i = 0; i < count; i++) {
+        Sk4h px = Sk4h::Load(src);
+        src += 8;
+        Sk4f rgba = SkNx_cast<float>((px << 8) | (px >> 8)) * (1.0f / 65535.0f);
+        float a = rgba[3];
+        SkFloatToHalf_finite_ftz(rgba * Sk4f(a, a, a, 1.0f)).store(dst + i);
+    }
+}
+
 #if defined(SK_ARM_HAS_NEON)
 
 // Rounded divide by 255, (x + 127) / 255
@@ -490,6 +540,10 @@ static void inverted_CMYK_to_BGR1(uint32_t dst[], const void* src, int count) {
     inverted_cmyk_to<kBGR1>(dst, src, count);
 }
 
+static void RGBA16_to_RGBA(uint32_t* dst, const void* src, int count) {
+    RGBA16_to_RGBA_portable(dst, src, count);
+}
+
 #elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
 
 // Scale a byte by another.
@@ -797,6 +851,28 @@ static void inverted_CMYK_to_BGR1(uint32_t dst[], const void* src, int count) {
     inverted_cmyk_to<kBGR1>(dst, src, count);
 }
 
+static void RGBA16_to_RGBA(uint32_t* dst, const void* vsrc, int count) {
+    auto src = (const uint8_t*)vsrc;
+
+    // Gather the high byte of each big-endian channel.
+    const __m128i highBytes = _mm_setr_epi8(0,2,4,6, 8,10,12,14, -1,-1,-1,-1, -1,-1,-1,-1);
+    while (count >= 4) {
+        __m128i lo = _mm_loadu_si128((const __m128i*) (src +  0)),
+                hi = _mm_loadu_si128((const __m128i*) (src + 16));
+
+        lo = _mm_shuffle_epi8(lo, highBytes);
+        hi = _mm_shuffle_epi8(hi, highBytes);
+
+        _mm_storeu_si128((__m128i*) dst, _mm_unpacklo_epi64(lo, hi));
+
+        src += 4*8;
+        dst += 4;
+        count -= 4;
+    }
+
+    RGBA16_to_RGBA_portable(dst, src, count);
+}
+
 #else
 
 static void RGBA_to_rgbA(uint32_t* dst, const void* src, int count) {
@@ -839,8 +915,36 @@ static void inverted_CMYK_to_BGR1(uint32_t dst[], const void* src, int count) {
     inverted_CMYK_to_BGR1_portable(dst, src, count);
 }
 
+static void RGBA16_to_RGBA(uint32_t* dst, const void* src, int count) {
+    RGBA16_to_RGBA_portable(dst, src, count);
+}
+
 #endif
 
+// Strip to 8-bit RGBA in dst, then premultiply in place.
+static void RGBA16_to_rgbA(uint32_t* dst, const void* src, int count) {
+    RGBA16_to_RGBA(dst, src, count);
+    RGBA_to_rgbA(dst, dst, count);
+}
+
+static void RGBA16_to_bgrA(uint32_t* dst, const void* src, int count) {
+    RGBA16_to_RGBA(dst, src, count);
+    RGBA_to_bgrA(dst, dst, count);
+}
+
+// The portable versions already work on all four channels of a pixel at once.
+static void RGB16_to_F16(uint64_t dst[], const void* src, int count) {
+    RGB16_to_F16_portable(dst, src, count);
+}
+
+static void RGBA16_to_F16(uint64_t dst[], const void* src, int count) {
+    RGBA16_to_F16_portable(dst, src, count);
+}
+
+static void RGBA16_to_F16_premul(uint64_t dst[], const void* src, int count) {
+    RGBA16_to_F16_premul_portable(dst, src, count);
+}
+
 }
 
 #endif // SkSwizzler_opts_DEFINED
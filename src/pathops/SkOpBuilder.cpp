@@ -6,11 +6,26 @@
  */
 
 #include "SkArenaAlloc.h"
+#include "SkExecutor.h"
 #include "SkMatrix.h"
 #include "SkOpEdgeBuilder.h"
 #include "SkPathPriv.h"
 #include "SkPathOps.h"
 #include "SkPathOpsCommon.h"
+#include "SkTSort.h"
+#include "SkTaskGroup.h"
+
+#include <atomic>
+
+// Unions of more paths than this are split in two halves, which are unioned concurrently and
+// then with each other.
+static constexpr int kMaxUnionLeafPaths = 16;
+
+// Unlike SkRect::Intersects(), also true for rects that only share an edge, as paths that do
+// may still need to be joined.
+static bool touches(const SkRect& a, const SkRect& b) {
+    return a.fLeft <= b.fRight && b.fLeft <= a.fRight && a.fTop <= b.fBottom && b.fTop <= a.fBottom;
+}
 
 static bool one_contour(const SkPath& path) {
     char storage[256];
@@ -122,25 +137,28 @@ void SkOpBuilder::reset() {
     fOps.reset();
 }
 
+static bool all_union(const SkTArray<SkPath>& paths, const SkTDArray<SkPathOp>& ops) {
+    for (int index = 0; index < ops.count(); ++index) {
+        if (kUnion_SkPathOp != ops[index] || paths[index].isInverseFillType()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 /* OPTIMIZATION: Union doesn't need to be all-or-nothing. A run of three or more convex
    paths with union ops could be locally resolved and still improve over doing the
    ops one at a time. */
-bool SkOpBuilder::resolve(SkPath* result) {
-    SkPath original = *result;
-    int count = fOps.count();
-    bool allUnion = true;
+bool SkOpBuilder::Union(SkPath* paths[], int count, SkPath* result) {
+    bool sumable = true;
     SkPathPriv::FirstDirection firstDir = SkPathPriv::kUnknown_FirstDirection;
     for (int index = 0; index < count; ++index) {
-        SkPath* test = &fPathRefs[index];
-        if (kUnion_SkPathOp != fOps[index] || test->isInverseFillType()) {
-            allUnion = false;
-            break;
-        }
+        SkPath* test = paths[index];
         // If all paths are convex, track direction, reversing as needed.
         if (test->isConvex()) {
             SkPathPriv::FirstDirection dir;
             if (!SkPathPriv::CheapComputeFirstDirection(*test, &dir)) {
-                allUnion = false;
+                sumable = false;
                 break;
             }
             if (firstDir == SkPathPriv::kUnknown_FirstDirection) {
@@ -154,44 +172,247 @@ bool SkOpBuilder::resolve(SkPath* result) {
         const SkRect& testBounds = test->getBounds();
         for (int inner = 0; inner < index; ++inner) {
             // OPTIMIZE: check to see if the contour bounds do not intersect other contour bounds?
-            if (SkRect::Intersects(fPathRefs[inner].getBounds(), testBounds)) {
-                allUnion = false;
+            if (SkRect::Intersects(paths[inner]->getBounds(), testBounds)) {
+                sumable = false;
                 break;
             }
         }
     }
-    if (!allUnion) {
-        *result = fPathRefs[0];
+    if (!sumable) {
+        *result = *paths[0];
         for (int index = 1; index < count; ++index) {
-            if (!Op(*result, fPathRefs[index], fOps[index], result)) {
-                reset();
-                *result = original;
+            if (!Op(*result, *paths[index], kUnion_SkPathOp, result)) {
                 return false;
             }
         }
-        reset();
         return true;
     }
     SkPath sum;
     for (int index = 0; index < count; ++index) {
-        if (!Simplify(fPathRefs[index], &fPathRefs[index])) {
-            reset();
-            *result = original;
+        if (!Simplify(*paths[index], paths[index])) {
             return false;
         }
-        if (!fPathRefs[index].isEmpty()) {
+        if (!paths[index]->isEmpty()) {
             // convert the even odd result back to winding form before accumulating it
-            if (!FixWinding(&fPathRefs[index])) {
+            if (!FixWinding(paths[index])) {
+                return false;
+            }
+            sum.addPath(*paths[index]);
+        }
+    }
+    return Simplify(sum, result);
+}
+
+bool SkOpBuilder::UnionTree(SkPath* paths[], int count, SkPath* result) {
+    if (count <= kMaxUnionLeafPaths) {
+        return Union(paths, count, result);
+    }
+    // Split across the longer side, so that each half spans as little as possible.
+    SkRect bounds = SkRect::MakeEmpty();
+    for (int index = 0; index < count; ++index) {
+        bounds.join(paths[index]->getBounds());
+    }
+    if (bounds.width() >= bounds.height()) {
+        SkTQSort(paths, paths + count - 1, [](const SkPath* a, const SkPath* b) {
+            return a->getBounds().centerX() < b->getBounds().centerX();
+        });
+    } else {
+        SkTQSort(paths, paths + count - 1, [](const SkPath* a, const SkPath* b) {
+            return a->getBounds().centerY() < b->getBounds().centerY();
+        });
+    }
+    const int half = count / 2;
+    SkPath first, second;
+    bool firstResolved;
+    SkTaskGroup tg(SkExecutor::GetDefault());
+    tg.add([&] { firstResolved = UnionTree(paths, half, &first); });
+    const bool secondResolved = UnionTree(paths + half, count - half, &second);
+    tg.wait();
+    return firstResolved && secondResolved && Op(first, second, kUnion_SkPathOp, result);
+}
+
+static int find_cluster(SkTDArray<int>* parents, int index) {
+    while ((*parents)[index] != index) {
+        (*parents)[index] = (*parents)[(*parents)[index]];
+        index = (*parents)[index];
+    }
+    return index;
+}
+
+bool SkOpBuilder::resolve(SkPath* result) {
+    SkPath original = *result;
+    int count = fOps.count();
+    if (!all_union(fPathRefs, fOps)) {
+        *result = fPathRefs[0];
+        for (int index = 1; index < count; ++index) {
+            if (!Op(*result, fPathRefs[index], fOps[index], result)) {
+                reset();
                 *result = original;
                 return false;
             }
-            sum.addPath(fPathRefs[index]);
+        }
+        reset();
+        return true;
+    }
+
+    // Group the paths into clusters whose bounds touch, sweeping them from left to right.
+    SkTDArray<int> order, active, parents;
+    parents.setCount(count);
+    for (int index = 0; index < count; ++index) {
+        parents[index] = index;
+        if (!fPathRefs[index].isEmpty()) {
+            *order.append() = index;
+        }
+    }
+    if (order.count() > 1) {
+        SkTQSort(order.begin(), order.end() - 1, [this](int a, int b) {
+            return fPathRefs[a].getBounds().fLeft < fPathRefs[b].getBounds().fLeft;
+        });
+    }
+    for (int index : order) {
+        const SkRect& bounds = fPathRefs[index].getBounds();
+        for (int i = active.count(); i-- > 0; ) {
+            const SkRect& activeBounds = fPathRefs[active[i]].getBounds();
+            if (activeBounds.fRight < bounds.fLeft) {
+                active.removeShuffle(i);
+            } else if (touches(activeBounds, bounds)) {
+                parents[find_cluster(&parents, active[i])] = find_cluster(&parents, index);
+            }
+        }
+        *active.append() = index;
+    }
+    SkTDArray<int> clusterOf;
+    clusterOf.setCount(count);
+    for (int index = 0; index < count; ++index) {
+        clusterOf[index] = -1;
+    }
+    SkTArray<SkTDArray<SkPath*>> clusters;
+    for (int index = 0; index < count; ++index) {
+        if (fPathRefs[index].isEmpty()) {
+            continue;
+        }
+        const int root = find_cluster(&parents, index);
+        if (clusterOf[root] < 0) {
+            clusterOf[root] = clusters.count();
+            clusters.push_back();
+        }
+        *clusters[clusterOf[root]].append() = &fPathRefs[index];
+    }
+
+    bool success;
+    if (clusters.count() <= 1) {
+        SkTDArray<SkPath*> paths;
+        for (int index = 0; index < count; ++index) {
+            *paths.append() = &fPathRefs[index];
+        }
+        success = UnionTree(paths.begin(), count, result);
+    } else {
+        // Clusters do not touch each other, so each can be unioned on its own, and their
+        // results simply added together.
+        SkTArray<SkPath> sums(clusters.count());
+        sums.push_back_n(clusters.count());
+        std::atomic<bool> resolved{true};
+        SkTaskGroup tg(SkExecutor::GetDefault());
+        tg.batch(clusters.count(), [&](int i) {
+            // A lone path may come back as it was, but the sums are added with even odd fill.
+            if (!UnionTree(clusters[i].begin(), clusters[i].count(), &sums[i]) ||
+                (sums[i].getFillType() != SkPath::kEvenOdd_FillType &&
+                 !Simplify(sums[i], &sums[i]))) {
+                resolved = false;
+            }
+        });
+        tg.wait();
+        success = resolved;
+        if (success) {
+            result->reset();
+            for (const SkPath& sum : sums) {
+                result->addPath(sum);
+            }
+            result->setFillType(SkPath::kEvenOdd_FillType);
         }
     }
     reset();
-    bool success = Simplify(sum, result);
     if (!success) {
         *result = original;
     }
     return success;
 }
+
+// Sets result to (one op two), recomputing only the contours of one whose bounds touch two's.
+// As one has even odd fill, the other contours count the same whether or not they are part of
+// the operation, and the operation leaves no contour of its own where they are.
+static bool op_touching_contours(const SkPath& one, const SkPath& two, SkPathOp op,
+                                 SkPath* result) {
+    if (one.getFillType() != SkPath::kEvenOdd_FillType || two.isInverseFillType()) {
+        return Op(one, two, op, result);
+    }
+    // Outside of two, these leave nothing.
+    const bool keepUntouched = kIntersect_SkPathOp != op && kReverseDifference_SkPathOp != op;
+    const SkRect& bounds = two.getBounds();
+    SkPath touching, untouched, contour;
+    auto flush = [&]() {
+        if (contour.countVerbs()) {
+            const bool nearTwo = !two.isEmpty() && touches(contour.getBounds(), bounds);
+            (nearTwo ? touching : untouched).addPath(contour);
+            contour.rewind();
+        }
+    };
+    SkPath::RawIter iter(one);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                flush();
+                contour.moveTo(pts[0]);
+                break;
+            case SkPath::kLine_Verb:
+                contour.lineTo(pts[1]);
+                break;
+            case SkPath::kQuad_Verb:
+                contour.quadTo(pts[1], pts[2]);
+                break;
+            case SkPath::kConic_Verb:
+                contour.conicTo(pts[1], pts[2], iter.conicWeight());
+                break;
+            case SkPath::kCubic_Verb:
+                contour.cubicTo(pts[1], pts[2], pts[3]);
+                break;
+            case SkPath::kClose_Verb:
+                contour.close();
+                break;
+            default:
+                break;
+        }
+    }
+    flush();
+
+    SkPath touched;
+    if (!Op(touching, two, op, &touched)) {
+        return false;
+    }
+    if (keepUntouched) {
+        touched.addPath(untouched);
+    }
+    touched.setFillType(SkPath::kEvenOdd_FillType);
+    *result = touched;
+    return true;
+}
+
+bool SkOpBuilder::resolveInto(SkPath* result) {
+    if (all_union(fPathRefs, fOps)) {
+        // Union the added paths first, so that the result is only revisited once.
+        SkPath sum;
+        return this->resolve(&sum) && op_touching_contours(*result, sum, kUnion_SkPathOp, result);
+    }
+    SkPath original = *result;
+    for (int index = 0; index < fOps.count(); ++index) {
+        if (!op_touching_contours(*result, fPathRefs[index], fOps[index], result)) {
+            reset();
+            *result = original;
+            return false;
+        }
+    }
+    reset();
+    return true;
+}
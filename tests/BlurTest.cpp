@@ -15,6 +15,7 @@
 #include "SkMath.h"
 #include "SkPaint.h"
 #include "SkPath.h"
+#include "SkRandom.h"
 #include "Test.h"
 
 #if SK_SUPPORT_GPU
@@ -693,3 +694,101 @@ DEF_TEST(BlurredRRectNinePatchComputation, reporter) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
+
+// Large masks are blurred down their columns rather than across transposed rows.  Blurring a mask
+// padded out with zeros should give exactly the same pixels as blurring the unpadded mask.
+DEF_TEST(BlurMask_LargeMatchesSmall, reporter) {
+    const int kSmallW = 100, kSmallH = 90,
+              kLargeW = 400, kLargeH = 300,
+              kOffsetX = 150, kOffsetY = 100;
+
+    SkRandom rand;
+    SkAutoTMalloc<uint8_t> smallPixels(kSmallW * kSmallH);
+    SkAutoTMalloc<uint8_t> largePixels(kLargeW * kLargeH);
+    sk_bzero(largePixels.get(), kLargeW * kLargeH);
+    for (int y = 0; y < kSmallH; ++y) {
+        for (int x = 0; x < kSmallW; ++x) {
+            uint8_t v = rand.nextU() & 0xFF;
+            smallPixels[y * kSmallW + x] = v;
+            largePixels[(y + kOffsetY) * kLargeW + x + kOffsetX] = v;
+        }
+    }
+
+    SkMask small, large;
+    small.fImage    = smallPixels.get();
+    small.fBounds   = SkIRect::MakeXYWH(kOffsetX, kOffsetY, kSmallW, kSmallH);
+    small.fRowBytes = kSmallW;
+    small.fFormat   = SkMask::kA8_Format;
+    large.fImage    = largePixels.get();
+    large.fBounds   = SkIRect::MakeWH(kLargeW, kLargeH);
+    large.fRowBytes = kLargeW;
+    large.fFormat   = SkMask::kA8_Format;
+
+    // Whole and fractional box radii, for both qualities.
+    const SkScalar sigmas[] = { 3, 4 + 1/6.0f, 5.3f };
+    const SkBlurQuality qualities[] = { kLow_SkBlurQuality, kHigh_SkBlurQuality };
+    for (SkScalar sigma : sigmas) {
+        for (SkBlurQuality quality : qualities) {
+            SkMask smallBlur, largeBlur;
+            REPORTER_ASSERT(reporter, SkBlurMask::BoxBlur(&smallBlur, small, sigma,
+                                                          kNormal_SkBlurStyle, quality));
+            REPORTER_ASSERT(reporter, SkBlurMask::BoxBlur(&largeBlur, large, sigma,
+                                                          kNormal_SkBlurStyle, quality));
+            SkAutoMaskFreeImage freeSmall(smallBlur.fImage),
+                                freeLarge(largeBlur.fImage);
+            REPORTER_ASSERT(reporter, largeBlur.fBounds.contains(smallBlur.fBounds));
+
+            int mismatches = 0;
+            for (int y = largeBlur.fBounds.fTop; y < largeBlur.fBounds.fBottom; ++y) {
+                for (int x = largeBlur.fBounds.fLeft; x < largeBlur.fBounds.fRight; ++x) {
+                    uint8_t expected = smallBlur.fBounds.contains(x, y)
+                                     ? *smallBlur.getAddr8(x, y) : 0;
+                    mismatches += *largeBlur.getAddr8(x, y) != expected;
+                }
+            }
+            REPORTER_ASSERT(reporter, 0 == mismatches);
+        }
+    }
+}
+
+// Downsampled blurs keep the same bounds, and stay close to the full resolution blur.
+DEF_TEST(BlurMask_Downsample, reporter) {
+    const int kW = 300, kH = 200;
+    SkAutoTMalloc<uint8_t> pixels(kW * kH);
+    for (int y = 0; y < kH; ++y) {
+        for (int x = 0; x < kW; ++x) {
+            pixels[y * kW + x] = ((x / 37 + y / 23) & 1) ? 0xFF : 0x00;
+        }
+    }
+    SkMask src;
+    src.fImage    = pixels.get();
+    src.fBounds   = SkIRect::MakeXYWH(-20, 30, kW, kH);
+    src.fRowBytes = kW;
+    src.fFormat   = SkMask::kA8_Format;
+
+    const SkScalar sigmas[] = { 40, 64, 100 };
+    const SkBlurQuality qualities[] = { kLow_SkBlurQuality, kHigh_SkBlurQuality };
+    for (SkScalar sigma : sigmas) {
+        for (SkBlurQuality quality : qualities) {
+            SkMask full, down;
+            SkIPoint fullMargin, downMargin;
+            REPORTER_ASSERT(reporter, SkBlurMask::BoxBlur(&full, src, sigma, kNormal_SkBlurStyle,
+                                                          quality, &fullMargin));
+            REPORTER_ASSERT(reporter, SkBlurMask::BoxBlur(&down, src, sigma, kNormal_SkBlurStyle,
+                                                          quality, &downMargin, false, true));
+            SkAutoMaskFreeImage freeFull(full.fImage),
+                                freeDown(down.fImage);
+            REPORTER_ASSERT(reporter, full.fBounds == down.fBounds);
+            REPORTER_ASSERT(reporter, fullMargin == downMargin);
+
+            int maxDiff = 0;
+            for (int y = full.fBounds.fTop; y < full.fBounds.fBottom; ++y) {
+                for (int x = full.fBounds.fLeft; x < full.fBounds.fRight; ++x) {
+                    maxDiff = SkTMax(maxDiff, SkAbs32(*full.getAddr8(x, y) -
+                                                      *down.getAddr8(x, y)));
+                }
+            }
+            REPORTER_ASSERT(reporter, maxDiff <= 4);
+        }
+    }
+}
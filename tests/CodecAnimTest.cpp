@@ -182,3 +182,73 @@ DEF_TEST(Codec_frames, r) {
         }
     }
 }
+
+// Decoding frames in any order with a frame cache should match decoding each one from scratch.
+DEF_TEST(Codec_frameCache, r) {
+    for (const char* name : { "randPixelsAnim.gif", "test640x479.gif", "colorTables.gif" }) {
+        sk_sp<SkData> data(GetResourceAsData(name));
+        if (!data) {
+            continue;
+        }
+
+        std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(data));
+        if (!codec) {
+            ERRORF(r, "Failed to create an SkCodec from '%s'", name);
+            continue;
+        }
+
+        const auto info = codec->getInfo().makeColorType(kN32_SkColorType);
+        const size_t frameCount = codec->getFrameInfo().size();
+        std::vector<SkBitmap> expected(frameCount);
+        for (size_t i = 0; i < frameCount; i++) {
+            expected[i].allocPixels(info);
+            SkCodec::Options opts;
+            opts.fFrameIndex = i;
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info,
+                    expected[i].getPixels(), expected[i].rowBytes(), &opts, nullptr, nullptr));
+        }
+
+        const size_t frameBytes = info.getSafeSize(info.minRowBytes());
+        for (int interval : { 1, 2, 3 }) {
+            for (size_t budget : { frameBytes, 4 * frameBytes, 100 * frameBytes }) {
+                for (bool discardable : { false, true }) {
+                    SkCodec::FrameCacheOptions cacheOptions;
+                    cacheOptions.fBudget = budget;
+                    cacheOptions.fKeyframeInterval = interval;
+                    cacheOptions.fUseDiscardableMemory = discardable;
+                    codec->setFrameCacheOptions(cacheOptions);
+
+                    // Backwards, then forwards, then each frame twice in a scrambled order.
+                    std::vector<size_t> order;
+                    for (size_t i = frameCount; i > 0; i--) {
+                        order.push_back(i - 1);
+                    }
+                    for (size_t i = 0; i < frameCount; i++) {
+                        order.push_back(i);
+                    }
+                    for (size_t i = 0; i < 2 * frameCount; i++) {
+                        order.push_back((i * 7) % frameCount);
+                    }
+
+                    SkBitmap bm;
+                    bm.allocPixels(info);
+                    for (size_t index : order) {
+                        SkCodec::Options opts;
+                        opts.fFrameIndex = index;
+                        const auto result = codec->getPixels(info, bm.getPixels(), bm.rowBytes(),
+                                                             &opts, nullptr, nullptr);
+                        REPORTER_ASSERT(r, SkCodec::kSuccess == result);
+                        if (memcmp(bm.getPixels(), expected[index].getPixels(),
+                                   bm.getSafeSize())) {
+                            ERRORF(r, "%s frame %i differs with a frame cache (interval %i, "
+                                   "budget %i frames, discardable %i)", name, SkToInt(index),
+                                   interval, SkToInt(budget / frameBytes), discardable);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        codec->setFrameCacheOptions(SkCodec::FrameCacheOptions());
+    }
+}
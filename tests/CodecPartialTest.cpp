@@ -135,6 +135,69 @@ DEF_TEST(Codec_partial, r) {
     test_partial(r, "box.gif");
     test_partial(r, "randPixels.gif", 215);
     test_partial(r, "color_wheel.gif");
+    test_partial(r, "mandrill_512_q075.jpg");
+    test_partial(r, "CMYK.jpg");
+    test_partial(r, "brickwork-texture.jpg");
+    test_partial(r, "yellow_rose.webp");
+    test_partial(r, "baby_tux.webp");
+}
+
+// Test that a progressive jpeg shows the whole image, at a lower fidelity, before all of
+// the data has arrived, and that the preview improves as more scans arrive.
+DEF_TEST(Codec_jpeg_progressivePreview, r) {
+    const char* name = "brickwork-texture.jpg";
+    sk_sp<SkData> file = GetResourceAsData(name);
+    if (!file) {
+        return;
+    }
+
+    SkBitmap truth;
+    if (!create_truth(file, &truth)) {
+        ERRORF(r, "Failed to decode %s\n", name);
+        return;
+    }
+
+    HaltingStream* stream = new HaltingStream(file, file->size() / 8);
+    std::unique_ptr<SkCodec> partialCodec(SkCodec::NewFromStream(stream));
+    if (!partialCodec) {
+        ERRORF(r, "Failed to create codec for %s", name);
+        return;
+    }
+
+    const SkImageInfo info = standardize_info(partialCodec.get());
+    SkBitmap incremental;
+    incremental.allocPixels(info);
+    incremental.eraseColor(SK_ColorTRANSPARENT);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == partialCodec->startIncrementalDecode(info,
+            incremental.getPixels(), incremental.rowBytes()));
+
+    const size_t rowBytes = info.minRowBytes();
+    int previews = 0;
+    while (true) {
+        int rowsDecoded;
+        const SkCodec::Result result = partialCodec->incrementalDecode(&rowsDecoded);
+        if (result == SkCodec::kSuccess) {
+            break;
+        }
+        REPORTER_ASSERT(r, result == SkCodec::kIncompleteInput);
+        REPORTER_ASSERT(r, rowsDecoded == 0 || rowsDecoded == info.height());
+        if (rowsDecoded == info.height()) {
+            previews++;
+        }
+
+        if (stream->isAllDataReceived()) {
+            ERRORF(r, "Failed to completely decode %s", name);
+            return;
+        }
+        stream->addNewData(file->size() / 8);
+    }
+
+    // The first eighth of the data holds at least one scan, and we should have output the
+    // image again most times the data grew.
+    REPORTER_ASSERT(r, previews >= 4);
+    for (int y = 0; y < info.height(); y++) {
+        REPORTER_ASSERT(r, !memcmp(truth.getAddr(0, y), incremental.getAddr(0, y), rowBytes));
+    }
 }
 
 // Verify that when decoding an animated gif byte by byte we report the correct
@@ -332,6 +395,7 @@ DEF_TEST(Codec_rewind, r) {
     test_interleaved(r, "plane.png");
     test_interleaved(r, "plane_interlaced.png");
     test_interleaved(r, "box.gif");
+    test_interleaved(r, "mandrill_512_q075.jpg");
 }
 
 // Modified version of the giflib logo, from
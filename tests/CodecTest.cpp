@@ -10,20 +10,26 @@
 #include "SkAndroidCodec.h"
 #include "SkAutoMalloc.h"
 #include "SkBitmap.h"
+#include "SkBitmapRegionDecoder.h"
+#include "SkBitmapScaler.h"
 #include "SkCodec.h"
 #include "SkCodecImageGenerator.h"
 #include "SkColorSpace_XYZ.h"
 #include "SkColorSpacePriv.h"
 #include "SkData.h"
+#include "SkExecutor.h"
 #include "SkFrontBufferedStream.h"
 #include "SkImageEncoder.h"
 #include "SkImageEncoderPriv.h"
 #include "SkMD5.h"
 #include "SkOSPath.h"
 #include "SkPngChunkReader.h"
+#include "SkPngEncoder.h"
+#include "SkPngRowIndex.h"
 #include "SkRandom.h"
 #include "SkStream.h"
 #include "SkStreamPriv.h"
+#include "SkWebpEncoder.h"
 #include "Test.h"
 
 #include "png.h"
@@ -497,10 +503,10 @@ DEF_TEST(Codec_jpg, r) {
     check(r, "CMYK.jpg", SkISize::Make(642, 516), true, false, true);
     check(r, "color_wheel.jpg", SkISize::Make(128, 128), true, false, true);
     // grayscale.jpg is too small to test incomplete
-    check(r, "grayscale.jpg", SkISize::Make(128, 128), true, false, false);
+    check(r, "grayscale.jpg", SkISize::Make(128, 128), true, false, false, true);
     check(r, "mandrill_512_q075.jpg", SkISize::Make(512, 512), true, false, true);
     // randPixels.jpg is too small to test incomplete
-    check(r, "randPixels.jpg", SkISize::Make(8, 8), true, false, false);
+    check(r, "randPixels.jpg", SkISize::Make(8, 8), true, false, false, true);
 }
 
 DEF_TEST(Codec_png, r) {
@@ -1049,6 +1055,61 @@ DEF_TEST(Codec_jpeg_rewind, r) {
     REPORTER_ASSERT(r, SkCodec::kIncompleteInput == result);
 }
 
+static void check_jpeg_threaded(skiatest::Reporter* r, SkExecutor* executor, sk_sp<SkData> data,
+                                const SkImageInfo& info) {
+    std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(data));
+    if (!codec) {
+        ERRORF(r, "Unable to create codec.");
+        return;
+    }
+
+    const size_t rowBytes = info.minRowBytes();
+    SkAutoMalloc serial(info.getSafeSize(rowBytes)),
+                 threaded(info.getSafeSize(rowBytes));
+    const SkCodec::Result expected = codec->getPixels(info, serial.get(), rowBytes);
+
+    SkCodec::Options options;
+    options.fExecutor = executor;
+    const SkCodec::Result result = codec->getPixels(info, threaded.get(), rowBytes, &options,
+                                                    nullptr, nullptr);
+    REPORTER_ASSERT(r, expected == result);
+    if (SkCodec::kSuccess == result) {
+        REPORTER_ASSERT(r, !memcmp(serial.get(), threaded.get(), info.getSafeSize(rowBytes)));
+    }
+}
+
+DEF_TEST(Codec_jpeg_threaded, r) {
+    // This image has a restart marker at the end of every row of MCUs.
+    const char* path = "icc-v2-gbr.jpg";
+    sk_sp<SkData> data(GetResourceAsData(path));
+    if (!data) {
+        return;
+    }
+    std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(data));
+    if (!codec) {
+        ERRORF(r, "Unable to create codec '%s'.", path);
+        return;
+    }
+
+    auto executor = SkExecutor::MakeThreadPool(4);
+    for (float scale : { 1.0f, 0.75f, 0.5f, 0.125f }) {
+        SkImageInfo info = codec->getInfo().makeWH(codec->getScaledDimensions(scale).width(),
+                                                   codec->getScaledDimensions(scale).height());
+        check_jpeg_threaded(r, executor.get(), data, info);
+        check_jpeg_threaded(r, executor.get(), data, info.makeColorSpace(nullptr));
+        check_jpeg_threaded(r, executor.get(), data,
+                            info.makeColorType(kRGB_565_SkColorType).makeColorSpace(nullptr));
+        check_jpeg_threaded(r, executor.get(), data,
+                            info.makeColorType(kRGBA_F16_SkColorType)
+                                .makeColorSpace(SkColorSpace::MakeSRGBLinear()));
+    }
+
+    // Without the end of the scan there's nothing to split, so this decodes serially.  (The
+    // headers take up the first 33K of this file.)
+    check_jpeg_threaded(r, executor.get(), SkData::MakeSubset(data.get(), 0, data->size() - 4096),
+                        codec->getInfo());
+}
+
 static void check_color_xform(skiatest::Reporter* r, const char* path) {
     std::unique_ptr<SkAndroidCodec> codec(SkAndroidCodec::NewFromStream(GetResourceAsStream(path)));
 
@@ -1239,8 +1300,8 @@ static void test_conversion_possible(skiatest::Reporter* r, const char* path,
 }
 
 DEF_TEST(Codec_F16ConversionPossible, r) {
-    test_conversion_possible(r, "color_wheel.webp", false, false);
-    test_conversion_possible(r, "mandrill_512_q075.jpg", true, false);
+    test_conversion_possible(r, "color_wheel.webp", false, true);
+    test_conversion_possible(r, "mandrill_512_q075.jpg", true, true);
     test_conversion_possible(r, "yellow_rose.png", false, true);
 }
 
@@ -1356,7 +1417,6 @@ DEF_TEST(Codec_fallBack, r) {
 
     // Formats that currently do not support incremental decoding
     auto files = {
-            "CMYK.jpg",
             "color_wheel.ico",
             "mandrill.wbmp",
             "randPixels.bmp",
@@ -1593,6 +1653,290 @@ DEF_TEST(Codec_EncodeICC, r) {
     test_encode_icc(r, SkEncodedImageFormat::kWEBP, SkTransferFunctionBehavior::kIgnore);
 }
 
+static void check_png_encoder_options(skiatest::Reporter* r, const SkBitmap& bitmap,
+                                      const SkPngEncoder::Options& options) {
+    SkPixmap pixmap;
+    SkAssertResult(bitmap.peekPixels(&pixmap));
+    SkDynamicMemoryWStream buf;
+    if (!SkPngEncoder::Encode(&buf, pixmap, options)) {
+        ERRORF(r, "Failed to encode with filters %x, zlib level %d, executor %p",
+               options.fFilterFlags, options.fZLibLevel, options.fExecutor);
+        return;
+    }
+
+    std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(buf.detachAsData()));
+    if (!codec) {
+        ERRORF(r, "Failed to create a codec for the encoded png");
+        return;
+    }
+
+    // Lossless webp is always reported as unpremul, even when every pixel is opaque.
+    SkBitmap decoded;
+    decoded.allocPixels(bitmap.info().makeAlphaType(codec->getInfo().alphaType()));
+    SkCodec::Result result = codec->getPixels(decoded.info(), decoded.getPixels(),
+                                              decoded.rowBytes());
+    REPORTER_ASSERT(r, SkCodec::kSuccess == result);
+    for (int y = 0; y < bitmap.height(); y++) {
+        if (memcmp(bitmap.getAddr(0, y), decoded.getAddr(0, y), bitmap.width() * 4)) {
+            ERRORF(r, "Row %d differs with filters %x, zlib level %d, executor %p", y,
+                   options.fFilterFlags, options.fZLibLevel, options.fExecutor);
+            return;
+        }
+    }
+}
+
+DEF_TEST(Codec_PngEncoderOptions, r) {
+    // Tall enough to be split into several bands when encoding with an executor.
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeN32(640, 480, kUnpremul_SkAlphaType));
+    SkRandom random;
+    for (int y = 0; y < bitmap.height(); y++) {
+        for (int x = 0; x < bitmap.width(); x++) {
+            *bitmap.getAddr32(x, y) = SkPackARGB32NoCheck(255 - y / 2, (x + y) & 0xFF, x & 0xFF,
+                                                         random.nextULessThan(4));
+        }
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeThreadPool(4);
+    const int filterFlags[] = {
+        SkPngEncoder::kAll_FilterFlag,
+        SkPngEncoder::kNone_FilterFlag,
+        SkPngEncoder::kSub_FilterFlag,
+        SkPngEncoder::kUp_FilterFlag,
+        SkPngEncoder::kAvg_FilterFlag,
+        SkPngEncoder::kPaeth_FilterFlag,
+        SkPngEncoder::kSub_FilterFlag | SkPngEncoder::kUp_FilterFlag,
+    };
+    for (int flags : filterFlags) {
+        for (int level : { 0, 1, 6, 9 }) {
+            for (SkExecutor* e : { (SkExecutor*) nullptr, executor.get() }) {
+                SkPngEncoder::Options options;
+                options.fFilterFlags = flags;
+                options.fZLibLevel = level;
+                options.fExecutor = e;
+                check_png_encoder_options(r, bitmap, options);
+            }
+        }
+    }
+
+    SkPixmap pixmap;
+    SkAssertResult(bitmap.peekPixels(&pixmap));
+    SkNullWStream stream;
+    SkPngEncoder::Options options;
+    options.fZLibLevel = 10;
+    REPORTER_ASSERT(r, !SkPngEncoder::Encode(&stream, pixmap, options));
+    options.fZLibLevel = 6;
+    options.fFilterFlags = 0x1;
+    REPORTER_ASSERT(r, !SkPngEncoder::Encode(&stream, pixmap, options));
+}
+
+static void check_webp_encoder_options(skiatest::Reporter* r, const SkBitmap& bitmap,
+                                       const SkWebpEncoder::Options& options) {
+    SkPixmap pixmap;
+    SkAssertResult(bitmap.peekPixels(&pixmap));
+    SkDynamicMemoryWStream buf;
+    if (!SkWebpEncoder::Encode(&buf, pixmap, options)) {
+        ERRORF(r, "Failed to encode with quality %g, method %d, threads %d",
+               options.fQuality, options.fMethod, options.fUseThreads);
+        return;
+    }
+
+    std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(buf.detachAsData()));
+    if (!codec) {
+        ERRORF(r, "Failed to create a codec for the encoded webp");
+        return;
+    }
+
+    // Lossless webp is always reported as unpremul, even when every pixel is opaque.
+    SkBitmap decoded;
+    decoded.allocPixels(bitmap.info().makeAlphaType(codec->getInfo().alphaType()));
+    SkCodec::Result result = codec->getPixels(decoded.info(), decoded.getPixels(),
+                                              decoded.rowBytes());
+    REPORTER_ASSERT(r, SkCodec::kSuccess == result);
+    if (SkWebpEncoder::Compression::kLossy == options.fCompression) {
+        return;
+    }
+
+    for (int y = 0; y < bitmap.height(); y++) {
+        if (memcmp(bitmap.getAddr(0, y), decoded.getAddr(0, y), bitmap.width() * 4)) {
+            ERRORF(r, "Lossless row %d differs with quality %g, method %d, threads %d", y,
+                   options.fQuality, options.fMethod, options.fUseThreads);
+            return;
+        }
+    }
+}
+
+DEF_TEST(Codec_WebpEncoderOptions, r) {
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeN32(160, 120, kOpaque_SkAlphaType));
+    SkRandom random;
+    for (int y = 0; y < bitmap.height(); y++) {
+        for (int x = 0; x < bitmap.width(); x++) {
+            *bitmap.getAddr32(x, y) = SkPackARGB32NoCheck(0xFF, (x + y) & 0xFF, x & 0xFF,
+                                                         random.nextULessThan(4));
+        }
+    }
+
+    for (auto compression : { SkWebpEncoder::Compression::kLossy,
+                              SkWebpEncoder::Compression::kLossless }) {
+        for (int method : { 0, 4, 6 }) {
+            for (bool useThreads : { false, true }) {
+                SkWebpEncoder::Options options;
+                options.fCompression = compression;
+                options.fQuality = 75;
+                options.fMethod = method;
+                options.fUseThreads = useThreads;
+                check_webp_encoder_options(r, bitmap, options);
+            }
+        }
+    }
+
+    SkPixmap pixmap;
+    SkAssertResult(bitmap.peekPixels(&pixmap));
+    SkNullWStream stream;
+    SkWebpEncoder::Options options;
+    options.fMethod = 7;
+    REPORTER_ASSERT(r, !SkWebpEncoder::Encode(&stream, pixmap, options));
+    options.fMethod = 4;
+    options.fQuality = 101;
+    REPORTER_ASSERT(r, !SkWebpEncoder::Encode(&stream, pixmap, options));
+}
+
+// Threaded and incremental webp decodes should match a plain getPixels().
+DEF_TEST(Codec_webp_useThreads, r) {
+    for (const char* path : { "yellow_rose.webp", "baby_tux.webp" }) {
+        sk_sp<SkData> data(GetResourceAsData(path));
+        if (!data) {
+            return;
+        }
+
+        std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(data));
+        if (!codec) {
+            ERRORF(r, "Failed to create a codec for %s", path);
+            continue;
+        }
+
+        const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+        SkBitmap truth;
+        truth.allocPixels(info);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, truth.getPixels(),
+                                                                 truth.rowBytes()));
+        SkMD5::Digest truthDigest;
+        md5(truth, &truthDigest);
+
+        SkCodec::Options options;
+        options.fUseThreads = true;
+        SkBitmap bm;
+        bm.allocPixels(info);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, bm.getPixels(),
+                bm.rowBytes(), &options, nullptr, nullptr));
+        compare_to_good_digest(r, truthDigest, bm);
+
+        bm.eraseColor(SK_ColorYELLOW);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->startIncrementalDecode(info,
+                bm.getPixels(), bm.rowBytes(), &options));
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->incrementalDecode());
+        compare_to_good_digest(r, truthDigest, bm);
+    }
+}
+
+static void decode_png_subset(skiatest::Reporter* r, SkCodec* codec, const SkIRect& subset,
+                              SkBitmap* bm) {
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    bm->allocPixels(info.makeWH(subset.width(), subset.height()));
+    SkCodec::Options options;
+    options.fSubset = &subset;
+    SkCodec::Result result = codec->startIncrementalDecode(info, bm->getPixels(), bm->rowBytes(),
+                                                           &options);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == result);
+    if (SkCodec::kSuccess == result) {
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->incrementalDecode());
+    }
+}
+
+static void check_png_subset_index(skiatest::Reporter* r, sk_sp<SkData> data, int rowInterval) {
+    SkMemoryStream stream(data);
+    std::unique_ptr<SkPngRowIndex> index = SkPngRowIndex::Make(&stream, rowInterval);
+    REPORTER_ASSERT(r, index && index->count() > 0);
+    REPORTER_ASSERT(r, 0 == stream.getPosition());
+
+    std::unique_ptr<SkCodec> indexed(SkCodec::NewFromData(data));
+    std::unique_ptr<SkCodec> plain(SkCodec::NewFromData(data));
+    REPORTER_ASSERT(r, indexed->buildSubsetIndex(rowInterval));
+
+    const int width = plain->getInfo().width();
+    const int height = plain->getInfo().height();
+    const SkIRect subsets[] = {
+        SkIRect::MakeWH(width, 1),
+        SkIRect::MakeXYWH(3, rowInterval, 50, 40),
+        SkIRect::MakeXYWH(width / 2, height / 2, width / 2, 17),
+        SkIRect::MakeXYWH(0, height - 5, width, 5),
+        SkIRect::MakeXYWH(7, 2 * rowInterval + 1, 20, 20),
+    };
+    for (const SkIRect& subset : subsets) {
+        SkBitmap expected, actual;
+        decode_png_subset(r, plain.get(), subset, &expected);
+        decode_png_subset(r, indexed.get(), subset, &actual);
+        SkMD5::Digest digest;
+        md5(expected, &digest);
+        compare_to_good_digest(r, digest, actual);
+    }
+
+    // Sampled subsets go through the same path.
+    std::unique_ptr<SkBitmapRegionDecoder> indexedBRD(SkBitmapRegionDecoder::Create(data,
+            SkBitmapRegionDecoder::kAndroidCodec_Strategy));
+    std::unique_ptr<SkBitmapRegionDecoder> plainBRD(SkBitmapRegionDecoder::Create(data,
+            SkBitmapRegionDecoder::kAndroidCodec_Strategy));
+    REPORTER_ASSERT(r, indexedBRD->buildRegionIndex(rowInterval));
+    const SkIRect region = SkIRect::MakeXYWH(5, height * 2 / 3, 60, 45);
+    for (int sampleSize : { 1, 2, 3 }) {
+        SkBitmap expected, actual;
+        REPORTER_ASSERT(r, plainBRD->decodeRegion(&expected, nullptr, region, sampleSize,
+                                                  kN32_SkColorType, false));
+        REPORTER_ASSERT(r, indexedBRD->decodeRegion(&actual, nullptr, region, sampleSize,
+                                                    kN32_SkColorType, false));
+        SkMD5::Digest digest;
+        md5(expected, &digest);
+        compare_to_good_digest(r, digest, actual);
+    }
+}
+
+DEF_TEST(Codec_pngSubsetIndex, r) {
+    // Noisy enough to be compressed into many deflate blocks, with every filter type in use.
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeN32(300, 700, kUnpremul_SkAlphaType));
+    SkRandom random;
+    for (int y = 0; y < bitmap.height(); y++) {
+        for (int x = 0; x < bitmap.width(); x++) {
+            *bitmap.getAddr32(x, y) = SkPackARGB32NoCheck(255 - y / 3, (x + y) & 0xFF, x & 0xFF,
+                                                         random.nextULessThan(16));
+        }
+    }
+
+    for (SkAlphaType alphaType : { kUnpremul_SkAlphaType, kOpaque_SkAlphaType }) {
+        SkPixmap pixmap;
+        SkAssertResult(bitmap.peekPixels(&pixmap));
+        pixmap.reset(pixmap.info().makeAlphaType(alphaType), pixmap.addr(), pixmap.rowBytes());
+        SkDynamicMemoryWStream buf;
+        SkAssertResult(SkPngEncoder::Encode(&buf, pixmap, SkPngEncoder::Options()));
+        check_png_subset_index(r, buf.detachAsData(), 16);
+    }
+
+    // Interlaced images, streams that cannot seek and other formats are not indexed.
+    sk_sp<SkData> interlaced = GetResourceAsData("plane_interlaced.png");
+    sk_sp<SkData> png = GetResourceAsData("plane.png");
+    sk_sp<SkData> jpeg = GetResourceAsData("mandrill_512_q075.jpg");
+    if (!interlaced || !png || !jpeg) {
+        return;
+    }
+    std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(interlaced));
+    REPORTER_ASSERT(r, codec && !codec->buildSubsetIndex(16));
+    codec.reset(SkCodec::NewFromStream(new NotAssetMemStream(png)));
+    REPORTER_ASSERT(r, codec && !codec->buildSubsetIndex(16));
+    codec.reset(SkCodec::NewFromData(jpeg));
+    REPORTER_ASSERT(r, codec && !codec->buildSubsetIndex(16));
+}
+
 DEF_TEST(Codec_webp_rowsDecoded, r) {
     const char* path = "baby_tux.webp";
     sk_sp<SkData> data(GetResourceAsData(path));
@@ -1613,3 +1957,171 @@ DEF_TEST(Codec_webp_rowsDecoded, r) {
 
     test_info(r, codec.get(), codec->getInfo(), SkCodec::kInvalidInput, nullptr);
 }
+
+// An SkMemoryStream that counts the bytes copied out of it.
+class CountingMemoryStream : public SkMemoryStream {
+public:
+    CountingMemoryStream(sk_sp<SkData> data)
+        : INHERITED(std::move(data))
+        , fBytesCopied(0)
+    {}
+
+    size_t read(void* buffer, size_t size) override {
+        const size_t bytes = INHERITED::read(buffer, size);
+        // A null buffer means skip.
+        if (buffer) {
+            fBytesCopied += bytes;
+        }
+        return bytes;
+    }
+
+    size_t bytesCopied() const { return fBytesCopied; }
+
+private:
+    size_t fBytesCopied;
+
+    typedef SkMemoryStream INHERITED;
+};
+
+// Decoding from a stream in memory should read the encoded data in place, rather than copy it.
+DEF_TEST(Codec_readsMemoryInPlace, r) {
+    for (const char* path : { "mandrill_512_q075.jpg", "brickwork-texture.jpg", "mandrill_512.png",
+                              "plane_interlaced.png", "test640x479.gif", "color_wheel.gif" }) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+
+        CountingMemoryStream* stream = new CountingMemoryStream(data);
+        std::unique_ptr<SkCodec> codec(SkCodec::NewFromStream(stream));
+        if (!codec) {
+            ERRORF(r, "Failed to create codec for %s", path);
+            continue;
+        }
+
+        const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+        SkBitmap bm;
+        bm.allocPixels(info);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, bm.getPixels(),
+                                                                 bm.rowBytes()));
+
+        // Only small headers, such as the lengths and types of PNG chunks, may be copied.
+        if (stream->bytesCopied() > 128) {
+            ERRORF(r, "Copied %lu of %lu bytes of %s", stream->bytesCopied(), data->size(), path);
+        }
+    }
+}
+
+// Decoding the sampled image, then resizing it, gives the same result as streaming the rows
+// through the resize filters.
+static void check_resized(skiatest::Reporter* r, const char* path, sk_sp<SkData> data,
+                          const SkPixmap& resized) {
+    std::unique_ptr<SkAndroidCodec> codec(SkAndroidCodec::NewFromData(data));
+    const SkISize size = codec->getInfo().dimensions();
+    int sampleSize = SkTMax(1, SkTMin(size.width() / resized.width(),
+                                      size.height() / resized.height()));
+    SkISize sampledSize = codec->getSampledDimensions(sampleSize);
+    while (sampleSize > 1 &&
+            (sampledSize.width() < resized.width() || sampledSize.height() < resized.height())) {
+        sampledSize = codec->getSampledDimensions(--sampleSize);
+    }
+
+    SkBitmap sampled;
+    sampled.allocPixels(resized.info().makeWH(sampledSize.width(), sampledSize.height()));
+    SkAndroidCodec::AndroidOptions options;
+    options.fSampleSize = sampleSize;
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getAndroidPixels(sampled.info(),
+            sampled.getPixels(), sampled.rowBytes(), &options));
+
+    SkBitmap expected;
+    expected.allocPixels(resized.info());
+    SkPixmap src, dst;
+    REPORTER_ASSERT(r, sampled.peekPixels(&src) && expected.peekPixels(&dst));
+    REPORTER_ASSERT(r, SkBitmapScaler::Resize(dst, src, SkBitmapScaler::RESIZE_MITCHELL));
+
+    for (int y = 0; y < resized.height(); y++) {
+        if (0 != memcmp(resized.addr(0, y), dst.addr(0, y), resized.info().minRowBytes())) {
+            ERRORF(r, "Resized %s differs from the sampled decode at row %d", path, y);
+            return;
+        }
+    }
+}
+
+DEF_TEST(Codec_resizedPixels, r) {
+    const char* paths[] = { "mandrill_512_q075.jpg", "mandrill_512.png", "plane_interlaced.png",
+                            "color_wheel.gif", "randPixels.bmp", "yellow_rose.png" };
+    const SkISize sizes[] = { { 100, 77 }, { 37, 200 }, { 1, 1 } };
+
+    SkAutoTArray<SkAndroidCodec::ResizeRequest> requests(SK_ARRAY_COUNT(paths) *
+                                                         SK_ARRAY_COUNT(sizes));
+    SkAutoTArray<SkBitmap> bitmaps(SK_ARRAY_COUNT(paths) * SK_ARRAY_COUNT(sizes));
+    SkAutoTArray<SkBitmap> batchBitmaps(SK_ARRAY_COUNT(paths) * SK_ARRAY_COUNT(sizes));
+    int count = 0;
+    for (const char* path : paths) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        std::unique_ptr<SkAndroidCodec> codec(SkAndroidCodec::NewFromData(data));
+        if (!codec) {
+            ERRORF(r, "Failed to create codec for %s", path);
+            continue;
+        }
+        const SkAlphaType alphaType = codec->computeOutputAlphaType(false);
+
+        for (SkISize size : sizes) {
+            const SkImageInfo info = SkImageInfo::MakeN32(size.width(), size.height(),
+                                                          alphaType);
+            SkBitmap& bm = bitmaps[count];
+            bm.allocPixels(info);
+            SkPixmap pixmap;
+            bm.peekPixels(&pixmap);
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getResizedPixels(pixmap));
+            check_resized(r, path, data, pixmap);
+
+            // Queue the same decode for the batch, below.
+            SkAndroidCodec::ResizeRequest& request = requests[count];
+            request.fEncoded = data;
+            batchBitmaps[count].allocPixels(info);
+            batchBitmaps[count].peekPixels(&request.fDst);
+            count++;
+        }
+
+        // Truncated data is filled before resizing.
+        sk_sp<SkData> partial = SkData::MakeSubset(data.get(), 0, data->size() / 2);
+        std::unique_ptr<SkAndroidCodec> partialCodec(SkAndroidCodec::NewFromData(partial));
+        if (partialCodec) {
+            SkBitmap bm;
+            bm.allocPixels(SkImageInfo::MakeN32(64, 48, alphaType));
+            SkPixmap pixmap;
+            bm.peekPixels(&pixmap);
+            REPORTER_ASSERT(r, SkCodec::kIncompleteInput ==
+                               partialCodec->getResizedPixels(pixmap));
+        }
+
+        // The resize filters only support N32.
+        SkBitmap bm;
+        bm.allocPixels(SkImageInfo::Make(64, 48, kRGB_565_SkColorType, kOpaque_SkAlphaType));
+        SkPixmap pixmap;
+        bm.peekPixels(&pixmap);
+        REPORTER_ASSERT(r, SkCodec::kInvalidConversion == codec->getResizedPixels(pixmap));
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeThreadPool(4);
+    SkAndroidCodec::DecodeResized(requests.get(), count, executor.get());
+    for (int i = 0; i < count; i++) {
+        const SkPixmap& dst = requests[i].fDst;
+        REPORTER_ASSERT(r, SkCodec::kSuccess == requests[i].fResult);
+        for (int y = 0; y < dst.height(); y++) {
+            if (0 != memcmp(dst.addr(0, y), bitmaps[i].getAddr(0, y), dst.info().minRowBytes())) {
+                ERRORF(r, "Batch decode %d differs at row %d", i, y);
+                break;
+            }
+        }
+    }
+
+    SkAndroidCodec::ResizeRequest invalid;
+    invalid.fEncoded = SkData::MakeWithCString("not an image");
+    SkAndroidCodec::DecodeResized(&invalid, 1);
+    REPORTER_ASSERT(r, SkCodec::kInvalidInput == invalid.fResult);
+}
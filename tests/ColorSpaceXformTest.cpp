@@ -14,6 +14,7 @@
 #include "SkColorSpace_Base.h"
 #include "SkColorSpace_XYZ.h"
 #include "SkColorSpaceXform_Base.h"
+#include "SkHalf.h"
 #include "Test.h"
 
 static constexpr int kChannels = 3;
@@ -337,3 +338,55 @@ DEF_TEST(SkColorSpaceXform_LoadTail, r) {
     REPORTER_ASSERT(r, success);
 }
 
+
+DEF_TEST(ColorSpaceXform_U16ToF16, r) {
+    // Between identical linear spaces, 16-bit sources are just widened to F16.
+    sk_sp<SkColorSpace> linear = SkColorSpace::MakeSRGBLinear();
+    std::unique_ptr<SkColorSpaceXform> xform = SkColorSpaceXform::New(linear.get(), linear.get());
+
+    // Big-endian channels; the last pixel is half transparent.
+    const uint8_t kSrc[] = {
+        0x00,0x00, 0x00,0x00, 0x00,0x00, 0x00,0x00,
+        0xFF,0xFF, 0xFF,0xFF, 0xFF,0xFF, 0xFF,0xFF,
+        0x80,0x80, 0x40,0x40, 0x20,0x20, 0xFF,0xFF,
+        0xFF,0xFF, 0x7F,0xFF, 0x00,0x00, 0x7F,0xFF,
+    };
+    const float kRGBA[][4] = {
+        { 0.0f,      0.0f,      0.0f,      0.0f      },
+        { 1.0f,      1.0f,      1.0f,      1.0f      },
+        { 0.50196f,  0.25098f,  0.12549f,  1.0f      },
+        { 1.0f,      0.49999f,  0.0f,      0.49999f  },
+    };
+    static const int kCount = SK_ARRAY_COUNT(kRGBA);
+
+    auto check = [&](const uint64_t dst[], bool hasAlpha, bool premul) {
+        for (int i = 0; i < kCount; i++) {
+            float a = hasAlpha ? kRGBA[i][3] : 1.0f;
+            for (int c = 0; c < 4; c++) {
+                float want = c < 3 ? kRGBA[i][c] * (premul ? a : 1.0f) : a;
+                float got  = SkHalfToFloat((dst[i] >> (16*c)) & 0xFFFF);
+                REPORTER_ASSERT(r, fabsf(got - want) <= 1/1024.0f);
+            }
+        }
+    };
+
+    uint64_t dst[kCount];
+    REPORTER_ASSERT(r, xform->apply(SkColorSpaceXform::kRGBA_F16_ColorFormat, dst,
+                                    SkColorSpaceXform::kRGBA_U16_BE_ColorFormat, kSrc, kCount,
+                                    kUnpremul_SkAlphaType));
+    check(dst, true, false);
+    REPORTER_ASSERT(r, xform->apply(SkColorSpaceXform::kRGBA_F16_ColorFormat, dst,
+                                    SkColorSpaceXform::kRGBA_U16_BE_ColorFormat, kSrc, kCount,
+                                    kPremul_SkAlphaType));
+    check(dst, true, true);
+
+    // The same pixels without alpha.
+    uint8_t rgb[kCount * 6];
+    for (int i = 0; i < kCount; i++) {
+        memcpy(rgb + 6*i, kSrc + 8*i, 6);
+    }
+    REPORTER_ASSERT(r, xform->apply(SkColorSpaceXform::kRGBA_F16_ColorFormat, dst,
+                                    SkColorSpaceXform::kRGB_U16_BE_ColorFormat, rgb, kCount,
+                                    kOpaque_SkAlphaType));
+    check(dst, false, false);
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkArenaAlloc.h"
+#include "SkBitmap.h"
+#include "SkBlitter.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkRasterClip.h"
+#include "SkScan.h"
+#include "Test.h"
+
+static void fill(SkBitmap* bm, const SkPath& path, const SkIRect& clip, bool antiAlias = true) {
+    bm->eraseColor(SK_ColorTRANSPARENT);
+    SkPixmap pixmap;
+    bm->peekPixels(&pixmap);
+    SkPaint paint;
+    SkArenaAlloc alloc(0);
+    SkBlitter* blitter = SkBlitter::Choose(pixmap, SkMatrix::I(), paint, &alloc);
+    const SkRasterClip rc(clip);
+    if (antiAlias) {
+        SkScan::DAAFillPath(path, rc, blitter);
+    } else {
+        SkScan::FillPath(path, rc, blitter);
+    }
+}
+
+// Computes the coverage of |path| by filling it 16 times larger without anti-aliasing.
+static void fill_reference(SkBitmap* bm, const SkPath& path) {
+    SkBitmap big;
+    big.allocPixels(SkImageInfo::MakeA8(bm->width() * 16, bm->height() * 16));
+    SkPath bigPath;
+    path.transform(SkMatrix::MakeScale(16, 16), &bigPath);
+    fill(&big, bigPath, SkIRect::MakeWH(big.width(), big.height()), false);
+    for (int y = 0; y < bm->height(); y++) {
+        for (int x = 0; x < bm->width(); x++) {
+            int covered = 0;
+            for (int j = 0; j < 16; j++) {
+                for (int i = 0; i < 16; i++) {
+                    covered += *big.getAddr8(16 * x + i, 16 * y + j) ? 1 : 0;
+                }
+            }
+            *bm->getAddr8(x, y) = SkTMin(covered, 255);
+        }
+    }
+}
+
+// Returns the number of pixels that differ by more than |tolerance|.
+static int count_differences(const SkBitmap& a, const SkBitmap& b, int tolerance) {
+    int count = 0;
+    for (int y = 0; y < a.height(); y++) {
+        for (int x = 0; x < a.width(); x++) {
+            if (SkTAbs(*a.getAddr8(x, y) - *b.getAddr8(x, y)) > tolerance) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+static SkPath make_star(int points, SkScalar radius, SkPath::FillType fillType) {
+    SkPath path;
+    path.setFillType(fillType);
+    for (int i = 0; i < points; i++) {
+        const SkScalar angle = 2 * SK_ScalarPI * ((2 * i) % points) / points;
+        const SkPoint p = SkPoint::Make(100 + radius * SkScalarCos(angle),
+                                        100 + radius * SkScalarSin(angle));
+        if (0 == i) {
+            path.moveTo(p);
+        } else {
+            path.lineTo(p);
+        }
+    }
+    path.close();
+    return path;
+}
+
+// Delta AA computes exact areas, up to 1/256 of a pixel vertically and the flattening of
+// curves.  Only where edges cross inside a pixel does it approximate: it fills the pixel by its
+// average winding.
+DEF_TEST(DeltaAA_coverage, r) {
+    SkBitmap expected, actual;
+    expected.allocPixels(SkImageInfo::MakeA8(200, 200));
+    actual.allocPixels(SkImageInfo::MakeA8(200, 200));
+    const SkIRect bounds = SkIRect::MakeWH(200, 200);
+
+    // Each path, and how many times its edges cross.
+    SkPath paths[5];
+    paths[0].addCircle(100, 100, 73.3f);
+    paths[1].addRoundRect(SkRect::MakeLTRB(10.2f, 20.7f, 180.5f, 150.1f), 30, 20);
+    paths[2] = make_star(5, 90, SkPath::kWinding_FillType);
+    paths[3] = make_star(5, 90, SkPath::kEvenOdd_FillType);
+    paths[4].moveTo(-30, 40);
+    paths[4].cubicTo(250, -50, 300, 250, 20, 180);
+    paths[4].quadTo(-100, 100, 50, 30);
+    paths[4].conicTo(220, 5, 190, 230, 0.5f);
+    const int crossings[] = { 0, 0, 5, 5, 2 };
+
+    for (int i = 0; i < 5; i++) {
+        fill_reference(&expected, paths[i]);
+        fill(&actual, paths[i], bounds);
+        REPORTER_ASSERT(r, count_differences(expected, actual, 12) <= 2 * crossings[i]);
+    }
+}
+
+DEF_TEST(DeltaAA_exact, r) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::MakeA8(64, 64));
+
+    // Pixel aligned rects are covered exactly.
+    SkPath path;
+    path.addRect(SkRect::MakeLTRB(10, 20, 30, 40));
+    fill(&bm, path, SkIRect::MakeWH(64, 64));
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 64; x++) {
+            const bool inside = x >= 10 && x < 30 && y >= 20 && y < 40;
+            REPORTER_ASSERT(r, *bm.getAddr8(x, y) == (inside ? 0xFF : 0));
+        }
+    }
+
+    // As is half of a pixel.
+    path.reset();
+    path.addRect(SkRect::MakeLTRB(10, 20, 10.5f, 21));
+    fill(&bm, path, SkIRect::MakeWH(64, 64));
+    REPORTER_ASSERT(r, *bm.getAddr8(10, 20) == 0x80);
+    REPORTER_ASSERT(r, *bm.getAddr8(11, 20) == 0);
+
+    // Even-odd leaves the overlap of two rects empty, nonzero fills it.
+    path.reset();
+    path.addRect(SkRect::MakeLTRB(0, 0, 40, 40));
+    path.addRect(SkRect::MakeLTRB(20, 20, 60, 60));
+    fill(&bm, path, SkIRect::MakeWH(64, 64));
+    REPORTER_ASSERT(r, *bm.getAddr8(30, 30) == 0xFF);
+    path.setFillType(SkPath::kEvenOdd_FillType);
+    fill(&bm, path, SkIRect::MakeWH(64, 64));
+    REPORTER_ASSERT(r, *bm.getAddr8(30, 30) == 0);
+    REPORTER_ASSERT(r, *bm.getAddr8(10, 10) == 0xFF);
+    REPORTER_ASSERT(r, *bm.getAddr8(50, 50) == 0xFF);
+}
+
+// Clipping only limits which pixels are drawn, so the pixels inside the clip should be close
+// to what an unclipped fill draws there.  Lines are evaluated again at the clip's edges, which
+// may round them differently.
+DEF_TEST(DeltaAA_clipped, r) {
+    SkBitmap clipped, unclipped;
+    clipped.allocPixels(SkImageInfo::MakeA8(200, 200));
+    unclipped.allocPixels(SkImageInfo::MakeA8(200, 200));
+
+    const SkPath path = make_star(7, 95, SkPath::kWinding_FillType);
+    const SkIRect clip = SkIRect::MakeLTRB(37, 51, 163, 129);
+    fill(&clipped, path, clip);
+    fill(&unclipped, path, SkIRect::MakeWH(200, 200));
+    for (int y = 0; y < 200; y++) {
+        for (int x = 0; x < 200; x++) {
+            const int expected = clip.contains(x, y) ? *unclipped.getAddr8(x, y) : 0;
+            REPORTER_ASSERT(r, SkTAbs(*clipped.getAddr8(x, y) - expected) <= 2);
+        }
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkExecutor.h"
+#include "SkTaskGroup.h"
+#include "Test.h"
+
+#include <atomic>
+
+DEF_TEST(Executor_workStealing_add, r) {
+    auto pool = SkExecutor::MakeWorkStealingPool(4);
+
+    std::atomic<int> sum{0};
+    SkTaskGroup tg(*pool);
+    for (int i = 1; i <= 1000; i++) {
+        tg.add([&sum, i] { sum.fetch_add(i, std::memory_order_relaxed); });
+    }
+    tg.wait();
+    REPORTER_ASSERT(r, 500500 == sum.load());
+}
+
+DEF_TEST(Executor_workStealing_batch, r) {
+    auto pool = SkExecutor::MakeWorkStealingPool(4);
+
+    // Each index must run exactly once.
+    const int N = 10007;
+    std::unique_ptr<std::atomic<int>[]> counts(new std::atomic<int>[N]);
+    for (int i = 0; i < N; i++) {
+        counts[i].store(0);
+    }
+    SkTaskGroup tg(*pool);
+    tg.batch(N, [&](int i) { counts[i].fetch_add(1, std::memory_order_relaxed); });
+    tg.wait();
+
+    for (int i = 0; i < N; i++) {
+        if (1 != counts[i].load()) {
+            ERRORF(r, "index %d ran %d times", i, counts[i].load());
+            break;
+        }
+    }
+}
+
+DEF_TEST(Executor_workStealing_nested, r) {
+    // Every outer task waits on its own inner SkTaskGroup.  With only two threads,
+    // that only finishes if waiting threads run the inner work themselves.
+    auto pool = SkExecutor::MakeWorkStealingPool(2);
+
+    std::atomic<int> inner{0};
+    SkTaskGroup outer(*pool);
+    outer.batch(16, [&](int) {
+        SkTaskGroup tg(*pool);
+        tg.batch(64, [&](int) { inner.fetch_add(1, std::memory_order_relaxed); });
+        tg.wait();
+    });
+    outer.wait();
+    REPORTER_ASSERT(r, 16 * 64 == inner.load());
+}
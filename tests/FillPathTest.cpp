@@ -5,8 +5,14 @@
  * found in the LICENSE file.
  */
 
+#include "SkArenaAlloc.h"
+#include "SkBitmap.h"
 #include "SkBlitter.h"
+#include "SkExecutor.h"
+#include "SkPaint.h"
 #include "SkPath.h"
+#include "SkRandom.h"
+#include "SkRasterClip.h"
 #include "SkRegion.h"
 #include "SkScan.h"
 #include "Test.h"
@@ -46,3 +52,122 @@ DEF_TEST(FillPathInverse, reporter) {
 
     REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
+
+// A path with thousands of lines, quads and cubics criss-crossing the bitmap, so that edges
+// tie, cross and span many bands.
+static SkPath make_huge_path(int width, int height, SkPath::FillType fillType) {
+    SkRandom rand;
+    SkPath path;
+    path.setFillType(fillType);
+    auto point = [&]() {
+        // Snap some of the points to pixel and half pixel centers, for more ties.
+        SkPoint p = SkPoint::Make(rand.nextRangeF(-10, width + 10),
+                                  rand.nextRangeF(-10, height + 10));
+        if (rand.nextBool()) {
+            p.set(SkScalarHalf(SkScalarRoundToScalar(2 * p.fX)),
+                  SkScalarHalf(SkScalarRoundToScalar(2 * p.fY)));
+        }
+        return p;
+    };
+    for (int contour = 0; contour < 20; contour++) {
+        path.moveTo(point());
+        for (int i = 0; i < 100; i++) {
+            switch (rand.nextULessThan(3)) {
+                case 0:
+                    path.lineTo(point());
+                    break;
+                case 1:
+                    path.quadTo(point(), point());
+                    break;
+                default:
+                    path.cubicTo(point(), point(), point());
+                    break;
+            }
+        }
+        path.close();
+    }
+    return path;
+}
+
+// Columns of rects whose neighbors share a side, often in the middle of a pixel, crossed by
+// thin strips that cancel them out.  Where the columns start on different rows, their shared
+// sides tie in x in an order that depends on where the walk began.
+static SkPath make_abutting_rects(SkPath::FillType fillType) {
+    SkPath path;
+    path.setFillType(fillType);
+    for (int col = 0; col < 118; col++) {
+        path.addRect(SkRect::MakeLTRB(2.5f * col + 0.5f, (col * 37) % 50 + 0.3f,
+                                      2.5f * col + 3, 390.6f));
+    }
+    for (int strip = 0; strip < 19; strip++) {
+        path.addRect(SkRect::MakeLTRB(0.5f, 20 * strip + 10, 295.5f, 20 * strip + 10.25f),
+                     SkPath::kCCW_Direction);
+    }
+    return path;
+}
+
+static void fill_huge_path(SkBitmap* bm, const SkPath& path, const SkIRect& clip,
+                           bool antiAlias, SkExecutor* executor, skiatest::Reporter* r) {
+    bm->eraseColor(SK_ColorTRANSPARENT);
+    SkPixmap pixmap;
+    bm->peekPixels(&pixmap);
+    SkPaint paint;
+    paint.setColor(0xFF4080C0);
+    auto makeBlitter = [&](SkArenaAlloc* alloc) {
+        return SkBlitter::Choose(pixmap, SkMatrix::I(), paint, alloc);
+    };
+
+    const SkRasterClip rc(clip);
+    if (executor) {
+        REPORTER_ASSERT(r, SkScan::FillPathInBands(path, rc, antiAlias, makeBlitter, executor));
+        return;
+    }
+    SkArenaAlloc alloc(0);
+    if (antiAlias) {
+        SkScan::AntiFillPath(path, rc, makeBlitter(&alloc));
+    } else {
+        SkScan::FillPath(path, rc, makeBlitter(&alloc));
+    }
+}
+
+// Filling in bands must not change a single pixel, clipped or not, anti-aliased or not.
+DEF_TEST(FillPathInBands, r) {
+    const int width = 300, height = 400;
+    SkBitmap serial, banded;
+    serial.allocN32Pixels(width, height);
+    banded.allocN32Pixels(width, height);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeThreadPool(4);
+
+    const SkIRect clips[] = {
+        SkIRect::MakeWH(width, height),
+        SkIRect::MakeLTRB(17, 33, 251, 377),
+    };
+    for (SkPath::FillType fillType : { SkPath::kWinding_FillType, SkPath::kEvenOdd_FillType }) {
+        const SkPath paths[] = {
+            make_huge_path(width, height, fillType),
+            make_abutting_rects(fillType),
+        };
+        for (const SkPath& path : paths) {
+            for (const SkIRect& clip : clips) {
+                for (bool antiAlias : { false, true }) {
+                    fill_huge_path(&serial, path, clip, antiAlias, nullptr, r);
+                    fill_huge_path(&banded, path, clip, antiAlias, executor.get(), r);
+                    for (int y = 0; y < height; y++) {
+                        if (0 != memcmp(serial.getAddr32(0, y), banded.getAddr32(0, y),
+                                        width * sizeof(uint32_t))) {
+                            ERRORF(r, "Banded fill differs on row %d (aa %d, fill type %d)",
+                                   y, antiAlias, fillType);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Inverse fills are left to the serial scan converter.
+    SkPath inverse = make_huge_path(width, height, SkPath::kInverseWinding_FillType);
+    REPORTER_ASSERT(r, !SkScan::FillPathInBands(inverse, SkRasterClip(clips[0]), false,
+                                                [](SkArenaAlloc*) { return nullptr; },
+                                                executor.get()));
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkDescriptor.h"
+#include "SkGlyphCache.h"
+#include "SkGlyphCache_Globals.h"
+#include "SkTaskGroup.h"
+#include "Test.h"
+#include "sk_tool_utils.h"
+
+#include <atomic>
+
+static bool hold_proc(const SkGlyphCache*, void*) { return true; }
+
+// Uses its own list of strikes, so that sharing it doesn't change how any other test draws text.
+DEF_TEST(GlyphCache_shared, r) {
+    SkGlyphCache_Globals globals;
+    globals.setShared(true);
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setTextSize(17);
+    paint.setTypeface(sk_tool_utils::create_portable_typeface("serif", SkFontStyle()));
+
+    SkScalerContext::Rec rec;
+    SkScalerContext::MakeRec(paint, nullptr, nullptr, &rec);
+    SkAutoDescriptor ad(SkDescriptor::ComputeOverhead(1) + sizeof(rec));
+    SkDescriptor* desc = ad.getDesc();
+    desc->init();
+    desc->addEntry(kRec_SkDescriptorTag, sizeof(rec), &rec);
+    desc->computeChecksum();
+
+    SkTypeface* typeface = paint.getTypeface();
+    SkScalerContextEffects effects;
+    auto hold = [&]() { return globals.visitCache(typeface, effects, desc, hold_proc, nullptr); };
+
+    {
+        // While shared, two holders of the same strike get the same cache.
+        SkGlyphCache* a = hold();
+        SkGlyphCache* b = hold();
+        REPORTER_ASSERT(r, a && a == b);
+        globals.attachCacheToHead(b);
+
+        // Purging can't free a strike while it's held, so asking again finds the same one.
+        globals.purgeAll();
+        REPORTER_ASSERT(r, globals.getCacheCountUsed() == 1);
+        b = hold();
+        REPORTER_ASSERT(r, a == b);
+        globals.attachCacheToHead(b);
+        globals.attachCacheToHead(a);
+
+        // Once nobody holds it, it goes.
+        globals.purgeAll();
+        REPORTER_ASSERT(r, globals.getCacheCountUsed() == 0);
+    }
+
+    // Many threads reading and filling one strike see the same glyphs.
+    SkGlyphID glyphs['z'];
+    SkScalar advances['z'];
+    {
+        SkGlyphCache* cache = hold();
+        for (int c = ' '; c < 'z'; c++) {
+            glyphs[c] = cache->unicharToGlyph(c);
+            advances[c] = cache->getGlyphIDAdvance(glyphs[c]).fAdvanceX;
+        }
+
+        // Full metrics for a glyph that only has its advance come in a new glyph, since other
+        // holders may be reading the old one.
+        const SkGlyph& justAdvance = cache->getGlyphIDAdvance(glyphs['A']);
+        const SkGlyph& full = cache->getGlyphIDMetrics(glyphs['A']);
+        REPORTER_ASSERT(r, &justAdvance != &full);
+        REPORTER_ASSERT(r, justAdvance.isJustAdvance() && full.isFullMetrics());
+        REPORTER_ASSERT(r, justAdvance.fAdvanceX == full.fAdvanceX);
+        REPORTER_ASSERT(r, &cache->getGlyphIDAdvance(glyphs['A']) == &full);
+        globals.attachCacheToHead(cache);
+    }
+    globals.purgeAll();
+
+    std::atomic<int> mismatches{0};
+    SkTaskGroup().batch(8, [&](int) {
+        SkGlyphCache* cache = hold();
+        for (int c = ' '; c < 'z'; c++) {
+            const SkGlyph& glyph = cache->getGlyphIDMetrics(glyphs[c]);
+            cache->findImage(glyph);
+            if (cache->unicharToGlyph(c) != glyphs[c] || glyph.fAdvanceX != advances[c]) {
+                mismatches++;
+            }
+        }
+        globals.attachCacheToHead(cache);
+    });
+    REPORTER_ASSERT(r, mismatches == 0);
+}
@@ -5,7 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "SkChecksum.h"
 #include "SkDiscardableMemory.h"
+#include "SkGraphics.h"
 #include "SkResourceCache.h"
 #include "Test.h"
 
@@ -150,3 +152,76 @@ DEF_TEST(ImageCache_doubleAdd, r) {
     REPORTER_ASSERT(r, cache.find(key, TestingRec::Visitor, &value));
     REPORTER_ASSERT(r, 2 == value || 3 == value);
 }
+
+DEF_TEST(ImageCache_purgeToByteLimit, r) {
+    SkResourceCache cache(4096);
+    for (int i = 0; i < COUNT; ++i) {
+        cache.add(new TestingRec(TestingKey(i), i));
+    }
+    const size_t recBytes = cache.getTotalBytesUsed() / COUNT;
+
+    // Keep the three most recently used, without touching the limit.
+    cache.purgeToByteLimit(3 * recBytes);
+    REPORTER_ASSERT(r, cache.getTotalBytesUsed() == 3 * recBytes);
+    REPORTER_ASSERT(r, cache.getTotalByteLimit() == 4096);
+    for (int i = 0; i < COUNT; ++i) {
+        intptr_t value = -1;
+        bool found = cache.find(TestingKey(i), TestingRec::Visitor, &value);
+        REPORTER_ASSERT(r, found == (i >= COUNT - 3));
+    }
+}
+
+// The shard that holds a key, picked the way SkResourceCache picks it.
+static int shard_index(const TestingKey& key, int shardCount) {
+    return SkChecksum::Mix(key.hash()) % shardCount;
+}
+
+// Other tests may use the global cache while this runs, so this only checks keys of its own,
+// and restores the global settings when it's done.
+DEF_TEST(ImageCache_shards, r) {
+    const int kShards = 4;
+    const int prevCount = SkGraphics::SetResourceCacheShardCount(kShards);
+    const size_t prevLimit = SkGraphics::GetResourceCacheTotalByteLimit();
+    REPORTER_ASSERT(r, SkGraphics::GetResourceCacheShardCount() == kShards);
+    REPORTER_ASSERT(r, SkGraphics::SetResourceCacheShardCount(kShards) == kShards);
+
+    // Add keys until every shard holds some, and find each one again.
+    int keyCount = 0;
+    bool inShard[kShards] = { false, false, false, false };
+    while (!(inShard[0] && inShard[1] && inShard[2] && inShard[3])) {
+        TestingKey key(keyCount);
+        inShard[shard_index(key, kShards)] = true;
+        SkResourceCache::Add(new TestingRec(key, keyCount));
+        keyCount++;
+    }
+    REPORTER_ASSERT(r, keyCount > 1);
+    for (int i = 0; i < keyCount; ++i) {
+        intptr_t value = -1;
+        REPORTER_ASSERT(r, SkResourceCache::Find(TestingKey(i), TestingRec::Visitor, &value));
+        REPORTER_ASSERT(r, i == value);
+    }
+
+    // The byte limit is for all the shards together, even though each shard alone may use it all.
+    const size_t recBytes = TestingRec(TestingKey(0), 0).bytesUsed();
+    const size_t limit = 8 * recBytes;
+    SkGraphics::SetResourceCacheTotalByteLimit(limit);
+    REPORTER_ASSERT(r, SkGraphics::GetResourceCacheTotalBytesUsed() <= limit);
+    for (int i = 0; i < COUNT * 10; ++i) {
+        SkResourceCache::Add(new TestingRec(TestingKey(keyCount + i), i));
+        REPORTER_ASSERT(r, SkGraphics::GetResourceCacheTotalBytesUsed() <= limit);
+    }
+    intptr_t value = -1;
+    const int lastKey = keyCount + COUNT * 10 - 1;
+    REPORTER_ASSERT(r, SkResourceCache::Find(TestingKey(lastKey), TestingRec::Visitor, &value));
+    REPORTER_ASSERT(r, COUNT * 10 - 1 == value);
+    SkGraphics::SetResourceCacheTotalByteLimit(prevLimit);
+
+    // Changing the count purges, since keys may now belong in other shards.
+    REPORTER_ASSERT(r, SkGraphics::SetResourceCacheShardCount(2) == kShards);
+    REPORTER_ASSERT(r, !SkResourceCache::Find(TestingKey(lastKey), TestingRec::Visitor, &value));
+
+    // Counts are pinned to at least one shard.
+    SkGraphics::SetResourceCacheShardCount(0);
+    REPORTER_ASSERT(r, SkGraphics::GetResourceCacheShardCount() == 1);
+    SkGraphics::SetResourceCacheShardCount(prevCount);
+}
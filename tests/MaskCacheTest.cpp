@@ -6,6 +6,7 @@
  */
 
 #include "SkCachedData.h"
+#include "SkCanvas.h"
 #include "SkMaskCache.h"
 #include "SkResourceCache.h"
 #include "Test.h"
@@ -104,3 +105,152 @@ DEF_TEST(RectsMaskCache, reporter) {
     check_data(reporter, data, 1, kNotInCache, kLocked);
     data->unref();
 }
+
+DEF_TEST(PathMaskCache, reporter) {
+    SkResourceCache cache(1024);
+
+    SkPath path;
+    path.addCircle(10, 10, 8);
+    SkMatrix matrix = SkMatrix::MakeScale(2, 3);
+    matrix.postTranslate(10.25f, 20.5f);
+    SkMask mask;
+    bool seenBefore;
+
+    // A miss notes the key, so the next one knows the path was seen before.
+    SkCachedData* data = SkMaskCache::FindAndRef(path, matrix, true, &mask, &seenBefore, &cache);
+    REPORTER_ASSERT(reporter, nullptr == data);
+    REPORTER_ASSERT(reporter, !seenBefore);
+    data = SkMaskCache::FindAndRef(path, matrix, true, &mask, &seenBefore, &cache);
+    REPORTER_ASSERT(reporter, nullptr == data);
+    REPORTER_ASSERT(reporter, seenBefore);
+
+    size_t size = 256;
+    data = cache.newCachedData(size);
+    memset(data->writable_data(), 0xff, size);
+    mask.fBounds.setXYWH(12, 24, 16, 16);
+    mask.fRowBytes = 16;
+    mask.fFormat = SkMask::kA8_Format;
+    SkMaskCache::Add(path, matrix, true, mask, data, &cache);
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    data->unref();
+    check_data(reporter, data, 1, kInCache, kUnlocked);
+
+    sk_bzero(&mask, sizeof(mask));
+    data = SkMaskCache::FindAndRef(path, matrix, true, &mask, &seenBefore, &cache);
+    REPORTER_ASSERT(reporter, data);
+    REPORTER_ASSERT(reporter, data->size() == size);
+    REPORTER_ASSERT(reporter, mask.fBounds == SkIRect::MakeXYWH(12, 24, 16, 16));
+    REPORTER_ASSERT(reporter, data->data() == (const void*)mask.fImage);
+    check_data(reporter, data, 2, kInCache, kLocked);
+    data->unref();
+
+    // Whole pixels of translation find the same mask, moved.
+    SkMatrix moved = matrix;
+    moved.postTranslate(-13, 7);
+    data = SkMaskCache::FindAndRef(path, moved, true, &mask, &seenBefore, &cache);
+    REPORTER_ASSERT(reporter, data);
+    REPORTER_ASSERT(reporter, mask.fBounds == SkIRect::MakeXYWH(-1, 31, 16, 16));
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    // Anything else that may change the coverage misses.
+    SkMatrix subpixel = matrix;
+    subpixel.postTranslate(0.5f, 0);
+    REPORTER_ASSERT(reporter,
+                    !SkMaskCache::FindAndRef(path, subpixel, true, &mask, &seenBefore, &cache));
+    SkMatrix scaled = matrix;
+    scaled.preScale(2, 2);
+    REPORTER_ASSERT(reporter,
+                    !SkMaskCache::FindAndRef(path, scaled, true, &mask, &seenBefore, &cache));
+    REPORTER_ASSERT(reporter,
+                    !SkMaskCache::FindAndRef(path, matrix, false, &mask, &seenBefore, &cache));
+    SkPath evenOdd(path);
+    evenOdd.setFillType(SkPath::kEvenOdd_FillType);
+    REPORTER_ASSERT(reporter,
+                    !SkMaskCache::FindAndRef(evenOdd, matrix, true, &mask, &seenBefore, &cache));
+    SkPath edited(path);
+    edited.lineTo(0, 0);
+    REPORTER_ASSERT(reporter,
+                    !SkMaskCache::FindAndRef(edited, matrix, true, &mask, &seenBefore, &cache));
+
+    cache.purgeAll();
+    check_data(reporter, data, 1, kNotInCache, kLocked);
+    data->unref();
+}
+
+// A cached draw blends through a mask blit rather than scan conversion's run blits, so it may
+// round each channel differently by a unit or so.
+static bool nearly_equal_pixels(const SkBitmap& a, const SkBitmap& b, int tolerance) {
+    for (int y = 0; y < a.height(); y++) {
+        for (int x = 0; x < a.width(); x++) {
+            const SkColor ca = a.getColor(x, y),
+                          cb = b.getColor(x, y);
+            for (int shift : { 0, 8, 16, 24 }) {
+                if (SkTAbs((int)((ca >> shift) & 0xFF) - (int)((cb >> shift) & 0xFF)) >
+                        tolerance) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static SkPath make_cached_path() {
+    SkPath path;
+    path.moveTo(10, 10);
+    path.cubicTo(60, 0, 0, 60, 50, 40);
+    path.lineTo(20, 55);
+    path.close();
+    path.addCircle(30, 30, 12);
+    return path;
+}
+
+// Drawing a path from its cached mask should look like drawing it directly, wherever whole
+// pixels of translation move it.  Only paths drawn more than once are cached, and only drawn
+// from their masks while the clip does not cut them.
+DEF_TEST(PathMaskCache_draw, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(100, 100);
+    SkBitmap expected, actual;
+    expected.allocPixels(info);
+    actual.allocPixels(info);
+    auto draw = [&](const SkBitmap& bitmap, const SkPath& path, bool aa, SkColor color,
+                    const SkRect& clip, int dx) {
+        bitmap.eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(bitmap);
+        canvas.clipRect(clip);
+        canvas.translate(15.5f + dx, 3.25f);
+        canvas.rotate(10);
+        SkPaint paint;
+        paint.setAntiAlias(aa);
+        paint.setColor(color);
+        canvas.drawPath(path, paint);
+        return canvas.getTotalMatrix();
+    };
+
+    const SkRect containing = SkRect::MakeWH(100, 100),
+                 cutting    = SkRect::MakeLTRB(0, 0, 40, 100);
+    for (bool aa : { false, true })
+    for (SkColor color : { 0x80FF0000, SK_ColorBLUE })
+    for (const SkRect& clip : { containing, cutting }) {
+        SkPath path = make_cached_path();
+        SkPath volatilePath(path);
+        volatilePath.setIsVolatile(true);
+
+        bool seenBefore;
+        for (int i = 0; i < 4; i++) {
+            // Volatile paths are never cached, so this draws the path directly.
+            const int dx = i < 3 ? 0 : 7;
+            draw(expected, volatilePath, aa, color, clip, dx);
+            const SkMatrix matrix = draw(actual, path, aa, color, clip, dx);
+            REPORTER_ASSERT(reporter, nearly_equal_pixels(expected, actual, aa ? 1 : 0));
+
+            SkMask mask;
+            SkCachedData* data = SkMaskCache::FindAndRef(path, matrix, aa, &mask, &seenBefore);
+            REPORTER_ASSERT(reporter, SkToBool(data) == (i > 0 && clip == containing));
+            if (data) {
+                data->unref();
+            }
+        }
+    }
+}
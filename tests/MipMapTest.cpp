@@ -6,8 +6,11 @@
  */
 
 #include "SkBitmap.h"
+#include "SkColorSpace.h"
+#include "SkExecutor.h"
 #include "SkMipMap.h"
 #include "SkRandom.h"
+#include "SkTaskGroup.h"
 #include "Test.h"
 
 static void make_bitmap(SkBitmap* bm, int width, int height) {
@@ -202,3 +205,74 @@ DEF_TEST(MipMap_ComputeLevelSize, reporter) {
         REPORTER_ASSERT(reporter, currentTest.fExpectedMipMapLevelSize == levelSize);
     }
 }
+
+static bool levels_equal(const SkMipMap::Level& a, const SkMipMap::Level& b) {
+    const SkPixmap& pa = a.fPixmap;
+    const SkPixmap& pb = b.fPixmap;
+    if (pa.info() != pb.info()) {
+        return false;
+    }
+    for (int y = 0; y < pa.height(); y++) {
+        if (memcmp(pa.addr(0, y), pb.addr(0, y), pa.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Threaded and lazy builds must produce exactly the same levels as a plain Build().
+DEF_TEST(MipMap_threadedAndLazy, reporter) {
+    auto pool = SkExecutor::MakeWorkStealingPool(4);
+
+    const SkISize sizes[] = { {511, 511}, {512, 300}, {1000, 3}, {3, 1000}, {2047, 1023} };
+    const SkDestinationSurfaceColorMode modes[] = {
+        SkDestinationSurfaceColorMode::kLegacy,
+        SkDestinationSurfaceColorMode::kGammaAndColorSpaceAware,
+    };
+
+    SkRandom rand;
+    for (SkISize size : sizes) {
+        SkBitmap bm;
+        bm.allocPixels(SkImageInfo::MakeS32(size.width(), size.height(), kPremul_SkAlphaType));
+        for (int y = 0; y < bm.height(); y++) {
+            for (int x = 0; x < bm.width(); x++) {
+                U8CPU a = rand.nextU() & 0xFF;
+                *bm.getAddr32(x, y) = SkPremultiplyARGBInline(a, rand.nextU() & 0xFF,
+                                                              rand.nextU() & 0xFF,
+                                                              rand.nextU() & 0xFF);
+            }
+        }
+
+        for (auto mode : modes) {
+            sk_sp<SkMipMap> serial(SkMipMap::Build(bm, mode, nullptr));
+            sk_sp<SkMipMap> threaded(SkMipMap::Build(bm, mode, nullptr, pool.get()));
+            sk_sp<SkMipMap> lazy(SkMipMap::BuildLazy(bm, mode, nullptr));
+            sk_sp<SkMipMap> lazyThreaded(SkMipMap::BuildLazy(bm, mode, nullptr, pool.get()));
+            REPORTER_ASSERT(reporter, serial && threaded && lazy && lazyThreaded);
+            if (!serial || !threaded || !lazy || !lazyThreaded) {
+                continue;
+            }
+
+            // Ask lazyThreaded for its smallest level from many threads at once.
+            SkTaskGroup tg(*pool);
+            tg.batch(8, [&](int) {
+                SkMipMap::Level level;
+                REPORTER_ASSERT(reporter, lazyThreaded->extractLevel(SkSize::Make(0.001f, 0.001f),
+                                                                     &level));
+            });
+            tg.wait();
+
+            const int count = serial->countLevels();
+            for (int i = 0; i < count; i++) {
+                SkMipMap::Level expected, level;
+                REPORTER_ASSERT(reporter, serial->getLevel(i, &expected));
+                REPORTER_ASSERT(reporter, threaded->getLevel(i, &level) &&
+                                          levels_equal(expected, level));
+                REPORTER_ASSERT(reporter, lazy->getLevel(i, &level) &&
+                                          levels_equal(expected, level));
+                REPORTER_ASSERT(reporter, lazyThreaded->getLevel(i, &level) &&
+                                          levels_equal(expected, level));
+            }
+        }
+    }
+}
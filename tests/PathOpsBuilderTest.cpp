@@ -361,3 +361,115 @@ SkOpBuilder builder;
     builder.add(path1, SkPathOp::kUnion_SkPathOp);
     builder.resolve(&path);
 }
+
+// Adds |count| overlapping circles and stars around (cx, cy), which cannot simply be summed.
+static void add_cluster(SkOpBuilder* builder, SkPath* expected, SkScalar cx, SkScalar cy,
+                        int count) {
+    for (int index = 0; index < count; ++index) {
+        const SkScalar angle = 2 * SK_ScalarPI * index / count;
+        const SkScalar x = cx + 20 * SkScalarCos(angle);
+        const SkScalar y = cy + 20 * SkScalarSin(angle);
+        SkPath path;
+        if (index & 1) {
+            path.addCircle(x, y, 8, index & 2 ? SkPath::kCW_Direction : SkPath::kCCW_Direction);
+        } else {
+            path.moveTo(x, y - 10);
+            path.lineTo(x + 6, y + 8);
+            path.lineTo(x - 9, y - 3);
+            path.lineTo(x + 9, y - 3);
+            path.lineTo(x - 6, y + 8);
+            path.close();
+        }
+        builder->add(path, kUnion_SkPathOp);
+        if (expected->isEmpty()) {
+            *expected = path;
+        } else {
+            Op(*expected, path, kUnion_SkPathOp, expected);
+        }
+    }
+}
+
+// Clusters that do not touch are unioned separately, and large ones in halves, so the result
+// should draw the same as unioning the paths one at a time.
+DEF_TEST(PathOpsBuilderClusters, reporter) {
+    SkOpBuilder builder;
+    SkPath expected, result;
+    add_cluster(&builder, &expected, 50, 50, 40);
+    REPORTER_ASSERT(reporter, builder.resolve(&result));
+    REPORTER_ASSERT(reporter, !comparePaths(reporter, __FUNCTION__, expected, result));
+
+    expected.reset();
+    for (int index = 0; index < 9; ++index) {
+        add_cluster(&builder, &expected, 50 + 100 * (index % 3), 50 + 100 * (index / 3),
+                    index == 4 ? 40 : 3 + index);
+    }
+    // Empty paths do not join clusters.
+    builder.add(SkPath(), kUnion_SkPathOp);
+    REPORTER_ASSERT(reporter, builder.resolve(&result));
+    REPORTER_ASSERT(reporter, result.getFillType() == SkPath::kEvenOdd_FillType);
+    REPORTER_ASSERT(reporter, !comparePaths(reporter, __FUNCTION__, expected, result));
+
+    // Clusters whose bounds only share an edge are still joined.
+    SkPath left, right;
+    expected.reset();
+    expected.addRect(0, 0, 20, 10);
+    left.addRect(0, 0, 10, 10);
+    right.addRect(10, 0, 20, 10);
+    builder.add(left, kUnion_SkPathOp);
+    builder.add(right, kUnion_SkPathOp);
+    REPORTER_ASSERT(reporter, builder.resolve(&result));
+    REPORTER_ASSERT(reporter, result.getBounds() == SkRect::MakeWH(20, 10));
+    REPORTER_ASSERT(reporter, !comparePaths(reporter, __FUNCTION__, expected, result));
+}
+
+// resolveInto() recomputes only the contours near the added paths, so its result should draw
+// the same as applying the operations to the whole path, and keep the other contours as is.
+DEF_TEST(PathOpsBuilderResolveInto, reporter) {
+    SkOpBuilder builder;
+    SkPath base;
+    for (int index = 0; index < 16; ++index) {
+        SkPath circle;
+        circle.addCircle(20 + 40 * (index % 4), 20 + 40 * (index / 4), 12);
+        builder.add(circle, kUnion_SkPathOp);
+    }
+    REPORTER_ASSERT(reporter, builder.resolve(&base));
+
+    SkPath bar;
+    bar.addRect(15, 10, 70, 30);
+    const SkPathOp ops[] = { kDifference_SkPathOp, kIntersect_SkPathOp, kUnion_SkPathOp,
+                             kXOR_SkPathOp, kReverseDifference_SkPathOp };
+    for (SkPathOp op : ops) {
+        SkPath expected, result = base;
+        REPORTER_ASSERT(reporter, Op(base, bar, op, &expected));
+        builder.add(bar, op);
+        REPORTER_ASSERT(reporter, builder.resolveInto(&result));
+        REPORTER_ASSERT(reporter, !comparePaths(reporter, __FUNCTION__, expected, result));
+    }
+
+    // Unions are summed before they are applied.
+    SkPath expected, result = base, circle;
+    circle.addCircle(100, 100, 30);
+    REPORTER_ASSERT(reporter, Op(base, bar, kUnion_SkPathOp, &expected));
+    REPORTER_ASSERT(reporter, Op(expected, circle, kUnion_SkPathOp, &expected));
+    builder.add(bar, kUnion_SkPathOp);
+    builder.add(circle, kUnion_SkPathOp);
+    REPORTER_ASSERT(reporter, builder.resolveInto(&result));
+    REPORTER_ASSERT(reporter, !comparePaths(reporter, __FUNCTION__, expected, result));
+
+    // A path that touches nothing is added alongside the rest.
+    SkPath far;
+    far.addRect(200, 200, 210, 210);
+    result = base;
+    builder.add(far, kUnion_SkPathOp);
+    REPORTER_ASSERT(reporter, builder.resolveInto(&result));
+    const int basePoints = base.countPoints();
+    REPORTER_ASSERT(reporter, result.countPoints() > basePoints);
+    SkAutoTArray<SkPoint> pts(result.countPoints());
+    result.getPoints(pts.get(), result.countPoints());
+    for (int index = 0; index < basePoints; ++index) {
+        REPORTER_ASSERT(reporter,
+                pts[result.countPoints() - basePoints + index] == base.getPoint(index));
+    }
+    REPORTER_ASSERT(reporter, Op(base, far, kUnion_SkPathOp, &expected));
+    REPORTER_ASSERT(reporter, !comparePaths(reporter, __FUNCTION__, expected, result));
+}
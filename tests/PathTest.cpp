@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkArenaAlloc.h"
 #include "SkAutoMalloc.h"
 #include "SkCanvas.h"
 #include "SkGeometry.h"
@@ -4751,3 +4752,106 @@ DEF_TEST(path_tight_bounds, reporter) {
         }
     }
 }
+
+static void add_polyline(SkPath* path, int points) {
+    path->moveTo(0, 0);
+    for (int i = 1; i < points; ++i) {
+        path->lineTo(SkIntToScalar(i), SkIntToScalar(i * i % 7));
+    }
+}
+
+// Copies of short paths, and paths with room reserved up front, keep their points and verbs in
+// the same allocation as their SkPathRef.
+DEF_TEST(PathRef_inlineStorage, reporter) {
+    SkPath path;
+    add_polyline(&path, 20);
+
+    // An edit of a shared path copies it, in a single allocation.
+    int64_t before = SkPathPriv::ThreadHeapAllocationCount();
+    SkPath copy(path);
+    copy.close();
+    REPORTER_ASSERT(reporter, 1 == SkPathPriv::ThreadHeapAllocationCount() - before);
+    REPORTER_ASSERT(reporter, path.countPoints() == copy.countPoints());
+    REPORTER_ASSERT(reporter, path.countVerbs() + 1 == copy.countVerbs());
+
+    // So does transforming it into another path.
+    before = SkPathPriv::ThreadHeapAllocationCount();
+    SkPath transformed;
+    path.transform(SkMatrix::MakeScale(2, 3), &transformed);
+    REPORTER_ASSERT(reporter, 1 == SkPathPriv::ThreadHeapAllocationCount() - before);
+
+    // And building a path with room reserved for it.
+    before = SkPathPriv::ThreadHeapAllocationCount();
+    SkPath reserved;
+    reserved.incReserve(20);
+    add_polyline(&reserved, 20);
+    REPORTER_ASSERT(reporter, 1 == SkPathPriv::ThreadHeapAllocationCount() - before);
+    REPORTER_ASSERT(reporter, reserved == path);
+
+    // Paths that outgrow it move to the heap.
+    SkPath expected;
+    add_polyline(&expected, 200);
+    before = SkPathPriv::ThreadHeapAllocationCount();
+    add_polyline(&reserved, 180);
+    REPORTER_ASSERT(reporter, SkPathPriv::ThreadHeapAllocationCount() - before >= 1);
+    REPORTER_ASSERT(reporter, reserved.countPoints() == 200);
+    for (int i = 0; i < 20; ++i) {
+        REPORTER_ASSERT(reporter, reserved.getPoint(i) == expected.getPoint(i));
+    }
+}
+
+DEF_TEST(PathRef_arena, reporter) {
+    const SkMatrix matrix = SkMatrix::MakeScale(2, 3);
+
+    SkPath expected, expectedTransformed;
+    add_polyline(&expected, 20);
+    expected.transform(matrix, &expectedTransformed);
+
+    SkPath copy, identityCopy, longPath;
+    {
+        char storage[4096];
+        SkArenaAlloc alloc(storage);
+
+        // Building and transforming temporary paths in the arena does not touch the heap.
+        int64_t before = SkPathPriv::ThreadHeapAllocationCount();
+        SkPath path, transformed;
+        SkPathPriv::ResetInArena(&path, &alloc);
+        SkPathPriv::ResetInArena(&transformed, &alloc);
+        add_polyline(&path, 20);
+        path.transform(matrix, &transformed);
+        REPORTER_ASSERT(reporter, 0 == SkPathPriv::ThreadHeapAllocationCount() - before);
+        REPORTER_ASSERT(reporter, path == expected);
+        REPORTER_ASSERT(reporter, transformed == expectedTransformed);
+
+        // Nor does rewinding and rebuilding them.
+        path.rewind();
+        add_polyline(&path, 20);
+        REPORTER_ASSERT(reporter, 0 == SkPathPriv::ThreadHeapAllocationCount() - before);
+        REPORTER_ASSERT(reporter, path == expected);
+
+        // Copies, even untransformed ones, are made on the heap.
+        copy = path;
+        path.transform(SkMatrix::I(), &identityCopy);
+        REPORTER_ASSERT(reporter, 2 == SkPathPriv::ThreadHeapAllocationCount() - before);
+
+        // Reserved storage comes from the arena too, and paths that outgrow it move to the heap.
+        SkPath reserved;
+        SkPathPriv::ResetInArena(&reserved, &alloc, 100, 100);
+        add_polyline(&reserved, 100);
+        REPORTER_ASSERT(reporter, 2 == SkPathPriv::ThreadHeapAllocationCount() - before);
+        add_polyline(&reserved, 100);
+        REPORTER_ASSERT(reporter, 3 == SkPathPriv::ThreadHeapAllocationCount() - before);
+        longPath = reserved;
+    }
+
+    // The copies outlive the arena.
+    REPORTER_ASSERT(reporter, copy == expected);
+    REPORTER_ASSERT(reporter, identityCopy == expected);
+    copy.transform(matrix);
+    REPORTER_ASSERT(reporter, copy == expectedTransformed);
+
+    SkPath expectedLong;
+    add_polyline(&expectedLong, 100);
+    add_polyline(&expectedLong, 100);
+    REPORTER_ASSERT(reporter, longPath == expectedLong);
+}
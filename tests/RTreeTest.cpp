@@ -87,5 +87,88 @@ DEF_TEST(RTree, reporter) {
         REPORTER_ASSERT(reporter, NUM_RECTS == rtree.getCount());
         REPORTER_ASSERT(reporter, expectedDepthMin <= rtree.getDepth() &&
                                   expectedDepthMax >= rtree.getDepth());
+        REPORTER_ASSERT(reporter, rtree.isValid());
+    }
+}
+
+// Checks every query against the live entries, which must come back in increasing order.
+static void run_incremental_queries(skiatest::Reporter* reporter, SkRandom& rand,
+                                    const SkTDArray<SkRect>& rects, const SkRTree& tree) {
+    for (size_t i = 0; i < NUM_QUERIES; ++i) {
+        SkTDArray<int> hits;
+        SkRect query = random_rect(rand);
+        tree.search(query, &hits);
+
+        SkTDArray<int> expected;
+        for (int j = 0; j < rects.count(); ++j) {
+            if (SkRect::Intersects(query, rects[j])) {
+                expected.push(j);
+            }
+        }
+        REPORTER_ASSERT(reporter, hits == expected);
+    }
+}
+
+DEF_TEST(RTree_incremental, reporter) {
+    SkRandom rand;
+    for (int bulk = 0; bulk < 2; ++bulk) {
+        SkRTree rtree;
+        // Empty rects stand in for entries that aren't in the tree.
+        SkTDArray<SkRect> rects;
+        if (bulk) {
+            rects.setCount(NUM_RECTS);
+            for (int i = 0; i < NUM_RECTS; ++i) {
+                rects[i] = random_rect(rand);
+            }
+            rtree.insert(rects.begin(), NUM_RECTS);
+        }
+
+        int live = rects.count();
+        for (int i = 0; i < 2000; ++i) {
+            int op = rand.nextULessThan(rects.count() + 1);
+            switch (rand.nextULessThan(4)) {
+                case 0:  // Add a new entry at the end.
+                    *rects.append() = random_rect(rand);
+                    rtree.insert(rects.count() - 1, rects.top());
+                    live++;
+                    break;
+                case 1:  // Remove one, if it's there.
+                    if (op < rects.count() && !rects[op].isEmpty()) {
+                        REPORTER_ASSERT(reporter, rtree.remove(op));
+                        rects[op].setEmpty();
+                        live--;
+                    } else {
+                        REPORTER_ASSERT(reporter, !rtree.remove(op));
+                    }
+                    break;
+                case 2:  // Nudge one a little, which usually stays within its leaf.
+                    if (op < rects.count() && !rects[op].isEmpty()) {
+                        rects[op].offset(rand.nextRangeF(-5, 5), rand.nextRangeF(-5, 5));
+                        rtree.update(op, rects[op]);
+                    }
+                    break;
+                default:  // Move one anywhere, or put back one that was removed.
+                    if (op < rects.count()) {
+                        live += rects[op].isEmpty();
+                        rects[op] = random_rect(rand);
+                        rtree.update(op, rects[op]);
+                    }
+                    break;
+            }
+            REPORTER_ASSERT(reporter, live == rtree.getCount());
+            if (i % 100 == 0) {
+                REPORTER_ASSERT(reporter, rtree.isValid());
+                run_incremental_queries(reporter, rand, rects, rtree);
+            }
+        }
+
+        // Removing everything leaves an empty tree.
+        for (int i = 0; i < rects.count(); ++i) {
+            rtree.remove(i);
+        }
+        REPORTER_ASSERT(reporter, 0 == rtree.getCount());
+        REPORTER_ASSERT(reporter, 0 == rtree.getDepth());
+        REPORTER_ASSERT(reporter, rtree.getRootBound().isEmpty());
+        REPORTER_ASSERT(reporter, rtree.isValid());
     }
 }
@@ -0,0 +1,210 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkBitmapScaler.h"
+#include "SkColorPriv.h"
+#include "SkExecutor.h"
+#include "SkHalf.h"
+#include "SkRandom.h"
+#include "SkResampler.h"
+#include "Test.h"
+
+static const SkBitmapScaler::ResizeMethod gMethods[] = {
+    SkBitmapScaler::RESIZE_BOX,
+    SkBitmapScaler::RESIZE_TRIANGLE,
+    SkBitmapScaler::RESIZE_LANCZOS3,
+    SkBitmapScaler::RESIZE_HAMMING,
+    SkBitmapScaler::RESIZE_MITCHELL,
+};
+
+// Downscales, upscales, and both at once, including to a single pixel.
+static const SkISize gDstSizes[] = {
+    { 57, 40 }, { 300, 211 }, { 1, 1 }, { 500, 3 }, { 12, 260 },
+};
+
+static void make_premul_8888(SkBitmap* bm, int width, int height) {
+    bm->allocN32Pixels(width, height);
+    SkRandom random;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const U8CPU a = random.nextULessThan(256);
+            *bm->getAddr32(x, y) = SkPackARGB32(a, random.nextULessThan(a + 1),
+                                                random.nextULessThan(a + 1),
+                                                random.nextULessThan(a + 1));
+        }
+    }
+}
+
+static bool equal_pixels(const SkPixmap& a, const SkPixmap& b) {
+    for (int y = 0; y < a.height(); y++) {
+        if (0 != memcmp(a.addr(0, y), b.addr(0, y), a.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// For 8888, SkResampler uses the same fixed point filters as SkBitmapScaler, so whether it is
+// given the whole source, pushed one row at a time, or split across threads, it should match.
+DEF_TEST(Resampler_8888, r) {
+    SkBitmap src;
+    make_premul_8888(&src, 173, 131);
+    SkPixmap srcPixmap;
+    src.peekPixels(&srcPixmap);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeThreadPool(4);
+
+    for (SkBitmapScaler::ResizeMethod method : gMethods) {
+        for (SkISize size : gDstSizes) {
+            SkBitmap expected, actual;
+            expected.allocN32Pixels(size.width(), size.height());
+            actual.allocN32Pixels(size.width(), size.height());
+            SkPixmap expectedPixmap, actualPixmap;
+            expected.peekPixels(&expectedPixmap);
+            actual.peekPixels(&actualPixmap);
+            REPORTER_ASSERT(r, SkBitmapScaler::Resize(expectedPixmap, srcPixmap, method));
+
+            REPORTER_ASSERT(r, SkResampler::Resize(actualPixmap, srcPixmap, method));
+            REPORTER_ASSERT(r, equal_pixels(expectedPixmap, actualPixmap));
+
+            actual.eraseColor(SK_ColorTRANSPARENT);
+            REPORTER_ASSERT(r, SkResampler::Resize(actualPixmap, srcPixmap, method,
+                                                   executor.get()));
+            REPORTER_ASSERT(r, equal_pixels(expectedPixmap, actualPixmap));
+
+            actual.eraseColor(SK_ColorTRANSPARENT);
+            std::unique_ptr<SkResampler> resampler =
+                    SkResampler::Make(actualPixmap, src.info().dimensions(), method);
+            REPORTER_ASSERT(r, resampler && resampler->sourceRowsNeeded() <= src.height());
+            for (int y = 0; y < resampler->sourceRowsNeeded(); y++) {
+                REPORTER_ASSERT(r, !resampler->isComplete());
+                resampler->pushRow(src.getAddr32(0, y));
+            }
+            REPORTER_ASSERT(r, resampler->isComplete());
+            REPORTER_ASSERT(r, equal_pixels(expectedPixmap, actualPixmap));
+        }
+    }
+}
+
+// A8 is filtered exactly like the alpha of a gray 8888 image.
+DEF_TEST(Resampler_A8, r) {
+    SkBitmap alphas, grays;
+    alphas.allocPixels(SkImageInfo::MakeA8(173, 131));
+    grays.allocN32Pixels(173, 131);
+    SkRandom random;
+    for (int y = 0; y < alphas.height(); y++) {
+        for (int x = 0; x < alphas.width(); x++) {
+            const U8CPU a = random.nextULessThan(256);
+            *alphas.getAddr8(x, y) = a;
+            *grays.getAddr32(x, y) = SkPackARGB32(a, a, a, a);
+        }
+    }
+    SkPixmap alphaSrc, graySrc;
+    alphas.peekPixels(&alphaSrc);
+    grays.peekPixels(&graySrc);
+
+    for (SkBitmapScaler::ResizeMethod method : gMethods) {
+        for (SkISize size : gDstSizes) {
+            SkBitmap alphaDst, grayDst;
+            alphaDst.allocPixels(SkImageInfo::MakeA8(size.width(), size.height()));
+            grayDst.allocN32Pixels(size.width(), size.height());
+            SkPixmap alphaPixmap, grayPixmap;
+            alphaDst.peekPixels(&alphaPixmap);
+            grayDst.peekPixels(&grayPixmap);
+            REPORTER_ASSERT(r, SkResampler::Resize(alphaPixmap, alphaSrc, method));
+            REPORTER_ASSERT(r, SkResampler::Resize(grayPixmap, graySrc, method));
+
+            for (int y = 0; y < size.height(); y++) {
+                for (int x = 0; x < size.width(); x++) {
+                    if (*alphaDst.getAddr8(x, y) != SkGetPackedA32(*grayDst.getAddr32(x, y))) {
+                        ERRORF(r, "A8 and 8888 differ at (%d, %d) resizing to %dx%d",
+                               x, y, size.width(), size.height());
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// F16 is filtered in float, so it should be close to 8888, which rounds between passes.  The
+// source is smooth, so the filters do not ring, which 8888 would clamp and F16 would not.
+DEF_TEST(Resampler_F16, r) {
+    SkBitmap src8888;
+    src8888.allocN32Pixels(173, 131);
+    for (int y = 0; y < src8888.height(); y++) {
+        for (int x = 0; x < src8888.width(); x++) {
+            const U8CPU a = 255 - x;
+            *src8888.getAddr32(x, y) = SkPackARGB32(a, a * y / 255, a * (255 - y) / 255, a / 2);
+        }
+    }
+    SkBitmap srcF16;
+    srcF16.allocPixels(SkImageInfo::Make(173, 131, kRGBA_F16_SkColorType, kPremul_SkAlphaType));
+    for (int y = 0; y < src8888.height(); y++) {
+        for (int x = 0; x < src8888.width(); x++) {
+            const SkPMColor c = *src8888.getAddr32(x, y);
+            const Sk4f rgba = Sk4f(SkGetPackedR32(c), SkGetPackedG32(c), SkGetPackedB32(c),
+                                   SkGetPackedA32(c)) * (1 / 255.0f);
+            SkFloatToHalf_finite_ftz(rgba).store(srcF16.getAddr(x, y));
+        }
+    }
+    SkPixmap src8888Pixmap, srcF16Pixmap;
+    src8888.peekPixels(&src8888Pixmap);
+    srcF16.peekPixels(&srcF16Pixmap);
+
+    for (SkISize size : gDstSizes) {
+        SkBitmap dst8888, dstF16;
+        dst8888.allocN32Pixels(size.width(), size.height());
+        dstF16.allocPixels(srcF16.info().makeWH(size.width(), size.height()));
+        SkPixmap pixmap8888, pixmapF16;
+        dst8888.peekPixels(&pixmap8888);
+        dstF16.peekPixels(&pixmapF16);
+        REPORTER_ASSERT(r, SkResampler::Resize(pixmap8888, src8888Pixmap,
+                                               SkBitmapScaler::RESIZE_MITCHELL));
+        REPORTER_ASSERT(r, SkResampler::Resize(pixmapF16, srcF16Pixmap,
+                                               SkBitmapScaler::RESIZE_MITCHELL));
+
+        for (int y = 0; y < size.height(); y++) {
+            for (int x = 0; x < size.width(); x++) {
+                const SkPMColor c = *dst8888.getAddr32(x, y);
+                const Sk4f expected = Sk4f(SkGetPackedR32(c), SkGetPackedG32(c),
+                                           SkGetPackedB32(c), SkGetPackedA32(c)) * (1 / 255.0f);
+                const Sk4f actual = SkHalfToFloat_finite_ftz(*pixmapF16.addr64(x, y));
+                if (((expected - actual).abs() > 3 / 255.0f).anyTrue()) {
+                    ERRORF(r, "F16 and 8888 differ at (%d, %d) resizing to %dx%d",
+                           x, y, size.width(), size.height());
+                    return;
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(Resampler_invalid, r) {
+    SkBitmap src, dst;
+    src.allocN32Pixels(16, 16);
+    dst.allocPixels(SkImageInfo::MakeA8(8, 8));
+    SkPixmap srcPixmap, dstPixmap;
+    src.peekPixels(&srcPixmap);
+    dst.peekPixels(&dstPixmap);
+
+    // The source and destination must have the same color type.
+    REPORTER_ASSERT(r, !SkResampler::Resize(dstPixmap, srcPixmap,
+                                            SkBitmapScaler::RESIZE_MITCHELL));
+
+    // 565 is not supported.
+    dst.allocPixels(SkImageInfo::Make(8, 8, kRGB_565_SkColorType, kOpaque_SkAlphaType));
+    dst.peekPixels(&dstPixmap);
+    REPORTER_ASSERT(r, !SkResampler::Make(dstPixmap, { 16, 16 },
+                                          SkBitmapScaler::RESIZE_MITCHELL));
+
+    // Nor are empty sources.
+    dst.allocN32Pixels(8, 8);
+    dst.peekPixels(&dstPixmap);
+    REPORTER_ASSERT(r, !SkResampler::Make(dstPixmap, { 0, 16 },
+                                          SkBitmapScaler::RESIZE_MITCHELL));
+}
@@ -308,6 +308,26 @@ DEF_TEST(SkNx_int_u16, r) {
     }
 }
 
+DEF_TEST(SkNx_u8_u16, r) {
+    for (int i = 0; i <= 0xff; i++) {
+        uint8_t  b = (uint8_t)i;
+        uint16_t h = SkNx_cast<uint16_t>(Sk16b(b))[15];
+        REPORTER_ASSERT(r, i == h);
+        REPORTER_ASSERT(r, b == SkNx_cast<uint8_t>(Sk16h(h))[15]);
+    }
+}
+
+DEF_TEST(SkNx_mulHi, r) {
+    const uint16_t vals[] = { 0, 1, 2, 0x00ff, 0x0100, 0x7fff, 0x8000, 0xfffe, 0xffff };
+    for (uint16_t x : vals) {
+        for (uint16_t y : vals) {
+            uint16_t expected = (uint16_t)(((uint32_t)x * y) >> 16);
+            REPORTER_ASSERT(r, expected == Sk8h(x).mulHi(Sk8h(y))[7]);
+            REPORTER_ASSERT(r, expected == Sk16h(x).mulHi(Sk16h(y))[15]);
+        }
+    }
+}
+
 DEF_TEST(SkNx_4fLoad4Store4, r) {
     float src[] = {
          0.0f,  1.0f,  2.0f,  3.0f,
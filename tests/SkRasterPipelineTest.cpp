@@ -79,3 +79,74 @@ DEF_TEST(SkRasterPipeline_JIT, r) {
         }
     }
 }
+
+DEF_TEST(SkRasterPipeline_run_2d, r) {
+    // A 5x3 source with a 7-pixel row stride copied into a 6-pixel-stride destination.
+    uint32_t srcBuf[7*3], dstBuf[6*3];
+    for (int i = 0; i < 7*3; i++) {
+        srcBuf[i] = (uint32_t)i;
+    }
+    for (int i = 0; i < 6*3; i++) {
+        dstBuf[i] = 0;
+    }
+
+    const uint32_t* src = nullptr;
+    uint32_t*       dst = nullptr;
+
+    SkRasterPipeline p;
+    p.append(SkRasterPipeline:: load_8888, &src);
+    p.append(SkRasterPipeline::store_8888, &dst);
+    p.run_2d(1,0, 5,3, [&](size_t y) {
+        src = srcBuf + 7*y;
+        dst = dstBuf + 6*y;
+    });
+
+    for (int y = 0; y < 3; y++) {
+        for (int x = 0; x < 6; x++) {
+            uint32_t want = x == 0 ? 0 : (uint32_t)(7*y + x);
+            REPORTER_ASSERT(r, dstBuf[6*y + x] == want);
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_compile, r) {
+    uint32_t srcBuf[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 },
+             dstBuf[9] = { 0 };
+
+    const uint32_t* src = srcBuf;
+    uint32_t*       dst = dstBuf;
+
+    SkRasterPipeline p;
+    p.append(SkRasterPipeline:: load_8888, &src);
+    p.append(SkRasterPipeline::store_8888, &dst);
+    auto fn = p.compile();
+
+    fn(0,5);
+    fn(5,4);
+    REPORTER_ASSERT(r, 0 == memcmp(dstBuf, srcBuf, sizeof(dstBuf)));
+
+    // The compiled function reads its contexts each time it runs.
+    uint32_t other[9] = { 0 };
+    dst = other;
+    fn(0,9);
+    REPORTER_ASSERT(r, 0 == memcmp(other, srcBuf, sizeof(other)));
+
+    // Another pipeline with the same stages but different contexts should share the cached
+    // program.  Other tests may be running pipelines too, so we only check lower bounds.
+    uint32_t copy[9] = { 0 };
+    const uint32_t* src2 = dstBuf;
+    uint32_t*       dst2 = copy;
+    SkRasterPipeline q;
+    q.append(SkRasterPipeline:: load_8888, &src2);
+    q.append(SkRasterPipeline::store_8888, &dst2);
+
+    auto before = SkRasterPipeline::GetProgramCacheStats();
+    q.run(0,9);
+    auto after  = SkRasterPipeline::GetProgramCacheStats();
+    REPORTER_ASSERT(r, 0 == memcmp(copy, srcBuf, sizeof(copy)));
+#if defined(SK_JUMPER)
+    REPORTER_ASSERT(r, after.hits + after.misses > before.hits + before.misses);
+#else
+    REPORTER_ASSERT(r, after.hits == before.hits && after.misses == before.misses);
+#endif
+}
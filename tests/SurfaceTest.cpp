@@ -6,11 +6,15 @@
  */
 
 #include <functional>
+#include "SkBlurImageFilter.h"
 #include "SkCanvas.h"
 #include "SkColorSpace_Base.h"
+#include "SkDashPathEffect.h"
 #include "SkData.h"
 #include "SkDevice.h"
+#include "SkExecutor.h"
 #include "SkImage_Base.h"
+#include "SkOffsetImageFilter.h"
 #include "SkOverdrawCanvas.h"
 #include "SkPath.h"
 #include "SkRegion.h"
@@ -580,6 +584,159 @@ DEF_TEST(surface_raster_zeroinitialized, reporter) {
     }
 }
 
+static void draw_threaded_test_content(SkCanvas* canvas) {
+    SkPaint paint;
+    canvas->drawColor(SK_ColorWHITE);
+
+    paint.setColor(SK_ColorRED);
+    canvas->drawRect(SkRect::MakeLTRB(3.5f, 9.25f, 60.75f, 71.5f), paint);
+
+    paint.setAntiAlias(true);
+    paint.setColor(0x800000FF);
+    canvas->drawRect(SkRect::MakeLTRB(20.3f, 0.6f, 97.2f, 44.9f), paint);
+
+    canvas->save();
+    canvas->clipRect(SkRect::MakeLTRB(10, 30, 90, 80));
+    canvas->translate(5.5f, 2.25f);
+    canvas->scale(1.5f, 0.75f);
+    paint.setColor(0xC000FF00);
+    canvas->drawRect(SkRect::MakeLTRB(0, 0, 40, 90), paint);
+    canvas->restore();
+
+    paint.setColor(SK_ColorBLACK);
+    paint.setTextSize(17);
+    canvas->drawText("threaded", 8, 4, 60, paint);
+}
+
+DEF_TEST(surface_raster_threaded, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(100, 100);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeThreadPool(4);
+
+    sk_sp<SkSurface> serial(SkSurface::MakeRaster(info));
+    // 7 tiles don't divide 100 rows evenly, so the tiles are not all the same height.
+    sk_sp<SkSurface> threaded(SkSurface::MakeRasterThreaded(info, 7, executor.get()));
+    REPORTER_ASSERT(reporter, serial && threaded);
+
+    draw_threaded_test_content(serial->getCanvas());
+    draw_threaded_test_content(threaded->getCanvas());
+
+    // Snapping an image must pick up the draws still queued in the threaded canvas.
+    sk_sp<SkImage> serialImage(serial->makeImageSnapshot());
+    sk_sp<SkImage> threadedImage(threaded->makeImageSnapshot());
+
+    SkPixmap expected, actual;
+    REPORTER_ASSERT(reporter, serialImage->peekPixels(&expected));
+    REPORTER_ASSERT(reporter, threadedImage->peekPixels(&actual));
+    for (int y = 0; y < info.height(); ++y) {
+        REPORTER_ASSERT(reporter,
+                        !memcmp(expected.addr32(0, y), actual.addr32(0, y), info.minRowBytes()));
+    }
+
+    // Drawing after the snapshot must not disturb the snapped image.
+    threaded->getCanvas()->drawColor(SK_ColorBLUE);
+    REPORTER_ASSERT(reporter, threadedImage->peekPixels(&actual));
+    REPORTER_ASSERT(reporter, *actual.addr32(0, 0) == SK_ColorWHITE);
+
+    REPORTER_ASSERT(reporter, threaded->peekPixels(&actual));
+    REPORTER_ASSERT(reporter, *actual.addr32(0, 0) == SkPreMultiplyColor(SK_ColorBLUE));
+}
+
+// Geometry that crosses the threaded surface's tile seams, and layers that read back what was
+// drawn before them.
+static void draw_threaded_seams_content(SkCanvas* canvas) {
+    SkPaint paint;
+    canvas->drawColor(SK_ColorWHITE);
+    paint.setAntiAlias(true);
+
+    SkPath star;
+    star.moveTo(50, 2);
+    star.lineTo(79, 95);
+    star.lineTo(3, 37);
+    star.lineTo(97, 37);
+    star.lineTo(21, 95);
+    star.close();
+    paint.setColor(0xFF00A000);
+    canvas->drawPath(star, paint);
+
+    paint.setColor(0xC0C00000);
+    canvas->drawCircle(37.3f, 61.7f, 30.2f, paint);
+
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(3.3f);
+    paint.setColor(0xFF0000C0);
+    canvas->drawOval(SkRect::MakeLTRB(11.1f, 5.7f, 91.4f, 93.8f), paint);
+
+    const SkScalar intervals[] = { 7, 3 };
+    paint.setPathEffect(SkDashPathEffect::Make(intervals, 2, 0));
+    paint.setStrokeWidth(1.7f);
+    paint.setColor(SK_ColorBLACK);
+    canvas->drawLine(2.5f, 97.1f, 96.3f, 1.9f, paint);
+    paint.setPathEffect(nullptr);
+
+    paint.setStrokeWidth(0);
+    const SkPoint pts[] = { {5, 5}, {95.5f, 40.2f}, {60.7f, 98}, {4.1f, 71.3f} };
+    canvas->drawPoints(SkCanvas::kPolygon_PointMode, 4, pts, paint);
+    paint.setColor(0x80008000);
+    canvas->drawLine(1.3f, 12.2f, 98.7f, 31.9f, paint);
+
+    canvas->save();
+    canvas->rotate(17, 50, 50);
+    paint.setStyle(SkPaint::kFill_Style);
+    paint.setColor(0x8000C0C0);
+    canvas->drawRect(SkRect::MakeLTRB(20.5f, 9.5f, 80.5f, 90.5f), paint);
+    canvas->restore();
+
+    // A layer with a backdrop reads what has been drawn so far.
+    canvas->save();
+    canvas->clipRect(SkRect::MakeLTRB(30, 20, 70, 80));
+    sk_sp<SkImageFilter> backdrop = SkOffsetImageFilter::Make(-9, 13, nullptr);
+    canvas->saveLayer(SkCanvas::SaveLayerRec(nullptr, nullptr, backdrop.get(), 0));
+    paint.setColor(0x400000FF);
+    canvas->drawCircle(50, 50, 20, paint);
+    canvas->restore();
+    canvas->restore();
+
+    // So does a layer that is drawn back with an image filter.
+    SkPaint layerPaint;
+    layerPaint.setImageFilter(SkBlurImageFilter::Make(2, 3, nullptr));
+    canvas->saveLayer(nullptr, &layerPaint);
+    paint.setColor(0xFFFF00FF);
+    canvas->drawRect(SkRect::MakeLTRB(60, 10, 90, 90), paint);
+    canvas->restore();
+
+    SkPaint alphaPaint;
+    alphaPaint.setAlpha(0x80);
+    canvas->saveLayer(nullptr, &alphaPaint);
+    paint.setColor(SK_ColorYELLOW);
+    canvas->drawCircle(45, 45, 12.5f, paint);
+    canvas->restore();
+}
+
+DEF_TEST(surface_raster_threaded_seams, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(100, 100);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeThreadPool(4);
+
+    sk_sp<SkSurface> serial(SkSurface::MakeRaster(info));
+    sk_sp<SkSurface> threaded(SkSurface::MakeRasterThreaded(info, 7, executor.get()));
+    REPORTER_ASSERT(reporter, serial && threaded);
+
+    draw_threaded_seams_content(serial->getCanvas());
+    draw_threaded_seams_content(threaded->getCanvas());
+
+    SkPixmap expected, actual;
+    REPORTER_ASSERT(reporter, serial->peekPixels(&expected));
+    REPORTER_ASSERT(reporter, threaded->peekPixels(&actual));
+    for (int y = 0; y < info.height(); ++y) {
+        for (int x = 0; x < info.width(); ++x) {
+            if (*expected.addr32(x, y) != *actual.addr32(x, y)) {
+                ERRORF(reporter, "threaded pixel (%d, %d) is %08x, serial is %08x", x, y,
+                       *actual.addr32(x, y), *expected.addr32(x, y));
+                return;
+            }
+        }
+    }
+}
+
 #if SK_SUPPORT_GPU
 static sk_sp<SkSurface> create_gpu_surface_backend_texture(
     GrContext* context, int sampleCnt, uint32_t color, GrBackendObject* outTexture) {
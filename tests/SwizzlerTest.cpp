@@ -5,11 +5,15 @@
  * found in the LICENSE file.
  */
 
+#include "SkHalf.h"
+#include "SkRandom.h"
 #include "SkSwizzle.h"
 #include "SkSwizzler.h"
 #include "Test.h"
 #include "SkOpts.h"
 
+#include <functional>
+
 // These are the values that we will look for to indicate that the fill was successful
 static const uint8_t kFillIndex = 0x11;
 static const uint8_t kFillGray = 0x22;
@@ -167,3 +171,116 @@ DEF_TEST(PublicSwizzleOpts, r) {
     SkSwapRB(&dst, &src, 1);
     REPORTER_ASSERT(r, dst == 0xFA04B0CE);
 }
+
+// Runs each swizzle over every length up to a few SIMD iterations, so that both the vector
+// loops and their tails are checked against a scalar reference.
+DEF_TEST(SwizzleOpts_AllProcs, r) {
+    static const int kMax = 67;
+    uint8_t src[kMax * 8];
+    SkRandom random;
+    for (auto& byte : src) {
+        byte = random.nextU() >> 24;
+    }
+    // Some fully transparent and opaque pixels, to catch premul edge cases.
+    src[3] = 0x00;  src[7] = 0xFF;  src[6*8 + 6] = 0x00;  src[7*8 + 6] = 0xFF;
+
+    auto pack = [](int r, int g, int b, int a) {
+        return (uint32_t)a << 24 | (uint32_t)b << 16 | (uint32_t)g << 8 | (uint32_t)r;
+    };
+    auto mul = [](int x, int y) { return (x*y+127)/255; };
+
+    struct {
+        const char*          name;
+        SkOpts::Swizzle_8888 proc;
+        int                  srcBytes;
+        std::function<uint32_t(const uint8_t*)> expected;
+    } procs[] = {
+        { "RGBA_to_BGRA", SkOpts::RGBA_to_BGRA, 4,
+          [&](const uint8_t* s) { return pack(s[2], s[1], s[0], s[3]); } },
+        { "RGBA_to_rgbA", SkOpts::RGBA_to_rgbA, 4,
+          [&](const uint8_t* s) {
+              return pack(mul(s[0],s[3]), mul(s[1],s[3]), mul(s[2],s[3]), s[3]); } },
+        { "RGBA_to_bgrA", SkOpts::RGBA_to_bgrA, 4,
+          [&](const uint8_t* s) {
+              return pack(mul(s[2],s[3]), mul(s[1],s[3]), mul(s[0],s[3]), s[3]); } },
+        { "RGB_to_RGB1", SkOpts::RGB_to_RGB1, 3,
+          [&](const uint8_t* s) { return pack(s[0], s[1], s[2], 0xFF); } },
+        { "RGB_to_BGR1", SkOpts::RGB_to_BGR1, 3,
+          [&](const uint8_t* s) { return pack(s[2], s[1], s[0], 0xFF); } },
+        { "gray_to_RGB1", SkOpts::gray_to_RGB1, 1,
+          [&](const uint8_t* s) { return pack(s[0], s[0], s[0], 0xFF); } },
+        { "grayA_to_RGBA", SkOpts::grayA_to_RGBA, 2,
+          [&](const uint8_t* s) { return pack(s[0], s[0], s[0], s[1]); } },
+        { "grayA_to_rgbA", SkOpts::grayA_to_rgbA, 2,
+          [&](const uint8_t* s) {
+              int g = mul(s[0], s[1]);
+              return pack(g, g, g, s[1]); } },
+        { "inverted_CMYK_to_RGB1", SkOpts::inverted_CMYK_to_RGB1, 4,
+          [&](const uint8_t* s) {
+              return pack(mul(s[0],s[3]), mul(s[1],s[3]), mul(s[2],s[3]), 0xFF); } },
+        { "inverted_CMYK_to_BGR1", SkOpts::inverted_CMYK_to_BGR1, 4,
+          [&](const uint8_t* s) {
+              return pack(mul(s[2],s[3]), mul(s[1],s[3]), mul(s[0],s[3]), 0xFF); } },
+        { "RGBA16_to_rgbA", SkOpts::RGBA16_to_rgbA, 8,
+          [&](const uint8_t* s) {
+              return pack(mul(s[0],s[6]), mul(s[2],s[6]), mul(s[4],s[6]), s[6]); } },
+        { "RGBA16_to_bgrA", SkOpts::RGBA16_to_bgrA, 8,
+          [&](const uint8_t* s) {
+              return pack(mul(s[4],s[6]), mul(s[2],s[6]), mul(s[0],s[6]), s[6]); } },
+    };
+
+    for (const auto& p : procs) {
+        for (int count = 0; count <= kMax; count++) {
+            uint32_t dst[kMax + 1];
+            dst[count] = 0xDEADBEEF;
+            p.proc(dst, src, count);
+            for (int i = 0; i < count; i++) {
+                uint32_t want = p.expected(src + i * p.srcBytes);
+                if (dst[i] != want) {
+                    ERRORF(r, "%s, count %d, pixel %d: got %08x, want %08x",
+                           p.name, count, i, dst[i], want);
+                    break;
+                }
+            }
+            REPORTER_ASSERT(r, dst[count] == 0xDEADBEEF);
+        }
+    }
+
+    struct {
+        const char*         name;
+        SkOpts::Swizzle_F16 proc;
+        int                 srcBytes;
+        bool                hasAlpha, premul;
+    } f16Procs[] = {
+        { "RGB16_to_F16",         SkOpts::RGB16_to_F16,         6, false, false },
+        { "RGBA16_to_F16",        SkOpts::RGBA16_to_F16,        8,  true, false },
+        { "RGBA16_to_F16_premul", SkOpts::RGBA16_to_F16_premul, 8,  true,  true },
+    };
+
+    for (const auto& p : f16Procs) {
+        for (int count = 0; count <= kMax; count++) {
+            uint64_t dst[kMax + 1];
+            dst[count] = 0xDEADBEEF;
+            p.proc(dst, src, count);
+            for (int i = 0; i < count; i++) {
+                const uint8_t* s = src + i * p.srcBytes;
+                float want[4];
+                for (int c = 0; c < 4; c++) {
+                    want[c] = (c < 3 || p.hasAlpha) ? (s[2*c] << 8 | s[2*c+1]) / 65535.0f : 1.0f;
+                }
+                for (int c = 0; p.premul && c < 3; c++) {
+                    want[c] *= want[3];
+                }
+                for (int c = 0; c < 4; c++) {
+                    float got = SkHalfToFloat((dst[i] >> (16*c)) & 0xFFFF);
+                    // Allow for rounding to 11 bits of precision, and for flushing denormals.
+                    if (fabsf(got - want[c]) > want[c] / 1024 + 1/16384.0f) {
+                        ERRORF(r, "%s, count %d, pixel %d, channel %d: got %g, want %g",
+                               p.name, count, i, c, got, want[c]);
+                    }
+                }
+            }
+            REPORTER_ASSERT(r, dst[count] == 0xDEADBEEF);
+        }
+    }
+}
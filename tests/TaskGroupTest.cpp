@@ -0,0 +1,75 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkExecutor.h"
+#include "SkTaskGroup.h"
+#include "Test.h"
+
+#include <atomic>
+
+DEF_TEST(SkTaskGroup_parallel_for, r) {
+    auto pool = SkExecutor::MakeWorkStealingPool(4);
+
+    for (int grain : { 1, 7, 100, 1000, 5000 }) {
+        const int N = 1000;
+        std::unique_ptr<std::atomic<int>[]> counts(new std::atomic<int>[N]);
+        for (int i = 0; i < N; i++) {
+            counts[i].store(0);
+        }
+
+        std::atomic<int> chunks{0};
+        SkTaskGroup tg(*pool);
+        tg.parallel_for(N, grain, [&](int start, int end) {
+            REPORTER_ASSERT(r, start < end && end - start <= grain && end <= N);
+            chunks.fetch_add(1, std::memory_order_relaxed);
+            for (int i = start; i < end; i++) {
+                counts[i].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        tg.wait();
+
+        REPORTER_ASSERT(r, (N + grain - 1) / grain == chunks.load());
+        for (int i = 0; i < N; i++) {
+            REPORTER_ASSERT(r, 1 == counts[i].load());
+        }
+    }
+
+    // Nothing to do is fine too.
+    SkTaskGroup tg(*pool);
+    tg.parallel_for(0, 16, [&](int, int) { ERRORF(r, "ran a chunk of nothing"); });
+    tg.wait();
+}
+
+DEF_TEST(SkTaskGroup_parallel_reduce, r) {
+    auto pool = SkExecutor::MakeWorkStealingPool(4);
+
+    const int N = 10000;
+    SkTaskGroup tg(*pool);
+    int64_t sum = tg.parallel_reduce(N, 64, int64_t(0),
+                                     [](int start, int end) {
+                                         int64_t partial = 0;
+                                         for (int i = start; i < end; i++) {
+                                             partial += i;
+                                         }
+                                         return partial;
+                                     },
+                                     [](int64_t a, int64_t b) { return a + b; });
+    REPORTER_ASSERT(r, int64_t(N) * (N - 1) / 2 == sum);
+
+    // Results are folded in chunk order, so a non-commutative reduce still comes out right.
+    auto concat = [](SkString a, const SkString& b) { a.append(b); return a; };
+    SkString digits = tg.parallel_reduce(10, 3, SkString(),
+                                         [](int start, int end) {
+                                             SkString chunk;
+                                             for (int i = start; i < end; i++) {
+                                                 chunk.appendS32(i);
+                                             }
+                                             return chunk;
+                                         },
+                                         concat);
+    REPORTER_ASSERT(r, digits.equals("0123456789"));
+}
@@ -72,6 +72,14 @@ DEFINE_bool(forceAnalyticAA, false, "Force analytic anti-aliasing even if the pa
                                     "whether it's concave or convex, we consider a path complicated"
                                     "if its number of points is comparable to its resolution.");
 
+DEFINE_bool(deltaAA, false, "If true, use delta anti-aliasing for paths too complicated for "
+                            "analytic anti-aliasing.");
+
+DEFINE_bool(forceDeltaAA, false, "Force delta anti-aliasing for all anti-aliased paths.");
+
+DEFINE_bool(bandedFill, false, "If true, split the edges of huge path fills into bands that are "
+                               "scan-converted concurrently on the thread pool.");
+
 bool CollectImages(SkCommandLineFlags::StringArray images, SkTArray<SkString>* output) {
     SkASSERT(output);
 